@@ -0,0 +1,321 @@
+/* GStreamer Editing Services
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+/* Reduction of decoded audio to the peaks of buckets of time.
+ *
+ * The decoded interleaved samples are first split by channel, so that the
+ * kernel reducing a bucket only goes through contiguous memory. The kernel
+ * keeps LANES independent minimums, maximums and sums, which removes the
+ * dependency between consecutive iterations so that they can overlap in
+ * the CPU pipeline. The lanes are only combined at the end.
+ *
+ * The sums of squares of each call are accumulated in doubles, so the
+ * precision of the RMS does not depend on how long the buckets are.
+ *
+ * NOTE: This is for internal use exclusively
+ */
+
+#include <math.h>
+#include <string.h>
+#include "ges-internal.h"
+#include "ges-audio-peaks.h"
+
+#define LANES 8
+
+/* How far the timestamps can drift from the frames counted so far before
+ * the reducer is resynchronised on them, the same default as the
+ * alignment threshold of the audio sinks */
+#define ALIGNMENT_THRESHOLD (40 * GST_MSECOND)
+
+struct _GESPeaksReducer
+{
+  GstClockTime bucket_duration;
+  guint n_channels;
+  gint rate;
+
+  /* The position of the next frame, and whether any was pushed yet */
+  guint64 frame;
+  gboolean started;
+
+  /* The bucket being filled, and the first frame of the next one */
+  guint64 bucket;
+  guint64 bucket_end;
+  guint64 bucket_frames;
+
+  /* Per channel accumulators of the current bucket */
+  gfloat *min;
+  gfloat *max;
+  gdouble *sum_squares;
+
+  /* GESAudioPeak of the buckets finished since the last take */
+  guint64 first_finished;
+  GArray *finished;
+};
+
+/* Accumulates the peaks of @samples into @min, @max and @sum_squares. */
+void
+ges_audio_peaks_reduce (const gfloat * samples, guint n_samples,
+    gfloat * min, gfloat * max, gdouble * sum_squares)
+{
+  guint i, j;
+  gfloat lane_min[LANES], lane_max[LANES], lane_squares[LANES];
+  gfloat rmin = *min, rmax = *max;
+  gdouble squares = 0;
+
+  for (j = 0; j < LANES; j++) {
+    lane_min[j] = rmin;
+    lane_max[j] = rmax;
+    lane_squares[j] = 0;
+  }
+
+  for (i = 0; i + LANES <= n_samples; i += LANES) {
+    for (j = 0; j < LANES; j++) {
+      gfloat x = samples[i + j];
+
+      lane_min[j] = x < lane_min[j] ? x : lane_min[j];
+      lane_max[j] = x > lane_max[j] ? x : lane_max[j];
+      lane_squares[j] += x * x;
+    }
+  }
+
+  for (j = 0; j < LANES; j++) {
+    rmin = MIN (rmin, lane_min[j]);
+    rmax = MAX (rmax, lane_max[j]);
+    squares += lane_squares[j];
+  }
+
+  for (; i < n_samples; i++) {
+    gfloat x = samples[i];
+
+    rmin = MIN (rmin, x);
+    rmax = MAX (rmax, x);
+    squares += x * x;
+  }
+
+  *min = rmin;
+  *max = rmax;
+  *sum_squares += squares;
+}
+
+/* Splits @interleaved by channel, the samples of channel c going to
+ * @planar + c * @n_frames */
+void
+ges_audio_peaks_deinterleave (const gfloat * interleaved, guint n_frames,
+    guint n_channels, gfloat * planar)
+{
+  guint i, c;
+
+  if (n_channels == 1) {
+    memcpy (planar, interleaved, n_frames * sizeof (gfloat));
+
+    return;
+  }
+
+  for (c = 0; c < n_channels; c++) {
+    gfloat *out = planar + c * n_frames;
+    const gfloat *in = interleaved + c;
+
+    for (i = 0; i < n_frames; i++)
+      out[i] = in[i * n_channels];
+  }
+}
+
+static inline guint64
+_bucket_start (GESPeaksReducer * reducer, guint64 bucket)
+{
+  return gst_util_uint64_scale (bucket * reducer->bucket_duration,
+      reducer->rate, GST_SECOND);
+}
+
+static void
+_reset_bucket (GESPeaksReducer * reducer)
+{
+  guint c;
+
+  for (c = 0; c < reducer->n_channels; c++) {
+    reducer->min[c] = G_MAXFLOAT;
+    reducer->max[c] = -G_MAXFLOAT;
+    reducer->sum_squares[c] = 0;
+  }
+  reducer->bucket_frames = 0;
+}
+
+static void
+_finish_bucket (GESPeaksReducer * reducer)
+{
+  guint c;
+
+  for (c = 0; c < reducer->n_channels; c++) {
+    GESAudioPeak peak = { 0, 0, 0 };
+
+    /* Buckets shorter than a frame can be empty */
+    if (reducer->bucket_frames) {
+      peak.min = reducer->min[c];
+      peak.max = reducer->max[c];
+      peak.rms = sqrt (reducer->sum_squares[c] / reducer->bucket_frames);
+    }
+    g_array_append_val (reducer->finished, peak);
+  }
+
+  reducer->bucket++;
+  reducer->bucket_end = _bucket_start (reducer, reducer->bucket + 1);
+  _reset_bucket (reducer);
+}
+
+/* Returns a new #GESPeaksReducer */
+GESPeaksReducer *
+ges_peaks_reducer_new (GstClockTime bucket_duration, guint n_channels,
+    gint rate)
+{
+  GESPeaksReducer *reducer;
+
+  g_return_val_if_fail (bucket_duration > 0, NULL);
+  g_return_val_if_fail (n_channels > 0, NULL);
+  g_return_val_if_fail (rate > 0, NULL);
+
+  reducer = g_slice_new0 (GESPeaksReducer);
+  reducer->bucket_duration = bucket_duration;
+  reducer->n_channels = n_channels;
+  reducer->rate = rate;
+  reducer->min = g_new (gfloat, n_channels);
+  reducer->max = g_new (gfloat, n_channels);
+  reducer->sum_squares = g_new (gdouble, n_channels);
+  reducer->finished = g_array_new (FALSE, FALSE, sizeof (GESAudioPeak));
+  reducer->bucket_end = _bucket_start (reducer, 1);
+  _reset_bucket (reducer);
+
+  return reducer;
+}
+
+void
+ges_peaks_reducer_free (GESPeaksReducer * reducer)
+{
+  g_free (reducer->min);
+  g_free (reducer->max);
+  g_free (reducer->sum_squares);
+  g_array_free (reducer->finished, TRUE);
+  g_slice_free (GESPeaksReducer, reducer);
+}
+
+/* Reduces @n_frames frames of @planar starting from @offset, each channel
+ * having @stride frames */
+static void
+_push (GESPeaksReducer * reducer, const gfloat * planar, guint stride,
+    guint offset, guint n_frames)
+{
+  guint c, n;
+
+  n_frames += offset;
+  while (offset < n_frames) {
+    n = MIN (n_frames - offset, reducer->bucket_end - reducer->frame);
+
+    for (c = 0; c < reducer->n_channels; c++)
+      ges_audio_peaks_reduce (planar + c * stride + offset, n,
+          &reducer->min[c], &reducer->max[c], &reducer->sum_squares[c]);
+
+    reducer->bucket_frames += n;
+    reducer->frame += n;
+    offset += n;
+
+    if (reducer->frame == reducer->bucket_end)
+      _finish_bucket (reducer);
+  }
+  reducer->started = TRUE;
+}
+
+/* Reduces the next @n_frames frames of the audio. */
+void
+ges_peaks_reducer_push (GESPeaksReducer * reducer, const gfloat * planar,
+    guint n_frames)
+{
+  _push (reducer, planar, n_frames, 0, n_frames);
+}
+
+/* Reduces @n_frames frames of the audio starting at the @frame position,
+ * or following the previous ones if @frame is
+ * %GES_PEAKS_REDUCER_NO_POSITION.
+ *
+ * The reducer is moved to @frame for the first frames, after a
+ * discontinuity, or when @frame drifted too far from the frames counted so
+ * far. Skipped frames are considered silent, and frames before the ones
+ * already reduced are dropped. */
+void
+ges_peaks_reducer_push_at (GESPeaksReducer * reducer, guint64 frame,
+    gboolean discont, const gfloat * planar, guint n_frames)
+{
+  guint skip = 0;
+  guint64 threshold;
+
+  if (frame == GES_PEAKS_REDUCER_NO_POSITION || frame == reducer->frame)
+    goto push;
+
+  threshold = gst_util_uint64_scale (ALIGNMENT_THRESHOLD, reducer->rate,
+      GST_SECOND);
+  if (reducer->started && !discont && frame <= reducer->frame + threshold &&
+      frame + threshold >= reducer->frame)
+    goto push;
+
+  if (frame > reducer->frame) {
+    while (frame >= reducer->bucket_end)
+      _finish_bucket (reducer);
+    reducer->frame = frame;
+  } else {
+    skip = MIN (reducer->frame - frame, n_frames);
+  }
+
+push:
+  _push (reducer, planar, n_frames, skip, n_frames - skip);
+}
+
+/* Finishes the bucket being filled, at the end of the audio. */
+void
+ges_peaks_reducer_drain (GESPeaksReducer * reducer)
+{
+  if (reducer->bucket_frames)
+    _finish_bucket (reducer);
+}
+
+/* Takes the peaks of the buckets finished since the last call.
+ *
+ * Returns @n_buckets times the number of channels peaks,
+ * or %NULL if no bucket was finished */
+GESAudioPeak *
+ges_peaks_reducer_take (GESPeaksReducer * reducer, guint64 * first_bucket,
+    guint * n_buckets)
+{
+  GESAudioPeak *peaks;
+
+  *first_bucket = reducer->first_finished;
+  *n_buckets = reducer->finished->len / reducer->n_channels;
+  if (*n_buckets == 0)
+    return NULL;
+
+  peaks = g_memdup (reducer->finished->data,
+      reducer->finished->len * sizeof (GESAudioPeak));
+  reducer->first_finished += *n_buckets;
+  g_array_set_size (reducer->finished, 0);
+
+  return peaks;
+}
+
+/* Returns the number of buckets finished so far */
+guint64
+ges_peaks_reducer_get_n_buckets (GESPeaksReducer * reducer)
+{
+  return reducer->bucket;
+}
@@ -0,0 +1,72 @@
+/* GStreamer Editing Services
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef _GES_AUDIO_PEAKS_H_
+#define _GES_AUDIO_PEAKS_H_
+
+#include <gst/gst.h>
+#include <ges/ges.h>
+
+G_BEGIN_DECLS
+
+/* Reduction of decoded audio to the min/max/RMS peaks of buckets of time,
+ * used by ges_uri_clip_asset_compute_peaks_async().
+ *
+ * NOTE: This is for internal use exclusively, the unit tests build their
+ * own copy of it to check the kernels against a reference implementation */
+typedef struct _GESPeaksReducer GESPeaksReducer;
+
+#define GES_PEAKS_REDUCER_NO_POSITION G_MAXUINT64
+
+G_GNUC_INTERNAL void
+ges_audio_peaks_reduce          (const gfloat *samples, guint n_samples,
+                                 gfloat *min, gfloat *max,
+                                 gdouble *sum_squares);
+
+G_GNUC_INTERNAL void
+ges_audio_peaks_deinterleave    (const gfloat *interleaved, guint n_frames,
+                                 guint n_channels, gfloat *planar);
+
+G_GNUC_INTERNAL GESPeaksReducer *
+ges_peaks_reducer_new           (GstClockTime bucket_duration,
+                                 guint n_channels, gint rate);
+
+G_GNUC_INTERNAL void
+ges_peaks_reducer_free          (GESPeaksReducer *reducer);
+
+G_GNUC_INTERNAL void
+ges_peaks_reducer_push          (GESPeaksReducer *reducer,
+                                 const gfloat *planar, guint n_frames);
+
+G_GNUC_INTERNAL void
+ges_peaks_reducer_push_at       (GESPeaksReducer *reducer, guint64 frame,
+                                 gboolean discont, const gfloat *planar,
+                                 guint n_frames);
+
+G_GNUC_INTERNAL void
+ges_peaks_reducer_drain         (GESPeaksReducer *reducer);
+
+G_GNUC_INTERNAL GESAudioPeak *
+ges_peaks_reducer_take          (GESPeaksReducer *reducer,
+                                 guint64 *first_bucket, guint *n_buckets);
+
+G_GNUC_INTERNAL guint64
+ges_peaks_reducer_get_n_buckets (GESPeaksReducer *reducer);
+
+G_END_DECLS
+#endif /* _GES_AUDIO_PEAKS_H_ */
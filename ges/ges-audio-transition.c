@@ -54,6 +54,8 @@ ges_audio_transition_duration_changed (GESTrackElement * self, guint64);
 
 static GstElement *ges_audio_transition_create_element (GESTrackElement * self);
 
+static void ges_audio_transition_release_element (GESTrackElement * self);
+
 static void ges_audio_transition_dispose (GObject * object);
 
 static void ges_audio_transition_finalize (GObject * object);
@@ -88,6 +90,7 @@ ges_audio_transition_class_init (GESAudioTransitionClass * klass)
   object_class->finalize = ges_audio_transition_finalize;
 
   toclass->create_element = ges_audio_transition_create_element;
+  toclass->release_element = ges_audio_transition_release_element;
 
 }
 
@@ -249,6 +252,21 @@ ges_audio_transition_create_element (GESTrackElement * track_element)
   return topbin;
 }
 
+static void
+ges_audio_transition_release_element (GESTrackElement * track_element)
+{
+  GESAudioTransition *self = GES_AUDIO_TRANSITION (track_element);
+
+  /* The control sources are created again with the elements */
+  gst_object_unref (self->priv->a_control_source);
+  self->priv->a_control_source = NULL;
+  gst_object_unref (self->priv->b_control_source);
+  self->priv->b_control_source = NULL;
+
+  g_signal_handlers_disconnect_by_func (track_element, duration_changed_cb,
+      NULL);
+}
+
 static void
 ges_audio_transition_duration_changed (GESTrackElement * track_element,
     guint64 duration)
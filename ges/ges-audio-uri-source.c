@@ -144,10 +144,28 @@ ges_audio_uri_source_dispose (GObject * object)
   G_OBJECT_CLASS (ges_audio_uri_source_parent_class)->dispose (object);
 }
 
+static GESTimelineElement *
+ges_audio_uri_source_clone (GESTimelineElement * element)
+{
+  GESAudioUriSource *copy, *self = GES_AUDIO_URI_SOURCE (element);
+
+  if (G_OBJECT_TYPE (self) != GES_TYPE_AUDIO_URI_SOURCE)
+    return GES_TIMELINE_ELEMENT_CLASS
+        (ges_audio_uri_source_parent_class)->clone (element);
+
+  copy = g_object_new (GES_TYPE_AUDIO_URI_SOURCE, NULL);
+  copy->uri = g_strdup (self->uri);
+  ges_track_element_clone_fields (GES_TRACK_ELEMENT (self),
+      GES_TRACK_ELEMENT (copy));
+
+  return GES_TIMELINE_ELEMENT (copy);
+}
+
 static void
 ges_audio_uri_source_class_init (GESAudioUriSourceClass * klass)
 {
   GObjectClass *object_class = G_OBJECT_CLASS (klass);
+  GESTimelineElementClass *element_class = GES_TIMELINE_ELEMENT_CLASS (klass);
   GESAudioSourceClass *source_class = GES_AUDIO_SOURCE_CLASS (klass);
 
   g_type_class_add_private (klass, sizeof (GESAudioUriSourcePrivate));
@@ -155,6 +173,7 @@ ges_audio_uri_source_class_init (GESAudioUriSourceClass * klass)
   object_class->get_property = ges_audio_uri_source_get_property;
   object_class->set_property = ges_audio_uri_source_set_property;
   object_class->dispose = ges_audio_uri_source_dispose;
+  element_class->clone = ges_audio_uri_source_clone;
 
   /**
    * GESAudioUriSource:uri:
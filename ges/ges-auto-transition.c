@@ -77,19 +77,6 @@ _height_changed_cb (GESClip * clip, GParamSpec * arg G_GNUC_UNUSED,
       GES_CONTAINER_HEIGHT (self->previous_clip));
 }
 
-static void
-_track_changed_cb (GESTrackElement * track_element,
-    GParamSpec * arg G_GNUC_UNUSED, GESAutoTransition * self)
-{
-  if (ges_track_element_get_track (track_element) == NULL) {
-    GST_DEBUG_OBJECT (self, "Neighboor %" GST_PTR_FORMAT
-        " removed from track ... auto destructing", track_element);
-
-    g_signal_emit (self, auto_transition_signals[DESTROY_ME], 0);
-  }
-
-}
-
 static void
 ges_auto_transition_init (GESAutoTransition * ges_auto_transition)
 {
@@ -106,12 +93,6 @@ ges_auto_transition_finalize (GObject * object)
       self);
   g_signal_handlers_disconnect_by_func (self->previous_clip,
       _height_changed_cb, self);
-  g_signal_handlers_disconnect_by_func (self->next_source, _track_changed_cb,
-      self);
-  g_signal_handlers_disconnect_by_func (self->previous_source,
-      _track_changed_cb, self);
-
-  g_free (self->key);
 
   G_OBJECT_CLASS (ges_auto_transition_parent_class)->finalize (object);
 }
@@ -159,11 +140,6 @@ ges_auto_transition_new (GESTrackElement * transition,
   g_signal_connect (self->previous_clip, "notify::height",
       G_CALLBACK (_height_changed_cb), self);
 
-  g_signal_connect (next_source, "notify::track",
-      G_CALLBACK (_track_changed_cb), self);
-  g_signal_connect (previous_source, "notify::track",
-      G_CALLBACK (_track_changed_cb), self);
-
   _height_changed_cb (self->previous_clip, NULL, self);
 
   GST_DEBUG_OBJECT (self, "Created transition %" GST_PTR_FORMAT
@@ -175,8 +151,24 @@ ges_auto_transition_new (GESTrackElement * transition,
       GST_TIME_ARGS (_START (transition)),
       GST_TIME_ARGS (_DURATION (transition)));
 
-  self->key = g_strdup_printf ("%p%p", self->previous_source,
-      self->next_source);
+  self->key.previous_source = previous_source;
+  self->key.next_source = next_source;
 
   return self;
 }
+
+guint
+ges_auto_transition_key_hash (const GESAutoTransitionKey * key)
+{
+  guint hash = g_direct_hash (key->previous_source);
+
+  return (hash << 5) - hash + g_direct_hash (key->next_source);
+}
+
+gboolean
+ges_auto_transition_key_equal (const GESAutoTransitionKey * a,
+    const GESAutoTransitionKey * b)
+{
+  return a->previous_source == b->previous_source &&
+      a->next_source == b->next_source;
+}
@@ -37,6 +37,13 @@ G_BEGIN_DECLS
 typedef struct _GESAutoTransitionClass GESAutoTransitionClass;
 typedef struct _GESAutoTransition GESAutoTransition;
 
+/* Identifies an auto transition by the sources it is in between, meant
+ * to be used as a GHashTable key */
+typedef struct
+{
+  GESTrackElement *previous_source;
+  GESTrackElement *next_source;
+} GESAutoTransitionKey;
 
 
 struct _GESAutoTransitionClass
@@ -62,7 +69,7 @@ struct _GESAutoTransition
   GESClip *next_clip;
   GESClip *transition_clip;
 
-  gchar *key;
+  GESAutoTransitionKey key;
 
   /* Padding for API extension */
   gpointer _ges_reserved[GES_PADDING];
@@ -74,5 +81,9 @@ GESAutoTransition * ges_auto_transition_new (GESTrackElement * transition,
                                              GESTrackElement * previous_source,
                                              GESTrackElement * next_source);
 
+guint ges_auto_transition_key_hash (const GESAutoTransitionKey * key);
+gboolean ges_auto_transition_key_equal (const GESAutoTransitionKey * a,
+                                        const GESAutoTransitionKey * b);
+
 G_END_DECLS
 #endif /* _GES_AUTO_TRANSITION_H_ */
@@ -79,6 +79,8 @@ typedef struct LayerEntry
 typedef struct PendingAsset
 {
   GESFormatter *formatter;
+  GType extractable_type;
+  gchar *id;
   gchar *metadatas;
   gchar *parent_id;
   GstStructure *properties;
@@ -89,6 +91,10 @@ struct _GESBaseXmlFormatterPrivate
   GMarkupParseContext *parsecontext;
   gboolean check_only;
 
+  /* Set when the parsing failed or got cancelled, in which case the
+   * project should not be considered loaded */
+  gboolean parsing_failed;
+
   /* Asset.id -> PendingClip */
   GHashTable *assetid_pendingclips;
 
@@ -107,6 +113,12 @@ struct _GESBaseXmlFormatterPrivate
   /* List of asset waited to be created */
   GList *pending_assets;
 
+  /* The PendingAsset-s whose request has not been issued yet, we only
+   * keep max_asset_requests requests in flight at the same time */
+  GQueue *queued_assets;
+  guint n_asset_requests;
+  guint max_asset_requests;
+
   /* current track element */
   GESTrackElement *current_track_element;
 
@@ -138,13 +150,40 @@ enum
 static guint signals[LAST_SIGNAL];
 */
 
+/* Size of the chunks the project file is read and parsed by, so that we
+ * never need to hold the whole file in memory */
+#define PARSE_CHUNK_SIZE (64 * 1024)
+
+static void
+_report_progress (GESBaseXmlFormatter * self, goffset offset, goffset size,
+    gint * last_percent)
+{
+  gint percent;
+  GESProject *project = GES_FORMATTER (self)->project;
+
+  if (project == NULL || size <= 0)
+    return;
+
+  /* Only notify when the progress is noticeable */
+  percent = MIN (100, offset * 100 / size);
+  if (percent == *last_percent)
+    return;
+
+  *last_percent = percent;
+  ges_project_emit_loading_progress (project, (gdouble) percent / 100.0);
+}
+
 static GMarkupParseContext *
 create_parser_context (GESBaseXmlFormatter * self, const gchar * uri,
-    GError ** error)
+    GCancellable * cancellable, GError ** error)
 {
-  gsize xmlsize;
+  gssize read;
+  GFileInfo *info;
   GFile *file = NULL;
-  gchar *xmlcontent = NULL;
+  gchar *buffer = NULL;
+  gint last_percent = -1;
+  goffset size = -1, offset = 0;
+  GFileInputStream *stream = NULL;
   GMarkupParseContext *parsecontext = NULL;
   GESBaseXmlFormatterClass *self_class =
       GES_BASE_XML_FORMATTER_GET_CLASS (self);
@@ -154,23 +193,42 @@ create_parser_context (GESBaseXmlFormatter * self, const gchar * uri,
   if ((file = g_file_new_for_uri (uri)) == NULL)
     goto wrong_uri;
 
-  /* TODO Handle GCancellable */
-  if (!g_file_load_contents (file, NULL, &xmlcontent, &xmlsize, NULL, &err))
+  stream = g_file_read (file, cancellable, &err);
+  if (stream == NULL)
     goto failed;
 
-  if (g_strcmp0 (xmlcontent, "") == 0)
-    goto failed;
+  info = g_file_input_stream_query_info (stream,
+      G_FILE_ATTRIBUTE_STANDARD_SIZE, cancellable, NULL);
+  if (info) {
+    size = g_file_info_get_size (info);
+    g_object_unref (info);
+  }
 
   parsecontext = g_markup_parse_context_new (&self_class->content_parser,
       G_MARKUP_TREAT_CDATA_AS_TEXT, self, NULL);
 
-  if (g_markup_parse_context_parse (parsecontext, xmlcontent, xmlsize,
-          &err) == FALSE)
+  buffer = g_malloc (PARSE_CHUNK_SIZE);
+  while ((read = g_input_stream_read (G_INPUT_STREAM (stream), buffer,
+              PARSE_CHUNK_SIZE, cancellable, &err)) > 0) {
+    if (g_markup_parse_context_parse (parsecontext, buffer, read,
+            &err) == FALSE)
+      goto failed;
+
+    offset += read;
+    _report_progress (self, offset, size, &last_percent);
+  }
+
+  if (read < 0 || offset == 0)
+    goto failed;
+
+  if (g_markup_parse_context_end_parse (parsecontext, &err) == FALSE)
     goto failed;
 
 done:
-  if (xmlcontent)
-    g_free (xmlcontent);
+  g_free (buffer);
+
+  if (stream)
+    g_object_unref (stream);
 
   if (file)
     gst_object_unref (file);
@@ -183,7 +241,8 @@ wrong_uri:
   goto done;
 
 failed:
-  g_propagate_error (error, err);
+  if (err)
+    g_propagate_error (error, err);
 
   if (parsecontext) {
     g_markup_parse_context_free (parsecontext);
@@ -199,111 +258,154 @@ failed:
  *                                             *
  ***********************************************/
 
+/* Only the beginning of the file is parsed to check whether it can be
+ * loaded, that is enough for the subclasses to check the root elements */
+#define SNIFF_SIZE (4 * 1024)
+
 static gboolean
 _can_load_uri (GESFormatter * dummy_formatter, const gchar * uri,
     GError ** error)
 {
+  GFile *file;
+  gsize read = 0;
+  gboolean ret = FALSE;
+  gchar buffer[SNIFF_SIZE];
+  GFileInputStream *stream;
   GMarkupParseContext *ctx;
   GESBaseXmlFormatter *self = GES_BASE_XML_FORMATTER (dummy_formatter);
+  GESBaseXmlFormatterClass *self_class =
+      GES_BASE_XML_FORMATTER_GET_CLASS (self);
 
   /* we create a temporary object so we can use it as a context */
   _GET_PRIV (self)->check_only = TRUE;
 
-
-  ctx = create_parser_context (self, uri, error);
-  if (!ctx)
+  file = g_file_new_for_uri (uri);
+  stream = g_file_read (file, NULL, error);
+  gst_object_unref (file);
+  if (stream == NULL)
     return FALSE;
 
+  if (!g_input_stream_read_all (G_INPUT_STREAM (stream), buffer,
+          SNIFF_SIZE, &read, NULL, error) || read == 0)
+    goto done;
+
+  ctx = g_markup_parse_context_new (&self_class->content_parser,
+      G_MARKUP_TREAT_CDATA_AS_TEXT, self, NULL);
+  if (g_markup_parse_context_parse (ctx, buffer, read, error)) {
+    if (read < SNIFF_SIZE)
+      /* We got the whole file */
+      ret = g_markup_parse_context_end_parse (ctx, error);
+    else
+      /* The subclass accepted the root element(s) */
+      ret = g_markup_parse_context_get_element (ctx) != NULL;
+  }
   g_markup_parse_context_free (ctx);
-  return TRUE;
+
+done:
+  g_object_unref (stream);
+
+  return ret;
 }
 
 static gboolean
 _load_from_uri (GESFormatter * self, GESTimeline * timeline, const gchar * uri,
     GError ** error)
 {
+  GCancellable *cancellable = NULL;
   GESBaseXmlFormatterPrivate *priv = _GET_PRIV (self);
 
   ges_timeline_set_auto_transition (timeline, FALSE);
 
+  if (self->project)
+    cancellable = ges_project_get_load_cancellable (self->project);
+
   priv->parsecontext =
-      create_parser_context (GES_BASE_XML_FORMATTER (self), uri, error);
+      create_parser_context (GES_BASE_XML_FORMATTER (self), uri, cancellable,
+      error);
+
+  if (!priv->parsecontext) {
+    priv->parsing_failed = TRUE;
 
-  if (!priv->parsecontext)
     return FALSE;
+  }
 
   return TRUE;
 }
 
+typedef struct
+{
+  GESFormatter *formatter;
+  GESTimeline *timeline;
+} SaveData;
+
 static gboolean
-_save_to_uri (GESFormatter * formatter, GESTimeline * timeline,
-    const gchar * uri, gboolean overwrite, GError ** error)
+_write_project (GOutputStream * stream, SaveData * data, GError ** error)
 {
-  GFile *file;
-  gboolean ret;
   GString *str;
-  GOutputStream *stream;
-  GError *lerror = NULL;
-
-  g_return_val_if_fail (formatter->project, FALSE);
-
-  file = g_file_new_for_uri (uri);
-  stream = G_OUTPUT_STREAM (g_file_create (file, G_FILE_CREATE_NONE, NULL,
-          &lerror));
-  if (stream == NULL) {
-    if (overwrite && lerror->code == G_IO_ERROR_EXISTS) {
-      g_clear_error (&lerror);
-      stream = G_OUTPUT_STREAM (g_file_replace (file, NULL, FALSE,
-              G_FILE_CREATE_NONE, NULL, &lerror));
-    }
-
-    if (stream == NULL)
-      goto failed_opening_file;
-  }
+  gboolean ret;
+  GESFormatterClass *klass = GES_FORMATTER_GET_CLASS (data->formatter);
 
-  str = GES_BASE_XML_FORMATTER_GET_CLASS (formatter)->save (formatter,
-      timeline, error);
+  if (klass->save_to_stream)
+    return klass->save_to_stream (data->formatter, data->timeline, stream,
+        error);
 
+  str = GES_BASE_XML_FORMATTER_GET_CLASS (data->formatter)->save
+      (data->formatter, data->timeline, error);
   if (str == NULL)
-    goto serialization_failed;
+    return FALSE;
 
   ret = g_output_stream_write_all (stream, str->str, str->len, NULL,
-      NULL, &lerror);
-  ret = g_output_stream_close (stream, NULL, &lerror);
+      g_cancellable_get_current (), error);
+  g_string_free (str, TRUE);
 
-  if (ret == FALSE)
-    GST_WARNING_OBJECT (formatter, "Could not save %s because: %s", uri,
-        lerror->message);
+  return ret;
+}
 
-  g_string_free (str, TRUE);
-  gst_object_unref (file);
-  gst_object_unref (stream);
+static gboolean
+_save_to_uri (GESFormatter * formatter, GESTimeline * timeline,
+    const gchar * uri, gboolean overwrite, GError ** error)
+{
+  SaveData data = { formatter, timeline };
 
-  if (lerror)
-    g_propagate_error (error, lerror);
+  g_return_val_if_fail (formatter->project, FALSE);
 
-  return ret;
+  return ges_formatter_write_uri (uri, overwrite,
+      (GESFormatterWriteFunc) _write_project, &data,
+      g_cancellable_get_current (), error);
+}
 
-serialization_failed:
-  gst_object_unref (file);
+/* Default implementation of the save vmethod for subclasses writing to a
+ * stream */
+static GString *
+_save (GESFormatter * formatter, GESTimeline * timeline, GError ** error)
+{
+  gsize size;
+  GString *str;
+  GOutputStream *stream;
+  GESFormatterClass *klass = GES_FORMATTER_GET_CLASS (formatter);
 
-  g_output_stream_close (stream, NULL, NULL);
-  gst_object_unref (stream);
-  if (lerror)
-    g_propagate_error (error, lerror);
+  if (klass->save_to_stream == NULL) {
+    GST_ERROR_OBJECT (formatter, "Neither save nor save_to_stream "
+        "implemented");
 
-  return FALSE;
+    return NULL;
+  }
 
-failed_opening_file:
-  gst_object_unref (file);
+  stream = g_memory_output_stream_new (NULL, 0, g_realloc, g_free);
+  if (!klass->save_to_stream (formatter, timeline, stream, error) ||
+      !g_output_stream_close (stream, NULL, error)) {
+    g_object_unref (stream);
 
-  GST_WARNING_OBJECT (formatter, "Could not open %s because: %s", uri,
-      lerror->message);
+    return NULL;
+  }
 
-  if (lerror)
-    g_propagate_error (error, lerror);
+  size = g_memory_output_stream_get_data_size (G_MEMORY_OUTPUT_STREAM
+      (stream));
+  str = g_string_new_len (g_memory_output_stream_get_data
+      (G_MEMORY_OUTPUT_STREAM (stream)), size);
+  g_object_unref (stream);
 
-  return FALSE;
+  return str;
 }
 
 /***********************************************
@@ -335,6 +437,8 @@ _finalize (GObject * object)
   if (priv->parsecontext != NULL)
     g_markup_parse_context_free (priv->parsecontext);
 
+  g_queue_free (priv->queued_assets);
+
   G_OBJECT_CLASS (parent_class)->finalize (object);
 }
 
@@ -344,8 +448,18 @@ ges_base_xml_formatter_init (GESBaseXmlFormatter * self)
   GESBaseXmlFormatterPrivate *priv = _GET_PRIV (self);
 
   priv->check_only = FALSE;
+  priv->parsing_failed = FALSE;
   priv->parsecontext = NULL;
   priv->pending_assets = NULL;
+  priv->queued_assets = g_queue_new ();
+  priv->n_asset_requests = 0;
+
+  /* Enough requests to keep all the discoverers busy */
+#if GLIB_CHECK_VERSION(2, 36, 0)
+  priv->max_asset_requests = 2 * MAX (g_get_num_processors (), 1);
+#else
+  priv->max_asset_requests = 4;
+#endif
 
   /* The PendingClip are owned by the assetid_pendingclips table */
   priv->assetid_pendingclips = g_hash_table_new_full (g_str_hash,
@@ -378,7 +492,7 @@ ges_base_xml_formatter_class_init (GESBaseXmlFormatterClass * self_class)
   formatter_klass->load_from_uri = _load_from_uri;
   formatter_klass->save_to_uri = _save_to_uri;
 
-  self_class->save = NULL;
+  self_class->save = _save;
 }
 
 /***********************************************
@@ -531,6 +645,7 @@ _free_pending_clip (GESBaseXmlFormatterPrivate * priv, PendingClip * pend)
 static void
 _free_pending_asset (GESBaseXmlFormatterPrivate * priv, PendingAsset * passet)
 {
+  g_free (passet->id);
   if (passet->metadatas)
     g_free (passet->metadatas);
   if (passet->properties)
@@ -556,6 +671,22 @@ _add_pending_bindings (GESBaseXmlFormatterPrivate * priv, GList * bindings,
   }
 }
 
+static void new_asset_cb (GESAsset * source, GAsyncResult * res,
+    PendingAsset * passet);
+
+static void
+_request_queued_assets (GESBaseXmlFormatterPrivate * priv)
+{
+  PendingAsset *passet;
+
+  while (priv->n_asset_requests < priv->max_asset_requests &&
+      (passet = g_queue_pop_head (priv->queued_assets))) {
+    priv->n_asset_requests++;
+    ges_asset_request_async (passet->extractable_type, passet->id, NULL,
+        (GAsyncReadyCallback) new_asset_cb, passet);
+  }
+}
+
 static void
 new_asset_cb (GESAsset * source, GAsyncResult * res, PendingAsset * passet)
 {
@@ -567,6 +698,8 @@ new_asset_cb (GESAsset * source, GAsyncResult * res, PendingAsset * passet)
   GESBaseXmlFormatterPrivate *priv = _GET_PRIV (self);
   GESAsset *asset = ges_asset_request_finish (res, &error);
 
+  priv->n_asset_requests--;
+
   if (error) {
     GST_LOG_OBJECT (self, "Error %s creating asset id: %s", error->message, id);
 
@@ -600,10 +733,11 @@ new_asset_cb (GESAsset * source, GAsyncResult * res, PendingAsset * passet)
       goto done;
     }
 
-    /* We got a possible ID replacement for that asset, create it, and
+    /* We got a possible ID replacement for that asset, create it first, and
      * make sure the assetid_pendingclips will use it */
-    ges_asset_request_async (ges_asset_get_extractable_type (source),
-        possible_id, NULL, (GAsyncReadyCallback) new_asset_cb, passet);
+    g_free (passet->id);
+    passet->id = g_strdup (possible_id);
+    g_queue_push_head (priv->queued_assets, passet);
     ges_project_add_loading_asset (GES_FORMATTER (self)->project,
         ges_asset_get_extractable_type (source), possible_id);
 
@@ -619,10 +753,12 @@ new_asset_cb (GESAsset * source, GAsyncResult * res, PendingAsset * passet)
     goto done;
   }
 
-  /* now that we have the GESAsset, we create the GESClips */
+  /* now that we have the GESAsset, we create the GESClips, all at once */
   pendings = g_hash_table_lookup (priv->assetid_pendingclips, id);
   GST_DEBUG_OBJECT (self, "Asset created with ID %s, now creating pending "
       " Clips, nb pendings: %i", id, g_list_length (pendings));
+  if (pendings)
+    ges_timeline_begin_edit (self->timeline);
   for (tmp = pendings; tmp; tmp = tmp->next) {
     GList *tmpeffect;
     GESClip *clip;
@@ -649,6 +785,8 @@ new_asset_cb (GESAsset * source, GAsyncResult * res, PendingAsset * passet)
     }
     _free_pending_clip (priv, pend);
   }
+  if (pendings)
+    ges_timeline_end_edit (self->timeline);
 
   /* And now add to the project */
   ges_project_add_asset (self->project, asset);
@@ -667,8 +805,10 @@ done:
     g_list_free (pendings);
   }
 
+  _request_queued_assets (priv);
+
   if (g_hash_table_size (priv->assetid_pendingclips) == 0 &&
-      priv->pending_assets == NULL)
+      priv->pending_assets == NULL && !priv->parsing_failed)
     _loading_done (self);
 }
 
@@ -729,6 +869,8 @@ ges_base_xml_formatter_add_asset (GESBaseXmlFormatter * self,
     return;
 
   passet = g_slice_new0 (PendingAsset);
+  passet->extractable_type = extractable_type;
+  passet->id = g_strdup (id);
   passet->metadatas = g_strdup (metadatas);
   passet->formatter = gst_object_ref (self);
   if (parent_id)
@@ -736,11 +878,13 @@ ges_base_xml_formatter_add_asset (GESBaseXmlFormatter * self,
   if (properties)
     passet->properties = gst_structure_copy (properties);
 
-  ges_asset_request_async (extractable_type, id, NULL,
-      (GAsyncReadyCallback) new_asset_cb, passet);
+  /* All the assets are requested as soon as they are parsed, a bounded
+   * number of them at a time, so they are discovered in parallel */
+  g_queue_push_tail (priv->queued_assets, passet);
   ges_project_add_loading_asset (GES_FORMATTER (self)->project,
       extractable_type, id);
   priv->pending_assets = g_list_prepend (priv->pending_assets, passet);
+  _request_queued_assets (priv);
 }
 
 void
@@ -1130,3 +1274,99 @@ done:
   if (restriction)
     gst_caps_unref (restriction);
 }
+
+void
+ges_base_xml_formatter_abort_loading (GESBaseXmlFormatter * self)
+{
+  _GET_PRIV (self)->parsing_failed = TRUE;
+}
+
+static inline gboolean
+_can_serialize_spec (GParamSpec * spec)
+{
+  if (spec->flags & G_PARAM_WRITABLE && !(spec->flags & G_PARAM_CONSTRUCT_ONLY)
+      && !g_type_is_a (G_PARAM_SPEC_VALUE_TYPE (spec), G_TYPE_OBJECT)
+      && g_strcmp0 (spec->name, "name")
+      && G_PARAM_SPEC_VALUE_TYPE (spec) != G_TYPE_GTYPE)
+    return TRUE;
+
+  return FALSE;
+}
+
+static inline void
+_init_value_from_spec_for_serialization (GValue * value, GParamSpec * spec)
+{
+
+  if (g_type_is_a (spec->value_type, G_TYPE_ENUM) ||
+      g_type_is_a (spec->value_type, G_TYPE_FLAGS))
+    g_value_init (value, G_TYPE_INT);
+  else
+    g_value_init (value, spec->value_type);
+}
+
+gchar *
+ges_base_xml_formatter_serialize_properties (GObject * object,
+    const gchar * fieldname, ...)
+{
+  gchar *ret;
+  guint n_props, j;
+  GParamSpec *spec, **pspecs;
+  GObjectClass *class = G_OBJECT_GET_CLASS (object);
+  GstStructure *structure = gst_structure_new_empty ("properties");
+
+  pspecs = g_object_class_list_properties (class, &n_props);
+  for (j = 0; j < n_props; j++) {
+    GValue val = { 0 };
+
+    spec = pspecs[j];
+    if (_can_serialize_spec (spec)) {
+      _init_value_from_spec_for_serialization (&val, spec);
+      g_object_get_property (object, spec->name, &val);
+      gst_structure_set_value (structure, spec->name, &val);
+      g_value_unset (&val);
+    }
+  }
+  g_free (pspecs);
+
+  if (fieldname) {
+    va_list varargs;
+    va_start (varargs, fieldname);
+    gst_structure_remove_fields_valist (structure, fieldname, varargs);
+    va_end (varargs);
+  }
+
+  ret = gst_structure_to_string (structure);
+  gst_structure_free (structure);
+
+  return ret;
+}
+
+gchar *
+ges_base_xml_formatter_serialize_children_properties (GESTrackElement *
+    trackelement)
+{
+  gchar *ret;
+  guint n_props, j;
+  GParamSpec *spec, **pspecs;
+  GstStructure *structure = gst_structure_new_empty ("properties");
+
+  pspecs = ges_track_element_list_children_properties (trackelement, &n_props);
+  for (j = 0; j < n_props; j++) {
+    GValue val = { 0 };
+
+    spec = pspecs[j];
+    if (_can_serialize_spec (spec)) {
+      _init_value_from_spec_for_serialization (&val, spec);
+      ges_track_element_get_child_property_by_pspec (trackelement, spec, &val);
+      gst_structure_set_value (structure, spec->name, &val);
+      g_value_unset (&val);
+    }
+    g_param_spec_unref (spec);
+  }
+  g_free (pspecs);
+
+  ret = gst_structure_to_string (structure);
+  gst_structure_free (structure);
+
+  return ret;
+}
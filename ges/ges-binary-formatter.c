@@ -0,0 +1,1164 @@
+/* Gstreamer Editing Services
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ * Boston, MA 02111-1307, USA.
+ */
+
+/**
+ * SECTION: gesbinaryformatter
+ * @short_description: Compact binary project files
+ *
+ * A #GESFormatter storing the same information as the #GESXmlFormatter
+ * in a compact binary form, faster to save and load for big projects.
+ *
+ * A file starts with the "GESB" magic followed by the format version, then
+ * comes a list of records, each made of a tag and the length of its
+ * payload so that readers can skip the records they do not know about.
+ *
+ * Integers and timestamps are stored as LEB128 varints, doubles as
+ * little endian IEEE 754. Strings are interned, a STRING record introduces
+ * each of them the first time it is used and the following records only
+ * reference it by index, so each asset id, type name or serialized
+ * properties is stored (and parsed) only once.
+ */
+
+#include <string.h>
+
+#include "ges.h"
+#include "ges-internal.h"
+
+#define parent_class ges_binary_formatter_parent_class
+G_DEFINE_TYPE (GESBinaryFormatter, ges_binary_formatter,
+    GES_TYPE_BASE_XML_FORMATTER);
+
+#define MAGIC "GESB"
+#define MAGIC_LEN 4
+#define FORMAT_VERSION 1
+#define VERSION 0.1
+
+/* Same as the XML formatter */
+#define WRITE_BUFFER_SIZE (64 * 1024)
+
+typedef enum
+{
+  RECORD_END = 0,
+  RECORD_PROJECT,
+  RECORD_ENCODING_PROFILE,
+  RECORD_ASSET,
+  RECORD_TIMELINE,
+  RECORD_TRACK,
+  RECORD_LAYER,
+  RECORD_CLIP,
+  RECORD_EFFECT,
+  RECORD_BINDING,
+  RECORD_STRING
+} RecordType;
+
+/***********************************************
+ *                                             *
+ *            Loading implementation           *
+ *                                             *
+ ***********************************************/
+
+typedef struct
+{
+  const guint8 *data;
+  const guint8 *end;
+
+  /* Set as soon as something could not be decoded */
+  gboolean invalid;
+
+  /* Index -> interned string */
+  GPtrArray *strings;
+
+  /* Index -> GstStructure parsed from the interned string, lazily filled */
+  GPtrArray *structures;
+} BinaryReader;
+
+static guint64
+_read_uint (BinaryReader * r)
+{
+  guint shift = 0;
+  guint64 ret = 0;
+
+  while (r->data < r->end && shift < 64) {
+    guint8 byte = *r->data++;
+
+    ret |= ((guint64) (byte & 0x7f)) << shift;
+    if (!(byte & 0x80))
+      return ret;
+
+    shift += 7;
+  }
+
+  r->invalid = TRUE;
+
+  return 0;
+}
+
+static inline gint64
+_read_int (BinaryReader * r)
+{
+  guint64 v = _read_uint (r);
+
+  /* zigzag decoding */
+  return (gint64) (v >> 1) ^ -(gint64) (v & 1);
+}
+
+static inline gdouble
+_read_double (BinaryReader * r)
+{
+  union
+  {
+    guint64 i;
+    gdouble d;
+  } u;
+
+  if (r->end - r->data < 8) {
+    r->invalid = TRUE;
+
+    return 0.0;
+  }
+
+  memcpy (&u.i, r->data, 8);
+  r->data += 8;
+  u.i = GUINT64_FROM_LE (u.i);
+
+  return u.d;
+}
+
+static const gchar *
+_read_string (BinaryReader * r)
+{
+  guint64 index = _read_uint (r);
+
+  if (index == 0)
+    return NULL;
+
+  if (index > r->strings->len) {
+    r->invalid = TRUE;
+
+    return NULL;
+  }
+
+  return g_ptr_array_index (r->strings, index - 1);
+}
+
+/* The returned structure is owned by @r and shared by all the records using
+ * the same string, it has to be copied before being handed to anything that
+ * modifies it */
+static GstStructure *
+_read_structure (BinaryReader * r)
+{
+  GstStructure *structure;
+  guint64 index = _read_uint (r);
+
+  if (index == 0)
+    return NULL;
+
+  if (index > r->strings->len) {
+    r->invalid = TRUE;
+
+    return NULL;
+  }
+
+  if (r->structures->len < r->strings->len)
+    g_ptr_array_set_size (r->structures, r->strings->len);
+
+  structure = g_ptr_array_index (r->structures, index - 1);
+  if (structure == NULL) {
+    structure =
+        gst_structure_from_string (g_ptr_array_index (r->strings, index - 1),
+        NULL);
+    if (structure == NULL)
+      r->invalid = TRUE;
+
+    g_ptr_array_index (r->structures, index - 1) = structure;
+  }
+
+  return structure;
+}
+
+static void
+_read_string_record (BinaryReader * r)
+{
+  guint64 len = _read_uint (r);
+
+  if (r->invalid || len > (guint64) (r->end - r->data)) {
+    r->invalid = TRUE;
+
+    return;
+  }
+
+  g_ptr_array_add (r->strings, g_strndup ((const gchar *) r->data, len));
+  r->data += len;
+}
+
+static GType
+_read_type (BinaryReader * r, GType parent_type)
+{
+  GType type;
+  const gchar *type_name = _read_string (r);
+
+  if (type_name == NULL)
+    return G_TYPE_NONE;
+
+  type = g_type_from_name (type_name);
+  if (type == 0 || !g_type_is_a (type, parent_type)) {
+    GST_WARNING ("%s is not a %s", type_name, g_type_name (parent_type));
+    r->invalid = TRUE;
+
+    return G_TYPE_NONE;
+  }
+
+  return type;
+}
+
+static void
+_load_project (GESBaseXmlFormatter * self, BinaryReader * r, GError ** error)
+{
+  const gchar *metadatas = _read_string (r);
+  GESProject *project = GES_FORMATTER (self)->project;
+
+  if (!r->invalid && project && metadatas)
+    ges_meta_container_add_metas_from_string (GES_META_CONTAINER (project),
+        metadatas);
+}
+
+static void
+_load_encoding_profile (GESBaseXmlFormatter * self, BinaryReader * r,
+    GError ** error)
+{
+  guint id, presence, pass;
+  gboolean variableframerate;
+  const gchar *type, *parent, *name, *description, *format, *preset,
+      *preset_name, *restriction;
+
+  type = _read_string (r);
+  parent = _read_string (r);
+  name = _read_string (r);
+  description = _read_string (r);
+  format = _read_string (r);
+  preset = _read_string (r);
+  preset_name = _read_string (r);
+  id = _read_uint (r);
+  presence = _read_uint (r);
+  pass = _read_uint (r);
+  variableframerate = _read_uint (r);
+  restriction = _read_string (r);
+
+  if (r->invalid)
+    return;
+
+  ges_base_xml_formatter_add_encoding_profile (self, type, parent, name,
+      description, format ? gst_caps_from_string (format) : NULL, preset,
+      preset_name, id, presence,
+      restriction ? gst_caps_from_string (restriction) : NULL, pass,
+      variableframerate, NULL, error);
+}
+
+static void
+_load_asset (GESBaseXmlFormatter * self, BinaryReader * r, GError ** error)
+{
+  GType extractable_type;
+  GstStructure *properties;
+  const gchar *id, *parent_id, *metadatas;
+
+  id = _read_string (r);
+  parent_id = _read_string (r);
+  extractable_type = _read_type (r, GES_TYPE_EXTRACTABLE);
+  properties = _read_structure (r);
+  metadatas = _read_string (r);
+
+  if (r->invalid || id == NULL || extractable_type == G_TYPE_NONE) {
+    r->invalid = TRUE;
+
+    return;
+  }
+
+  ges_base_xml_formatter_add_asset (self, id, parent_id, extractable_type,
+      properties, metadatas, error);
+}
+
+static void
+_load_timeline (GESBaseXmlFormatter * self, BinaryReader * r, GError ** error)
+{
+  const gchar *properties, *metadatas;
+  GESTimeline *timeline = GES_FORMATTER (self)->timeline;
+
+  properties = _read_string (r);
+  metadatas = _read_string (r);
+
+  if (r->invalid || timeline == NULL)
+    return;
+
+  ges_base_xml_formatter_set_timeline_properties (self, timeline, properties,
+      metadatas);
+}
+
+static void
+_load_track (GESBaseXmlFormatter * self, BinaryReader * r, GError ** error)
+{
+  GstCaps *caps;
+  GESTrackType track_type;
+  const gchar *strcaps, *metadatas;
+  gchar track_id[G_ASCII_DTOSTR_BUF_SIZE];
+
+  track_type = _read_uint (r);
+  strcaps = _read_string (r);
+  g_snprintf (track_id, sizeof (track_id), "%" G_GUINT64_FORMAT,
+      _read_uint (r));
+  metadatas = _read_string (r);
+
+  if (r->invalid || strcaps == NULL ||
+      (caps = gst_caps_from_string (strcaps)) == NULL) {
+    r->invalid = TRUE;
+
+    return;
+  }
+
+  ges_base_xml_formatter_add_track (self, track_type, caps, track_id, NULL,
+      metadatas, error);
+}
+
+static void
+_load_layer (GESBaseXmlFormatter * self, BinaryReader * r, GError ** error)
+{
+  guint priority;
+  GstStructure *properties;
+  const gchar *metadatas;
+
+  priority = _read_uint (r);
+  properties = _read_structure (r);
+  metadatas = _read_string (r);
+
+  if (r->invalid)
+    return;
+
+  /* Adding the layer removes the fields it handles itself */
+  properties = properties ? gst_structure_copy (properties) : NULL;
+  ges_base_xml_formatter_add_layer (self, G_TYPE_NONE, priority, properties,
+      metadatas, error);
+  if (properties)
+    gst_structure_free (properties);
+}
+
+static void
+_load_clip (GESBaseXmlFormatter * self, BinaryReader * r, GError ** error)
+{
+  GType type;
+  guint layer_prio;
+  GESTrackType track_types;
+  GstStructure *properties;
+  const gchar *asset_id;
+  GstClockTime start, duration, inpoint;
+  gchar clip_id[G_ASCII_DTOSTR_BUF_SIZE];
+
+  g_snprintf (clip_id, sizeof (clip_id), "%" G_GUINT64_FORMAT, _read_uint (r));
+  asset_id = _read_string (r);
+  type = _read_type (r, GES_TYPE_CLIP);
+  layer_prio = _read_uint (r);
+  track_types = _read_uint (r);
+  start = _read_uint (r);
+  duration = _read_uint (r);
+  inpoint = _read_uint (r);
+  properties = _read_structure (r);
+
+  if (r->invalid || asset_id == NULL || type == G_TYPE_NONE) {
+    r->invalid = TRUE;
+
+    return;
+  }
+
+  properties = properties ? gst_structure_copy (properties) : NULL;
+  ges_base_xml_formatter_add_clip (self, clip_id, asset_id, type, start,
+      inpoint, duration, layer_prio, track_types, properties, NULL, error);
+  if (properties)
+    gst_structure_free (properties);
+}
+
+static void
+_load_effect (GESBaseXmlFormatter * self, BinaryReader * r, GError ** error)
+{
+  GType type;
+  const gchar *asset_id, *metadatas;
+  GstStructure *properties, *children_properties;
+  gchar clip_id[G_ASCII_DTOSTR_BUF_SIZE], track_id[G_ASCII_DTOSTR_BUF_SIZE];
+
+  asset_id = _read_string (r);
+  g_snprintf (clip_id, sizeof (clip_id), "%" G_GUINT64_FORMAT, _read_uint (r));
+  type = _read_type (r, GES_TYPE_BASE_EFFECT);
+  /* The track type, which is implied by the track */
+  _read_uint (r);
+  g_snprintf (track_id, sizeof (track_id), "%" G_GUINT64_FORMAT,
+      _read_uint (r));
+  properties = _read_structure (r);
+  metadatas = _read_string (r);
+  children_properties = _read_structure (r);
+
+  if (r->invalid || asset_id == NULL || type == G_TYPE_NONE) {
+    r->invalid = TRUE;
+
+    return;
+  }
+
+  ges_base_xml_formatter_add_track_element (self, type, asset_id, track_id,
+      clip_id, children_properties, properties, metadatas, error);
+}
+
+static void
+_load_binding (GESBaseXmlFormatter * self, BinaryReader * r, GError ** error)
+{
+  gint mode;
+  guint64 i, n_values;
+  GSList *tmp, *values = NULL;
+  GstClockTime timestamp = 0;
+  const gchar *type, *source_type, *property_name;
+  gchar track_id[G_ASCII_DTOSTR_BUF_SIZE];
+
+  type = _read_string (r);
+  source_type = _read_string (r);
+  property_name = _read_string (r);
+  mode = _read_uint (r);
+  g_snprintf (track_id, sizeof (track_id), "%" G_GINT64_FORMAT,
+      _read_int (r));
+  n_values = _read_uint (r);
+
+  /* Each value takes at least 9 bytes */
+  if (r->invalid || n_values > (guint64) (r->end - r->data) / 9) {
+    r->invalid = TRUE;
+
+    return;
+  }
+
+  /* The timestamps are stored as deltas, all together, followed by all
+   * the values */
+  for (i = 0; i < n_values; i++) {
+    GstTimedValue *value = g_slice_new (GstTimedValue);
+
+    timestamp += _read_uint (r);
+    value->timestamp = timestamp;
+    values = g_slist_prepend (values, value);
+  }
+  values = g_slist_reverse (values);
+
+  for (tmp = values; tmp; tmp = tmp->next)
+    ((GstTimedValue *) tmp->data)->value = _read_double (r);
+
+  if (!r->invalid)
+    ges_base_xml_formatter_add_control_binding (self, type, source_type,
+        property_name, mode, track_id, values);
+
+  for (tmp = values; tmp; tmp = tmp->next)
+    g_slice_free (GstTimedValue, tmp->data);
+  g_slist_free (values);
+}
+
+static gboolean
+_read_header (const guint8 * data, gsize size, GError ** error)
+{
+  guint64 version;
+  BinaryReader r = { 0, };
+
+  if (size < MAGIC_LEN || memcmp (data, MAGIC, MAGIC_LEN))
+    goto wrong_magic;
+
+  r.data = data + MAGIC_LEN;
+  r.end = data + size;
+  version = _read_uint (&r);
+  if (r.invalid || version > FORMAT_VERSION) {
+    g_set_error (error, G_IO_ERROR, G_IO_ERROR_NOT_SUPPORTED,
+        "Unsupported binary project version %" G_GUINT64_FORMAT, version);
+
+    return FALSE;
+  }
+
+  return TRUE;
+
+wrong_magic:
+  g_set_error (error, G_IO_ERROR, G_IO_ERROR_INVALID_DATA,
+      "Not a binary GES project");
+
+  return FALSE;
+}
+
+static gboolean
+_parse (GESBaseXmlFormatter * self, const guint8 * data, gsize size,
+    GCancellable * cancellable, GError ** error)
+{
+  gint percent, last_percent = -1;
+  gboolean ret = FALSE, done = FALSE;
+  BinaryReader r = { 0, };
+  GESProject *project = GES_FORMATTER (self)->project;
+
+  GError *err = NULL;
+
+  if (!_read_header (data, size, error))
+    return FALSE;
+
+  r.data = data + MAGIC_LEN;
+  r.end = data + size;
+  _read_uint (&r);
+  r.strings = g_ptr_array_new_with_free_func (g_free);
+  r.structures =
+      g_ptr_array_new_with_free_func ((GDestroyNotify) gst_structure_free);
+
+  while (!r.invalid && err == NULL) {
+    guint64 len;
+    const guint8 *record_end, *end = r.end;
+    RecordType type = _read_uint (&r);
+
+    if (type == RECORD_END) {
+      done = TRUE;
+      break;
+    }
+
+    len = _read_uint (&r);
+    if (r.invalid || len > (guint64) (r.end - r.data)) {
+      r.invalid = TRUE;
+      break;
+    }
+
+    /* Fields added to a record in later versions of the format are
+     * ignored */
+    record_end = r.data + len;
+    r.end = record_end;
+
+    switch (type) {
+      case RECORD_STRING:
+        _read_string_record (&r);
+        break;
+      case RECORD_PROJECT:
+        _load_project (self, &r, &err);
+        break;
+      case RECORD_ENCODING_PROFILE:
+        _load_encoding_profile (self, &r, &err);
+        break;
+      case RECORD_ASSET:
+        _load_asset (self, &r, &err);
+        break;
+      case RECORD_TIMELINE:
+        _load_timeline (self, &r, &err);
+        break;
+      case RECORD_TRACK:
+        _load_track (self, &r, &err);
+        break;
+      case RECORD_LAYER:
+        _load_layer (self, &r, &err);
+        break;
+      case RECORD_CLIP:
+        _load_clip (self, &r, &err);
+        break;
+      case RECORD_EFFECT:
+        _load_effect (self, &r, &err);
+        break;
+      case RECORD_BINDING:
+        _load_binding (self, &r, &err);
+        break;
+      default:
+        GST_LOG_OBJECT (self, "Record %i not handled", type);
+        break;
+    }
+
+    r.data = record_end;
+    r.end = end;
+
+    if (g_cancellable_set_error_if_cancelled (cancellable, &err))
+      break;
+
+    if (project) {
+      percent = (r.data - data) * 100 / size;
+      if (percent != last_percent) {
+        last_percent = percent;
+        ges_project_emit_loading_progress (project, (gdouble) percent / 100.0);
+      }
+    }
+  }
+
+  if (err)
+    g_propagate_error (error, err);
+  else if (r.invalid || !done)
+    g_set_error (error, G_IO_ERROR, G_IO_ERROR_INVALID_DATA,
+        "Corrupted binary project at offset %" G_GSIZE_FORMAT,
+        (gsize) (r.data - data));
+  else
+    ret = TRUE;
+
+  g_ptr_array_unref (r.structures);
+  g_ptr_array_unref (r.strings);
+
+  return ret;
+}
+
+/***********************************************
+ *                                             *
+ *            Saving implementation            *
+ *                                             *
+ ***********************************************/
+
+typedef struct
+{
+  GOutputStream *stream;
+  GCancellable *cancellable;
+
+  /* Flushed to the stream whenever it gets bigger than WRITE_BUFFER_SIZE */
+  GByteArray *buffer;
+
+  /* The record being written, its size needs to be known before it is
+   * appended to @buffer */
+  GByteArray *record;
+
+  /* Interned string -> index + 1 */
+  GHashTable *strings;
+  guint n_strings;
+
+  /* Strings interned while writing @record, written before it */
+  GPtrArray *new_strings;
+
+  /* The first error that happened while writing, once set nothing is
+   * written anymore */
+  GError *error;
+} BinaryWriter;
+
+static void
+_flush (BinaryWriter * w)
+{
+  if (w->error == NULL && w->buffer->len)
+    g_output_stream_write_all (w->stream, w->buffer->data, w->buffer->len,
+        NULL, w->cancellable, &w->error);
+
+  g_byte_array_set_size (w->buffer, 0);
+}
+
+static void
+_append_uint (GByteArray * array, guint64 v)
+{
+  guint8 bytes[10];
+  guint n = 0;
+
+  do {
+    bytes[n] = v & 0x7f;
+    v >>= 7;
+    if (v)
+      bytes[n] |= 0x80;
+    n++;
+  } while (v);
+
+  g_byte_array_append (array, bytes, n);
+}
+
+static inline void
+_write_uint (BinaryWriter * w, guint64 v)
+{
+  _append_uint (w->record, v);
+}
+
+static inline void
+_write_int (BinaryWriter * w, gint64 v)
+{
+  /* zigzag encoding, so that small negative values stay small */
+  _write_uint (w, ((guint64) v << 1) ^ (guint64) (v >> 63));
+}
+
+static inline void
+_write_double (BinaryWriter * w, gdouble d)
+{
+  union
+  {
+    guint64 i;
+    gdouble d;
+  } u;
+
+  u.d = d;
+  u.i = GUINT64_TO_LE (u.i);
+  g_byte_array_append (w->record, (const guint8 *) &u.i, 8);
+}
+
+static void
+_write_string (BinaryWriter * w, const gchar * str)
+{
+  guint index;
+  gchar *key;
+
+  if (str == NULL) {
+    _write_uint (w, 0);
+
+    return;
+  }
+
+  index = GPOINTER_TO_UINT (g_hash_table_lookup (w->strings, str));
+  if (index == 0) {
+    key = g_strdup (str);
+    index = ++w->n_strings;
+    g_hash_table_insert (w->strings, key, GUINT_TO_POINTER (index));
+    g_ptr_array_add (w->new_strings, key);
+  }
+
+  _write_uint (w, index);
+}
+
+static void
+_write_string_take (BinaryWriter * w, gchar * str)
+{
+  _write_string (w, str);
+  g_free (str);
+}
+
+static void
+_begin_record (BinaryWriter * w)
+{
+  g_byte_array_set_size (w->record, 0);
+}
+
+static void
+_end_record (BinaryWriter * w, RecordType type)
+{
+  guint i;
+
+  for (i = 0; i < w->new_strings->len; i++) {
+    const gchar *str = g_ptr_array_index (w->new_strings, i);
+    gsize len = strlen (str), len_size = 1;
+    guint64 tmp;
+
+    for (tmp = len >> 7; tmp; tmp >>= 7)
+      len_size++;
+
+    _append_uint (w->buffer, RECORD_STRING);
+    _append_uint (w->buffer, len_size + len);
+    _append_uint (w->buffer, len);
+    g_byte_array_append (w->buffer, (const guint8 *) str, len);
+  }
+  g_ptr_array_set_size (w->new_strings, 0);
+
+  _append_uint (w->buffer, type);
+  _append_uint (w->buffer, w->record->len);
+  g_byte_array_append (w->buffer, w->record->data, w->record->len);
+
+  if (G_UNLIKELY (w->buffer->len >= WRITE_BUFFER_SIZE))
+    _flush (w);
+}
+
+static void
+_save_encoding_profiles (BinaryWriter * w, GESProject * project)
+{
+  GstCaps *caps;
+  const GList *tmp;
+
+  for (tmp = ges_project_list_encoding_profiles (project); tmp; tmp = tmp->next) {
+    GstEncodingProfile *prof = GST_ENCODING_PROFILE (tmp->data);
+    const gchar *profname = gst_encoding_profile_get_name (prof);
+
+    _begin_record (w);
+    _write_string (w, gst_encoding_profile_get_type_nick (prof));
+    _write_string (w, NULL);
+    _write_string (w, profname);
+    _write_string (w, gst_encoding_profile_get_description (prof));
+    caps = gst_encoding_profile_get_format (prof);
+    _write_string_take (w, caps ? gst_caps_to_string (caps) : NULL);
+    if (caps)
+      gst_caps_unref (caps);
+    _write_string (w, gst_encoding_profile_get_preset (prof));
+    _write_string (w, gst_encoding_profile_get_preset_name (prof));
+    _write_uint (w, 0);
+    _write_uint (w, 0);
+    _write_uint (w, 0);
+    _write_uint (w, FALSE);
+    _write_string (w, NULL);
+    _end_record (w, RECORD_ENCODING_PROFILE);
+
+    if (GST_IS_ENCODING_CONTAINER_PROFILE (prof)) {
+      guint i = 0;
+      const GList *tmp2;
+      GstEncodingContainerProfile *container_prof;
+
+      container_prof = GST_ENCODING_CONTAINER_PROFILE (prof);
+      for (tmp2 = gst_encoding_container_profile_get_profiles (container_prof);
+          tmp2; tmp2 = tmp2->next, i++) {
+        GstEncodingProfile *sprof = (GstEncodingProfile *) tmp2->data;
+        guint pass = 0;
+        gboolean variableframerate = FALSE;
+
+        if (GST_IS_ENCODING_VIDEO_PROFILE (sprof)) {
+          GstEncodingVideoProfile *vp = (GstEncodingVideoProfile *) sprof;
+
+          pass = gst_encoding_video_profile_get_pass (vp);
+          variableframerate =
+              gst_encoding_video_profile_get_variableframerate (vp);
+        }
+
+        _begin_record (w);
+        _write_string (w, gst_encoding_profile_get_type_nick (sprof));
+        _write_string (w, profname);
+        _write_string (w, gst_encoding_profile_get_name (sprof));
+        _write_string (w, gst_encoding_profile_get_description (sprof));
+        caps = gst_encoding_profile_get_format (sprof);
+        _write_string_take (w, caps ? gst_caps_to_string (caps) : NULL);
+        if (caps)
+          gst_caps_unref (caps);
+        _write_string (w, gst_encoding_profile_get_preset (sprof));
+        _write_string (w, gst_encoding_profile_get_preset_name (sprof));
+        _write_uint (w, i);
+        _write_uint (w, gst_encoding_profile_get_presence (sprof));
+        _write_uint (w, pass);
+        _write_uint (w, variableframerate);
+        caps = gst_encoding_profile_get_restriction (sprof);
+        _write_string_take (w, caps ? gst_caps_to_string (caps) : NULL);
+        if (caps)
+          gst_caps_unref (caps);
+        _end_record (w, RECORD_ENCODING_PROFILE);
+      }
+    }
+  }
+}
+
+static void
+_save_assets (BinaryWriter * w, GList * assets)
+{
+  GList *tmp;
+
+  for (tmp = assets; tmp; tmp = tmp->next) {
+    GESAsset *asset = GES_ASSET (tmp->data);
+
+    _begin_record (w);
+    _write_string (w, ges_asset_get_id (asset));
+    _write_string (w, ges_asset_get_parent_id (asset));
+    _write_string (w, g_type_name (ges_asset_get_extractable_type (asset)));
+    _write_string_take (w,
+        ges_base_xml_formatter_serialize_properties (G_OBJECT (asset), NULL));
+    _write_string_take (w,
+        ges_meta_container_metas_to_string (GES_META_CONTAINER (asset)));
+    _end_record (w, RECORD_ASSET);
+  }
+  g_list_free_full (assets, gst_object_unref);
+}
+
+static void
+_save_keyframes (BinaryWriter * w, GESTrackElement * trackelement, gint index)
+{
+  GHashTableIter iter;
+  gpointer key, value;
+
+  g_hash_table_iter_init (&iter,
+      ges_track_element_get_bindings_hashtable (trackelement));
+  while (g_hash_table_iter_next (&iter, &key, &value)) {
+    GList *timed_values, *tmp;
+    GstControlSource *source;
+    GstInterpolationMode mode;
+    GstClockTime previous = 0;
+
+    if (!GST_IS_DIRECT_CONTROL_BINDING ((GstControlBinding *) value)) {
+      GST_DEBUG ("Binding type not in [direct]");
+      continue;
+    }
+
+    g_object_get (value, "control-source", &source, NULL);
+    if (!GST_IS_INTERPOLATION_CONTROL_SOURCE (source)) {
+      GST_DEBUG ("control source not in [interpolation]");
+      gst_object_unref (source);
+      continue;
+    }
+
+    g_object_get (source, "mode", &mode, NULL);
+    timed_values =
+        gst_timed_value_control_source_get_all (GST_TIMED_VALUE_CONTROL_SOURCE
+        (source));
+
+    _begin_record (w);
+    _write_string (w, "direct");
+    _write_string (w, "interpolation");
+    _write_string (w, (const gchar *) key);
+    _write_uint (w, mode);
+    _write_int (w, index);
+    _write_uint (w, g_list_length (timed_values));
+
+    /* The values are sorted, so the deltas between timestamps are small and
+     * positive */
+    for (tmp = timed_values; tmp; tmp = tmp->next) {
+      GstTimedValue *timed_value = tmp->data;
+
+      _write_uint (w, timed_value->timestamp - previous);
+      previous = timed_value->timestamp;
+    }
+
+    for (tmp = timed_values; tmp; tmp = tmp->next)
+      _write_double (w, ((GstTimedValue *) tmp->data)->value);
+
+    _end_record (w, RECORD_BINDING);
+
+    g_list_free (timed_values);
+    gst_object_unref (source);
+  }
+}
+
+static void
+_save_effect (BinaryWriter * w, guint clip_id, GESTrackElement * trackelement,
+    GList * tracks)
+{
+  gint track_id;
+  GESTrack *track = ges_track_element_get_track (trackelement);
+
+  if (track == NULL) {
+    GST_WARNING_OBJECT (trackelement, " Not in any track, can not save it");
+
+    return;
+  }
+
+  track_id = g_list_index (tracks, track);
+
+  _begin_record (w);
+  _write_string (w, ges_extractable_get_id (GES_EXTRACTABLE (trackelement)));
+  _write_uint (w, clip_id);
+  _write_string (w, g_type_name (G_OBJECT_TYPE (trackelement)));
+  _write_uint (w, track->type);
+  _write_uint (w, track_id);
+  _write_string_take (w,
+      ges_base_xml_formatter_serialize_properties (G_OBJECT (trackelement),
+          "start", "in-point", "duration", "locked", "max-duration", "name",
+          NULL));
+  _write_string_take (w,
+      ges_meta_container_metas_to_string (GES_META_CONTAINER (trackelement)));
+  _write_string_take (w,
+      ges_base_xml_formatter_serialize_children_properties (trackelement));
+  _end_record (w, RECORD_EFFECT);
+
+  _save_keyframes (w, trackelement, -1);
+}
+
+static void
+_save_layers (BinaryWriter * w, GESTimeline * timeline, GList * tracks)
+{
+  GList *tmplayer, *tmpclip, *clips;
+  guint nbclips = 0;
+
+  for (tmplayer = timeline->layers; tmplayer; tmplayer = tmplayer->next) {
+    GESLayer *layer = GES_LAYER (tmplayer->data);
+    guint priority = ges_layer_get_priority (layer);
+
+    _begin_record (w);
+    _write_uint (w, priority);
+    _write_string_take (w,
+        ges_base_xml_formatter_serialize_properties (G_OBJECT (layer),
+            "priority", NULL));
+    _write_string_take (w,
+        ges_meta_container_metas_to_string (GES_META_CONTAINER (layer)));
+    _end_record (w, RECORD_LAYER);
+
+    clips = ges_layer_get_clips (layer);
+    for (tmpclip = clips; tmpclip; tmpclip = tmpclip->next) {
+      GList *effects, *tmp;
+      GESClip *clip = GES_CLIP (tmpclip->data);
+
+      _begin_record (w);
+      _write_uint (w, nbclips);
+      _write_string (w, ges_extractable_get_id (GES_EXTRACTABLE (clip)));
+      _write_string (w, g_type_name (G_OBJECT_TYPE (clip)));
+      _write_uint (w, priority);
+      _write_uint (w, ges_clip_get_supported_formats (clip));
+      _write_uint (w, _START (clip));
+      _write_uint (w, _DURATION (clip));
+      _write_uint (w, _INPOINT (clip));
+      /* Same properties as the XML formatter */
+      _write_string_take (w,
+          ges_base_xml_formatter_serialize_properties (G_OBJECT (clip),
+              "supported-formats", "rate", "in-point", "start", "duration",
+              "max-duration", "priority", "vtype", "uri", NULL));
+      _end_record (w, RECORD_CLIP);
+
+      effects = ges_clip_get_top_effects (clip);
+      for (tmp = effects; tmp; tmp = tmp->next)
+        _save_effect (w, nbclips, GES_TRACK_ELEMENT (tmp->data), tracks);
+      g_list_free_full (effects, gst_object_unref);
+
+      for (tmp = GES_CONTAINER_CHILDREN (clip); tmp; tmp = tmp->next) {
+        if (!GES_IS_SOURCE (tmp->data))
+          continue;
+
+        _save_keyframes (w, tmp->data, g_list_index (tracks,
+                ges_track_element_get_track (tmp->data)));
+      }
+
+      nbclips++;
+    }
+    g_list_free_full (clips, gst_object_unref);
+  }
+}
+
+static void
+_save_timeline (BinaryWriter * w, GESTimeline * timeline)
+{
+  guint nb_tracks = 0;
+  GList *tmp, *tracks;
+
+  ges_meta_container_set_uint64 (GES_META_CONTAINER (timeline), "duration",
+      ges_timeline_get_duration (timeline));
+
+  _begin_record (w);
+  _write_string_take (w,
+      ges_base_xml_formatter_serialize_properties (G_OBJECT (timeline),
+          "update", "name", "async-handling", "message-forward", NULL));
+  _write_string_take (w,
+      ges_meta_container_metas_to_string (GES_META_CONTAINER (timeline)));
+  _end_record (w, RECORD_TIMELINE);
+
+  tracks = ges_timeline_get_tracks (timeline);
+  for (tmp = tracks; tmp; tmp = tmp->next) {
+    GESTrack *track = GES_TRACK (tmp->data);
+
+    _begin_record (w);
+    _write_uint (w, track->type);
+    _write_string_take (w, gst_caps_to_string (ges_track_get_caps (track)));
+    _write_uint (w, nb_tracks++);
+    _write_string_take (w,
+        ges_meta_container_metas_to_string (GES_META_CONTAINER (track)));
+    _end_record (w, RECORD_TRACK);
+  }
+
+  _save_layers (w, timeline, tracks);
+  g_list_free_full (tracks, gst_object_unref);
+}
+
+static gboolean
+_save_to_stream (GESFormatter * formatter, GESTimeline * timeline,
+    GOutputStream * stream, GError ** error)
+{
+  BinaryWriter w;
+  GESProject *project = formatter->project;
+
+  w.stream = stream;
+  w.cancellable = g_cancellable_get_current ();
+  w.buffer = g_byte_array_sized_new (WRITE_BUFFER_SIZE + 4096);
+  w.record = g_byte_array_new ();
+  w.strings = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, NULL);
+  w.n_strings = 0;
+  w.new_strings = g_ptr_array_new ();
+  w.error = NULL;
+
+  g_byte_array_append (w.buffer, (const guint8 *) MAGIC, MAGIC_LEN);
+  _append_uint (w.buffer, FORMAT_VERSION);
+
+  _begin_record (&w);
+  _write_string_take (&w,
+      ges_meta_container_metas_to_string (GES_META_CONTAINER (project)));
+  _end_record (&w, RECORD_PROJECT);
+
+  _save_encoding_profiles (&w, project);
+  _save_assets (&w, ges_project_list_assets (project, GES_TYPE_EXTRACTABLE));
+  _save_assets (&w, ges_project_list_proxies (project, GES_TYPE_EXTRACTABLE));
+  _save_timeline (&w, timeline);
+
+  _append_uint (w.buffer, RECORD_END);
+  _flush (&w);
+
+  g_ptr_array_unref (w.new_strings);
+  g_hash_table_unref (w.strings);
+  g_byte_array_unref (w.record);
+  g_byte_array_unref (w.buffer);
+
+  if (w.error) {
+    g_propagate_error (error, w.error);
+
+    return FALSE;
+  }
+
+  return TRUE;
+}
+
+/***********************************************
+ *                                             *
+ * GESFormatter virtual methods implementation *
+ *                                             *
+ ***********************************************/
+
+static gboolean
+_can_load_uri (GESFormatter * dummy_formatter, const gchar * uri,
+    GError ** error)
+{
+  GFile *file;
+  gsize read = 0;
+  gboolean ret = FALSE;
+  GFileInputStream *stream;
+  /* The magic and the version */
+  guint8 header[MAGIC_LEN + 10];
+
+  file = g_file_new_for_uri (uri);
+  stream = g_file_read (file, NULL, error);
+  if (stream) {
+    if (g_input_stream_read_all (G_INPUT_STREAM (stream), header,
+            sizeof (header), &read, NULL, error))
+      ret = _read_header (header, read, error);
+
+    g_object_unref (stream);
+  }
+  gst_object_unref (file);
+
+  return ret;
+}
+
+static gboolean
+_load_from_uri (GESFormatter * self, GESTimeline * timeline, const gchar * uri,
+    GError ** error)
+{
+  GFile *file;
+  gsize size;
+  gchar *data = NULL;
+  gboolean ret = FALSE;
+  GCancellable *cancellable = NULL;
+
+  ges_timeline_set_auto_transition (timeline, FALSE);
+
+  if (self->project)
+    cancellable = ges_project_get_load_cancellable (self->project);
+
+  /* Projects are small enough compared to their XML counterpart that they
+   * can be parsed in one go */
+  file = g_file_new_for_uri (uri);
+  if (g_file_load_contents (file, cancellable, &data, &size, NULL, error))
+    ret = _parse (GES_BASE_XML_FORMATTER (self), (const guint8 *) data, size,
+        cancellable, error);
+  gst_object_unref (file);
+  g_free (data);
+
+  if (!ret) {
+    GST_WARNING_OBJECT (self, "Could not load %s", uri);
+    ges_base_xml_formatter_abort_loading (GES_BASE_XML_FORMATTER (self));
+  }
+
+  return ret;
+}
+
+/***********************************************
+ *                                             *
+ *   GObject virtual methods implementation    *
+ *                                             *
+ ***********************************************/
+
+static void
+ges_binary_formatter_init (GESBinaryFormatter * self)
+{
+}
+
+static void
+ges_binary_formatter_class_init (GESBinaryFormatterClass * self_class)
+{
+  GESFormatterClass *formatter_klass = GES_FORMATTER_CLASS (self_class);
+
+  formatter_klass->can_load_uri = _can_load_uri;
+  formatter_klass->load_from_uri = _load_from_uri;
+  formatter_klass->save_to_stream = _save_to_stream;
+
+  ges_formatter_class_register_metas (formatter_klass,
+      "gesb", "GStreamer Editing Services binary project files",
+      "gesb", "application/x-ges-binary", VERSION, GST_RANK_SECONDARY);
+}
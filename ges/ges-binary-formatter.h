@@ -0,0 +1,49 @@
+/* Gstreamer Editing Services
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ * Boston, MA 02111-1307, USA.
+ */
+
+#include "ges-base-xml-formatter.h"
+
+#ifndef GES_BINARY_FORMATTER_H
+#define GES_BINARY_FORMATTER_H
+
+G_BEGIN_DECLS
+#define GES_TYPE_BINARY_FORMATTER (ges_binary_formatter_get_type ())
+#define GES_BINARY_FORMATTER(obj) (G_TYPE_CHECK_INSTANCE_CAST ((obj), GES_TYPE_BINARY_FORMATTER, GESBinaryFormatter))
+#define GES_BINARY_FORMATTER_CLASS(klass) (G_TYPE_CHECK_CLASS_CAST ((klass), GES_TYPE_BINARY_FORMATTER, GESBinaryFormatterClass))
+#define GES_IS_BINARY_FORMATTER(obj) (G_TYPE_CHECK_INSTANCE_TYPE ((obj), GES_TYPE_BINARY_FORMATTER))
+#define GES_IS_BINARY_FORMATTER_CLASS(klass) (G_TYPE_CHECK_CLASS_TYPE ((klass), GES_TYPE_BINARY_FORMATTER))
+#define GES_BINARY_FORMATTER_GET_CLASS(obj) (G_TYPE_INSTANCE_GET_CLASS ((obj), GES_TYPE_BINARY_FORMATTER, GESBinaryFormatterClass))
+
+typedef struct
+{
+  GESBaseXmlFormatter parent;
+
+  gpointer _ges_reserved[GES_PADDING];
+} GESBinaryFormatter;
+
+typedef struct
+{
+  GESBaseXmlFormatterClass parent;
+
+  gpointer _ges_reserved[GES_PADDING];
+} GESBinaryFormatterClass;
+
+GType ges_binary_formatter_get_type (void);
+
+G_END_DECLS
+#endif /* _GES_BINARY_FORMATTER_H */
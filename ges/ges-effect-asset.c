@@ -28,6 +28,7 @@
 #include "ges-effect-asset.h"
 #include "ges-track-element.h"
 #include "ges-internal.h"
+#include "ges-parse-cache.h"
 
 G_DEFINE_TYPE (GESEffectAsset, ges_effect_asset, GES_TYPE_TRACK_ELEMENT_ASSET);
 
@@ -41,8 +42,8 @@ static void
 _fill_track_type (GESAsset * asset)
 {
   GList *tmp;
-  GstElement *effect = gst_parse_bin_from_description (ges_asset_get_id (asset),
-      TRUE, NULL);
+  GstElement *effect = ges_parse_cache_get_bin (ges_asset_get_id (asset),
+      NULL);
 
   if (effect == NULL)
     return;
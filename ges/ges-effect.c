@@ -29,6 +29,7 @@
 #include "ges-base-effect.h"
 #include "ges-effect-asset.h"
 #include "ges-effect.h"
+#include "ges-parse-cache.h"
 
 static void ges_extractable_interface_init (GESExtractableInterface * iface);
 
@@ -55,7 +56,7 @@ enum
 static gchar *
 extractable_check_id (GType type, const gchar * id, GError ** error)
 {
-  GstElement *effect = gst_parse_bin_from_description (id, TRUE, error);
+  GstElement *effect = ges_parse_cache_get_bin (id, error);
 
   if (effect == NULL)
     return NULL;
@@ -123,14 +124,33 @@ ges_effect_set_property (GObject * object,
   }
 }
 
+static GESTimelineElement *
+ges_effect_clone (GESTimelineElement * element)
+{
+  GESEffect *copy, *self = GES_EFFECT (element);
+
+  if (G_OBJECT_TYPE (self) != GES_TYPE_EFFECT)
+    return GES_TIMELINE_ELEMENT_CLASS (ges_effect_parent_class)->clone
+        (element);
+
+  copy = g_object_new (GES_TYPE_EFFECT, NULL);
+  copy->priv->bin_description = g_strdup (self->priv->bin_description);
+  ges_track_element_clone_fields (GES_TRACK_ELEMENT (self),
+      GES_TRACK_ELEMENT (copy));
+
+  return GES_TIMELINE_ELEMENT (copy);
+}
+
 static void
 ges_effect_class_init (GESEffectClass * klass)
 {
   GObjectClass *object_class;
   GESTrackElementClass *obj_bg_class;
+  GESTimelineElementClass *element_class;
 
   object_class = G_OBJECT_CLASS (klass);
   obj_bg_class = GES_TRACK_ELEMENT_CLASS (klass);
+  element_class = GES_TIMELINE_ELEMENT_CLASS (klass);
 
   g_type_class_add_private (klass, sizeof (GESEffectPrivate));
 
@@ -140,6 +160,7 @@ ges_effect_class_init (GESEffectClass * klass)
   object_class->finalize = ges_effect_finalize;
 
   obj_bg_class->create_element = ges_effect_create_element;
+  element_class->clone = ges_effect_clone;
 
   /**
    * GESEffect:bin-description:
@@ -211,7 +232,7 @@ ges_effect_create_element (GESTrackElement * object)
     return NULL;
   }
 
-  effect = gst_parse_bin_from_description (bin_desc, TRUE, &error);
+  effect = ges_parse_cache_get_bin (bin_desc, &error);
 
   g_free (bin_desc);
 
@@ -49,6 +49,30 @@ static void ges_formatter_dispose (GObject * object);
 static gboolean default_can_load_uri (GESFormatter * dummy_instance,
     const gchar * uri, GError ** error);
 
+/* The formatter that has been found to load a URI, valid as long as the
+ * file is not modified */
+typedef struct
+{
+  gchar *uri;
+  GESAsset *formatter_asset;
+  guint64 mtime;
+  goffset size;
+
+  /* Link in sniffed_uris_order */
+  GList link;
+} SniffedUri;
+
+/* URI -> SniffedUri, only the GES_FORMATTER_MAX_SNIFFED_URIS most recently
+ * used ones are kept, the table is freed when it gets empty */
+static GHashTable *sniffed_uris = NULL;
+/* The SniffedUri, from the least recently used one */
+static GQueue sniffed_uris_order = G_QUEUE_INIT;
+static GMutex sniffed_uris_lock;
+
+static GESAsset *_find_formatter_asset_for_uri_full (const gchar * uri,
+    GError ** error);
+static void _forget_sniffed_uri (const gchar * uri);
+
 /* GESExtractable implementation */
 static gchar *
 extractable_check_id (GType type, const gchar * id)
@@ -203,6 +227,10 @@ no_extension:
  * Checks if there is a #GESFormatter available which can load a #GESTimeline
  * from the given URI.
  *
+ * The formatters handling the extension of @uri are checked first, and they
+ * only look at the beginning of the file. The result is cached until the
+ * file is modified, so loading @uri afterward does not check it again.
+ *
  * Returns: TRUE if there is a #GESFormatter that can support the given uri
  * or FALSE if not.
  */
@@ -210,44 +238,20 @@ no_extension:
 gboolean
 ges_formatter_can_load_uri (const gchar * uri, GError ** error)
 {
-  gboolean ret = FALSE;
-  gchar *extension;
-  GList *formatter_assets, *tmp;
-  GESFormatterClass *class = NULL;
+  GESAsset *asset;
 
   if (!(gst_uri_is_valid (uri))) {
     GST_ERROR ("Invalid uri!");
     return FALSE;
   }
 
-  extension = _get_extension (uri);
-
-  formatter_assets = ges_list_assets (GES_TYPE_FORMATTER);
-  for (tmp = formatter_assets; tmp; tmp = tmp->next) {
-    GESAsset *asset = GES_ASSET (tmp->data);
-    GESFormatter *dummy_instance;
+  asset = _find_formatter_asset_for_uri_full (uri, error);
+  if (asset == NULL)
+    return FALSE;
 
-    if (extension
-        && g_strcmp0 (extension,
-            ges_meta_container_get_string (GES_META_CONTAINER (asset),
-                GES_META_FORMATTER_EXTENSION)))
-      continue;
+  gst_object_unref (asset);
 
-    class = g_type_class_ref (ges_asset_get_extractable_type (asset));
-    dummy_instance =
-        g_object_new (ges_asset_get_extractable_type (asset), NULL);
-    if (class->can_load_uri (dummy_instance, uri, error)) {
-      g_type_class_unref (class);
-      gst_object_unref (dummy_instance);
-      ret = TRUE;
-      break;
-    }
-    g_type_class_unref (class);
-    gst_object_unref (dummy_instance);
-  }
-
-  g_list_free (formatter_assets);
-  return ret;
+  return TRUE;
 }
 
 /**
@@ -389,6 +393,9 @@ ges_formatter_save_to_uri (GESFormatter * formatter, GESTimeline *
   else
     GST_ERROR_OBJECT (formatter, "save_to_uri not implemented!");
 
+  /* The file might now be in another format */
+  _forget_sniffed_uri (uri);
+
   if (lerr) {
     GST_WARNING_OBJECT (formatter, "%" GST_PTR_FORMAT
         " not saved to %s error: %s", timeline, uri, lerr->message);
@@ -400,6 +407,82 @@ ges_formatter_save_to_uri (GESFormatter * formatter, GESTimeline *
   return ret;
 }
 
+/* Writes @uri through @write_func, to a temporary file next to it which
+ * replaces it once completely written, so that an already existing file is
+ * never left half written */
+gboolean
+ges_formatter_write_uri (const gchar * uri, gboolean overwrite,
+    GESFormatterWriteFunc write_func, gpointer user_data,
+    GCancellable * cancellable, GError ** error)
+{
+  gchar *basename, *tmpname;
+  GFile *file, *parent, *tmpfile = NULL;
+  GOutputStream *stream = NULL;
+  GError *lerror = NULL;
+
+  file = g_file_new_for_uri (uri);
+  if (!overwrite && g_file_query_exists (file, cancellable)) {
+    g_set_error (&lerror, G_IO_ERROR, G_IO_ERROR_EXISTS,
+        "%s already exists", uri);
+
+    goto failed;
+  }
+
+  parent = g_file_get_parent (file);
+  basename = g_file_get_basename (file);
+  tmpname = g_strdup_printf (".%s.%08x.part", basename, g_random_int ());
+  tmpfile = g_file_get_child (parent, tmpname);
+  g_free (basename);
+  g_free (tmpname);
+  g_object_unref (parent);
+
+  stream = G_OUTPUT_STREAM (g_file_replace (tmpfile, NULL, FALSE,
+          G_FILE_CREATE_NONE, cancellable, &lerror));
+  if (stream == NULL)
+    goto failed;
+
+  if (!write_func (stream, user_data, &lerror))
+    goto failed;
+
+  if (!g_output_stream_close (stream, cancellable, &lerror))
+    goto failed;
+
+  if (!g_file_move (tmpfile, file, overwrite ? G_FILE_COPY_OVERWRITE :
+          G_FILE_COPY_NONE, cancellable, NULL, NULL, &lerror))
+    goto failed;
+
+  /* The file might now be in another format */
+  _forget_sniffed_uri (uri);
+
+  g_object_unref (stream);
+  g_object_unref (tmpfile);
+  g_object_unref (file);
+
+  return TRUE;
+
+failed:
+  GST_WARNING ("Could not write %s because: %s", uri,
+      lerror ? lerror->message : "unknown error");
+
+  if (stream) {
+    if (!g_output_stream_is_closed (stream))
+      g_output_stream_close (stream, NULL, NULL);
+    g_object_unref (stream);
+  }
+
+  if (tmpfile) {
+    g_file_delete (tmpfile, NULL, NULL);
+    g_object_unref (tmpfile);
+  }
+
+  g_object_unref (file);
+
+  if (lerror)
+    g_propagate_error (error, lerror);
+
+  return FALSE;
+}
+
 /**
  * ges_formatter_get_default:
  *
@@ -493,14 +576,168 @@ _init_formatter_assets (void)
   g_free (formatters);
 }
 
-GESAsset *
-_find_formatter_asset_for_uri (const gchar * uri)
+static void
+_free_sniffed_uri (SniffedUri * sniffed)
 {
+  g_queue_unlink (&sniffed_uris_order, &sniffed->link);
+  gst_object_unref (sniffed->formatter_asset);
+  g_free (sniffed->uri);
+  g_slice_free (SniffedUri, sniffed);
+}
+
+/* Must be called with sniffed_uris_lock held */
+static void
+_remove_sniffed_uri (const gchar * uri)
+{
+  if (sniffed_uris == NULL || !g_hash_table_remove (sniffed_uris, uri))
+    return;
+
+  if (g_hash_table_size (sniffed_uris) == 0)
+    g_clear_pointer (&sniffed_uris, (GDestroyNotify) g_hash_table_unref);
+}
+
+/* Gets what identifies the current version of the file at @uri, returns
+ * %FALSE if it can not be known, in which case nothing is cached */
+static gboolean
+_get_file_stamp (const gchar * uri, guint64 * mtime, goffset * size)
+{
+  GFile *file;
+  GFileInfo *info;
+
+  file = g_file_new_for_uri (uri);
+  info = g_file_query_info (file, G_FILE_ATTRIBUTE_TIME_MODIFIED ","
+      G_FILE_ATTRIBUTE_TIME_MODIFIED_USEC "," G_FILE_ATTRIBUTE_STANDARD_SIZE,
+      G_FILE_QUERY_INFO_NONE, NULL, NULL);
+  gst_object_unref (file);
+
+  if (info == NULL)
+    return FALSE;
+
+  *mtime = g_file_info_get_attribute_uint64 (info,
+      G_FILE_ATTRIBUTE_TIME_MODIFIED) * G_USEC_PER_SEC +
+      g_file_info_get_attribute_uint32 (info,
+      G_FILE_ATTRIBUTE_TIME_MODIFIED_USEC);
+  *size = g_file_info_get_size (info);
+  g_object_unref (info);
+
+  return TRUE;
+}
+
+static GESAsset *
+_lookup_sniffed_uri (const gchar * uri, guint64 mtime, goffset size)
+{
+  SniffedUri *sniffed;
+  GESAsset *asset = NULL;
+
+  g_mutex_lock (&sniffed_uris_lock);
+  if (sniffed_uris && (sniffed = g_hash_table_lookup (sniffed_uris, uri))) {
+    if (sniffed->mtime == mtime && sniffed->size == size) {
+      asset = gst_object_ref (sniffed->formatter_asset);
+
+      /* Now the most recently used one */
+      g_queue_unlink (&sniffed_uris_order, &sniffed->link);
+      g_queue_push_tail_link (&sniffed_uris_order, &sniffed->link);
+    } else {
+      _remove_sniffed_uri (uri);
+    }
+  }
+  g_mutex_unlock (&sniffed_uris_lock);
+
+  return asset;
+}
+
+static void
+_add_sniffed_uri (const gchar * uri, GESAsset * asset, guint64 mtime,
+    goffset size)
+{
+  SniffedUri *sniffed = g_slice_new0 (SniffedUri);
+
+  sniffed->uri = g_strdup (uri);
+  sniffed->formatter_asset = gst_object_ref (asset);
+  sniffed->mtime = mtime;
+  sniffed->size = size;
+  sniffed->link.data = sniffed;
+
+  g_mutex_lock (&sniffed_uris_lock);
+  _remove_sniffed_uri (uri);
+  if (sniffed_uris == NULL)
+    sniffed_uris = g_hash_table_new_full (g_str_hash, g_str_equal, NULL,
+        (GDestroyNotify) _free_sniffed_uri);
+
+  while (g_hash_table_size (sniffed_uris) >= GES_FORMATTER_MAX_SNIFFED_URIS) {
+    SniffedUri *oldest = g_queue_peek_head (&sniffed_uris_order);
+
+    g_hash_table_remove (sniffed_uris, oldest->uri);
+  }
+
+  g_hash_table_insert (sniffed_uris, sniffed->uri, sniffed);
+  g_queue_push_tail_link (&sniffed_uris_order, &sniffed->link);
+  g_mutex_unlock (&sniffed_uris_lock);
+}
+
+static void
+_forget_sniffed_uri (const gchar * uri)
+{
+  g_mutex_lock (&sniffed_uris_lock);
+  _remove_sniffed_uri (uri);
+  g_mutex_unlock (&sniffed_uris_lock);
+}
+
+static gint
+_compare_formatter_assets (GESAsset * a, GESAsset * b, const gchar * extension)
+{
+  gboolean a_matches, b_matches;
+  GstRank a_rank = GST_RANK_NONE, b_rank = GST_RANK_NONE;
+
+  a_matches = extension && !g_strcmp0 (extension,
+      ges_meta_container_get_string (GES_META_CONTAINER (a),
+          GES_META_FORMATTER_EXTENSION));
+  b_matches = extension && !g_strcmp0 (extension,
+      ges_meta_container_get_string (GES_META_CONTAINER (b),
+          GES_META_FORMATTER_EXTENSION));
+  if (a_matches != b_matches)
+    return a_matches ? -1 : 1;
+
+  ges_meta_container_get_uint (GES_META_CONTAINER (a),
+      GES_META_FORMATTER_RANK, &a_rank);
+  ges_meta_container_get_uint (GES_META_CONTAINER (b),
+      GES_META_FORMATTER_RANK, &b_rank);
+
+  return b_rank - a_rank;
+}
+
+static GESAsset *
+_find_formatter_asset_for_uri_full (const gchar * uri, GError ** error)
+{
+  goffset size;
+  guint64 mtime;
+  gchar *extension;
+  gboolean stamped;
   GESFormatterClass *class = NULL;
   GList *formatter_assets, *tmp;
   GESAsset *asset = NULL;
 
-  formatter_assets = ges_list_assets (GES_TYPE_FORMATTER);
+  GError *lerror = NULL;
+
+  stamped = _get_file_stamp (uri, &mtime, &size);
+  if (!stamped) {
+    /* The file is gone or not reachable anymore */
+    _forget_sniffed_uri (uri);
+  } else if ((asset = _lookup_sniffed_uri (uri, mtime, size))) {
+    GST_DEBUG ("Using cached formatter %s for %s", ges_asset_get_id (asset),
+        uri);
+
+    return asset;
+  }
+
+  /* Try the formatters handling the extension of @uri first, so that we
+   * usually do not need to check with every formatters */
+  extension = _get_extension (uri);
+  formatter_assets = g_list_sort_with_data (ges_list_assets
+      (GES_TYPE_FORMATTER), (GCompareDataFunc) _compare_formatter_assets,
+      extension);
+  g_free (extension);
+
   for (tmp = formatter_assets; tmp; tmp = tmp->next) {
     GESFormatter *dummy_instance;
 
@@ -508,7 +745,9 @@ _find_formatter_asset_for_uri (const gchar * uri)
     class = g_type_class_ref (ges_asset_get_extractable_type (asset));
     dummy_instance =
         g_object_new (ges_asset_get_extractable_type (asset), NULL);
-    if (class->can_load_uri (dummy_instance, uri, NULL)) {
+
+    g_clear_error (&lerror);
+    if (class->can_load_uri (dummy_instance, uri, &lerror)) {
       g_type_class_unref (class);
       asset = gst_object_ref (asset);
       gst_object_unref (dummy_instance);
@@ -522,5 +761,23 @@ _find_formatter_asset_for_uri (const gchar * uri)
 
   g_list_free (formatter_assets);
 
+  if (asset == NULL) {
+    if (lerror)
+      g_propagate_error (error, lerror);
+
+    return NULL;
+  }
+
+  g_clear_error (&lerror);
+
+  if (stamped)
+    _add_sniffed_uri (uri, asset, mtime, size);
+
   return asset;
 }
+
+GESAsset *
+_find_formatter_asset_for_uri (const gchar * uri)
+{
+  return _find_formatter_asset_for_uri_full (uri, NULL);
+}
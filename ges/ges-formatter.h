@@ -103,12 +103,31 @@ typedef gboolean (*GESFormatterSaveToURIMethod) (GESFormatter *formatter,
                GESTimeline *timeline, const gchar * uri, gboolean overwrite,
                GError **error);
 
+/**
+ * GESFormatterSaveToStreamMethod:
+ * @formatter: a #GESFormatter
+ * @timeline: a #GESTimeline
+ * @stream: the #GOutputStream to write to
+ * @error: (out) (allow-none): An error to be set in case something wrong happens or %NULL
+ *
+ * Virtual method for serializing a timeline to a #GOutputStream.
+ *
+ * Implementing it is optional, it lets ges_timeline_save_to_uri_async()
+ * serialize the timeline before writing it from another thread.
+ *
+ * Returns: TRUE if the @timeline was properly written to @stream,
+ * else FALSE.
+ */
+typedef gboolean (*GESFormatterSaveToStreamMethod) (GESFormatter *formatter,
+               GESTimeline *timeline, GOutputStream *stream, GError **error);
+
 /**
  * GESFormatterClass:
  * @parent_class: the parent class structure
  * @can_load_uri: Whether the URI can be loaded
  * @load_from_uri: class method to deserialize data from a URI
  * @save_to_uri: class method to serialize data to a URI
+ * @save_to_stream: class method to serialize data to a #GOutputStream
  *
  * GES Formatter class. Override the vmethods to implement the formatter functionnality.
  */
@@ -128,9 +147,12 @@ struct _GESFormatterClass {
   gdouble version;
   GstRank rank;
 
+  /* < public > */
+  GESFormatterSaveToStreamMethod save_to_stream;
 
+  /* < private > */
   /* Padding for API extension */
-  gpointer _ges_reserved[GES_PADDING];
+  gpointer _ges_reserved[GES_PADDING - 1];
 };
 
 GType ges_formatter_get_type (void);
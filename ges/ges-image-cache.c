@@ -0,0 +1,333 @@
+/* GStreamer Editing Services
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+/* Cache of decoded still images shared by all the #GESImageSource of the
+ * process, so that an image used by many clips is decoded only once and
+ * only one copy of the raw frame is kept in memory.
+ *
+ * Frames are stored as #GstSample keyed by URI, in the format the decoder
+ * outputs them: the sources convert and scale them in their own pipeline.
+ * The cache keeps a reference on them and hands out new references, so
+ * evicting an entry never invalidates the frames currently in use. Once
+ * the memory used by the cached frames exceeds the budget, the least
+ * recently used entries are evicted.
+ *
+ * Images are decoded by a pool of threads of the cache, never from the
+ * thread asking for them, which for the sources is the streaming thread of
+ * their appsrc. All the requests made while an image is being decoded get
+ * the result of that single decoding.
+ *
+ * NOTE: This is for internal use exclusively
+ */
+
+#include "ges-internal.h"
+#include "ges-image-cache.h"
+
+#define DECODE_TIMEOUT (30 * GST_SECOND)
+
+typedef struct
+{
+  gchar *uri;
+  GstSample *sample;
+  gsize size;
+
+  /* Our link in the LRU queue */
+  GList *link;
+} CacheEntry;
+
+typedef struct
+{
+  GESImageCacheCallback callback;
+  gpointer user_data;
+} Waiter;
+
+static GMutex cache_lock;
+static GHashTable *entries = NULL;
+static GHashTable *decoding = NULL;     /* uri -> GSList of Waiter */
+static GThreadPool *decoders = NULL;
+static GQueue lru = G_QUEUE_INIT;       /* Most recently used first */
+static gsize memory_used = 0;
+static gsize memory_budget = GES_IMAGE_CACHE_DEFAULT_BUDGET;
+
+static guint hits = 0;
+static guint misses = 0;
+static guint evictions = 0;
+
+static void _decode_func (gchar * uri, gpointer unused);
+
+static void
+_free_entry (CacheEntry * entry)
+{
+  gst_sample_unref (entry->sample);
+  g_free (entry->uri);
+  g_slice_free (CacheEntry, entry);
+}
+
+/* Must be called with the lock held */
+static inline void
+_ensure_tables (void)
+{
+  guint n_decoders;
+
+  if (G_UNLIKELY (entries == NULL)) {
+#if GLIB_CHECK_VERSION(2, 36, 0)
+    n_decoders = MAX (g_get_num_processors (), 1);
+#else
+    n_decoders = 2;
+#endif
+    entries = g_hash_table_new_full (g_str_hash, g_str_equal, NULL,
+        (GDestroyNotify) _free_entry);
+    decoding = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, NULL);
+    decoders = g_thread_pool_new ((GFunc) _decode_func, NULL, n_decoders,
+        FALSE, NULL);
+  }
+}
+
+static void
+_remove_entry (CacheEntry * entry)
+{
+  g_queue_delete_link (&lru, entry->link);
+  memory_used -= entry->size;
+  g_hash_table_remove (entries, entry->uri);
+}
+
+/* Must be called with the lock held */
+static void
+_evict (void)
+{
+  CacheEntry *entry;
+
+  /* Never evict the entry that has just been used */
+  while (memory_used > memory_budget && g_queue_get_length (&lru) > 1) {
+    entry = g_queue_peek_tail (&lru);
+
+    GST_DEBUG ("Evicting %s (%" G_GSIZE_FORMAT " bytes)", entry->uri,
+        entry->size);
+    _remove_entry (entry);
+    evictions++;
+  }
+}
+
+static GstSample *
+_decode (const gchar * uri, GError ** error)
+{
+  GstBus *bus;
+  GstMessage *msg;
+  GstBuffer *buffer;
+  GstStateChangeReturn ret;
+  GstSample *sample = NULL, *result = NULL;
+  GstElement *pipeline, *source, *sink;
+
+  pipeline = gst_parse_launch ("uridecodebin name=source ! videoconvert "
+      "! appsink name=sink sync=false", error);
+  if (pipeline == NULL)
+    return NULL;
+
+  source = gst_bin_get_by_name (GST_BIN (pipeline), "source");
+  sink = gst_bin_get_by_name (GST_BIN (pipeline), "sink");
+  g_object_set (source, "uri", uri, NULL);
+
+  gst_element_set_state (pipeline, GST_STATE_PAUSED);
+  ret = gst_element_get_state (pipeline, NULL, NULL, DECODE_TIMEOUT);
+
+  bus = gst_element_get_bus (pipeline);
+  msg = gst_bus_pop_filtered (bus, GST_MESSAGE_ERROR);
+  if (msg) {
+    gst_message_parse_error (msg, error, NULL);
+    gst_message_unref (msg);
+
+    goto done;
+  } else if (ret == GST_STATE_CHANGE_FAILURE
+      || ret == GST_STATE_CHANGE_ASYNC) {
+    g_set_error (error, GST_CORE_ERROR, GST_CORE_ERROR_STATE_CHANGE,
+        "Could not preroll %s", uri);
+
+    goto done;
+  }
+
+  g_signal_emit_by_name (sink, "pull-preroll", &sample);
+  if (sample == NULL) {
+    g_set_error (error, GST_STREAM_ERROR, GST_STREAM_ERROR_DECODE,
+        "Could not decode an image out of %s", uri);
+
+    goto done;
+  }
+
+  /* We only keep the frame itself, the image sources timestamp it */
+  buffer = gst_buffer_copy (gst_sample_get_buffer (sample));
+  GST_BUFFER_PTS (buffer) = 0;
+  GST_BUFFER_DTS (buffer) = GST_CLOCK_TIME_NONE;
+  GST_BUFFER_DURATION (buffer) = GST_CLOCK_TIME_NONE;
+  GST_BUFFER_OFFSET (buffer) = GST_BUFFER_OFFSET_NONE;
+  result = gst_sample_new (buffer, gst_sample_get_caps (sample), NULL, NULL);
+  gst_buffer_unref (buffer);
+  gst_sample_unref (sample);
+
+done:
+  gst_element_set_state (pipeline, GST_STATE_NULL);
+  gst_object_unref (bus);
+  gst_object_unref (source);
+  gst_object_unref (sink);
+  gst_object_unref (pipeline);
+
+  return result;
+}
+
+/* Runs in the threads of @decoders */
+static void
+_decode_func (gchar * uri, gpointer unused)
+{
+  GSList *waiters, *tmp;
+  CacheEntry *entry = NULL;
+  GError *error = NULL;
+  GstSample *sample;
+
+  GST_DEBUG ("Decoding %s", uri);
+  sample = _decode (uri, &error);
+  if (sample == NULL && error == NULL)
+    g_set_error (&error, GST_STREAM_ERROR, GST_STREAM_ERROR_DECODE,
+        "Could not decode an image out of %s", uri);
+
+  g_mutex_lock (&cache_lock);
+  waiters = g_hash_table_lookup (decoding, uri);
+  g_hash_table_remove (decoding, uri);
+  if (sample) {
+    entry = g_slice_new0 (CacheEntry);
+    entry->uri = uri;
+    entry->sample = sample;
+    entry->size = gst_buffer_get_size (gst_sample_get_buffer (sample));
+    g_queue_push_head (&lru, entry);
+    entry->link = lru.head;
+    g_hash_table_insert (entries, uri, entry);
+    memory_used += entry->size;
+    _evict ();
+
+    /* The waiters hold their own references, the entry can be evicted */
+    sample = gst_sample_ref (sample);
+  } else {
+    g_free (uri);
+  }
+  g_mutex_unlock (&cache_lock);
+
+  waiters = g_slist_reverse (waiters);
+  for (tmp = waiters; tmp; tmp = tmp->next) {
+    Waiter *waiter = tmp->data;
+
+    waiter->callback (sample, error, waiter->user_data);
+    g_slice_free (Waiter, waiter);
+  }
+  g_slist_free (waiters);
+
+  if (sample)
+    gst_sample_unref (sample);
+  g_clear_error (&error);
+}
+
+/* Gets the decoded frame of @uri. If it is in the cache, @callback is
+ * called right away from the calling thread, otherwise it is called from
+ * a thread of the cache once the image has been decoded. On failure, the
+ * sample given to @callback is %NULL and the error is set. */
+void
+ges_image_cache_get_async (const gchar * uri, GESImageCacheCallback callback,
+    gpointer user_data)
+{
+  GSList *waiters;
+  CacheEntry *entry;
+  GstSample *sample;
+  Waiter *waiter;
+
+  g_return_if_fail (uri);
+  g_return_if_fail (callback);
+
+  g_mutex_lock (&cache_lock);
+  _ensure_tables ();
+  entry = g_hash_table_lookup (entries, uri);
+  if (entry) {
+    hits++;
+    g_queue_unlink (&lru, entry->link);
+    g_queue_push_head_link (&lru, entry->link);
+    sample = gst_sample_ref (entry->sample);
+    g_mutex_unlock (&cache_lock);
+
+    callback (sample, NULL, user_data);
+    gst_sample_unref (sample);
+
+    return;
+  }
+
+  waiter = g_slice_new (Waiter);
+  waiter->callback = callback;
+  waiter->user_data = user_data;
+
+  /* Share the decoding already going on */
+  if (g_hash_table_lookup_extended (decoding, uri, NULL,
+          (gpointer *) & waiters)) {
+    hits++;
+    g_hash_table_insert (decoding, g_strdup (uri),
+        g_slist_prepend (waiters, waiter));
+  } else {
+    misses++;
+    g_hash_table_insert (decoding, g_strdup (uri),
+        g_slist_prepend (NULL, waiter));
+    g_thread_pool_push (decoders, g_strdup (uri), NULL);
+  }
+  g_mutex_unlock (&cache_lock);
+}
+
+/* Sets the memory budget of the cache, evicting the least recently used
+ * frames if needed. */
+void
+ges_image_cache_set_budget (gsize budget)
+{
+  g_mutex_lock (&cache_lock);
+  memory_budget = budget;
+  if (entries)
+    _evict ();
+  g_mutex_unlock (&cache_lock);
+}
+
+/* Drops all the cached frames and resets the statistics. */
+void
+ges_image_cache_clear (void)
+{
+  g_mutex_lock (&cache_lock);
+  g_queue_clear (&lru);
+  if (entries)
+    g_hash_table_remove_all (entries);
+  memory_used = 0;
+  hits = misses = evictions = 0;
+  g_mutex_unlock (&cache_lock);
+}
+
+/* Gets the statistics of the cache, @memory being the number of bytes
+ * currently used by the cached frames. */
+void
+ges_image_cache_get_stats (guint * n_hits, guint * n_misses,
+    guint * n_evictions, gsize * memory)
+{
+  g_mutex_lock (&cache_lock);
+  if (n_hits)
+    *n_hits = hits;
+  if (n_misses)
+    *n_misses = misses;
+  if (n_evictions)
+    *n_evictions = evictions;
+  if (memory)
+    *memory = memory_used;
+  g_mutex_unlock (&cache_lock);
+}
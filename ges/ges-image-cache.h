@@ -0,0 +1,52 @@
+/* GStreamer Editing Services
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef _GES_IMAGE_CACHE_H_
+#define _GES_IMAGE_CACHE_H_
+
+#include <gst/gst.h>
+
+G_BEGIN_DECLS
+
+/* Default memory budget of the cache, in bytes */
+#define GES_IMAGE_CACHE_DEFAULT_BUDGET (128 * 1024 * 1024)
+
+/* Process wide cache of decoded still images, keyed by URI.
+ *
+ * NOTE: This is for internal use exclusively, the unit tests build their
+ * own copy of it */
+typedef void (*GESImageCacheCallback) (GstSample *sample,
+                                       const GError *error,
+                                       gpointer user_data);
+
+G_GNUC_INTERNAL void
+ges_image_cache_get_async  (const gchar *uri, GESImageCacheCallback callback,
+                            gpointer user_data);
+
+G_GNUC_INTERNAL void
+ges_image_cache_set_budget (gsize budget);
+
+G_GNUC_INTERNAL void
+ges_image_cache_clear      (void);
+
+G_GNUC_INTERNAL void
+ges_image_cache_get_stats  (guint *n_hits, guint *n_misses,
+                            guint *n_evictions, gsize *memory);
+
+G_END_DECLS
+#endif /* _GES_IMAGE_CACHE_H_ */
@@ -26,20 +26,40 @@
  * Outputs the video stream from a given file as a still frame. The frame
  * chosen will be determined by the in-point property on the track element. For
  * image files, do not set the in-point property.
+ *
+ * The decoded frames are shared between all the image sources of the process
+ * using the same file, so an image is decoded only once however many clips
+ * use it.
  */
 
 #include "ges-internal.h"
 #include "ges-track-element.h"
 #include "ges-image-source.h"
+#include "ges-image-cache.h"
 
 G_DEFINE_TYPE (GESImageSource, ges_image_source, GES_TYPE_VIDEO_SOURCE);
 
+/* Where the frame is since the last (re)start of the appsrc */
+enum
+{
+  FRAME_NONE,
+  FRAME_REQUESTED,
+  FRAME_PUSHED
+};
+
 struct _GESImageSourcePrivate
 {
-  /*  Dummy variable */
-  void *nothing;
+  /* One of the FRAME_ values, changed from the streaming thread of the
+   * appsrc and from the threads of the image cache */
+  gint frame_state;
 };
 
+typedef struct
+{
+  GESImageSource *self;
+  GstElement *appsrc;
+} FrameRequest;
+
 enum
 {
   PROP_0,
@@ -87,26 +107,71 @@ ges_image_source_dispose (GObject * object)
   G_OBJECT_CLASS (ges_image_source_parent_class)->dispose (object);
 }
 
+/* Called from the thread asking for the frame if it is in the cache,
+ * from a thread of the cache otherwise */
+static void
+frame_ready_cb (GstSample * sample, const GError * error,
+    FrameRequest * request)
+{
+  GstFlowReturn ret;
+  GESImageSource *self = request->self;
+
+  g_atomic_int_set (&self->priv->frame_state, FRAME_PUSHED);
+
+  if (sample) {
+    g_object_set (request->appsrc, "caps", gst_sample_get_caps (sample),
+        NULL);
+    g_signal_emit_by_name (request->appsrc, "push-buffer",
+        gst_sample_get_buffer (sample), &ret);
+  } else {
+    GST_ERROR_OBJECT (self, "Could not get image %s: %s", self->uri,
+        error->message);
+    gst_element_post_message (request->appsrc,
+        gst_message_new_error (GST_OBJECT (request->appsrc),
+            (GError *) error, self->uri));
+    g_signal_emit_by_name (request->appsrc, "end-of-stream", &ret);
+  }
+
+  gst_object_unref (request->appsrc);
+  gst_object_unref (self);
+  g_slice_free (FrameRequest, request);
+}
+
 static void
-pad_added_cb (GstElement * timeline, GstPad * pad, GstElement * scale)
+need_data_cb (GstElement * appsrc, guint length, GESImageSource * self)
 {
-  GstPad *sinkpad;
-  GstPadLinkReturn ret;
-
-  sinkpad = gst_element_get_static_pad (scale, "sink");
-  if (sinkpad) {
-    GST_DEBUG ("got sink pad, trying to link");
-
-    ret = gst_pad_link (pad, sinkpad);
-    if GST_PAD_LINK_SUCCESSFUL
-      (ret) {
-      GST_DEBUG ("linked ok, returning");
-      gst_object_unref (sinkpad);
-      return;
-      }
+  GstFlowReturn ret;
+  FrameRequest *request;
+
+  if (g_atomic_int_get (&self->priv->frame_state) == FRAME_PUSHED) {
+    g_signal_emit_by_name (appsrc, "end-of-stream", &ret);
+    return;
   }
 
-  GST_DEBUG ("pad failed to link properly");
+  /* The frame is requested the first time it is actually needed, and
+   * pushed from whatever thread it is ready in so that the streaming
+   * thread never waits for the decoding */
+  if (!g_atomic_int_compare_and_exchange (&self->priv->frame_state,
+          FRAME_NONE, FRAME_REQUESTED))
+    return;
+
+  request = g_slice_new (FrameRequest);
+  request->self = gst_object_ref (self);
+  request->appsrc = gst_object_ref (appsrc);
+  ges_image_cache_get_async (self->uri,
+      (GESImageCacheCallback) frame_ready_cb, request);
+}
+
+static gboolean
+seek_data_cb (GstElement * appsrc, guint64 offset, GESImageSource * self)
+{
+  /* imagefreeze handles the seeks itself, we only have to be able to push
+   * the frame again after a flush. A frame still being decoded is pushed
+   * once ready, after the flush */
+  g_atomic_int_compare_and_exchange (&self->priv->frame_state, FRAME_PUSHED,
+      FRAME_NONE);
+
+  return TRUE;
 }
 
 static GstElement *
@@ -116,15 +181,19 @@ ges_image_source_create_source (GESTrackElement * track_element)
   GstPad *src, *target;
 
   bin = GST_ELEMENT (gst_bin_new ("still-image-bin"));
-  source = gst_element_factory_make ("uridecodebin", NULL);
+  source = gst_element_factory_make ("appsrc", NULL);
   scale = gst_element_factory_make ("videoscale", NULL);
   freeze = gst_element_factory_make ("imagefreeze", NULL);
   iconv = gst_element_factory_make ("videoconvert", NULL);
 
   g_object_set (scale, "add-borders", TRUE, NULL);
+  g_object_set (source, "format", GST_FORMAT_TIME, NULL);
+  gst_util_set_object_arg (G_OBJECT (source), "stream-type", "seekable");
 
   gst_bin_add_many (GST_BIN (bin), source, scale, freeze, iconv, NULL);
 
+  gst_element_link_pads_full (source, "src", scale, "sink",
+      GST_PAD_LINK_CHECK_NOTHING);
   gst_element_link_pads_full (scale, "src", iconv, "sink",
       GST_PAD_LINK_CHECK_NOTHING);
   gst_element_link_pads_full (iconv, "src", freeze, "sink",
@@ -138,10 +207,14 @@ ges_image_source_create_source (GESTrackElement * track_element)
   gst_element_add_pad (bin, src);
   gst_object_unref (target);
 
-  g_object_set (source, "uri", ((GESImageSource *) track_element)->uri, NULL);
-
-  g_signal_connect (G_OBJECT (source), "pad-added",
-      G_CALLBACK (pad_added_cb), scale);
+  /* The appsrc is new when the element is created again after having been
+   * released by the track, the frame has to be pushed to it again */
+  g_atomic_int_set (&GES_IMAGE_SOURCE (track_element)->priv->frame_state,
+      FRAME_NONE);
+  g_signal_connect (source, "need-data", G_CALLBACK (need_data_cb),
+      track_element);
+  g_signal_connect (source, "seek-data", G_CALLBACK (seek_data_cb),
+      track_element);
 
   return bin;
 }
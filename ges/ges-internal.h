@@ -91,6 +91,9 @@ void
 timeline_remove_group          (GESTimeline *timeline,
                                 GESGroup *group);
 
+G_GNUC_INTERNAL gboolean
+timeline_is_editing            (GESTimeline *timeline);
+
 G_GNUC_INTERNAL void
 ges_asset_cache_init (void);
 
@@ -154,6 +157,21 @@ ges_formatter_get_project                        (GESFormatter *formatter);
 G_GNUC_INTERNAL  GESAsset *
 _find_formatter_asset_for_uri                    (const gchar *uri);
 
+/* Number of URIs whose formatter is remembered by
+ * _find_formatter_asset_for_uri() and ges_formatter_can_load_uri() */
+#define GES_FORMATTER_MAX_SNIFFED_URIS 32
+
+typedef gboolean (*GESFormatterWriteFunc)        (GOutputStream *stream,
+                                                  gpointer user_data,
+                                                  GError **error);
+G_GNUC_INTERNAL gboolean
+ges_formatter_write_uri                          (const gchar *uri,
+                                                  gboolean overwrite,
+                                                  GESFormatterWriteFunc write_func,
+                                                  gpointer user_data,
+                                                  GCancellable *cancellable,
+                                                  GError **error);
+
 
 
 /************************************************
@@ -172,6 +190,17 @@ G_GNUC_INTERNAL  gchar * ges_project_try_updating_id              (GESProject *s
 G_GNUC_INTERNAL  void ges_project_add_loading_asset               (GESProject *project,
                                                                    GType extractable_type,
                                                                    const gchar *id);
+G_GNUC_INTERNAL  GCancellable * ges_project_get_load_cancellable  (GESProject *project);
+G_GNUC_INTERNAL  void ges_project_set_uri                         (GESProject *project,
+                                                                   const gchar *uri);
+G_GNUC_INTERNAL  gboolean ges_project_save_to_stream              (GESProject *project,
+                                                                   GESTimeline *timeline,
+                                                                   const gchar *uri,
+                                                                   GESAsset *formatter_asset,
+                                                                   GOutputStream *stream,
+                                                                   GError **error);
+G_GNUC_INTERNAL  void ges_project_emit_loading_progress           (GESProject *project,
+                                                                   gdouble progress);
 
 /************************************************
  *                                              *
@@ -246,6 +275,18 @@ G_GNUC_INTERNAL void ges_base_xml_formatter_add_control_binding (GESBaseXmlForma
                                                                   const gchar *track_id,
                                                                   GSList * timed_values);
 
+/* Makes sure the project is never considered loaded, for subclasses that do
+ * not go through the GMarkupParser */
+G_GNUC_INTERNAL void ges_base_xml_formatter_abort_loading    (GESBaseXmlFormatter * self);
+
+/* Serialize the properties that can be restored of @object/@trackelement
+ * children as a GstStructure string, @fieldname... being the properties
+ * to leave out */
+G_GNUC_INTERNAL gchar * ges_base_xml_formatter_serialize_properties (GObject * object,
+                                                                 const gchar * fieldname,
+                                                                 ...);
+G_GNUC_INTERNAL gchar * ges_base_xml_formatter_serialize_children_properties (GESTrackElement * trackelement);
+
 G_GNUC_INTERNAL void set_property_foreach                       (GQuark field_id,
                                                                  const GValue * value,
                                                                  GObject * object);;
@@ -266,6 +307,17 @@ ges_base_xml_formatter_set_timeline_properties(GESBaseXmlFormatter * self,
 					       const gchar *properties,
 					       const gchar *metadatas);
 
+/****************************************************
+ *              GESTimelineElement                  *
+ ****************************************************/
+G_GNUC_INTERNAL void ges_timeline_element_clone_fields (GESTimelineElement * self,
+                                                        GESTimelineElement * copy);
+
+/****************************************************
+ *              GESSimpleLayer                      *
+ ****************************************************/
+G_GNUC_INTERNAL void _ges_simple_layer_flush (GESSimpleLayer *layer);
+
 /****************************************************
  *              GESContainer                        *
  ****************************************************/
@@ -288,9 +340,13 @@ GList*            ges_clip_create_track_elements  (GESClip *clip, GESTrackType t
  ****************************************************/
 #define         GNL_OBJECT_TRACK_ELEMENT_QUARK                  (g_quark_from_string ("gnl_object_track_element_quark"))
 G_GNUC_INTERNAL gboolean  ges_track_element_set_track           (GESTrackElement * object, GESTrack * track);
+G_GNUC_INTERNAL gboolean  ges_track_element_ensure_gnl_object   (GESTrackElement * object);
+G_GNUC_INTERNAL void      ges_track_element_release_gnl_object  (GESTrackElement * object);
 G_GNUC_INTERNAL guint32   _ges_track_element_get_layer_priority (GESTrackElement * element);
 G_GNUC_INTERNAL void ges_track_element_copy_properties          (GESTimelineElement * element,
                                                                  GESTimelineElement * elementcopy);
+G_GNUC_INTERNAL void ges_track_element_clone_fields             (GESTrackElement * self,
+                                                                 GESTrackElement * copy);
 
 G_GNUC_INTERNAL void ges_track_element_split_bindings (GESTrackElement *element,
 						       GESTrackElement *new_element,
@@ -0,0 +1,272 @@
+/* GStreamer Editing Services
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+/* Interval tree used to index the sources of a layer in a track so that
+ * looking for the sources overlapping a given time range is done in
+ * O(log n + k).
+ *
+ * It is implemented as a treap ordered by (start, data), each node
+ * knowing the maximum end of its subtree, which lets us prune the
+ * subtrees that can not contain any overlapping interval.
+ *
+ * NOTE: This is for internal use exclusively
+ */
+
+#include "ges-interval-tree.h"
+
+struct _GESIntervalTree
+{
+  GESIntervalNode *root;
+  guint size;
+};
+
+static inline gint
+node_compare (GESIntervalNode * a, GESIntervalNode * b)
+{
+  if (a->start < b->start)
+    return -1;
+  if (a->start > b->start)
+    return 1;
+  if (a->data < b->data)
+    return -1;
+  if (a->data > b->data)
+    return 1;
+
+  return 0;
+}
+
+static inline void
+node_update_max_end (GESIntervalNode * node)
+{
+  node->max_end = node->end;
+
+  if (node->left && node->left->max_end > node->max_end)
+    node->max_end = node->left->max_end;
+  if (node->right && node->right->max_end > node->max_end)
+    node->max_end = node->right->max_end;
+}
+
+/* Splits @root in @left containing the nodes ordered before @node, and
+ * @right containing the other ones */
+static void
+split (GESIntervalNode * root, GESIntervalNode * node,
+    GESIntervalNode ** left, GESIntervalNode ** right)
+{
+  if (root == NULL) {
+    *left = *right = NULL;
+  } else if (node_compare (root, node) < 0) {
+    split (root->right, node, &root->right, right);
+    node_update_max_end (root);
+    *left = root;
+  } else {
+    split (root->left, node, left, &root->left);
+    node_update_max_end (root);
+    *right = root;
+  }
+}
+
+/* All nodes of @left must be ordered before the ones of @right */
+static GESIntervalNode *
+merge (GESIntervalNode * left, GESIntervalNode * right)
+{
+  if (left == NULL)
+    return right;
+  if (right == NULL)
+    return left;
+
+  if (left->weight > right->weight) {
+    left->right = merge (left->right, right);
+    node_update_max_end (left);
+
+    return left;
+  }
+
+  right->left = merge (left, right->left);
+  node_update_max_end (right);
+
+  return right;
+}
+
+static GESIntervalNode *
+insert (GESIntervalNode * root, GESIntervalNode * node)
+{
+  if (root == NULL)
+    return node;
+
+  if (node->weight > root->weight) {
+    split (root, node, &node->left, &node->right);
+    node_update_max_end (node);
+
+    return node;
+  }
+
+  if (node_compare (node, root) < 0)
+    root->left = insert (root->left, node);
+  else
+    root->right = insert (root->right, node);
+  node_update_max_end (root);
+
+  return root;
+}
+
+static GESIntervalNode *
+erase (GESIntervalNode * root, GESIntervalNode * node)
+{
+  if (root == NULL)
+    return NULL;
+
+  if (root == node)
+    return merge (node->left, node->right);
+
+  if (node_compare (node, root) < 0)
+    root->left = erase (root->left, node);
+  else
+    root->right = erase (root->right, node);
+  node_update_max_end (root);
+
+  return root;
+}
+
+static void
+detach_nodes (GESIntervalNode * node)
+{
+  if (node == NULL)
+    return;
+
+  detach_nodes (node->left);
+  detach_nodes (node->right);
+
+  node->left = node->right = NULL;
+  node->tree = NULL;
+}
+
+static void
+foreach_node (GESIntervalNode * node, GFunc func, gpointer user_data)
+{
+  if (node == NULL)
+    return;
+
+  foreach_node (node->left, func, user_data);
+  func (node->data, user_data);
+  foreach_node (node->right, func, user_data);
+}
+
+static void
+foreach_overlapping (GESIntervalNode * node, GstClockTime start,
+    GstClockTime end, GFunc func, gpointer user_data)
+{
+  if (node == NULL || node->max_end <= start)
+    return;
+
+  foreach_overlapping (node->left, start, end, func, user_data);
+
+  /* Everything on the right starts after @node */
+  if (node->start >= end)
+    return;
+
+  if (node->end > start)
+    func (node->data, user_data);
+
+  foreach_overlapping (node->right, start, end, func, user_data);
+}
+
+GESIntervalTree *
+ges_interval_tree_new (void)
+{
+  return g_slice_new0 (GESIntervalTree);
+}
+
+/* Nodes still in @tree are detached, not freed */
+void
+ges_interval_tree_free (GESIntervalTree * tree)
+{
+  detach_nodes (tree->root);
+
+  g_slice_free (GESIntervalTree, tree);
+}
+
+guint
+ges_interval_tree_get_size (GESIntervalTree * tree)
+{
+  return tree->size;
+}
+
+void
+ges_interval_tree_insert (GESIntervalTree * tree, GESIntervalNode * node,
+    GstClockTime start, GstClockTime end, gpointer data)
+{
+  g_return_if_fail (node->tree == NULL);
+
+  node->start = start;
+  node->end = end;
+  node->max_end = end;
+  node->data = data;
+  node->weight = g_random_int ();
+  node->left = node->right = NULL;
+  node->tree = tree;
+
+  tree->root = insert (tree->root, node);
+  tree->size++;
+}
+
+void
+ges_interval_tree_remove (GESIntervalNode * node)
+{
+  GESIntervalTree *tree = node->tree;
+
+  if (tree == NULL)
+    return;
+
+  tree->root = erase (tree->root, node);
+  tree->size--;
+
+  node->left = node->right = NULL;
+  node->tree = NULL;
+}
+
+void
+ges_interval_tree_update (GESIntervalNode * node, GstClockTime start,
+    GstClockTime end)
+{
+  GESIntervalTree *tree = node->tree;
+
+  if (node->start == start && node->end == end)
+    return;
+
+  g_return_if_fail (tree != NULL);
+
+  ges_interval_tree_remove (node);
+  ges_interval_tree_insert (tree, node, start, end, node->data);
+}
+
+/* Calls @func on the data of all the nodes sorted by start */
+void
+ges_interval_tree_foreach (GESIntervalTree * tree, GFunc func,
+    gpointer user_data)
+{
+  foreach_node (tree->root, func, user_data);
+}
+
+/* Calls @func, sorted by start, on the data of all the nodes overlapping
+ * [@start, @end) */
+void
+ges_interval_tree_foreach_overlapping (GESIntervalTree * tree,
+    GstClockTime start, GstClockTime end, GFunc func, gpointer user_data)
+{
+  foreach_overlapping (tree->root, start, end, func, user_data);
+}
@@ -0,0 +1,75 @@
+/* GStreamer Editing Services
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef _GES_INTERVAL_TREE_H_
+#define _GES_INTERVAL_TREE_H_
+
+#include <gst/gst.h>
+
+G_BEGIN_DECLS
+
+typedef struct _GESIntervalTree GESIntervalTree;
+typedef struct _GESIntervalNode GESIntervalNode;
+
+/* An interval [start, end) stored in a #GESIntervalTree. Nodes are meant
+ * to be embedded in the structure of the object they represent, the tree
+ * never allocates nor frees them.
+ *
+ * NOTE: This is for internal use exclusively */
+struct _GESIntervalNode
+{
+  /* < read only > */
+  GstClockTime start;
+  GstClockTime end;
+  gpointer data;
+
+  /* The tree the node is in, or %NULL */
+  GESIntervalTree *tree;
+
+  /* < private > */
+  GstClockTime max_end;         /* Max end of the subtree */
+  guint32 weight;
+  GESIntervalNode *left;
+  GESIntervalNode *right;
+};
+
+G_GNUC_INTERNAL GESIntervalTree * ges_interval_tree_new       (void);
+G_GNUC_INTERNAL void ges_interval_tree_free                   (GESIntervalTree *tree);
+G_GNUC_INTERNAL guint ges_interval_tree_get_size              (GESIntervalTree *tree);
+
+G_GNUC_INTERNAL void ges_interval_tree_insert                 (GESIntervalTree *tree,
+                                                               GESIntervalNode *node,
+                                                               GstClockTime start,
+                                                               GstClockTime end,
+                                                               gpointer data);
+G_GNUC_INTERNAL void ges_interval_tree_remove                 (GESIntervalNode *node);
+G_GNUC_INTERNAL void ges_interval_tree_update                 (GESIntervalNode *node,
+                                                               GstClockTime start,
+                                                               GstClockTime end);
+
+G_GNUC_INTERNAL void ges_interval_tree_foreach                (GESIntervalTree *tree,
+                                                               GFunc func,
+                                                               gpointer user_data);
+G_GNUC_INTERNAL void ges_interval_tree_foreach_overlapping    (GESIntervalTree *tree,
+                                                               GstClockTime start,
+                                                               GstClockTime end,
+                                                               GFunc func,
+                                                               gpointer user_data);
+
+G_END_DECLS
+#endif /* _GES_INTERVAL_TREE_H_ */
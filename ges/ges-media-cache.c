@@ -0,0 +1,643 @@
+/* GStreamer Editing Services
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+/* On disk caches of the data UIs compute out of the media files, so that
+ * reopening a project does not need to decode them again.
+ *
+ * Each cache is a single file, which is memory mapped when opened: looking
+ * up data that was already computed in a previous session does not read
+ * nor copy anything but the pages that are actually used. The data is only
+ * copied to the heap the first time something new is stored, and written
+ * back atomically when saved. Lookups can happen at any time, including
+ * while the data is being generated from another thread, and only give
+ * back what is already there.
+ *
+ * The files are written in the byte order of the machine, files with
+ * another byte order or another layout are simply ignored.
+ *
+ * Peaks files are laid out as:
+ *   PeaksHeader
+ *   guint8 filled[n_buckets], padded to 8 bytes
+ *   GESAudioPeak peaks[n_buckets][n_channels]
+ *
+ * Thumbnail files are laid out as:
+ *   ThumbnailsHeader
+ *   ThumbnailIndex index[n_thumbnails], sorted by timestamp
+ *   for each thumbnail: its caps as a string, padded to 8 bytes, followed
+ *   by its data
+ *
+ * NOTE: This is for internal use exclusively
+ */
+
+#include <errno.h>
+#include <string.h>
+#include <glib/gstdio.h>
+#include "ges-internal.h"
+#include "ges-media-cache.h"
+
+#define MEDIA_CACHE_VERSION 1
+#define PEAKS_MAGIC "GESPEAKS"
+#define THUMBNAILS_MAGIC "GESTHUMB"
+
+typedef struct
+{
+  gchar magic[8];
+  guint32 version;
+  guint32 n_channels;
+  guint64 bucket_duration;
+  guint64 n_buckets;
+} PeaksHeader;
+
+typedef struct
+{
+  gchar magic[8];
+  guint32 version;
+  guint32 n_thumbnails;
+} ThumbnailsHeader;
+
+typedef struct
+{
+  guint64 timestamp;
+  guint64 offset;
+  guint32 caps_size;
+  guint32 size;
+} ThumbnailIndex;
+
+struct _GESPeaksCache
+{
+  GMutex lock;
+  gchar *filename;
+
+  GstClockTime bucket_duration;
+  guint n_channels;
+  guint64 n_buckets;
+  guint64 n_filled;
+
+  /* The whole file contents, either @mapped or owned */
+  GMappedFile *mapped;
+  guint8 *data;
+  gsize size;
+
+  gboolean dirty;
+};
+
+typedef struct
+{
+  GstClockTime timestamp;
+  GstSample *sample;
+} ThumbnailEntry;
+
+struct _GESThumbnailCache
+{
+  GMutex lock;
+  gchar *filename;
+
+  /* ThumbnailEntry sorted by timestamp */
+  GArray *entries;
+
+  gboolean dirty;
+};
+
+static gboolean
+_ensure_parent_dir (const gchar * filename, GError ** error)
+{
+  gchar *dirname = g_path_get_dirname (filename);
+  gboolean ret = g_mkdir_with_parents (dirname, 0755) == 0;
+
+  if (!ret)
+    g_set_error (error, G_FILE_ERROR, g_file_error_from_errno (errno),
+        "Could not create %s", dirname);
+  g_free (dirname);
+
+  return ret;
+}
+
+/****************************************************
+ *                     Peaks                        *
+ ****************************************************/
+static inline gsize
+_peaks_offset (guint64 n_buckets)
+{
+  return sizeof (PeaksHeader) + GST_ROUND_UP_8 (n_buckets);
+}
+
+static inline guint8 *
+_peaks_filled (GESPeaksCache * cache)
+{
+  return cache->data + sizeof (PeaksHeader);
+}
+
+static inline GESAudioPeak *
+_peaks_data (GESPeaksCache * cache)
+{
+  return (GESAudioPeak *) (cache->data + _peaks_offset (cache->n_buckets));
+}
+
+static gboolean
+_map_peaks (GESPeaksCache * cache)
+{
+  guint64 i;
+  const PeaksHeader *header;
+  GMappedFile *mapped = g_mapped_file_new (cache->filename, FALSE, NULL);
+
+  if (mapped == NULL)
+    return FALSE;
+
+  header = (const PeaksHeader *) g_mapped_file_get_contents (mapped);
+  if (g_mapped_file_get_length (mapped) < sizeof (PeaksHeader))
+    goto invalid;
+
+  if (g_mapped_file_get_length (mapped) != cache->size ||
+      memcmp (header->magic, PEAKS_MAGIC, sizeof (header->magic)) ||
+      header->version != MEDIA_CACHE_VERSION ||
+      header->n_channels != cache->n_channels ||
+      header->bucket_duration != cache->bucket_duration ||
+      header->n_buckets != cache->n_buckets)
+    goto invalid;
+
+  cache->mapped = mapped;
+  cache->data = (guint8 *) header;
+  for (i = 0; i < cache->n_buckets; i++)
+    cache->n_filled += _peaks_filled (cache)[i] != 0;
+
+  GST_DEBUG ("Mapped %s, %" G_GUINT64_FORMAT "/%" G_GUINT64_FORMAT
+      " buckets filled", cache->filename, cache->n_filled, cache->n_buckets);
+
+  return TRUE;
+
+invalid:
+  GST_INFO ("Ignoring invalid peaks cache %s", cache->filename);
+  g_mapped_file_unref (mapped);
+
+  return FALSE;
+}
+
+/* Must be called with the lock held */
+static void
+_make_peaks_writable (GESPeaksCache * cache)
+{
+  if (cache->mapped == NULL)
+    return;
+
+  cache->data = g_memdup (cache->data, cache->size);
+  g_mapped_file_unref (cache->mapped);
+  cache->mapped = NULL;
+}
+
+static GESPeaksCache *
+_new_peaks_cache (const gchar * filename, GstClockTime bucket_duration,
+    guint n_channels, guint64 n_buckets)
+{
+  GESPeaksCache *cache = g_slice_new0 (GESPeaksCache);
+
+  g_mutex_init (&cache->lock);
+  cache->filename = g_strdup (filename);
+  cache->bucket_duration = bucket_duration;
+  cache->n_channels = n_channels;
+  cache->n_buckets = n_buckets;
+  cache->size = _peaks_offset (n_buckets) +
+      n_buckets * n_channels * sizeof (GESAudioPeak);
+
+  return cache;
+}
+
+/* Opens the peaks cache stored in @filename, or a new empty one if it does
+ * not exist or does not match the given layout.
+ *
+ * Returns a new #GESPeaksCache */
+GESPeaksCache *
+ges_peaks_cache_new (const gchar * filename, GstClockTime bucket_duration,
+    guint n_channels, guint64 n_buckets)
+{
+  PeaksHeader *header;
+  GESPeaksCache *cache;
+
+  g_return_val_if_fail (n_channels > 0, NULL);
+  g_return_val_if_fail (GST_CLOCK_TIME_IS_VALID (bucket_duration) &&
+      bucket_duration > 0, NULL);
+
+  cache = _new_peaks_cache (filename, bucket_duration, n_channels, n_buckets);
+  if (filename && _map_peaks (cache))
+    return cache;
+
+  cache->data = g_malloc0 (cache->size);
+  header = (PeaksHeader *) cache->data;
+  memcpy (header->magic, PEAKS_MAGIC, sizeof (header->magic));
+  header->version = MEDIA_CACHE_VERSION;
+  header->n_channels = n_channels;
+  header->bucket_duration = bucket_duration;
+  header->n_buckets = n_buckets;
+
+  return cache;
+}
+
+/* Frees @cache, without saving it. */
+void
+ges_peaks_cache_free (GESPeaksCache * cache)
+{
+  if (cache->mapped)
+    g_mapped_file_unref (cache->mapped);
+  else
+    g_free (cache->data);
+  g_free (cache->filename);
+  g_mutex_clear (&cache->lock);
+  g_slice_free (GESPeaksCache, cache);
+}
+
+/* Stores the peaks of the given buckets, replacing the ones already there.
+ * The buckets past the end of the media file are ignored. */
+void
+ges_peaks_cache_store (GESPeaksCache * cache, guint64 first_bucket,
+    guint n_buckets, const GESAudioPeak * peaks)
+{
+  guint64 i;
+  guint8 *filled;
+
+  if (first_bucket >= cache->n_buckets)
+    return;
+  n_buckets = MIN (n_buckets, cache->n_buckets - first_bucket);
+
+  g_mutex_lock (&cache->lock);
+  _make_peaks_writable (cache);
+
+  memcpy (_peaks_data (cache) + first_bucket * cache->n_channels, peaks,
+      n_buckets * cache->n_channels * sizeof (GESAudioPeak));
+
+  filled = _peaks_filled (cache);
+  for (i = first_bucket; i < first_bucket + n_buckets; i++) {
+    if (!filled[i]) {
+      filled[i] = 1;
+      cache->n_filled++;
+    }
+  }
+  cache->dirty = TRUE;
+  g_mutex_unlock (&cache->lock);
+}
+
+/* Gets the peaks of the given buckets, stopping at the first one that has
+ * not been stored yet.
+ *
+ * Returns the number of buckets copied to @peaks */
+guint
+ges_peaks_cache_lookup (GESPeaksCache * cache, guint64 first_bucket,
+    guint n_buckets, GESAudioPeak * peaks)
+{
+  guint n;
+  const guint8 *filled;
+
+  if (first_bucket >= cache->n_buckets)
+    return 0;
+  n_buckets = MIN (n_buckets, cache->n_buckets - first_bucket);
+
+  g_mutex_lock (&cache->lock);
+  filled = _peaks_filled (cache) + first_bucket;
+  for (n = 0; n < n_buckets && filled[n]; n++);
+
+  memcpy (peaks, _peaks_data (cache) + first_bucket * cache->n_channels,
+      n * cache->n_channels * sizeof (GESAudioPeak));
+  g_mutex_unlock (&cache->lock);
+
+  return n;
+}
+
+/* Returns %TRUE if all the buckets of @cache have been stored */
+gboolean
+ges_peaks_cache_is_complete (GESPeaksCache * cache)
+{
+  gboolean ret;
+
+  g_mutex_lock (&cache->lock);
+  ret = cache->n_filled == cache->n_buckets;
+  g_mutex_unlock (&cache->lock);
+
+  return ret;
+}
+
+/* Returns %TRUE if the data of @cache is still the one of the file it
+ * has been opened from */
+gboolean
+ges_peaks_cache_is_mapped (GESPeaksCache * cache)
+{
+  gboolean ret;
+
+  g_mutex_lock (&cache->lock);
+  ret = cache->mapped != NULL;
+  g_mutex_unlock (&cache->lock);
+
+  return ret;
+}
+
+/* Writes @cache back to its file if anything was stored since it was
+ * opened or last saved.
+ *
+ * Returns %TRUE if @cache is saved */
+gboolean
+ges_peaks_cache_save (GESPeaksCache * cache, GError ** error)
+{
+  gboolean ret = TRUE;
+
+  g_mutex_lock (&cache->lock);
+  if (cache->filename && cache->dirty) {
+    ret = _ensure_parent_dir (cache->filename, error) &&
+        g_file_set_contents (cache->filename, (const gchar *) cache->data,
+        cache->size, error);
+    if (ret) {
+      GST_DEBUG ("Saved %s", cache->filename);
+      cache->dirty = FALSE;
+    }
+  }
+  g_mutex_unlock (&cache->lock);
+
+  return ret;
+}
+
+/****************************************************
+ *                   Thumbnails                     *
+ ****************************************************/
+static void
+_clear_thumbnail_entry (ThumbnailEntry * entry)
+{
+  gst_sample_unref (entry->sample);
+}
+
+/* Index of the first entry at or after @timestamp */
+static guint
+_find_thumbnail (GESThumbnailCache * cache, GstClockTime timestamp)
+{
+  guint low = 0, high = cache->entries->len;
+
+  while (low < high) {
+    guint middle = (low + high) / 2;
+
+    if (g_array_index (cache->entries, ThumbnailEntry, middle).timestamp <
+        timestamp)
+      low = middle + 1;
+    else
+      high = middle;
+  }
+
+  return low;
+}
+
+static GstSample *
+_make_mapped_thumbnail (GBytes * bytes, const ThumbnailIndex * index)
+{
+  GBytes *slice;
+  GstCaps *caps;
+  GstSample *sample;
+  GstBuffer *buffer;
+  const gchar *caps_str = (const gchar *) g_bytes_get_data (bytes, NULL) +
+      index->offset;
+
+  if (index->caps_size == 0 || caps_str[index->caps_size - 1] != '\0')
+    return NULL;
+
+  caps = gst_caps_from_string (caps_str);
+  if (caps == NULL)
+    return NULL;
+
+  /* The buffer directly wraps the mapped file */
+  slice = g_bytes_new_from_bytes (bytes, index->offset +
+      GST_ROUND_UP_8 (index->caps_size), index->size);
+  buffer = gst_buffer_new_wrapped_full (GST_MEMORY_FLAG_READONLY,
+      (gpointer) g_bytes_get_data (slice, NULL), index->size, 0, index->size,
+      slice, (GDestroyNotify) g_bytes_unref);
+  GST_BUFFER_PTS (buffer) = index->timestamp;
+
+  sample = gst_sample_new (buffer, caps, NULL, NULL);
+  gst_buffer_unref (buffer);
+  gst_caps_unref (caps);
+
+  return sample;
+}
+
+static void
+_map_thumbnails (GESThumbnailCache * cache)
+{
+  guint i;
+  gsize size;
+  GBytes *bytes;
+  const ThumbnailsHeader *header;
+  const ThumbnailIndex *indexes;
+  GMappedFile *mapped = g_mapped_file_new (cache->filename, FALSE, NULL);
+
+  if (mapped == NULL)
+    return;
+
+  bytes = g_mapped_file_get_bytes (mapped);
+  g_mapped_file_unref (mapped);
+
+  header = g_bytes_get_data (bytes, &size);
+  if (size < sizeof (ThumbnailsHeader) ||
+      memcmp (header->magic, THUMBNAILS_MAGIC, sizeof (header->magic)) ||
+      header->version != MEDIA_CACHE_VERSION ||
+      (size - sizeof (ThumbnailsHeader)) / sizeof (ThumbnailIndex) <
+      header->n_thumbnails)
+    goto invalid;
+
+  indexes = (const ThumbnailIndex *) (header + 1);
+  for (i = 0; i < header->n_thumbnails; i++) {
+    ThumbnailEntry entry;
+
+    if (indexes[i].offset > size || size - indexes[i].offset <
+        (guint64) GST_ROUND_UP_8 (indexes[i].caps_size) + indexes[i].size ||
+        (i > 0 && indexes[i].timestamp <= indexes[i - 1].timestamp))
+      goto invalid;
+
+    entry.timestamp = indexes[i].timestamp;
+    entry.sample = _make_mapped_thumbnail (bytes, &indexes[i]);
+    if (entry.sample == NULL)
+      goto invalid;
+
+    g_array_append_val (cache->entries, entry);
+  }
+
+  GST_DEBUG ("Mapped %s, %u thumbnails", cache->filename,
+      cache->entries->len);
+  g_bytes_unref (bytes);
+
+  return;
+
+invalid:
+  GST_INFO ("Ignoring invalid thumbnail cache %s", cache->filename);
+  g_array_set_size (cache->entries, 0);
+  g_bytes_unref (bytes);
+}
+
+/* Opens the thumbnail cache stored in @filename, or a new empty one if it
+ * does not exist or is not valid.
+ *
+ * Returns a new #GESThumbnailCache */
+GESThumbnailCache *
+ges_thumbnail_cache_new (const gchar * filename)
+{
+  GESThumbnailCache *cache = g_slice_new0 (GESThumbnailCache);
+
+  g_mutex_init (&cache->lock);
+  cache->filename = g_strdup (filename);
+  cache->entries = g_array_new (FALSE, FALSE, sizeof (ThumbnailEntry));
+  g_array_set_clear_func (cache->entries,
+      (GDestroyNotify) _clear_thumbnail_entry);
+
+  if (filename)
+    _map_thumbnails (cache);
+
+  return cache;
+}
+
+/* Frees @cache, without saving it. The thumbnails it gave stay valid. */
+void
+ges_thumbnail_cache_free (GESThumbnailCache * cache)
+{
+  g_array_free (cache->entries, TRUE);
+  g_free (cache->filename);
+  g_mutex_clear (&cache->lock);
+  g_slice_free (GESThumbnailCache, cache);
+}
+
+/* Stores @sample as the thumbnail at @timestamp, replacing the one that
+ * was there if any. */
+void
+ges_thumbnail_cache_store (GESThumbnailCache * cache, GstClockTime timestamp,
+    GstSample * sample)
+{
+  guint i;
+  ThumbnailEntry entry;
+  GstBuffer *buffer = gst_sample_get_buffer (sample);
+
+  g_return_if_fail (buffer != NULL);
+  g_return_if_fail (gst_sample_get_caps (sample) != NULL);
+
+  /* The thumbnails are given back with the timestamp they were stored at,
+   * without copying their data */
+  if (GST_BUFFER_PTS (buffer) == timestamp) {
+    entry.sample = gst_sample_ref (sample);
+  } else {
+    buffer = gst_buffer_copy (buffer);
+    GST_BUFFER_PTS (buffer) = timestamp;
+    entry.sample = gst_sample_new (buffer, gst_sample_get_caps (sample),
+        NULL, NULL);
+    gst_buffer_unref (buffer);
+  }
+  entry.timestamp = timestamp;
+
+  g_mutex_lock (&cache->lock);
+  i = _find_thumbnail (cache, timestamp);
+  if (i < cache->entries->len &&
+      g_array_index (cache->entries, ThumbnailEntry, i).timestamp ==
+      timestamp)
+    g_array_remove_index (cache->entries, i);
+  g_array_insert_val (cache->entries, i, entry);
+  cache->dirty = TRUE;
+  g_mutex_unlock (&cache->lock);
+}
+
+/* Gets the thumbnails stored between @start and @stop included.
+ *
+ * Returns the thumbnails, sorted by timestamp */
+GList *
+ges_thumbnail_cache_lookup (GESThumbnailCache * cache, GstClockTime start,
+    GstClockTime stop)
+{
+  guint i;
+  GList *ret = NULL;
+
+  g_mutex_lock (&cache->lock);
+  for (i = _find_thumbnail (cache, start); i < cache->entries->len; i++) {
+    ThumbnailEntry *entry = &g_array_index (cache->entries, ThumbnailEntry, i);
+
+    if (entry->timestamp > stop)
+      break;
+
+    ret = g_list_prepend (ret, gst_sample_ref (entry->sample));
+  }
+  g_mutex_unlock (&cache->lock);
+
+  return g_list_reverse (ret);
+}
+
+/* Writes @cache back to its file if anything was stored since it was
+ * opened or last saved.
+ *
+ * Returns %TRUE if @cache is saved */
+gboolean
+ges_thumbnail_cache_save (GESThumbnailCache * cache, GError ** error)
+{
+  guint i;
+  gsize offset;
+  GByteArray *data;
+  ThumbnailsHeader *header;
+  gboolean ret = TRUE;
+  static const guint8 padding[8] = { 0, };
+
+  g_mutex_lock (&cache->lock);
+  if (cache->filename == NULL || !cache->dirty)
+    goto done;
+
+  offset = sizeof (ThumbnailsHeader) +
+      cache->entries->len * sizeof (ThumbnailIndex);
+  data = g_byte_array_sized_new (offset);
+  g_byte_array_set_size (data, offset);
+
+  header = (ThumbnailsHeader *) data->data;
+  memcpy (header->magic, THUMBNAILS_MAGIC, sizeof (header->magic));
+  header->version = MEDIA_CACHE_VERSION;
+  header->n_thumbnails = cache->entries->len;
+
+  for (i = 0; i < cache->entries->len; i++) {
+    GstMapInfo info;
+    ThumbnailIndex *index;
+    ThumbnailEntry *entry = &g_array_index (cache->entries, ThumbnailEntry, i);
+    gchar *caps_str = gst_caps_to_string (gst_sample_get_caps (entry->sample));
+    guint32 caps_size = strlen (caps_str) + 1;
+
+    gst_buffer_map (gst_sample_get_buffer (entry->sample), &info,
+        GST_MAP_READ);
+    g_byte_array_append (data, (const guint8 *) caps_str, caps_size);
+    g_byte_array_append (data, padding, GST_ROUND_UP_8 (caps_size) -
+        caps_size);
+    g_byte_array_append (data, info.data, info.size);
+    g_byte_array_append (data, padding, GST_ROUND_UP_8 (info.size) -
+        info.size);
+
+    /* The array might have been reallocated */
+    index = (ThumbnailIndex *) (data->data + sizeof (ThumbnailsHeader)) + i;
+    index->timestamp = entry->timestamp;
+    index->offset = offset;
+    index->caps_size = caps_size;
+    index->size = info.size;
+
+    offset = data->len;
+    gst_buffer_unmap (gst_sample_get_buffer (entry->sample), &info);
+    g_free (caps_str);
+  }
+
+  ret = _ensure_parent_dir (cache->filename, error) &&
+      g_file_set_contents (cache->filename, (const gchar *) data->data,
+      data->len, error);
+  g_byte_array_unref (data);
+  if (ret) {
+    GST_DEBUG ("Saved %s", cache->filename);
+    cache->dirty = FALSE;
+  }
+
+done:
+  g_mutex_unlock (&cache->lock);
+
+  return ret;
+}
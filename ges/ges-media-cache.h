@@ -0,0 +1,80 @@
+/* GStreamer Editing Services
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef _GES_MEDIA_CACHE_H_
+#define _GES_MEDIA_CACHE_H_
+
+#include <gst/gst.h>
+#include <ges/ges.h>
+
+G_BEGIN_DECLS
+
+/* On disk caches of the audio peaks and of the thumbnails of a media file,
+ * backing ges_uri_clip_asset_store_peaks() and
+ * ges_uri_clip_asset_store_thumbnail(). A %NULL filename gives a cache
+ * that only lives in memory.
+ *
+ * NOTE: This is for internal use exclusively, the unit tests build their
+ * own copy of it */
+typedef struct _GESPeaksCache GESPeaksCache;
+typedef struct _GESThumbnailCache GESThumbnailCache;
+
+G_GNUC_INTERNAL GESPeaksCache *
+ges_peaks_cache_new          (const gchar *filename,
+                              GstClockTime bucket_duration,
+                              guint n_channels, guint64 n_buckets);
+
+G_GNUC_INTERNAL void
+ges_peaks_cache_free         (GESPeaksCache *cache);
+
+G_GNUC_INTERNAL void
+ges_peaks_cache_store        (GESPeaksCache *cache, guint64 first_bucket,
+                              guint n_buckets, const GESAudioPeak *peaks);
+
+G_GNUC_INTERNAL guint
+ges_peaks_cache_lookup       (GESPeaksCache *cache, guint64 first_bucket,
+                              guint n_buckets, GESAudioPeak *peaks);
+
+G_GNUC_INTERNAL gboolean
+ges_peaks_cache_is_complete  (GESPeaksCache *cache);
+
+G_GNUC_INTERNAL gboolean
+ges_peaks_cache_is_mapped    (GESPeaksCache *cache);
+
+G_GNUC_INTERNAL gboolean
+ges_peaks_cache_save         (GESPeaksCache *cache, GError **error);
+
+G_GNUC_INTERNAL GESThumbnailCache *
+ges_thumbnail_cache_new      (const gchar *filename);
+
+G_GNUC_INTERNAL void
+ges_thumbnail_cache_free     (GESThumbnailCache *cache);
+
+G_GNUC_INTERNAL void
+ges_thumbnail_cache_store    (GESThumbnailCache *cache,
+                              GstClockTime timestamp, GstSample *sample);
+
+G_GNUC_INTERNAL GList *
+ges_thumbnail_cache_lookup   (GESThumbnailCache *cache, GstClockTime start,
+                              GstClockTime stop);
+
+G_GNUC_INTERNAL gboolean
+ges_thumbnail_cache_save     (GESThumbnailCache *cache, GError **error);
+
+G_END_DECLS
+#endif /* _GES_MEDIA_CACHE_H_ */
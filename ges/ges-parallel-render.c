@@ -0,0 +1,1045 @@
+/* GStreamer Editing Services
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+/**
+ * SECTION:ges-parallel-render
+ * @short_description: Render a timeline in several pipelines at once
+ *
+ * A #GESPipeline in #TIMELINE_MODE_RENDER encodes the whole timeline in
+ * a single encoding pipeline, which does not make use of all the
+ * processors of the machine for long timelines.
+ * ges_timeline_render_parallel_async() instead cuts the timeline into
+ * several time ranges, renders each of them in its own #GESPipeline at the
+ * same time, and then joins the rendered segments into the final file
+ * without reencoding them.
+ *
+ * The segments are cut on frame boundaries and never in the middle of a
+ * transition. Each segment is encoded from scratch, so each of them starts
+ * with a keyframe and they can be put one after the other as is.
+ *
+ * Audio encoders add priming samples at the start of each stream they
+ * encode, so joining separately encoded audio segments would not be sample
+ * accurate. The audio of the whole timeline is thus rendered in one more
+ * pipeline, next to the video segments, and muxed with them when joining.
+ * Encoding audio costs little compared to video anyway.
+ */
+
+#include <glib/gstdio.h>
+
+#include "ges-internal.h"
+#include "ges-parallel-render.h"
+#include "ges.h"
+
+typedef struct _RenderData RenderData;
+
+/* The rendering of the [start, start + duration[ range of the timeline into
+ * @uri, through its own copy of the timeline */
+typedef struct
+{
+  RenderData *data;
+
+  GstClockTime start;
+  GstClockTime duration;
+  gchar *filename;
+  gchar *uri;
+  GstElement *pipeline;
+  gboolean rendered;
+} RenderSegment;
+
+struct _RenderData
+{
+  gint ref_count;
+
+  GSimpleAsyncResult *simple;
+  GCancellable *cancellable;
+  gulong cancelled_id;
+
+  gchar *uri;
+  GstEncodingProfile *profile;
+  gchar *tmpdir;
+  gint fps_n, fps_d;
+
+  RenderSegment *segments;
+  guint n_segments;
+  guint n_rendered;
+
+  /* The audio of the whole timeline, only rendered on its own if the video
+   * is rendered in segments */
+  RenderSegment audio;
+  gboolean split_audio;
+
+  /* Joining of the rendered segments, each of them is decoded up to the
+   * encoded streams by @source and fed to @encodebin, which only muxes them */
+  GstElement *join_pipeline;
+  GstElement *encodebin;
+  GstElement *source;
+  GstElement *audio_source;
+  GstCaps *encoded_caps;
+  guint current;
+  guint next_id;
+
+  /* Protected by @lock, set from the streaming threads of @source */
+  GMutex lock;
+  GHashTable *join_pads;        /* media type -> encodebin sink pad */
+  guint n_streams;
+  guint n_eos;
+  gboolean no_more_pads;
+
+  gboolean done;
+};
+
+static gboolean _join_next_segment (RenderData * data);
+static void segment_bus_message_cb (GstBus * bus, GstMessage * message,
+    RenderSegment * segment);
+static void join_bus_message_cb (GstBus * bus, GstMessage * message,
+    RenderData * data);
+
+/****************************************************
+ *              Cutting the timeline                *
+ ****************************************************/
+static void
+_get_framerate (const GstCaps * caps, gint * fps_n, gint * fps_d)
+{
+  guint i;
+
+  if (caps == NULL)
+    return;
+
+  for (i = 0; i < gst_caps_get_size (caps); i++) {
+    if (gst_structure_get_fraction (gst_caps_get_structure (caps, i),
+            "framerate", fps_n, fps_d))
+      return;
+  }
+}
+
+/* The framerate the timeline is rendered at, first looking at the
+ * restriction caps of the video tracks and then at the ones of the video
+ * profile */
+static void
+_find_framerate (RenderData * data, GESTimeline * timeline)
+{
+  GList *tmp, *tracks;
+  GstCaps *caps;
+
+  data->fps_n = 0;
+  data->fps_d = 1;
+
+  tracks = ges_timeline_get_tracks (timeline);
+  for (tmp = tracks; tmp && data->fps_n <= 0; tmp = tmp->next) {
+    if (GES_TRACK (tmp->data)->type != GES_TRACK_TYPE_VIDEO)
+      continue;
+
+    g_object_get (tmp->data, "restriction-caps", &caps, NULL);
+    _get_framerate (caps, &data->fps_n, &data->fps_d);
+    if (caps)
+      gst_caps_unref (caps);
+  }
+  g_list_free_full (tracks, gst_object_unref);
+
+  if (data->fps_n <= 0 && GST_IS_ENCODING_CONTAINER_PROFILE (data->profile)) {
+    const GList *profiles =
+        gst_encoding_container_profile_get_profiles
+        (GST_ENCODING_CONTAINER_PROFILE (data->profile));
+
+    for (; profiles && data->fps_n <= 0; profiles = profiles->next) {
+      if (!GST_IS_ENCODING_VIDEO_PROFILE (profiles->data))
+        continue;
+
+      caps = gst_encoding_profile_get_restriction (profiles->data);
+      _get_framerate (caps, &data->fps_n, &data->fps_d);
+      if (caps)
+        gst_caps_unref (caps);
+    }
+  }
+}
+
+/* The timestamp of the last frame starting at or before @position */
+static GstClockTime
+_align_on_frame (RenderData * data, GstClockTime position)
+{
+  guint64 frame;
+  GstClockTime aligned;
+
+  if (data->fps_n <= 0 || data->fps_d <= 0)
+    return position;
+
+  frame = gst_util_uint64_scale_ceil (position, data->fps_n,
+      data->fps_d * GST_SECOND);
+  aligned = gst_util_uint64_scale (frame, data->fps_d * GST_SECOND,
+      data->fps_n);
+  if (aligned > position && frame > 0)
+    aligned = gst_util_uint64_scale (frame - 1, data->fps_d * GST_SECOND,
+        data->fps_n);
+
+  return aligned;
+}
+
+/* Whether rendering the timeline in pieces gives the same result as
+ * rendering it at once. The control bindings are not copied into the
+ * segments, so elements with keyframes prevent cutting the timeline, as
+ * documented in ges_timeline_render_parallel_async() */
+static gboolean
+_can_be_cut (GESTimeline * timeline, GList * clips)
+{
+  GList *tmp, *child;
+
+  for (tmp = clips; tmp; tmp = tmp->next) {
+    for (child = GES_CONTAINER_CHILDREN (tmp->data); child;
+        child = child->next) {
+      if (g_hash_table_size (ges_track_element_get_bindings_hashtable
+              (child->data))) {
+        GST_INFO_OBJECT (timeline, "%" GST_PTR_FORMAT " has keyframes, "
+            "not cutting the timeline", child->data);
+
+        return FALSE;
+      }
+    }
+  }
+
+  return TRUE;
+}
+
+/* Moves @position out of the transitions, as the copies of a cut transition
+ * would each go through the whole transition */
+static GstClockTime
+_move_out_of_transitions (RenderData * data, GList * clips,
+    GstClockTime position)
+{
+  GList *tmp;
+  gboolean moved;
+
+  do {
+    moved = FALSE;
+
+    for (tmp = clips; tmp; tmp = tmp->next) {
+      GstClockTime start = _START (tmp->data);
+
+      if (!GES_IS_TRANSITION_CLIP (tmp->data) || start >= position ||
+          start + _DURATION (tmp->data) <= position)
+        continue;
+
+      position = _align_on_frame (data, start);
+      moved = TRUE;
+    }
+  } while (moved && position > 0);
+
+  return position;
+}
+
+static GESTrackType
+_get_track_types (GESTimeline * timeline)
+{
+  GList *tmp, *tracks;
+  GESTrackType types = 0;
+
+  tracks = ges_timeline_get_tracks (timeline);
+  for (tmp = tracks; tmp; tmp = tmp->next)
+    types |= GES_TRACK (tmp->data)->type;
+  g_list_free_full (tracks, gst_object_unref);
+
+  return types;
+}
+
+static GList *
+_get_all_clips (GESTimeline * timeline)
+{
+  GList *tmp, *layers, *clips = NULL;
+
+  layers = ges_timeline_get_layers (timeline);
+  for (tmp = layers; tmp; tmp = tmp->next)
+    clips = g_list_concat (clips, ges_layer_get_clips (tmp->data));
+  g_list_free_full (layers, gst_object_unref);
+
+  return clips;
+}
+
+/* Fills data->segments with at most @n_segments consecutive ranges covering
+ * the whole timeline */
+static void
+_cut_timeline (RenderData * data, GESTimeline * timeline, guint n_segments)
+{
+  guint i;
+  GList *clips;
+  GstClockTime position, previous = 0;
+  GstClockTime duration = ges_timeline_get_duration (timeline);
+
+  GESTrackType types = _get_track_types (timeline);
+
+  /* Audio alone is never cut, see the comment at the top */
+  clips = _get_all_clips (timeline);
+  if (duration == 0 || !(types & GES_TRACK_TYPE_VIDEO) ||
+      !_can_be_cut (timeline, clips))
+    n_segments = 1;
+
+  data->segments = g_new0 (RenderSegment, n_segments);
+  for (i = 1; i <= n_segments; i++) {
+    if (i == n_segments) {
+      position = duration;
+    } else {
+      position = gst_util_uint64_scale (duration, i, n_segments);
+      position = _move_out_of_transitions (data, clips,
+          _align_on_frame (data, position));
+
+      /* Segments too short to be worth it */
+      if (position <= previous)
+        continue;
+    }
+
+    data->segments[data->n_segments].data = data;
+    data->segments[data->n_segments].start = previous;
+    data->segments[data->n_segments].duration = position - previous;
+    data->n_segments++;
+    previous = position;
+  }
+
+  g_list_free_full (clips, gst_object_unref);
+
+  data->split_audio = data->n_segments > 1 && (types & GES_TRACK_TYPE_AUDIO);
+  if (data->split_audio) {
+    data->audio.data = data;
+    data->audio.start = 0;
+    data->audio.duration = duration;
+  }
+}
+
+/****************************************************
+ *        Copying the timeline for a segment        *
+ ****************************************************/
+static GESTrack *
+_copy_track (GESTrack * track)
+{
+  GESTrack *copy;
+  GstCaps *restriction_caps;
+
+  if (GES_IS_VIDEO_TRACK (track))
+    copy = GES_TRACK (ges_video_track_new ());
+  else if (GES_IS_AUDIO_TRACK (track))
+    copy = GES_TRACK (ges_audio_track_new ());
+  else
+    copy = ges_track_new (track->type,
+        gst_caps_copy (ges_track_get_caps (track)));
+
+  g_object_get (track, "restriction-caps", &restriction_caps, NULL);
+  if (restriction_caps) {
+    ges_track_set_restriction_caps (copy, restriction_caps);
+    gst_caps_unref (restriction_caps);
+  }
+  ges_track_set_mixing (copy, ges_track_get_mixing (track));
+
+  return copy;
+}
+
+/* The properties of the clip subclass, the ones of the base classes are
+ * set by ges_layer_add_asset() */
+static void
+_copy_clip_properties (GESClip * clip, GESClip * copy)
+{
+  guint n, n_specs;
+  GParamSpec **specs;
+  GValue value = { 0 };
+
+  specs = g_object_class_list_properties (G_OBJECT_GET_CLASS (clip), &n_specs);
+  for (n = 0; n < n_specs; n++) {
+    if ((specs[n]->flags & G_PARAM_READWRITE) != G_PARAM_READWRITE ||
+        (specs[n]->flags & G_PARAM_CONSTRUCT_ONLY) ||
+        !g_type_is_a (specs[n]->owner_type, GES_TYPE_CLIP) ||
+        specs[n]->owner_type == GES_TYPE_CLIP)
+      continue;
+
+    g_value_init (&value, specs[n]->value_type);
+    g_object_get_property (G_OBJECT (clip), specs[n]->name, &value);
+    g_object_set_property (G_OBJECT (copy), specs[n]->name, &value);
+    g_value_unset (&value);
+  }
+
+  g_free (specs);
+}
+
+static GESTrackElement *
+_find_matching_child (GESClip * clip, GESTrackElement * element)
+{
+  GList *tmp;
+
+  for (tmp = GES_CONTAINER_CHILDREN (clip); tmp; tmp = tmp->next) {
+    if (G_OBJECT_TYPE (tmp->data) == G_OBJECT_TYPE (element) &&
+        ges_track_element_get_track_type (tmp->data) ==
+        ges_track_element_get_track_type (element))
+      return tmp->data;
+  }
+
+  return NULL;
+}
+
+/* Adds to @layer the part of @clip inside [start, end[, shifted so that
+ * @start is at 0 */
+static void
+_copy_clip_range (GESClip * clip, GESLayer * layer, GstClockTime start,
+    GstClockTime end)
+{
+  GList *tmp;
+  GESClip *copy;
+  GstClockTime clip_start = _START (clip);
+  GstClockTime clip_end = clip_start + _DURATION (clip);
+  GstClockTime inpoint = _INPOINT (clip);
+
+  if (clip_end <= start || clip_start >= end)
+    return;
+
+  if (clip_start < start) {
+    inpoint += start - clip_start;
+    clip_start = start;
+  }
+  clip_end = MIN (clip_end, end);
+
+  copy = ges_layer_add_asset (layer,
+      ges_extractable_get_asset (GES_EXTRACTABLE (clip)), clip_start - start,
+      inpoint, clip_end - clip_start, ges_clip_get_supported_formats (clip));
+  if (copy == NULL) {
+    GST_WARNING_OBJECT (clip, "Could not be copied");
+
+    return;
+  }
+
+  _copy_clip_properties (clip, copy);
+
+  for (tmp = GES_CONTAINER_CHILDREN (clip); tmp; tmp = tmp->next) {
+    GESTrackElement *child = tmp->data, *child_copy;
+
+    if (GES_IS_BASE_EFFECT (child)) {
+      ges_container_add (GES_CONTAINER (copy),
+          ges_timeline_element_copy (GES_TIMELINE_ELEMENT (child), TRUE));
+    } else if ((child_copy = _find_matching_child (copy, child))) {
+      ges_track_element_copy_properties (GES_TIMELINE_ELEMENT (child),
+          GES_TIMELINE_ELEMENT (child_copy));
+      ges_track_element_set_active (child_copy, child->active);
+    }
+  }
+}
+
+/* Copies the [start, end[ range of the tracks of @types of @timeline */
+static GESTimeline *
+_copy_timeline_range (GESTimeline * timeline, GstClockTime start,
+    GstClockTime end, GESTrackType types)
+{
+  GList *tmp, *clip, *tracks, *layers, *clips;
+  GESAsset *asset;
+  GESLayer *layer;
+  GESClip *filler;
+  GESTimeline *copy = ges_timeline_new ();
+
+  tracks = ges_timeline_get_tracks (timeline);
+  for (tmp = tracks; tmp; tmp = tmp->next) {
+    if (GES_TRACK (tmp->data)->type & types)
+      ges_timeline_add_track (copy, _copy_track (tmp->data));
+  }
+  g_list_free_full (tracks, gst_object_unref);
+
+  /* The transitions are copied as any other clip */
+  layers = ges_timeline_get_layers (timeline);
+  for (tmp = layers; tmp; tmp = tmp->next) {
+    layer = ges_timeline_append_layer (copy);
+
+    clips = ges_layer_get_clips (tmp->data);
+    for (clip = clips; clip; clip = clip->next)
+      _copy_clip_range (clip->data, layer, start, end);
+    g_list_free_full (clips, gst_object_unref);
+  }
+  g_list_free_full (layers, gst_object_unref);
+
+  /* Make sure the copy lasts the whole range even if it ends with a gap,
+   * the filler renders the same black frames and silence as the gaps */
+  layer = ges_timeline_append_layer (copy);
+  asset = ges_asset_request (GES_TYPE_TEST_CLIP, NULL, NULL);
+  filler = ges_layer_add_asset (layer, asset, 0, 0, end - start,
+      GES_TRACK_TYPE_UNKNOWN);
+  g_object_set (filler, "vpattern", GES_VIDEO_TEST_PATTERN_BLACK, "mute",
+      TRUE, NULL);
+  gst_object_unref (asset);
+
+  ges_timeline_commit (copy);
+
+  return copy;
+}
+
+/****************************************************
+ *                 Running it all                   *
+ ****************************************************/
+static void
+_stop_pipeline (GstElement ** pipeline, gpointer bus_func, gpointer user_data)
+{
+  GstBus *bus;
+
+  if (*pipeline == NULL)
+    return;
+
+  bus = gst_pipeline_get_bus (GST_PIPELINE (*pipeline));
+  g_signal_handlers_disconnect_by_func (bus, bus_func, user_data);
+  gst_bus_remove_signal_watch (bus);
+  gst_object_unref (bus);
+
+  gst_element_set_state (*pipeline, GST_STATE_NULL);
+  gst_object_unref (*pipeline);
+  *pipeline = NULL;
+}
+
+static RenderData *
+_render_data_ref (RenderData * data)
+{
+  g_atomic_int_inc (&data->ref_count);
+
+  return data;
+}
+
+static void
+_render_data_unref (RenderData * data)
+{
+  guint i;
+
+  if (!g_atomic_int_dec_and_test (&data->ref_count))
+    return;
+
+  for (i = 0; i < data->n_segments; i++) {
+    g_free (data->segments[i].filename);
+    g_free (data->segments[i].uri);
+  }
+  g_free (data->segments);
+  g_free (data->audio.filename);
+  g_free (data->audio.uri);
+
+  if (data->cancellable)
+    g_object_unref (data->cancellable);
+  if (data->encoded_caps)
+    gst_caps_unref (data->encoded_caps);
+  if (data->join_pads)
+    g_hash_table_unref (data->join_pads);
+  gst_encoding_profile_unref (data->profile);
+  g_free (data->uri);
+  g_free (data->tmpdir);
+  g_mutex_clear (&data->lock);
+
+  g_slice_free (RenderData, data);
+}
+
+static void
+_stop_segment (RenderSegment * segment)
+{
+  _stop_pipeline (&segment->pipeline, segment_bus_message_cb, segment);
+  if (segment->filename)
+    g_unlink (segment->filename);
+}
+
+/* Stops everything, reports the result and releases the reference of the
+ * rendering to @data, takes @error */
+static void
+_render_done (RenderData * data, GError * error)
+{
+  guint i;
+  GSimpleAsyncResult *simple;
+
+  if (data->done) {
+    if (error)
+      g_error_free (error);
+
+    return;
+  }
+  data->done = TRUE;
+
+  if (data->cancellable)
+    g_cancellable_disconnect (data->cancellable, data->cancelled_id);
+  data->cancelled_id = 0;
+
+  for (i = 0; i < data->n_segments; i++)
+    _stop_segment (&data->segments[i]);
+  _stop_segment (&data->audio);
+  _stop_pipeline (&data->join_pipeline, join_bus_message_cb, data);
+  if (data->source)
+    gst_object_unref (data->source);
+  data->source = NULL;
+  if (data->audio_source)
+    gst_object_unref (data->audio_source);
+  data->audio_source = NULL;
+  if (data->tmpdir)
+    g_rmdir (data->tmpdir);
+
+  /* Only once the streaming threads, which add it, are stopped */
+  if (data->next_id)
+    g_source_remove (data->next_id);
+  data->next_id = 0;
+
+  GST_DEBUG ("Rendering to %s done: %s", data->uri,
+      error ? error->message : "success");
+
+  simple = data->simple;
+  data->simple = NULL;
+  if (error)
+    g_simple_async_result_take_error (simple, error);
+  g_simple_async_result_set_op_res_gboolean (simple, error == NULL);
+  g_simple_async_result_complete_in_idle (simple);
+  g_object_unref (simple);
+
+  _render_data_unref (data);
+}
+
+static GError *
+_error_from_message (GstMessage * message)
+{
+  GError *error;
+  gchar *debug;
+
+  gst_message_parse_error (message, &error, &debug);
+  GST_WARNING_OBJECT (GST_MESSAGE_SRC (message), "Error: %s (%s)",
+      error->message, debug);
+  g_free (debug);
+
+  return error;
+}
+
+
+static gboolean
+_cancel_idle (RenderData * data)
+{
+  GError *error = NULL;
+
+  if (!data->done) {
+    g_cancellable_set_error_if_cancelled (data->cancellable, &error);
+    _render_done (data, error);
+  }
+
+  return FALSE;
+}
+
+static void
+_cancelled_cb (GCancellable * cancellable, RenderData * data)
+{
+  /* Might be emitted from any thread, the pipelines are only ever handled
+   * from the main context */
+  g_idle_add_full (G_PRIORITY_DEFAULT_IDLE, (GSourceFunc) _cancel_idle,
+      _render_data_ref (data), (GDestroyNotify) _render_data_unref);
+}
+
+/* Joining the segments */
+static GstPadProbeReturn
+_join_probe_cb (GstPad * pad, GstPadProbeInfo * info, RenderData * data)
+{
+  gboolean last = data->current == data->n_segments - 1;
+
+  if (GST_PAD_PROBE_INFO_TYPE (info) & GST_PAD_PROBE_TYPE_BUFFER) {
+    /* The stream headers are already in the caps and were muxed with the
+     * first segment */
+    if (data->current > 0 && GST_BUFFER_FLAG_IS_SET (GST_PAD_PROBE_INFO_BUFFER
+            (info), GST_BUFFER_FLAG_HEADER))
+      return GST_PAD_PROBE_DROP;
+
+    return GST_PAD_PROBE_OK;
+  }
+
+  switch (GST_EVENT_TYPE (GST_PAD_PROBE_INFO_EVENT (info))) {
+    case GST_EVENT_STREAM_START:
+      /* For the muxer, the next segments are the continuation of the
+       * first one */
+      return data->current > 0 ? GST_PAD_PROBE_DROP : GST_PAD_PROBE_OK;
+    case GST_EVENT_EOS:
+      if (last)
+        return GST_PAD_PROBE_OK;
+
+      g_mutex_lock (&data->lock);
+      data->n_eos++;
+      if (data->no_more_pads && data->n_eos == data->n_streams)
+        data->next_id = g_idle_add ((GSourceFunc) _join_next_segment, data);
+      g_mutex_unlock (&data->lock);
+
+      return GST_PAD_PROBE_DROP;
+    default:
+      return GST_PAD_PROBE_OK;
+  }
+}
+
+static void
+_join_pad_added_cb (GstElement * source, GstPad * pad, RenderData * data)
+{
+  GstCaps *caps;
+  GstPad *sinkpad;
+  const gchar *media_type;
+
+  caps = gst_pad_query_caps (pad, NULL);
+  media_type = gst_structure_get_name (gst_caps_get_structure (caps, 0));
+
+  g_mutex_lock (&data->lock);
+  sinkpad = g_hash_table_lookup (data->join_pads, media_type);
+  if (sinkpad == NULL) {
+    g_signal_emit_by_name (data->encodebin, "request-pad", caps, &sinkpad);
+    if (sinkpad)
+      g_hash_table_insert (data->join_pads, g_strdup (media_type), sinkpad);
+  }
+  data->n_streams++;
+  g_mutex_unlock (&data->lock);
+
+  if (sinkpad == NULL) {
+    /* The not-linked error will stop the join */
+    GST_ERROR_OBJECT (source, "No stream of the profile for %" GST_PTR_FORMAT,
+        caps);
+    gst_caps_unref (caps);
+
+    return;
+  }
+  gst_caps_unref (caps);
+
+  /* Each segment starts at 0 */
+  gst_pad_set_offset (pad, data->segments[data->current].start);
+  gst_pad_add_probe (pad, GST_PAD_PROBE_TYPE_BUFFER |
+      GST_PAD_PROBE_TYPE_EVENT_DOWNSTREAM, (GstPadProbeCallback) _join_probe_cb,
+      data, NULL);
+
+  if (gst_pad_link (pad, sinkpad) != GST_PAD_LINK_OK)
+    GST_ERROR_OBJECT (source, "Could not link %" GST_PTR_FORMAT, pad);
+}
+
+static void
+_join_audio_pad_added_cb (GstElement * source, GstPad * pad,
+    RenderData * data)
+{
+  GstCaps *caps;
+  GstPad *sinkpad = NULL;
+
+  caps = gst_pad_query_caps (pad, NULL);
+  g_mutex_lock (&data->lock);
+  g_signal_emit_by_name (data->encodebin, "request-pad", caps, &sinkpad);
+  g_mutex_unlock (&data->lock);
+
+  if (sinkpad == NULL) {
+    GST_ERROR_OBJECT (source, "No stream of the profile for %" GST_PTR_FORMAT,
+        caps);
+  } else {
+    if (gst_pad_link (pad, sinkpad) != GST_PAD_LINK_OK)
+      GST_ERROR_OBJECT (source, "Could not link %" GST_PTR_FORMAT, pad);
+    gst_object_unref (sinkpad);
+  }
+  gst_caps_unref (caps);
+}
+
+static void
+_join_no_more_pads_cb (GstElement * source, RenderData * data)
+{
+  g_mutex_lock (&data->lock);
+  data->no_more_pads = TRUE;
+  if (data->n_streams && data->n_eos == data->n_streams &&
+      data->current < data->n_segments - 1)
+    data->next_id = g_idle_add ((GSourceFunc) _join_next_segment, data);
+  g_mutex_unlock (&data->lock);
+}
+
+/* Replaces the source of the previous segment by one for the next segment */
+static gboolean
+_join_next_segment (RenderData * data)
+{
+  GstElement *source;
+
+  data->next_id = 0;
+
+  if (data->source) {
+    gst_element_set_state (data->source, GST_STATE_NULL);
+    gst_bin_remove (GST_BIN (data->join_pipeline), data->source);
+    gst_object_unref (data->source);
+    data->current++;
+  }
+
+  GST_DEBUG ("Joining segment %u: %s", data->current,
+      data->segments[data->current].uri);
+
+  g_mutex_lock (&data->lock);
+  data->n_streams = data->n_eos = 0;
+  data->no_more_pads = FALSE;
+  g_mutex_unlock (&data->lock);
+
+  source = gst_element_factory_make ("uridecodebin", NULL);
+  g_object_set (source, "uri", data->segments[data->current].uri, "caps",
+      data->encoded_caps, NULL);
+  g_signal_connect (source, "pad-added", G_CALLBACK (_join_pad_added_cb),
+      data);
+  g_signal_connect (source, "no-more-pads",
+      G_CALLBACK (_join_no_more_pads_cb), data);
+
+  data->source = gst_object_ref (source);
+  gst_bin_add (GST_BIN (data->join_pipeline), source);
+  gst_element_sync_state_with_parent (source);
+
+  return FALSE;
+}
+
+static void
+join_bus_message_cb (GstBus * bus, GstMessage * message, RenderData * data)
+{
+  switch (GST_MESSAGE_TYPE (message)) {
+    case GST_MESSAGE_ERROR:
+      _render_done (data, _error_from_message (message));
+      break;
+    case GST_MESSAGE_EOS:
+      _render_done (data, NULL);
+      break;
+    default:
+      break;
+  }
+}
+
+static GstCaps *
+_get_encoded_caps (GstEncodingProfile * profile)
+{
+  const GList *tmp;
+  GstCaps *caps;
+
+  if (!GST_IS_ENCODING_CONTAINER_PROFILE (profile))
+    return gst_encoding_profile_get_format (profile);
+
+  caps = gst_caps_new_empty ();
+  for (tmp = gst_encoding_container_profile_get_profiles
+      (GST_ENCODING_CONTAINER_PROFILE (profile)); tmp; tmp = tmp->next)
+    gst_caps_append (caps, gst_encoding_profile_get_format (tmp->data));
+
+  return caps;
+}
+
+static void
+_start_join (RenderData * data)
+{
+  GstBus *bus;
+  GstElement *sink;
+  GError *error = NULL;
+
+  sink = gst_element_make_from_uri (GST_URI_SINK, data->uri, NULL, &error);
+  if (sink == NULL) {
+    _render_done (data, error);
+
+    return;
+  }
+
+  /* Already encoded streams matching the profile go through encodebin
+   * without being reencoded */
+  data->encodebin = gst_element_factory_make ("encodebin", NULL);
+  g_object_set (data->encodebin, "profile", data->profile, NULL);
+  data->encoded_caps = _get_encoded_caps (data->profile);
+  data->join_pads = g_hash_table_new_full (g_str_hash, g_str_equal, g_free,
+      gst_object_unref);
+
+  data->join_pipeline = gst_pipeline_new ("ges-parallel-render-join");
+  gst_bin_add_many (GST_BIN (data->join_pipeline), data->encodebin, sink,
+      NULL);
+  gst_element_link (data->encodebin, sink);
+
+  bus = gst_pipeline_get_bus (GST_PIPELINE (data->join_pipeline));
+  gst_bus_add_signal_watch (bus);
+  g_signal_connect (bus, "message", G_CALLBACK (join_bus_message_cb), data);
+  gst_object_unref (bus);
+
+  /* The audio goes along the whole join, while the video segments are
+   * decoded one after the other */
+  if (data->split_audio) {
+    data->audio_source = gst_element_factory_make ("uridecodebin", NULL);
+    g_object_set (data->audio_source, "uri", data->audio.uri, "caps",
+        data->encoded_caps, NULL);
+    g_signal_connect (data->audio_source, "pad-added",
+        G_CALLBACK (_join_audio_pad_added_cb), data);
+    gst_bin_add (GST_BIN (data->join_pipeline),
+        gst_object_ref (data->audio_source));
+  }
+
+  data->current = 0;
+  _join_next_segment (data);
+  gst_element_set_state (data->join_pipeline, GST_STATE_PLAYING);
+}
+
+/* Rendering the segments */
+static void
+segment_bus_message_cb (GstBus * bus, GstMessage * message,
+    RenderSegment * segment)
+{
+  RenderData *data = segment->data;
+
+  switch (GST_MESSAGE_TYPE (message)) {
+    case GST_MESSAGE_ERROR:
+      _render_done (data, _error_from_message (message));
+      break;
+    case GST_MESSAGE_EOS:
+      GST_DEBUG ("Segment %" GST_TIME_FORMAT " -- %" GST_TIME_FORMAT
+          " rendered", GST_TIME_ARGS (segment->start),
+          GST_TIME_ARGS (segment->start + segment->duration));
+
+      _stop_pipeline (&segment->pipeline, segment_bus_message_cb, segment);
+      segment->rendered = TRUE;
+      data->n_rendered++;
+
+      if (data->n_rendered == data->n_segments + (data->split_audio ? 1 : 0))
+        _start_join (data);
+      break;
+    default:
+      break;
+  }
+}
+
+static gboolean
+_start_segment (RenderData * data, GESTimeline * timeline,
+    RenderSegment * segment, const gchar * basename, GESTrackType types,
+    GError ** error)
+{
+  GstBus *bus;
+  GESPipeline *pipeline;
+
+  segment->filename = g_build_filename (data->tmpdir, basename, NULL);
+  segment->uri = gst_filename_to_uri (segment->filename, error);
+  if (segment->uri == NULL)
+    return FALSE;
+
+  pipeline = ges_pipeline_new ();
+  segment->pipeline = GST_ELEMENT (pipeline);
+
+  bus = gst_pipeline_get_bus (GST_PIPELINE (pipeline));
+  gst_bus_add_signal_watch (bus);
+  g_signal_connect (bus, "message", G_CALLBACK (segment_bus_message_cb),
+      segment);
+  gst_object_unref (bus);
+
+  ges_pipeline_add_timeline (pipeline, _copy_timeline_range (timeline,
+          segment->start, segment->start + segment->duration, types));
+  if (!ges_pipeline_set_render_settings (pipeline, segment->uri,
+          data->profile) ||
+      !ges_pipeline_set_mode (pipeline, TIMELINE_MODE_RENDER)) {
+    g_set_error (error, GST_CORE_ERROR, GST_CORE_ERROR_NEGOTIATION,
+        "Could not set the render settings");
+
+    return FALSE;
+  }
+
+  return gst_element_set_state (segment->pipeline, GST_STATE_PLAYING) !=
+      GST_STATE_CHANGE_FAILURE;
+}
+
+/**
+ * ges_timeline_render_parallel_async:
+ * @timeline: a #GESTimeline
+ * @uri: The location to render to
+ * @profile: The #GstEncodingProfile to render with
+ * @n_segments: The number of pieces to cut @timeline into, each of them being
+ * rendered in its own #GESPipeline
+ * @cancellable: (allow-none): A #GCancellable to cancel the rendering, or %NULL
+ * @callback: A #GAsyncReadyCallback to call when the rendering is done
+ * @user_data: The user data to pass to @callback
+ *
+ * Renders @timeline to @uri the same way as a #GESPipeline in
+ * #TIMELINE_MODE_RENDER would, but in up to @n_segments pipelines running
+ * at the same time.
+ *
+ * The rendered segments are joined with an encodebin which only muxes them,
+ * which means that the encoded formats of @profile need to be usable as
+ * they are by its muxer. Only the video is cut, the audio being rendered
+ * at once next to the video segments.
+ *
+ * The keyframes set with ges_track_element_set_control_source() are not
+ * carried over to the segments, so timelines where any #GESTrackElement
+ * has a control binding are not cut, and are rendered in a single
+ * pipeline, as are timelines without video.
+ *
+ * @timeline is copied when calling that function, later changes to it do
+ * not change the rendered file. The rendering is driven from the default
+ * #GMainContext, which needs to be running for the rendering to progress.
+ */
+void
+ges_timeline_render_parallel_async (GESTimeline * timeline, const gchar * uri,
+    GstEncodingProfile * profile, guint n_segments, GCancellable * cancellable,
+    GAsyncReadyCallback callback, gpointer user_data)
+{
+  guint i;
+  RenderData *data;
+  gboolean started;
+  GError *error = NULL;
+  GESTrackType segment_types = GES_TRACK_TYPE_AUDIO | GES_TRACK_TYPE_VIDEO |
+      GES_TRACK_TYPE_TEXT | GES_TRACK_TYPE_CUSTOM;
+
+  g_return_if_fail (GES_IS_TIMELINE (timeline));
+  g_return_if_fail (uri != NULL);
+  g_return_if_fail (GST_IS_ENCODING_PROFILE (profile));
+  g_return_if_fail (n_segments > 0);
+
+  data = g_slice_new0 (RenderData);
+  data->ref_count = 1;
+  g_mutex_init (&data->lock);
+  data->uri = g_strdup (uri);
+  data->profile = gst_encoding_profile_ref (profile);
+  data->simple = g_simple_async_result_new (G_OBJECT (timeline), callback,
+      user_data, ges_timeline_render_parallel_async);
+  g_simple_async_result_set_check_cancellable (data->simple, cancellable);
+
+  _find_framerate (data, timeline);
+  _cut_timeline (data, timeline, n_segments);
+  GST_INFO_OBJECT (timeline, "Rendering to %s in %u segments", uri,
+      data->n_segments);
+
+  data->tmpdir = g_dir_make_tmp ("ges-render-XXXXXX", &error);
+  started = data->tmpdir != NULL;
+  if (started && data->split_audio) {
+    started = _start_segment (data, timeline, &data->audio, "audio",
+        GES_TRACK_TYPE_AUDIO, &error);
+    segment_types &= ~GES_TRACK_TYPE_AUDIO;
+  }
+
+  for (i = 0; started && i < data->n_segments; i++) {
+    gchar *basename = g_strdup_printf ("segment-%u", i);
+
+    started = _start_segment (data, timeline, &data->segments[i], basename,
+        segment_types, &error);
+    g_free (basename);
+  }
+
+  if (!started) {
+    if (error == NULL)
+      error = g_error_new (GST_CORE_ERROR, GST_CORE_ERROR_STATE_CHANGE,
+          "Could not start rendering the timeline");
+    _render_done (data, error);
+
+    return;
+  }
+
+  if (cancellable) {
+    data->cancellable = g_object_ref (cancellable);
+    data->cancelled_id = g_cancellable_connect (cancellable,
+        G_CALLBACK (_cancelled_cb), data, NULL);
+  }
+}
+
+/**
+ * ges_timeline_render_parallel_finish:
+ * @timeline: a #GESTimeline
+ * @result: The #GAsyncResult passed to the #GAsyncReadyCallback
+ * @error: (out) (allow-none): An error to be set in case something wrong happens or %NULL
+ *
+ * Finishes an operation started with ges_timeline_render_parallel_async().
+ *
+ * Returns: %TRUE if the timeline was successfully rendered, else %FALSE.
+ */
+gboolean
+ges_timeline_render_parallel_finish (GESTimeline * timeline,
+    GAsyncResult * result, GError ** error)
+{
+  GSimpleAsyncResult *simple = G_SIMPLE_ASYNC_RESULT (result);
+
+  g_return_val_if_fail (g_simple_async_result_is_valid (result,
+          G_OBJECT (timeline), ges_timeline_render_parallel_async), FALSE);
+
+  if (g_simple_async_result_propagate_error (simple, error))
+    return FALSE;
+
+  return g_simple_async_result_get_op_res_gboolean (simple);
+}
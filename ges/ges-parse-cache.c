@@ -0,0 +1,366 @@
+/* GStreamer Editing Services
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+/* Cache of the bin descriptions used for the gaps and the effects, so that
+ * a description used by thousands of elements is only parsed once.
+ *
+ * The first time a description is requested, it is parsed with
+ * gst_parse_bin_from_description() and a template is made out of the
+ * resulting bin: the factory, name and non default properties of each of
+ * its elements, and the links between them. The next bins are then built
+ * from that template without going through the parser nor looking the
+ * factories up in the registry.
+ *
+ * Only the descriptions made of elements with always pads and no sub bins
+ * can be reproduced that way, the other ones are parsed each time.
+ *
+ * NOTE: This is for internal use exclusively
+ */
+
+#include "ges-internal.h"
+#include "ges-parse-cache.h"
+
+typedef struct
+{
+  GstElementFactory *factory;
+  gchar *name;
+
+  /* The properties that differ from the defaults of the factory */
+  guint n_params;
+  GParameter *params;
+} ElementTemplate;
+
+typedef struct
+{
+  guint src;
+  gchar *srcpad;
+  guint sink;
+  gchar *sinkpad;
+} LinkTemplate;
+
+typedef struct
+{
+  /* %FALSE if the description has to be parsed each time */
+  gboolean cacheable;
+
+  GArray *elements;
+  GArray *links;
+} BinTemplate;
+
+static GMutex cache_lock;
+static GHashTable *templates = NULL;
+
+static guint hits = 0;
+static guint misses = 0;
+
+static void
+_free_template (BinTemplate * template)
+{
+  guint i, j;
+
+  for (i = 0; i < template->elements->len; i++) {
+    ElementTemplate *element =
+        &g_array_index (template->elements, ElementTemplate, i);
+
+    gst_object_unref (element->factory);
+    g_free (element->name);
+    for (j = 0; j < element->n_params; j++)
+      g_value_unset (&element->params[j].value);
+    g_free (element->params);
+  }
+
+  for (i = 0; i < template->links->len; i++) {
+    LinkTemplate *link = &g_array_index (template->links, LinkTemplate, i);
+
+    g_free (link->srcpad);
+    g_free (link->sinkpad);
+  }
+
+  g_array_free (template->elements, TRUE);
+  g_array_free (template->links, TRUE);
+  g_slice_free (BinTemplate, template);
+}
+
+static inline void
+_ensure_templates (void)
+{
+  if (G_UNLIKELY (templates == NULL))
+    templates = g_hash_table_new_full (g_str_hash, g_str_equal, g_free,
+        (GDestroyNotify) _free_template);
+}
+
+/* Sub bins and elements with sometimes or request pads can not be
+ * reproduced by only linking static pads */
+static gboolean
+_can_be_templated (GstElement * element, GstElementFactory * factory)
+{
+  const GList *tmp;
+
+  if (factory == NULL || GST_IS_BIN (element))
+    return FALSE;
+
+  for (tmp = gst_element_factory_get_static_pad_templates (factory); tmp;
+      tmp = tmp->next) {
+    if (((GstStaticPadTemplate *) tmp->data)->presence != GST_PAD_ALWAYS)
+      return FALSE;
+  }
+
+  return TRUE;
+}
+
+/* Fills the properties of @element_template with the ones of @element
+ * that are not the ones of a newly created element */
+static gboolean
+_fill_params (ElementTemplate * element_template, GstElement * element)
+{
+  guint n, n_specs;
+  GParamSpec **specs;
+  GstElement *pristine;
+  GValue value = { 0 };
+  GValue default_value = { 0 };
+  gboolean ret = TRUE;
+
+  pristine = gst_element_factory_create (element_template->factory, NULL);
+  if (pristine == NULL)
+    return FALSE;
+  gst_object_ref_sink (pristine);
+
+  specs = g_object_class_list_properties (G_OBJECT_GET_CLASS (element),
+      &n_specs);
+  element_template->params = g_new0 (GParameter, n_specs);
+  for (n = 0; n < n_specs && ret; n++) {
+    if ((specs[n]->flags & G_PARAM_READWRITE) != G_PARAM_READWRITE ||
+        (specs[n]->flags & G_PARAM_CONSTRUCT_ONLY) ||
+        !g_strcmp0 (specs[n]->name, "name") ||
+        !g_strcmp0 (specs[n]->name, "parent"))
+      continue;
+
+    g_value_init (&value, specs[n]->value_type);
+    g_value_init (&default_value, specs[n]->value_type);
+    g_object_get_property (G_OBJECT (element), specs[n]->name, &value);
+    g_object_get_property (G_OBJECT (pristine), specs[n]->name,
+        &default_value);
+
+    if (g_param_values_cmp (specs[n], &value, &default_value) == 0) {
+      g_value_unset (&value);
+    } else if (G_TYPE_IS_OBJECT (specs[n]->value_type) ||
+        G_TYPE_IS_INTERFACE (specs[n]->value_type)) {
+      /* Objects can not be shared between the bins */
+      GST_DEBUG_OBJECT (element, "Object property %s set", specs[n]->name);
+      g_value_unset (&value);
+      ret = FALSE;
+    } else {
+      GParameter *param =
+          &element_template->params[element_template->n_params++];
+
+      param->name = g_intern_string (specs[n]->name);
+      g_value_init (&param->value, specs[n]->value_type);
+      g_value_copy (&value, &param->value);
+      g_value_unset (&value);
+    }
+    g_value_unset (&default_value);
+  }
+
+  g_free (specs);
+  gst_object_unref (pristine);
+
+  return ret;
+}
+
+static BinTemplate *
+_make_template (GstElement * bin)
+{
+  GList *tmp, *pads;
+  GHashTable *indexes;
+  BinTemplate *template = g_slice_new0 (BinTemplate);
+
+  template->elements = g_array_new (FALSE, TRUE, sizeof (ElementTemplate));
+  template->links = g_array_new (FALSE, TRUE, sizeof (LinkTemplate));
+  indexes = g_hash_table_new (NULL, NULL);
+
+  /* The children are prepended when added, so go through them backward to
+   * add them back in the same order */
+  for (tmp = g_list_last (GST_BIN_CHILDREN (bin)); tmp; tmp = tmp->prev) {
+    ElementTemplate element_template = { 0 };
+    GstElement *element = tmp->data;
+    GstElementFactory *factory = gst_element_get_factory (element);
+
+    if (!_can_be_templated (element, factory))
+      goto not_cacheable;
+
+    element_template.factory = gst_object_ref (factory);
+    element_template.name = gst_element_get_name (element);
+    g_array_append_val (template->elements, element_template);
+    if (!_fill_params (&g_array_index (template->elements, ElementTemplate,
+                template->elements->len - 1), element))
+      goto not_cacheable;
+
+    g_hash_table_insert (indexes, element,
+        GUINT_TO_POINTER (template->elements->len - 1));
+  }
+
+  /* The ghost pads are not in @indexes, they are recreated the same way
+   * gst_parse_bin_from_description() creates them */
+  for (tmp = GST_BIN_CHILDREN (bin); tmp; tmp = tmp->next) {
+    for (pads = GST_ELEMENT (tmp->data)->srcpads; pads; pads = pads->next) {
+      gpointer index;
+      LinkTemplate link;
+      GstPad *peer = GST_PAD_PEER (pads->data);
+
+      if (peer == NULL || !g_hash_table_lookup_extended (indexes,
+              GST_OBJECT_PARENT (peer), NULL, &index))
+        continue;
+
+      link.src = GPOINTER_TO_UINT (g_hash_table_lookup (indexes, tmp->data));
+      link.srcpad = gst_pad_get_name (pads->data);
+      link.sink = GPOINTER_TO_UINT (index);
+      link.sinkpad = gst_pad_get_name (peer);
+      g_array_append_val (template->links, link);
+    }
+  }
+
+  g_hash_table_unref (indexes);
+  template->cacheable = TRUE;
+
+  return template;
+
+not_cacheable:
+  GST_DEBUG ("Not caching %s", GST_OBJECT_NAME (bin));
+  g_hash_table_unref (indexes);
+  template->cacheable = FALSE;
+
+  return template;
+}
+
+static void
+_add_ghost_pad (GstElement * bin, GstPadDirection direction,
+    const gchar * name)
+{
+  GstPad *pad = gst_bin_find_unlinked_pad (GST_BIN (bin), direction);
+
+  if (pad) {
+    gst_element_add_pad (bin, gst_ghost_pad_new (name, pad));
+    gst_object_unref (pad);
+  }
+}
+
+static GstElement *
+_make_bin (BinTemplate * template)
+{
+  guint i, j;
+  GstElement *bin = gst_bin_new (NULL);
+  GstElement **elements = g_newa (GstElement *, template->elements->len);
+
+  for (i = 0; i < template->elements->len; i++) {
+    ElementTemplate *element_template =
+        &g_array_index (template->elements, ElementTemplate, i);
+
+    elements[i] = gst_element_factory_create (element_template->factory,
+        element_template->name);
+    for (j = 0; j < element_template->n_params; j++)
+      g_object_set_property (G_OBJECT (elements[i]),
+          element_template->params[j].name,
+          &element_template->params[j].value);
+    gst_bin_add (GST_BIN (bin), elements[i]);
+  }
+
+  /* The links were already checked when parsing */
+  for (i = 0; i < template->links->len; i++) {
+    LinkTemplate *link = &g_array_index (template->links, LinkTemplate, i);
+
+    gst_element_link_pads_full (elements[link->src], link->srcpad,
+        elements[link->sink], link->sinkpad, GST_PAD_LINK_CHECK_NOTHING);
+  }
+
+  _add_ghost_pad (bin, GST_PAD_SINK, "sink");
+  _add_ghost_pad (bin, GST_PAD_SRC, "src");
+
+  return bin;
+}
+
+/* Creates a new bin from @description, the same way
+ * gst_parse_bin_from_description() with ghost pads would.
+ *
+ * Returns a new bin, or %NULL */
+GstElement *
+ges_parse_cache_get_bin (const gchar * description, GError ** error)
+{
+  GstElement *bin;
+  BinTemplate *template;
+  GError *parse_error = NULL;
+
+  g_return_val_if_fail (description, NULL);
+
+  g_mutex_lock (&cache_lock);
+  _ensure_templates ();
+  template = g_hash_table_lookup (templates, description);
+  if (template && template->cacheable) {
+    hits++;
+    bin = _make_bin (template);
+    g_mutex_unlock (&cache_lock);
+
+    return bin;
+  }
+  misses++;
+  g_mutex_unlock (&cache_lock);
+
+  bin = gst_parse_bin_from_description (description, TRUE, &parse_error);
+  if (parse_error) {
+    g_propagate_error (error, parse_error);
+
+    return bin;
+  }
+
+  if (template == NULL && bin) {
+    template = _make_template (bin);
+
+    g_mutex_lock (&cache_lock);
+    _ensure_templates ();
+    if (g_hash_table_lookup (templates, description))
+      _free_template (template);
+    else
+      g_hash_table_insert (templates, g_strdup (description), template);
+    g_mutex_unlock (&cache_lock);
+  }
+
+  return bin;
+}
+
+/* Drops all the cached descriptions and resets the statistics. */
+void
+ges_parse_cache_clear (void)
+{
+  g_mutex_lock (&cache_lock);
+  if (templates)
+    g_hash_table_remove_all (templates);
+  hits = misses = 0;
+  g_mutex_unlock (&cache_lock);
+}
+
+/* Gets the number of bins built from a cached description, and of times
+ * a description was parsed. */
+void
+ges_parse_cache_get_stats (guint * n_hits, guint * n_misses)
+{
+  g_mutex_lock (&cache_lock);
+  if (n_hits)
+    *n_hits = hits;
+  if (n_misses)
+    *n_misses = misses;
+  g_mutex_unlock (&cache_lock);
+}
@@ -0,0 +1,42 @@
+/* GStreamer Editing Services
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef _GES_PARSE_CACHE_H_
+#define _GES_PARSE_CACHE_H_
+
+#include <gst/gst.h>
+
+G_BEGIN_DECLS
+
+/* Process wide cache of parsed bin descriptions, building new bins from
+ * the factories and properties resolved when the description was first
+ * parsed.
+ *
+ * NOTE: This is for internal use exclusively, the unit tests and
+ * benchmarks build their own copy of it */
+G_GNUC_INTERNAL GstElement *
+ges_parse_cache_get_bin   (const gchar *description, GError **error);
+
+G_GNUC_INTERNAL void
+ges_parse_cache_clear     (void);
+
+G_GNUC_INTERNAL void
+ges_parse_cache_get_stats (guint *n_hits, guint *n_misses);
+
+G_END_DECLS
+#endif /* _GES_PARSE_CACHE_H_ */
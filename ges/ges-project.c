@@ -64,22 +64,46 @@ struct _GESProjectPrivate
 
   gchar *uri;
 
+  /* The GCancellable of the load currently happening, if any */
+  GCancellable *load_cancellable;
+
   GList *encoding_profiles;
 
   GstEncodingProfile *proxy_profile;
-  GstElement *proxy_pipeline;
-  GESAsset *proxy_asset;
-  GESAsset *proxy_parent;
-  GList *create_proxies;
+  /* Assets waiting for their proxy to be created and the ProxyJob-s
+   * currently creating one, at most max_concurrent_proxies of them */
+  GQueue *pending_proxies;
+  GList *proxy_jobs;
+  guint max_concurrent_proxies;
+  gboolean proxies_paused;
+  GCancellable *proxies_cancellable;
+  gulong proxies_cancelled_id;
   GList *timeline_proxies;
   GHashTable *proxies;
   GHashTable *proxied_assets;
   gboolean proxies_creation_started;
   gboolean proxies_created;
-  gchar *proxy_uri;
   gchar *proxies_location;
 };
 
+/* The creation of the proxy of @parent, first trying to load an already
+ * existing proxy and transcoding @parent if none could be loaded */
+typedef struct
+{
+  GESProject *project;
+  GESAsset *parent;
+  gchar *proxy_uri;
+  /* Set while transcoding into the temporary file */
+  gchar *part_uri;
+  GstElement *pipeline;
+  guint progress_id;
+  gboolean requesting;
+  gboolean transcoded;
+  gboolean cancelled;
+} ProxyJob;
+
+#define PROXY_PROGRESS_INTERVAL 500
+
 typedef struct EmitLoadedInIdle
 {
   GESProject *project;
@@ -97,6 +121,8 @@ enum
   PROXIES_CREATION_PAUSED_SIGNAL,
   PROXIES_CREATION_CANCELLED_SIGNAL,
   PROXIES_CREATED_SIGNAL,
+  PROXY_CREATION_PROGRESS_SIGNAL,
+  LOADING_PROGRESS_SIGNAL,
   LAST_SIGNAL
 };
 
@@ -108,14 +134,19 @@ enum
 {
   PROP_0,
   PROP_URI,
+  PROP_MAX_CONCURRENT_PROXIES,
   PROP_LAST,
 };
 
 static GParamSpec *_properties[LAST_SIGNAL] = { 0 };
 
-static gboolean _transcode (GESProject * project, GESAsset * asset);
-static gboolean _create_proxy_asset (GESProject * project, const gchar * id,
-    GType extractable_type);
+static gboolean _transcode (ProxyJob * job);
+static void _schedule_proxy_jobs (GESProject * project);
+static gboolean _cancel_proxy_jobs (GESProject * project);
+static void new_proxy_asset_cb (GESAsset * source, GAsyncResult * res,
+    ProxyJob * job);
+static void bus_message_cb (GstBus * bus, GstMessage * message,
+    ProxyJob * job);
 
 static gboolean
 _emit_loaded_in_idle (EmitLoadedInIdle * data)
@@ -130,6 +161,16 @@ _emit_loaded_in_idle (EmitLoadedInIdle * data)
   return FALSE;
 }
 
+static guint
+_get_default_max_concurrent_proxies (void)
+{
+#if GLIB_CHECK_VERSION(2, 36, 0)
+  return MAX (g_get_num_processors (), 1);
+#else
+  return 2;
+#endif
+}
+
 static void
 ges_project_add_formatter (GESProject * project, GESFormatter * formatter)
 {
@@ -157,7 +198,7 @@ ges_project_remove_formatter (GESProject * project, GESFormatter * formatter)
   }
 }
 
-static void
+void
 ges_project_set_uri (GESProject * project, const gchar * uri)
 {
   GESProjectPrivate *priv;
@@ -282,22 +323,22 @@ _dispose (GObject * object)
     gst_object_unref (priv->formatter_asset);
   if (priv->proxy_profile)
     gst_object_unref (priv->proxy_profile);
-  if (priv->proxy_pipeline)
-    gst_object_unref (priv->proxy_pipeline);
+  if (priv->pending_proxies) {
+    _cancel_proxy_jobs (GES_PROJECT (object));
+    g_queue_free (priv->pending_proxies);
+    priv->pending_proxies = NULL;
+  }
+  if (priv->proxies_cancellable) {
+    g_cancellable_disconnect (priv->proxies_cancellable,
+        priv->proxies_cancelled_id);
+    g_clear_object (&priv->proxies_cancellable);
+  }
   if (priv->proxies)
     g_hash_table_unref (priv->proxies);
   if (priv->proxied_assets)
     g_hash_table_unref (priv->proxied_assets);
-  if (priv->proxy_uri)
-    g_free (priv->proxy_uri);
   if (priv->proxies_location)
     g_free (priv->proxies_location);
-  if (priv->proxy_asset)
-    g_free (priv->proxy_asset);
-  if (priv->proxy_parent)
-    g_free (priv->proxy_parent);
-  if (priv->create_proxies)
-    g_list_free_full (priv->create_proxies, g_free);
   if (priv->timeline_proxies)
     g_list_free_full (priv->timeline_proxies, g_free);
 
@@ -326,6 +367,9 @@ _get_property (GESProject * project, guint property_id,
     case PROP_URI:
       g_value_set_string (value, priv->uri);
       break;
+    case PROP_MAX_CONCURRENT_PROXIES:
+      g_value_set_uint (value, priv->max_concurrent_proxies);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (project, property_id, pspec);
   }
@@ -339,6 +383,10 @@ _set_property (GESProject * project, guint property_id,
     case PROP_URI:
       project->priv->uri = g_value_dup_string (value);
       break;
+    case PROP_MAX_CONCURRENT_PROXIES:
+      project->priv->max_concurrent_proxies = g_value_get_uint (value);
+      _schedule_proxy_jobs (project);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (project, property_id, pspec);
   }
@@ -366,6 +414,18 @@ ges_project_class_init (GESProjectClass * klass)
   _properties[PROP_URI] = g_param_spec_string ("uri", "URI",
       "uri of the project", NULL, G_PARAM_READWRITE | G_PARAM_CONSTRUCT_ONLY);
 
+  /**
+   * GESProject:max-concurrent-proxies:
+   *
+   * The maximum number of proxies that are created at the same time,
+   * each of them in its own transcoding pipeline. Defaults to the number
+   * of processors of the machine.
+   */
+  _properties[PROP_MAX_CONCURRENT_PROXIES] =
+      g_param_spec_uint ("max-concurrent-proxies", "Max concurrent proxies",
+      "Maximum number of proxies created at the same time", 1, G_MAXUINT,
+      _get_default_max_concurrent_proxies (), G_PARAM_READWRITE);
+
   g_object_class_install_properties (object_class, PROP_LAST, _properties);
 
   /**
@@ -489,6 +549,35 @@ ges_project_class_init (GESProjectClass * klass)
           proxies_creation_cancelled), NULL, NULL, g_cclosure_marshal_generic,
       G_TYPE_NONE, 0);
 
+  /**
+   * GESProject::proxy-creation-progress:
+   * @project: the #GESProject creating proxies
+   * @asset: The #GESAsset a proxy is being created for
+   * @progress: The progress of the creation of the proxy of @asset, between
+   * 0.0 and 1.0
+   *
+   * Regularly emitted while the proxy of @asset is being transcoded.
+   */
+  _signals[PROXY_CREATION_PROGRESS_SIGNAL] =
+      g_signal_new ("proxy-creation-progress", G_TYPE_FROM_CLASS (klass),
+      G_SIGNAL_RUN_LAST, 0, NULL, NULL, g_cclosure_marshal_generic,
+      G_TYPE_NONE, 2, GES_TYPE_ASSET, G_TYPE_DOUBLE);
+
+  /**
+   * GESProject::loading-progress:
+   * @project: the #GESProject being loaded
+   * @progress: The fraction of the project file that has been parsed,
+   * between 0.0 and 1.0
+   *
+   * Regularly emitted while the project file is being parsed. Once it is
+   * fully parsed, the assets it uses might still need to be loaded before
+   * #GESProject::loaded is emitted.
+   */
+  _signals[LOADING_PROGRESS_SIGNAL] =
+      g_signal_new ("loading-progress", G_TYPE_FROM_CLASS (klass),
+      G_SIGNAL_RUN_LAST, 0, NULL, NULL, g_cclosure_marshal_generic,
+      G_TYPE_NONE, 1, G_TYPE_DOUBLE);
+
   object_class->dispose = _dispose;
   object_class->dispose = _finalize;
 
@@ -503,17 +592,19 @@ ges_project_init (GESProject * project)
       GES_TYPE_PROJECT, GESProjectPrivate);
 
   priv->uri = NULL;
+  priv->load_cancellable = NULL;
   priv->formatters = NULL;
   priv->formatter_asset = NULL;
   priv->encoding_profiles = NULL;
   priv->proxy_profile = NULL;
   priv->proxies_creation_started = FALSE;
   priv->proxies_created = FALSE;
-  priv->proxy_uri = NULL;
   priv->proxies_location = NULL;
-  priv->proxy_asset = NULL;
-  priv->proxy_parent = NULL;
-  priv->create_proxies = NULL;
+  priv->pending_proxies = g_queue_new ();
+  priv->proxy_jobs = NULL;
+  priv->max_concurrent_proxies = _get_default_max_concurrent_proxies ();
+  priv->proxies_paused = FALSE;
+  priv->proxies_cancellable = NULL;
   priv->timeline_proxies = NULL;
   priv->assets = g_hash_table_new_full (g_str_hash, g_str_equal,
       g_free, gst_object_unref);
@@ -630,121 +721,177 @@ _add_proxy (GESProject * project, GESAsset * asset)
 static gchar *
 _get_outuri (GESProject * project, const gchar * uri)
 {
-  GESProjectPrivate *priv;
-  gchar *outuri;
+  gchar *filename, *basename, *location, *outfile, *outuri;
+  GESProjectPrivate *priv = project->priv;
 
-  g_return_val_if_fail (GES_IS_PROJECT (project), FALSE);
+  if (priv->proxies_location == NULL)
+    return g_strconcat (uri, ".proxy", NULL);
 
-  priv = project->priv;
+  filename = g_filename_from_uri (uri, NULL, NULL);
+  location = g_filename_from_uri (priv->proxies_location, NULL, NULL);
+  if (filename == NULL || location == NULL) {
+    GST_WARNING_OBJECT (project, "Can not use proxies location %s for %s",
+        priv->proxies_location, uri);
+    g_free (filename);
+    g_free (location);
 
-  outuri = g_strconcat (g_strdup (uri), ".proxy", NULL);
-  if (priv->proxies_location) {
-    outuri =
-        (gchar *) g_strconcat (g_strdup (priv->proxies_location),
-        g_path_get_basename (g_filename_from_uri (outuri, NULL, NULL)), NULL);
+    return g_strconcat (uri, ".proxy", NULL);
   }
 
-  return g_strdup (outuri);
+  basename = g_path_get_basename (filename);
+  outfile = g_strconcat (location, G_DIR_SEPARATOR_S, basename, ".proxy",
+      NULL);
+  outuri = gst_filename_to_uri (outfile, NULL);
+
+  g_free (filename);
+  g_free (location);
+  g_free (basename);
+  g_free (outfile);
+
+  return outuri;
 }
 
 static void
-new_proxy_asset_cb (GESAsset * source, GAsyncResult * res, GESProject * project)
+_link_proxy (GESProject * project, GESAsset * parent, GESAsset * proxy)
 {
-  GESProjectPrivate *priv;
-  GError *error = NULL;
-  GESAsset *asset, *extractable_asset;
+  GESAsset *extractable_asset;
   GESClip *clip;
   GESLayer *layer;
   GESTimeline *timeline;
-  gchar *outuri;
-  const gchar *uri;
-  GType extractable_type;
-  GList *cur_proxy, *cur_clip, *cur_layer, *cur_timeline, *clips, *layers;
+  GList *cur_clip, *cur_layer, *cur_timeline, *clips, *layers;
+
+  /* FIXME: look at the GstDiscovererInfo, and check if it matches the GstEncodingProfile you had set */
+  _add_proxy (project, proxy);
+  ges_asset_set_parent (proxy, parent);
+
+  /* Go over all proxies timeline and set proxy asset for clip */
+  for (cur_timeline = project->priv->timeline_proxies; cur_timeline;
+      cur_timeline = g_list_next (cur_timeline)) {
+    timeline = GES_TIMELINE (cur_timeline->data);
+    layers = ges_timeline_get_layers (timeline);
+    for (cur_layer = layers; cur_layer; cur_layer = g_list_next (cur_layer)) {
+      layer = GES_LAYER (cur_layer->data);
+      clips = ges_layer_get_clips (layer);
+      for (cur_clip = clips; cur_clip; cur_clip = g_list_next (cur_clip)) {
+        clip = GES_CLIP (cur_clip->data);
+        extractable_asset = ges_extractable_get_asset (GES_EXTRACTABLE (clip));
+        if (g_strcmp0 (ges_asset_get_id (parent),
+                ges_asset_get_id (extractable_asset)) == 0) {
+          GST_DEBUG_OBJECT (clip, "Set proxy asset %s for clip",
+              ges_asset_get_id (proxy));
+          ges_extractable_set_asset (GES_EXTRACTABLE (clip), proxy);
+        }
+      }
+      g_list_free_full (clips, gst_object_unref);
+    }
+    g_list_free_full (layers, gst_object_unref);
+    ges_timeline_commit (timeline);
+  }
+}
 
-  g_return_if_fail (GES_IS_PROJECT (project));
+static void
+_stop_proxy_pipeline (ProxyJob * job)
+{
+  GstBus *bus;
 
-  priv = project->priv;
+  if (job->progress_id) {
+    g_source_remove (job->progress_id);
+    job->progress_id = 0;
+  }
 
-  asset = ges_asset_request_finish (res, &error);
-  if (error) {
-    asset = g_hash_table_lookup (priv->assets, priv->proxy_uri);
-    /* FIXME: we must check if pipeline NULL, then create proxy asset else add to list for creating */
-    _transcode (project, asset);
+  if (job->pipeline == NULL)
+    return;
 
-    if (asset) {
-      gst_object_unref (asset);
-    }
-  } else {
-    /* FIXME: look at the GstDiscovererInfo, and check if it matches the GstEncodingProfile you had set */
-    _add_proxy (project, asset);
-    ges_asset_set_parent (asset, priv->proxy_parent);
-
-    /* Go over all proxies timeline and set proxy asset for clip */
-    if (priv->timeline_proxies) {
-      cur_timeline = g_list_first (priv->timeline_proxies);
-      for (; cur_timeline; cur_timeline = g_list_next (cur_timeline)) {
-        timeline = GES_TIMELINE (cur_timeline->data);
-        layers = ges_timeline_get_layers (timeline);
-        cur_layer = g_list_first (layers);
-        for (; cur_layer; cur_layer = g_list_next (cur_layer)) {
-          layer = GES_LAYER (cur_layer->data);
-          clips = ges_layer_get_clips (layer);
-          cur_clip = g_list_first (clips);
-          for (; cur_clip; cur_clip = g_list_next (cur_clip)) {
-            clip = GES_CLIP (cur_clip->data);
-            extractable_asset =
-                ges_extractable_get_asset (GES_EXTRACTABLE (clip));
-            if (g_strcmp0 (ges_asset_get_id (priv->proxy_parent),
-                    ges_asset_get_id (extractable_asset)) == 0) {
-              GST_DEBUG_OBJECT (clip, "Set proxy asset %s for clip",
-                  ges_asset_get_id (asset));
-              ges_extractable_set_asset (GES_EXTRACTABLE (clip), asset);
-            }
-          }
-        }
-        ges_timeline_commit (timeline);
-      }
-    }
+  bus = gst_pipeline_get_bus (GST_PIPELINE (job->pipeline));
+  g_signal_handlers_disconnect_by_func (bus, bus_message_cb, job);
+  gst_bus_remove_signal_watch (bus);
+  gst_object_unref (bus);
 
-    if (asset) {
-      gst_object_unref (asset);
-    }
+  gst_element_set_state (job->pipeline, GST_STATE_NULL);
+  gst_object_unref (job->pipeline);
+  job->pipeline = NULL;
+}
 
-    cur_proxy = g_list_previous (priv->create_proxies);
-    if (cur_proxy) {
-      asset = cur_proxy->data;
-      uri = ges_asset_get_id (asset);
-      outuri = _get_outuri (project, uri);
-      extractable_type = ges_asset_get_extractable_type (asset);
-      priv->proxy_parent = asset;
-      priv->proxy_uri = (gchar *) uri;
-      priv->create_proxies = cur_proxy;
-
-      _create_proxy_asset (project, outuri, extractable_type);
-    } else {
-      priv->proxies_created = TRUE;
-      g_signal_emit (project, _signals[PROXIES_CREATED_SIGNAL], 0, NULL);
-    }
+static void
+_proxy_job_free (ProxyJob * job)
+{
+  _stop_proxy_pipeline (job);
+
+  if (job->part_uri) {
+    gchar *filename = g_filename_from_uri (job->part_uri, NULL, NULL);
+
+    if (filename)
+      g_unlink (filename);
+    g_free (filename);
+    g_free (job->part_uri);
   }
+
+  gst_object_unref (job->parent);
+  gst_object_unref (job->project);
+  g_free (job->proxy_uri);
+  g_slice_free (ProxyJob, job);
 }
 
-static gboolean
-_create_proxy_asset (GESProject * project, const gchar * id,
-    GType extractable_type)
+/* Removes @job from the pool and start the next ones if any */
+static void
+_proxy_job_done (ProxyJob * job)
 {
-  g_return_val_if_fail (GES_IS_PROJECT (project), FALSE);
-  g_return_val_if_fail (id != NULL, FALSE);
-  g_return_val_if_fail (g_type_is_a (extractable_type, GES_TYPE_EXTRACTABLE),
-      FALSE);
+  GESProject *project = gst_object_ref (job->project);
 
-  if (g_hash_table_lookup (project->priv->proxies, id)) {
-    return FALSE;
+  project->priv->proxy_jobs = g_list_remove (project->priv->proxy_jobs, job);
+  _proxy_job_free (job);
+  _schedule_proxy_jobs (project);
+
+  gst_object_unref (project);
+}
+
+static void
+_request_proxy_asset (ProxyJob * job)
+{
+  job->requesting = TRUE;
+  ges_asset_request_async (ges_asset_get_extractable_type (job->parent),
+      job->proxy_uri, NULL, (GAsyncReadyCallback) new_proxy_asset_cb, job);
+}
+
+static void
+new_proxy_asset_cb (GESAsset * source, GAsyncResult * res, ProxyJob * job)
+{
+  GError *error = NULL;
+  GESAsset *asset = ges_asset_request_finish (res, &error);
+
+  job->requesting = FALSE;
+  if (job->cancelled) {
+    /* The pool already forgot about us */
+    g_clear_error (&error);
+    if (asset)
+      gst_object_unref (asset);
+    _proxy_job_free (job);
+
+    return;
   }
 
-  ges_asset_request_async (extractable_type, id, NULL,
-      (GAsyncReadyCallback) new_proxy_asset_cb, project);
+  if (error) {
+    if (asset)
+      gst_object_unref (asset);
 
-  return TRUE;
+    if (job->part_uri == NULL && _transcode (job)) {
+      g_error_free (error);
+
+      return;
+    }
+
+    GST_WARNING_OBJECT (job->project, "Could not create proxy for %s: %s",
+        ges_asset_get_id (job->parent), error->message);
+    g_error_free (error);
+    _proxy_job_done (job);
+
+    return;
+  }
+
+  _link_proxy (job->project, job->parent, asset);
+  gst_object_unref (asset);
+
+  _proxy_job_done (job);
 }
 
 static void
@@ -759,58 +906,80 @@ pad_added_cb (GstElement * uridecodebin, GstPad * pad, GstElement * encodebin)
   if (sinkpad == NULL) {
     GST_ERROR ("Couldn't get an encoding channel for pad %s:%s\n",
         GST_DEBUG_PAD_NAME (pad));
+    gst_caps_unref (caps);
     return;
   }
 
   if (G_UNLIKELY (gst_pad_link (pad, sinkpad) != GST_PAD_LINK_OK)) {
     GST_ERROR ("Couldn't link pads srccaps: %" GST_PTR_FORMAT "sinkcaps: %"
-        GST_PTR_FORMAT, gst_pad_query_caps (sinkpad, NULL), caps);
+        GST_PTR_FORMAT, caps, sinkpad);
   }
+  gst_caps_unref (caps);
+  gst_object_unref (sinkpad);
 
   return;
 }
 
-static void
-bus_message_cb (GstBus * bus, GstMessage * message, GESProject * project)
+static gboolean
+_proxy_progress_cb (ProxyJob * job)
 {
-  GESProjectPrivate *priv;
+  gint64 position, duration;
 
-  g_return_if_fail (GES_IS_PROJECT (project));
+  if (gst_element_query_position (job->pipeline, GST_FORMAT_TIME, &position)
+      && gst_element_query_duration (job->pipeline, GST_FORMAT_TIME,
+          &duration) && duration > 0) {
+    g_signal_emit (job->project, _signals[PROXY_CREATION_PROGRESS_SIGNAL], 0,
+        job->parent, CLAMP ((gdouble) position / duration, 0.0, 1.0));
+  }
 
-  priv = project->priv;
+  return TRUE;
+}
 
+static void
+bus_message_cb (GstBus * bus, GstMessage * message, ProxyJob * job)
+{
   switch (GST_MESSAGE_TYPE (message)) {
     case GST_MESSAGE_ERROR:
+    {
+      GError *error = NULL;
+
+      gst_message_parse_error (message, &error, NULL);
+      GST_WARNING_OBJECT (job->project, "Could not transcode %s: %s",
+          ges_asset_get_id (job->parent), error ? error->message : "");
+      g_clear_error (&error);
 
-      gst_bus_set_flushing (bus, TRUE);
-      gst_element_set_state (priv->proxy_pipeline, GST_STATE_NULL);
-      gst_object_unref (priv->proxy_pipeline);
+      _proxy_job_done (job);
       break;
+    }
     case GST_MESSAGE_EOS:{
-      GType extractable_type;
-
-      gst_element_set_state (priv->proxy_pipeline, GST_STATE_NULL);
-      gst_object_unref (priv->proxy_pipeline);
-
-      if (g_str_has_suffix ((const gchar *) priv->proxy_uri, ".part")) {
-        const gchar *oldfilename, *newfilename;
-
-        oldfilename =
-            (const gchar *) g_filename_from_uri (priv->proxy_uri, NULL, NULL);
-        newfilename = g_strsplit (oldfilename, ".part", 2)[0];
-
-        if (oldfilename && newfilename) {
-          g_rename (oldfilename, newfilename);
-        }
-
-        g_free (priv->proxy_uri);
+      gchar *partfilename, *filename;
+
+      _stop_proxy_pipeline (job);
+      g_signal_emit (job->project, _signals[PROXY_CREATION_PROGRESS_SIGNAL], 0,
+          job->parent, 1.0);
+
+      partfilename = g_filename_from_uri (job->part_uri, NULL, NULL);
+      filename = g_filename_from_uri (job->proxy_uri, NULL, NULL);
+      if (partfilename && filename && g_rename (partfilename, filename) == 0) {
+        g_free (job->part_uri);
+        job->part_uri = NULL;
+      } else {
+        GST_WARNING_OBJECT (job->project, "Could not move %s to %s",
+            job->part_uri, job->proxy_uri);
+      }
+      g_free (partfilename);
+      g_free (filename);
 
-        priv->proxy_uri = gst_filename_to_uri (newfilename, NULL);
+      if (job->part_uri) {
+        _proxy_job_done (job);
+        break;
       }
 
-      extractable_type = ges_asset_get_extractable_type (priv->proxy_asset);
-      ges_asset_needs_reload (extractable_type, priv->proxy_uri);
-      _create_proxy_asset (project, priv->proxy_uri, extractable_type);
+      /* Mark it as transcoded so we do not try again if it fails */
+      job->transcoded = TRUE;
+      ges_asset_needs_reload (ges_asset_get_extractable_type (job->parent),
+          job->proxy_uri);
+      _request_proxy_asset (job);
 
       break;
     }
@@ -819,141 +988,165 @@ bus_message_cb (GstBus * bus, GstMessage * message, GESProject * project)
   }
 }
 
-#if 0
-static gboolean
-_proxy_exists (GESProject * project, GESAsset * asset)
-{
-  gchar *outuri;
-  const gchar *uri;
-  gboolean proxy_exists = FALSE;
-
-  g_return_val_if_fail (GES_IS_PROJECT (project), FALSE);
-
-  uri = ges_asset_get_id (GES_ASSET (asset));
-  outuri = _get_outuri (project, uri);
-
-  proxy_exists =
-      g_file_test (g_filename_from_uri (outuri, NULL, NULL),
-      G_FILE_TEST_EXISTS);
-
-  return proxy_exists;
-}
-#endif
-
 static gboolean
-_transcode (GESProject * project, GESAsset * asset)
+_transcode (ProxyJob * job)
 {
   GstElement *pipeline, *src, *ebin, *sink;
   GstEncodingProfile *profile;
   GstBus *bus;
-  GESProjectPrivate *priv;
-  gchar *outuri;
-  const gchar *uri;
+  GESProjectPrivate *priv = job->project->priv;
 
-  g_return_val_if_fail (GES_IS_PROJECT (project), FALSE);
+  if (job->transcoded)
+    return FALSE;
 
-  priv = project->priv;
-  profile = priv->proxy_profile;
+  profile = ges_project_get_proxy_profile (job->project,
+      GES_URI_CLIP_ASSET (job->parent));
+  if (profile == NULL)
+    profile = priv->proxy_profile;
 
-  uri = ges_asset_get_id (GES_ASSET (asset));
-  outuri = _get_outuri (project, uri);
-  outuri = g_strconcat (g_strdup (outuri), ".part", NULL);
-  priv->proxy_uri = outuri;
-  priv->proxy_asset = asset;
+  if (profile == NULL) {
+    GST_WARNING_OBJECT (job->project, "No profile to create proxy for %s",
+        ges_asset_get_id (job->parent));
+    return FALSE;
+  }
+
+  job->part_uri = g_strconcat (job->proxy_uri, ".part", NULL);
 
   pipeline = gst_pipeline_new ("encoding-pipeline");
-  priv->proxy_pipeline = pipeline;
   src = gst_element_factory_make ("uridecodebin", NULL);
-
   ebin = gst_element_factory_make ("encodebin", NULL);
-  sink = gst_element_make_from_uri (GST_URI_SINK, outuri, "sink", NULL);
+  sink = gst_element_make_from_uri (GST_URI_SINK, job->part_uri, "sink",
+      NULL);
+
+  if (!src || !ebin || !sink) {
+    GST_ERROR_OBJECT (job->project, "Could not create transcoding elements");
+    gst_object_unref (pipeline);
+    if (src)
+      gst_object_unref (src);
+    if (ebin)
+      gst_object_unref (ebin);
+    if (sink)
+      gst_object_unref (sink);
+
+    return FALSE;
+  }
 
-  g_object_set (src, "uri", uri, NULL);
+  g_object_set (src, "uri", ges_asset_get_id (job->parent), NULL);
   g_object_set (ebin, "profile", profile, NULL);
 
   g_signal_connect (src, "pad-added", G_CALLBACK (pad_added_cb), ebin);
 
   gst_bin_add_many (GST_BIN (pipeline), src, ebin, sink, NULL);
   gst_element_link (ebin, sink);
+  job->pipeline = pipeline;
 
   bus = gst_pipeline_get_bus ((GstPipeline *) pipeline);
   gst_bus_add_signal_watch (bus);
-  g_signal_connect (bus, "message", G_CALLBACK (bus_message_cb), project);
+  g_signal_connect (bus, "message", G_CALLBACK (bus_message_cb), job);
+  gst_object_unref (bus);
+
+  if (gst_element_set_state (pipeline, priv->proxies_paused ?
+          GST_STATE_PAUSED : GST_STATE_PLAYING) == GST_STATE_CHANGE_FAILURE) {
+    GST_ERROR_OBJECT (job->project, "Could not set pipeline state to PLAYING");
+    _stop_proxy_pipeline (job);
 
-  if (gst_element_set_state (pipeline,
-          GST_STATE_PLAYING) == GST_STATE_CHANGE_FAILURE) {
-    GST_ERROR ("Could not set pipeline state to PLAYING");
     return FALSE;
   }
 
+  job->progress_id = g_timeout_add (PROXY_PROGRESS_INTERVAL,
+      (GSourceFunc) _proxy_progress_cb, job);
+
   return TRUE;
 }
 
-static GList *
-_get_create_proxies_list (GESProject * project)
+/* Starts as many proxy jobs as allowed by max-concurrent-proxies */
+static void
+_schedule_proxy_jobs (GESProject * project)
 {
-  GList *ret = NULL;
-  GHashTableIter iter;
-  gpointer key, value;
+  GESProjectPrivate *priv = project->priv;
 
-  g_return_val_if_fail (GES_IS_PROJECT (project), NULL);
+  while (!priv->proxies_paused && !g_queue_is_empty (priv->pending_proxies) &&
+      g_list_length (priv->proxy_jobs) < priv->max_concurrent_proxies) {
+    ProxyJob *job = g_slice_new0 (ProxyJob);
 
-  g_hash_table_iter_init (&iter, project->priv->assets);
-  while (g_hash_table_iter_next (&iter, &key, &value)) {
-    if (GES_IS_URI_CLIP_ASSET (GES_ASSET (value))) {
-      ret = g_list_append (ret, gst_object_ref (value));
-    }
+    job->project = gst_object_ref (project);
+    job->parent = g_queue_pop_head (priv->pending_proxies);
+    job->proxy_uri = _get_outuri (project, ges_asset_get_id (job->parent));
+
+    GST_DEBUG_OBJECT (project, "Creating proxy %s for %s", job->proxy_uri,
+        ges_asset_get_id (job->parent));
+
+    priv->proxy_jobs = g_list_prepend (priv->proxy_jobs, job);
+    _request_proxy_asset (job);
   }
 
-  return ret;
+  if (priv->proxies_creation_started && priv->proxy_jobs == NULL &&
+      g_queue_is_empty (priv->pending_proxies)) {
+    priv->proxies_creation_started = FALSE;
+    priv->proxies_created = TRUE;
+    g_signal_emit (project, _signals[PROXIES_CREATED_SIGNAL], 0, NULL);
+  }
 }
 
+/* Returns %TRUE if something was being done */
 static gboolean
-_create_proxies (GESProject * project)
+_cancel_proxy_jobs (GESProject * project)
 {
-  GstEncodingProfile *profile;
-  GESProjectPrivate *priv;
-  GESAsset *asset;
-  gchar *outuri;
-  const gchar *uri;
-  GType extractable_type;
-  GList *cur_proxy;
+  GList *tmp;
+  GESProjectPrivate *priv = project->priv;
+  gboolean had_jobs = priv->proxy_jobs ||
+      !g_queue_is_empty (priv->pending_proxies);
 
-  g_return_val_if_fail (GES_IS_PROJECT (project), FALSE);
+  g_queue_foreach (priv->pending_proxies, (GFunc) gst_object_unref, NULL);
+  g_queue_clear (priv->pending_proxies);
 
-  priv = project->priv;
-  profile = ges_project_get_proxy_profile (project, NULL);
+  for (tmp = priv->proxy_jobs; tmp; tmp = tmp->next) {
+    ProxyJob *job = tmp->data;
 
-  if (GST_IS_ENCODING_PROFILE (profile)) {
+    /* The asset request callback will free it */
+    if (job->requesting)
+      job->cancelled = TRUE;
+    else
+      _proxy_job_free (job);
+  }
+  g_list_free (priv->proxy_jobs);
+  priv->proxy_jobs = NULL;
+  priv->proxies_paused = FALSE;
+  priv->proxies_creation_started = FALSE;
 
-    if (priv->proxies_creation_started == FALSE) {
-      priv->proxies_creation_started = TRUE;
-      g_signal_emit (project, _signals[PROXIES_CREATION_STARTED_SIGNAL], 0,
-          NULL);
-    }
+  return had_jobs;
+}
+
+static void
+_create_proxies (GESProject * project)
+{
+  GHashTableIter iter;
+  gpointer key, value;
+  GESProjectPrivate *priv = project->priv;
 
-    priv->create_proxies = _get_create_proxies_list (project);
+  if (!GST_IS_ENCODING_PROFILE (priv->proxy_profile))
+    return;
 
-    cur_proxy = g_list_last (priv->create_proxies);
-    if (cur_proxy) {
-      asset = cur_proxy->data;
-      uri = ges_asset_get_id (asset);
-      outuri = _get_outuri (project, uri);
-      extractable_type = ges_asset_get_extractable_type (asset);
-      priv->proxy_parent = asset;
-      priv->proxy_uri = (gchar *) uri;
-      priv->create_proxies = cur_proxy;
+  if (priv->proxies_creation_started == FALSE) {
+    priv->proxies_creation_started = TRUE;
+    g_signal_emit (project, _signals[PROXIES_CREATION_STARTED_SIGNAL], 0,
+        NULL);
+  }
 
-      _create_proxy_asset (project, outuri, extractable_type);
-    } else {
-      priv->proxies_created = TRUE;
-      g_signal_emit (project, _signals[PROXIES_CREATED_SIGNAL], 0, NULL);
-    }
+  g_hash_table_iter_init (&iter, priv->assets);
+  while (g_hash_table_iter_next (&iter, &key, &value)) {
+    gchar *outuri;
 
-    gst_object_unref (profile);
+    if (!GES_IS_URI_CLIP_ASSET (value))
+      continue;
+
+    outuri = _get_outuri (project, key);
+    if (g_hash_table_lookup (priv->proxies, outuri) == NULL)
+      g_queue_push_tail (priv->pending_proxies, gst_object_ref (value));
+    g_free (outuri);
   }
 
-  return TRUE;
+  _schedule_proxy_jobs (project);
 }
 
 /**
@@ -982,6 +1175,18 @@ ges_project_set_loaded (GESProject * project, GESFormatter * formatter)
   return TRUE;
 }
 
+GCancellable *
+ges_project_get_load_cancellable (GESProject * project)
+{
+  return project->priv->load_cancellable;
+}
+
+void
+ges_project_emit_loading_progress (GESProject * project, gdouble progress)
+{
+  g_signal_emit (project, _signals[LOADING_PROGRESS_SIGNAL], 0, progress);
+}
+
 void
 ges_project_add_loading_asset (GESProject * project, GType extractable_type,
     const gchar * id)
@@ -1179,38 +1384,17 @@ ges_project_list_proxies (GESProject * project, GType filter)
   return ret;
 }
 
-/**
- * ges_project_save:
- * @project: A #GESProject to save
- * @timeline: The #GESTimeline to save, it must have been extracted from @project
- * @uri: The uri where to save @project and @timeline
- * @formatter_asset: (allow-none): The formatter asset to use or %NULL. If %NULL,
- * will try to save in the same format as the one from which the timeline as been loaded
- * or default to the formatter with highest rank
- * @overwrite: %TRUE to overwrite file if it exists
- * @error: (out) (allow-none): An error to be set in case something wrong happens or %NULL
- *
- * Save the timeline of @project to @uri. You should make sure that @timeline
- * is one of the timelines that have been extracted from @project
- * (using ges_asset_extract (@project);)
- *
- * Returns: %TRUE if the project could be save, %FALSE otherwize
- */
-gboolean
-ges_project_save (GESProject * project, GESTimeline * timeline,
+/* Saves to @uri, or only serializes to @stream if not %NULL, in which case
+ * the URI of @project is left for the caller to set once written */
+static gboolean
+_save_project (GESProject * project, GESTimeline * timeline,
     const gchar * uri, GESAsset * formatter_asset, gboolean overwrite,
-    GError ** error)
+    GOutputStream * stream, GError ** error)
 {
   GESAsset *tl_asset;
   gboolean ret = TRUE;
   GESFormatter *formatter = NULL;
 
-  g_return_val_if_fail (GES_IS_PROJECT (project), FALSE);
-  g_return_val_if_fail (formatter_asset == NULL ||
-      g_type_is_a (ges_asset_get_extractable_type (formatter_asset),
-          GES_TYPE_FORMATTER), FALSE);
-  g_return_val_if_fail ((error == NULL || *error == NULL), FALSE);
-
   tl_asset = ges_extractable_get_asset (GES_EXTRACTABLE (timeline));
   if (tl_asset == NULL && project->priv->uri == NULL) {
     GESAsset *asset = ges_asset_cache_lookup (GES_TYPE_PROJECT, uri);
@@ -1247,9 +1431,19 @@ ges_project_save (GESProject * project, GESTimeline * timeline,
   }
 
   ges_project_add_formatter (project, formatter);
-  ret = ges_formatter_save_to_uri (formatter, timeline, uri, overwrite, error);
-  if (ret && project->priv->uri == NULL)
-    ges_project_set_uri (project, uri);
+  if (stream == NULL) {
+    ret = ges_formatter_save_to_uri (formatter, timeline, uri, overwrite,
+        error);
+    if (ret && project->priv->uri == NULL)
+      ges_project_set_uri (project, uri);
+  } else if (GES_FORMATTER_GET_CLASS (formatter)->save_to_stream) {
+    ret = GES_FORMATTER_GET_CLASS (formatter)->save_to_stream (formatter,
+        timeline, stream, error);
+  } else {
+    g_set_error (error, G_IO_ERROR, G_IO_ERROR_NOT_SUPPORTED,
+        "%s can not save to a stream", ges_asset_get_id (formatter_asset));
+    ret = FALSE;
+  }
 
 out:
   if (formatter_asset)
@@ -1259,6 +1453,50 @@ out:
   return ret;
 }
 
+/**
+ * ges_project_save:
+ * @project: A #GESProject to save
+ * @timeline: The #GESTimeline to save, it must have been extracted from @project
+ * @uri: The uri where to save @project and @timeline
+ * @formatter_asset: (allow-none): The formatter asset to use or %NULL. If %NULL,
+ * will try to save in the same format as the one from which the timeline as been loaded
+ * or default to the formatter with highest rank
+ * @overwrite: %TRUE to overwrite file if it exists
+ * @error: (out) (allow-none): An error to be set in case something wrong happens or %NULL
+ *
+ * Save the timeline of @project to @uri. You should make sure that @timeline
+ * is one of the timelines that have been extracted from @project
+ * (using ges_asset_extract (@project);)
+ *
+ * Returns: %TRUE if the project could be save, %FALSE otherwize
+ */
+gboolean
+ges_project_save (GESProject * project, GESTimeline * timeline,
+    const gchar * uri, GESAsset * formatter_asset, gboolean overwrite,
+    GError ** error)
+{
+  g_return_val_if_fail (GES_IS_PROJECT (project), FALSE);
+  g_return_val_if_fail (formatter_asset == NULL ||
+      g_type_is_a (ges_asset_get_extractable_type (formatter_asset),
+          GES_TYPE_FORMATTER), FALSE);
+  g_return_val_if_fail ((error == NULL || *error == NULL), FALSE);
+
+  return _save_project (project, timeline, uri, formatter_asset, overwrite,
+      NULL, error);
+}
+
+/* Serializes @timeline as ges_project_save() would save it to @uri, into
+ * @stream. Fails with G_IO_ERROR_NOT_SUPPORTED if the formatter can only
+ * write to URIs */
+gboolean
+ges_project_save_to_stream (GESProject * project, GESTimeline * timeline,
+    const gchar * uri, GESAsset * formatter_asset, GOutputStream * stream,
+    GError ** error)
+{
+  return _save_project (project, timeline, uri, formatter_asset, FALSE,
+      stream, error);
+}
+
 /**
  * ges_project_new:
  * @uri: (allow-none): The uri to be set after creating the project.
@@ -1301,13 +1539,46 @@ ges_project_new (const gchar * uri)
 gboolean
 ges_project_load (GESProject * project, GESTimeline * timeline, GError ** error)
 {
+  return ges_project_load_with_cancellable (project, timeline, NULL, error);
+}
+
+/**
+ * ges_project_load_with_cancellable:
+ * @project: A #GESProject that has an @uri set already
+ * @timeline: A blank timeline to load @project into
+ * @cancellable: (allow-none): A #GCancellable to cancel the parsing of the
+ * project file, or %NULL
+ * @error: (out) (allow-none): An error to be set in case something wrong happens or %NULL
+ *
+ * Loads @project into @timeline, as ges_project_load() does. The project
+ * file is read and parsed in chunks, emitting #GESProject::loading-progress
+ * along the way, and cancelling @cancellable (from another thread or from
+ * a #GESProject::loading-progress handler) aborts the parsing, in which case
+ * %FALSE is returned and @error is set to %G_IO_ERROR_CANCELLED.
+ *
+ * Returns: %TRUE if the project could be loaded %FALSE otherwize.
+ */
+gboolean
+ges_project_load_with_cancellable (GESProject * project,
+    GESTimeline * timeline, GCancellable * cancellable, GError ** error)
+{
+  gboolean res;
+
   g_return_val_if_fail (GES_IS_TIMELINE (timeline), FALSE);
   g_return_val_if_fail (GES_IS_PROJECT (project), FALSE);
   g_return_val_if_fail (ges_project_get_uri (project), FALSE);
   g_return_val_if_fail (
       (ges_extractable_get_asset (GES_EXTRACTABLE (timeline)) == NULL), FALSE);
+  g_return_val_if_fail (cancellable == NULL
+      || G_IS_CANCELLABLE (cancellable), FALSE);
+
+  if (cancellable)
+    project->priv->load_cancellable = g_object_ref (cancellable);
+
+  res = _load_project (project, timeline, error);
+  g_clear_object (&project->priv->load_cancellable);
 
-  if (!_load_project (project, timeline, error))
+  if (!res)
     return FALSE;
 
   ges_extractable_set_asset (GES_EXTRACTABLE (timeline), GES_ASSET (project));
@@ -1501,25 +1772,16 @@ ges_project_get_proxy_profile (GESProject * project, GESUriClipAsset * asset)
   return priv->proxy_profile;
 }
 
-static gboolean
+static void
 project_start_proxies_cancalled_cb (GCancellable * cancellable,
     GESProject * project)
 {
-  GESProjectPrivate *priv;
-
-  priv = project->priv;
-
-  if (!GST_IS_ELEMENT (priv->proxy_pipeline)) {
-    GST_DEBUG_OBJECT (project, "Project haven't pipeline");
-    return FALSE;
+  if (!_cancel_proxy_jobs (project)) {
+    GST_DEBUG_OBJECT (project, "Project is not creating proxies");
+    return;
   }
 
-  gst_element_set_state (priv->proxy_pipeline, GST_STATE_NULL);
-  gst_object_unref (priv->proxy_pipeline);
-
   g_signal_emit (project, _signals[PROXIES_CREATION_CANCELLED_SIGNAL], 0, NULL);
-
-  return TRUE;
 }
 
 /**
@@ -1528,12 +1790,15 @@ project_start_proxies_cancalled_cb (GCancellable * cancellable,
  * @asset: (allow-none) The #GESUriClipAsset.
  * @cancellable: (allow-none) optional #GCancellable object, NULL to ignore. 
  * Method to start create proxies for proxy editing. If asset is NULL, it means start creation of all proxies.
+ * Up to #GESProject:max-concurrent-proxies proxies are created at the same time.
+ * If the creation was paused, this resumes it.
  * Returns: %TRUE if the creation was started, else %FALSE.
  */
 gboolean
 ges_project_start_proxy_creation (GESProject * project, GESUriClipAsset * asset,
     GCancellable * cancellable)
 {
+  GList *tmp;
   GESProjectPrivate *priv;
 
   g_return_val_if_fail (GES_IS_PROJECT (project), FALSE);
@@ -1542,38 +1807,49 @@ ges_project_start_proxy_creation (GESProject * project, GESUriClipAsset * asset,
 
   if (cancellable) {
     g_return_val_if_fail (G_IS_CANCELLABLE (cancellable), FALSE);
-    g_cancellable_connect (cancellable,
+
+    if (priv->proxies_cancellable) {
+      g_cancellable_disconnect (priv->proxies_cancellable,
+          priv->proxies_cancelled_id);
+      g_object_unref (priv->proxies_cancellable);
+    }
+    priv->proxies_cancellable = g_object_ref (cancellable);
+    priv->proxies_cancelled_id = g_cancellable_connect (cancellable,
         (GCallback) project_start_proxies_cancalled_cb, project, NULL);
   }
 
-  if (GST_IS_ELEMENT (priv->proxy_pipeline)) {
-    if (gst_element_set_state (priv->proxy_pipeline,
-            GST_STATE_PLAYING) == GST_STATE_CHANGE_FAILURE) {
-      return FALSE;
+  if (priv->proxies_paused) {
+    priv->proxies_paused = FALSE;
+    for (tmp = priv->proxy_jobs; tmp; tmp = tmp->next) {
+      ProxyJob *job = tmp->data;
+
+      if (job->pipeline && gst_element_set_state (job->pipeline,
+              GST_STATE_PLAYING) == GST_STATE_CHANGE_FAILURE)
+        return FALSE;
     }
+    _schedule_proxy_jobs (project);
+
     return TRUE;
   }
 
   if (asset) {
-    GstEncodingProfile *profile;
-
     g_return_val_if_fail (GES_IS_URI_CLIP_ASSET (asset), FALSE);
 
-    profile = ges_project_get_proxy_profile (project, asset);
-    if (profile == NULL) {
+    if (ges_project_get_proxy_profile (project, asset) == NULL &&
+        priv->proxy_profile == NULL) {
       GST_DEBUG_OBJECT (project, "Project haven't asset: %s",
           ges_asset_get_id (GES_ASSET (asset)));
       return FALSE;
     }
 
-    if (GES_IS_URI_CLIP_ASSET (asset)) {
-      _transcode (project, GES_ASSET (asset));
+    if (priv->proxies_creation_started == FALSE) {
+      priv->proxies_creation_started = TRUE;
+      g_signal_emit (project, _signals[PROXIES_CREATION_STARTED_SIGNAL], 0,
+          NULL);
     }
 
-    gst_object_unref (profile);
-    if (cancellable) {
-      g_cancellable_disconnect (cancellable, 0);
-    }
+    g_queue_push_head (priv->pending_proxies, gst_object_ref (asset));
+    _schedule_proxy_jobs (project);
 
     return TRUE;
   }
@@ -1589,10 +1865,6 @@ ges_project_start_proxy_creation (GESProject * project, GESUriClipAsset * asset,
         "Can't start proxy creation. Project loading assets");
   }
 
-  if (cancellable) {
-    g_cancellable_disconnect (cancellable, 0);
-  }
-
   return TRUE;
 }
 
@@ -1637,13 +1909,26 @@ ges_project_start_proxy_creation_async (GESProject * project,
 gboolean
 ges_project_pause_proxy_creation (GESProject * project)
 {
+  GList *tmp;
+  GESProjectPrivate *priv;
+
   g_return_val_if_fail (GES_IS_PROJECT (project), FALSE);
 
-  if (gst_element_set_state (project->priv->proxy_pipeline,
-          GST_STATE_PAUSED) == GST_STATE_CHANGE_FAILURE) {
+  priv = project->priv;
+  if (priv->proxy_jobs == NULL) {
+    GST_DEBUG_OBJECT (project, "Project is not creating proxies");
     return FALSE;
   }
 
+  priv->proxies_paused = TRUE;
+  for (tmp = priv->proxy_jobs; tmp; tmp = tmp->next) {
+    ProxyJob *job = tmp->data;
+
+    if (job->pipeline && gst_element_set_state (job->pipeline,
+            GST_STATE_PAUSED) == GST_STATE_CHANGE_FAILURE)
+      return FALSE;
+  }
+
   g_signal_emit (project, _signals[PROXIES_CREATION_PAUSED_SIGNAL], 0, NULL);
 
   return TRUE;
@@ -1672,18 +1957,18 @@ ges_project_pause_proxy_creation_async (GESProject * project,
  * ges_project_get_proxy_state:
  * @project: (transfer none) The #GESProject to get.
  * Method to get #GstState for proxy editing.
- * Returns: (transfer full) The #GstState used for proxy edition in project.
+ * Returns: #GST_STATE_PLAYING if proxies are being created,
+ * #GST_STATE_PAUSED if their creation is paused and #GST_STATE_NULL otherwise.
  */
 GstState
 ges_project_get_proxy_state (GESProject * project)
 {
-  GstState state;
-  g_return_val_if_fail (GES_IS_PROJECT (project), FALSE);
+  g_return_val_if_fail (GES_IS_PROJECT (project), GST_STATE_NULL);
 
-  gst_element_get_state (project->priv->proxy_pipeline, &state, NULL,
-      GST_CLOCK_TIME_NONE);
+  if (project->priv->proxy_jobs == NULL)
+    return GST_STATE_NULL;
 
-  return state;
+  return project->priv->proxies_paused ? GST_STATE_PAUSED : GST_STATE_PLAYING;
 }
 
 /**
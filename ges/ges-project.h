@@ -93,6 +93,10 @@ gboolean  ges_project_save         (GESProject * project,
 gboolean  ges_project_load         (GESProject * project,
                                     GESTimeline * timeline,
                                     GError **error);
+gboolean  ges_project_load_with_cancellable (GESProject * project,
+                                             GESTimeline * timeline,
+                                             GCancellable * cancellable,
+                                             GError **error);
 GESProject * ges_project_new       (const gchar *uri);
 gchar      * ges_project_get_uri   (GESProject *project);
 GESAsset   * ges_project_get_asset (GESProject * project,
@@ -44,14 +44,37 @@ static void
 clip_height_changed_cb (GESClip * clip G_GNUC_UNUSED,
     GParamSpec * arg G_GNUC_UNUSED, GESSimpleLayer * layer);
 
+static void clip_duration_changed_cb (GESClip * clip,
+    GParamSpec * arg G_GNUC_UNUSED, GESSimpleLayer * layer);
+
 static GList *get_objects (GESLayer * layer);
 
 G_DEFINE_TYPE (GESSimpleLayer, ges_simple_layer, GES_TYPE_LAYER);
 
 struct _GESSimpleLayerPrivate
 {
-  /* Sorted list of objects */
-  GList *objects;
+  /* Sorted sequence of objects, a balanced tree so that accessing
+   * an object by position and getting the position of an object
+   * are O(log n) */
+  GSequence *objects;
+
+  /* {GESClip -> GSequenceIter} */
+  GHashTable *iters;
+
+  /* Number of transitions in @objects, the validity only needs to be
+   * checked when there is at least one */
+  guint n_transitions;
+
+  /* Set of the transitions breaking one of the rules of
+   * gstl_check_transition(), the layer being valid when it is empty */
+  GHashTable *invalid_transitions;
+
+  /* The starts of the objects are the prefix sums of their durations. They
+   * are only computed again from the first position they were invalidated
+   * at, right away or, inside an edit transaction of the timeline, once it
+   * ends. G_MAXINT when they are up to date */
+  gint dirty_from;
+  gint dirty_to;
 
   gboolean adding_object;
   gboolean valid;
@@ -81,6 +104,7 @@ ges_simple_layer_get_property (GObject * object,
 
   switch (property_id) {
     case PROP_VALID:
+      _ges_simple_layer_flush (self);
       g_value_set_boolean (value, self->priv->valid);
       break;
     default:
@@ -98,6 +122,18 @@ ges_simple_layer_set_property (GObject * object, guint property_id,
   }
 }
 
+static void
+ges_simple_layer_finalize (GObject * object)
+{
+  GESSimpleLayerPrivate *priv = GES_SIMPLE_LAYER (object)->priv;
+
+  g_sequence_free (priv->objects);
+  g_hash_table_unref (priv->iters);
+  g_hash_table_unref (priv->invalid_transitions);
+
+  G_OBJECT_CLASS (ges_simple_layer_parent_class)->finalize (object);
+}
+
 static void
 ges_simple_layer_class_init (GESSimpleLayerClass * klass)
 {
@@ -106,6 +142,7 @@ ges_simple_layer_class_init (GESSimpleLayerClass * klass)
 
   g_type_class_add_private (klass, sizeof (GESSimpleLayerPrivate));
 
+  object_class->finalize = ges_simple_layer_finalize;
   object_class->get_property = ges_simple_layer_get_property;
   object_class->set_property = ges_simple_layer_set_property;
 
@@ -149,36 +186,153 @@ ges_simple_layer_init (GESSimpleLayer * self)
   self->priv = G_TYPE_INSTANCE_GET_PRIVATE (self,
       GES_TYPE_SIMPLE_LAYER, GESSimpleLayerPrivate);
 
-  self->priv->objects = NULL;
+  self->priv->objects = g_sequence_new (NULL);
+  self->priv->iters = g_hash_table_new (g_direct_hash, g_direct_equal);
+  self->priv->invalid_transitions = g_hash_table_new (g_direct_hash,
+      g_direct_equal);
+  self->priv->dirty_from = self->priv->dirty_to = G_MAXINT;
+}
+
+/* Checks the rules a transition at @iter has to follow, they only involve
+ * its neighbours and the previous transition */
+static gboolean
+gstl_check_transition (GSequenceIter * iter)
+{
+  GSequenceIter *prev, *next;
+  GESClip *prev_object, *clip = g_sequence_get (iter);
+  guint64 dur = _DURATION (clip);
+
+  if (g_sequence_iter_is_begin (iter)) {
+    GST_ERROR ("the layer starts with a transition!");
+    return FALSE;
+  }
+
+  prev = g_sequence_iter_prev (iter);
+  prev_object = g_sequence_get (prev);
+  if (GES_IS_BASE_TRANSITION_CLIP (prev_object)) {
+    GST_ERROR ("two transitions in sequence!");
+    return FALSE;
+  }
+
+  if (_DURATION (prev_object) < dur) {
+    GST_ERROR ("transition duration exceeds that of previous neighbor!");
+    return FALSE;
+  }
+
+  next = g_sequence_iter_next (iter);
+  if (g_sequence_iter_is_end (next)) {
+    GST_ERROR ("the layer ends with a transition!");
+    return FALSE;
+  }
+
+  if (_DURATION (g_sequence_get (next)) < dur) {
+    GST_ERROR ("transition duration exceeds that of next neighbor!");
+    return FALSE;
+  }
+
+  /* The sources between two transitions follow each other, and the
+   * previous transition ends before the end of the first of them. So it
+   * can only overlap @clip if the source before the previous neighbor
+   * does not end before @clip starts */
+  while (!g_sequence_iter_is_begin (prev)) {
+    prev = g_sequence_iter_prev (prev);
+    prev_object = g_sequence_get (prev);
+
+    if (GES_IS_BASE_TRANSITION_CLIP (prev_object)) {
+      guint64 end = _START (prev_object) + _DURATION (prev_object);
+
+      if (end > _START (clip)) {
+        GST_ERROR ("%" G_GUINT64_FORMAT ", %" G_GUINT64_FORMAT ": "
+            "overlapping transitions!", _START (clip), end);
+        return FALSE;
+      }
+      break;
+    }
+
+    if (_START (prev_object) + _DURATION (prev_object) <= _START (clip))
+      break;
+  }
+
+  return TRUE;
 }
 
+/* Checks again the transitions whose rules involve the objects between
+ * positions @from and @to */
 static void
-gstl_recalculate (GESSimpleLayer * self)
+gstl_update_validity (GESSimpleLayer * self, gint from, gint to)
 {
-  GList *tmp;
+  gint position;
+  gboolean valid;
+  GSequenceIter *iter;
+  GESSimpleLayerPrivate *priv = self->priv;
+
+  if (priv->n_transitions) {
+    /* A transition looks at most at the object after it and three
+     * objects before it */
+    position = MAX (from - 1, 0);
+    iter = g_sequence_get_iter_at_pos (priv->objects, position);
+    for (; !g_sequence_iter_is_end (iter) && position <= to + 3;
+        iter = g_sequence_iter_next (iter), position++) {
+      GESClip *clip = g_sequence_get (iter);
+
+      if (!GES_IS_BASE_TRANSITION_CLIP (clip))
+        continue;
+
+      if (gstl_check_transition (iter))
+        g_hash_table_remove (priv->invalid_transitions, clip);
+      else
+        g_hash_table_add (priv->invalid_transitions, clip);
+    }
+  }
+
+  valid = g_hash_table_size (priv->invalid_transitions) == 0;
+  if (valid != priv->valid) {
+    priv->valid = valid;
+    g_object_notify (G_OBJECT (self), "valid");
+  }
+}
+
+/* Recomputes the start and priority of the objects from position @from,
+ * everything before it being up to date. Once past position @to, stops at
+ * the first source that is already at its place as everything after it
+ * is then up to date too */
+static void
+gstl_recalculate (GESSimpleLayer * self, gint from, gint to)
+{
+  GSequenceIter *iter;
   gint64 pos = 0;
   gint priority = 0;
   gint transition_priority = 0;
-  gint height;
-  GESClip *prev_object = NULL;
-  GESClip *prev_transition = NULL;
-  gboolean valid = TRUE;
+  gint height, position;
+  gboolean done = FALSE;
   GESSimpleLayerPrivate *priv = self->priv;
 
   priority = GES_LAYER (self)->min_gnl_priority;
 
-  GST_DEBUG ("recalculating values");
+  GST_DEBUG ("recalculating values from position %d", from);
+
+  /* Resume from the last source before @from, its values are right */
+  iter = g_sequence_get_iter_at_pos (priv->objects, MAX (from, 0));
+  for (position = g_sequence_iter_get_position (iter); position > 0;
+      position--) {
+    GESClip *clip = g_sequence_get (g_sequence_iter_prev (iter));
+
+    if (GES_IS_SOURCE_CLIP (clip)) {
+      pos = _START (clip) + _DURATION (clip);
+      transition_priority = MAX (0, (gint) _PRIORITY (clip) - 1);
+      priority = _PRIORITY (clip) + GES_CONTAINER_HEIGHT (clip);
+      break;
+    }
 
-  if (priv->objects && GES_IS_BASE_TRANSITION_CLIP (priv->objects->data)) {
-    valid = FALSE;
+    iter = g_sequence_iter_prev (iter);
   }
 
-  for (tmp = priv->objects; tmp; tmp = tmp->next) {
+  for (; !g_sequence_iter_is_end (iter);
+      iter = g_sequence_iter_next (iter), position++) {
     GESClip *clip;
     guint64 dur;
-    GList *l_next;
 
-    clip = (GESClip *) tmp->data;
+    clip = (GESClip *) g_sequence_get (iter);
     dur = _DURATION (clip);
     height = GES_CONTAINER_HEIGHT (clip);
 
@@ -186,6 +340,13 @@ gstl_recalculate (GESSimpleLayer * self)
 
       GST_LOG ("%p clip: height: %d: priority %d", clip, height, priority);
 
+      if (position > to && _START (clip) == pos &&
+          _PRIORITY (clip) == priority) {
+        GST_DEBUG ("Objects are up to date from position %d", position);
+        done = TRUE;
+        break;
+      }
+
       if (G_UNLIKELY (_START (clip) != pos)) {
         _set_start0 (GES_TIMELINE_ELEMENT (clip), pos);
       }
@@ -218,56 +379,88 @@ gstl_recalculate (GESSimpleLayer * self)
       if (G_UNLIKELY (_PRIORITY (clip) != transition_priority)) {
         _set_priority0 (GES_TIMELINE_ELEMENT (clip), transition_priority);
       }
+    }
+  }
 
-      /* sanity checks */
-      l_next = g_list_next (tmp);
+  if (!done) {
+    GST_DEBUG ("Finished recalculating: final start pos is: %" GST_TIME_FORMAT,
+        GST_TIME_ARGS (pos));
 
-      if (GES_IS_BASE_TRANSITION_CLIP (prev_object)) {
-        GST_ERROR ("two transitions in sequence!");
-        valid = FALSE;
-      }
+    GES_LAYER (self)->max_gnl_priority = priority;
+  }
 
-      if (prev_object && (_DURATION (prev_object) < dur)) {
-        GST_ERROR ("transition duration exceeds that of previous neighbor!");
-        valid = FALSE;
-      }
+  gstl_update_validity (self, from, position);
+}
 
-      if (l_next && (_DURATION (l_next->data) < dur)) {
-        GST_ERROR ("transition duration exceeds that of next neighbor!");
-        valid = FALSE;
-      }
+/* Invalidates the starts of the objects from position @from, the ones
+ * after @to being only affected by a shift */
+static void
+gstl_invalidate (GESSimpleLayer * self, gint from, gint to)
+{
+  GESSimpleLayerPrivate *priv = self->priv;
+  GESTimeline *timeline = GES_LAYER (self)->timeline;
 
-      if (prev_transition) {
-        guint64 start, end;
-        end = (_DURATION (prev_transition) + _START (prev_transition));
+  /* The positions of the previous invalidation may have shifted since,
+   * so the early stop can not be used anymore */
+  if (priv->dirty_from != G_MAXINT)
+    to = G_MAXINT;
 
-        start = pos;
+  priv->dirty_from = MIN (priv->dirty_from, from);
+  priv->dirty_to = to;
 
-        if (end > start) {
-          GST_ERROR ("%" G_GUINT64_FORMAT ", %" G_GUINT64_FORMAT ": "
-              "overlapping transitions!", start, end);
-          valid = FALSE;
-        }
-      }
-      prev_transition = clip;
-    }
+  if (timeline == NULL || !timeline_is_editing (timeline))
+    _ges_simple_layer_flush (self);
+}
 
-    prev_object = clip;
+/* Computes the starts that were invalidated, if any */
+void
+_ges_simple_layer_flush (GESSimpleLayer * self)
+{
+  gint from = self->priv->dirty_from, to = self->priv->dirty_to;
 
-  }
+  if (from == G_MAXINT)
+    return;
 
-  if (prev_object && GES_IS_BASE_TRANSITION_CLIP (prev_object)) {
-    valid = FALSE;
-  }
+  self->priv->dirty_from = self->priv->dirty_to = G_MAXINT;
+  gstl_recalculate (self, from, to);
+}
 
-  GST_DEBUG ("Finished recalculating: final start pos is: %" GST_TIME_FORMAT,
-      GST_TIME_ARGS (pos));
+static gint
+gstl_get_position (GESSimpleLayer * self, GESClip * clip)
+{
+  GSequenceIter *iter = g_hash_table_lookup (self->priv->iters, clip);
 
-  GES_LAYER (self)->max_gnl_priority = priority;
+  return iter ? g_sequence_iter_get_position (iter) : -1;
+}
 
-  if (valid != self->priv->valid) {
-    self->priv->valid = valid;
-    g_object_notify (G_OBJECT (self), "valid");
+static void
+gstl_insert (GESSimpleLayer * self, GESClip * clip, gint position)
+{
+  GESSimpleLayerPrivate *priv = self->priv;
+
+  g_hash_table_insert (priv->iters, clip,
+      g_sequence_insert_before (g_sequence_get_iter_at_pos (priv->objects,
+              position), clip));
+
+  if (GES_IS_BASE_TRANSITION_CLIP (clip))
+    priv->n_transitions++;
+}
+
+static void
+gstl_remove (GESSimpleLayer * self, GESClip * clip)
+{
+  GESSimpleLayerPrivate *priv = self->priv;
+  GSequenceIter *iter = g_hash_table_lookup (priv->iters, clip);
+
+  if (iter == NULL)
+    return;
+
+  g_hash_table_remove (priv->iters, clip);
+  g_sequence_remove (iter);
+
+  if (GES_IS_BASE_TRANSITION_CLIP (clip)) {
+    priv->n_transitions--;
+    g_hash_table_remove (priv->invalid_transitions, clip);
   }
 }
 
@@ -295,18 +488,22 @@ ges_simple_layer_add_object (GESSimpleLayer * layer,
     GESClip * clip, gint position)
 {
   gboolean res;
-  GList *nth;
+  GSequenceIter *nth;
   GESSimpleLayerPrivate *priv = layer->priv;
 
   GST_DEBUG ("layer:%p, clip:%p, position:%d", layer, clip, position);
 
-  nth = g_list_nth (priv->objects, position);
+  nth = g_sequence_get_iter_at_pos (priv->objects, position);
+  if (g_sequence_iter_is_end (nth))
+    position = g_sequence_get_length (priv->objects);
 
   if (GES_IS_BASE_TRANSITION_CLIP (clip)) {
-    GList *lprev = g_list_previous (nth);
+    GESClip *prev = NULL, *next = NULL;
 
-    GESClip *prev = GES_CLIP (lprev ? lprev->data : NULL);
-    GESClip *next = GES_CLIP (nth ? nth->data : NULL);
+    if (!g_sequence_iter_is_begin (nth))
+      prev = g_sequence_get (g_sequence_iter_prev (nth));
+    if (!g_sequence_iter_is_end (nth))
+      next = g_sequence_get (nth);
 
     if ((prev && GES_IS_BASE_TRANSITION_CLIP (prev)) ||
         (next && GES_IS_BASE_TRANSITION_CLIP (next))) {
@@ -320,7 +517,7 @@ ges_simple_layer_add_object (GESSimpleLayer * layer,
   priv->adding_object = TRUE;
 
   /* provisionally insert the clip */
-  priv->objects = g_list_insert (priv->objects, clip, position);
+  gstl_insert (layer, clip, position);
 
   res = ges_layer_add_clip ((GESLayer *) layer, clip);
 
@@ -328,7 +525,7 @@ ges_simple_layer_add_object (GESSimpleLayer * layer,
   if (G_UNLIKELY (!res)) {
     priv->adding_object = FALSE;
     /* we failed to add the clip, so remove it from our list */
-    priv->objects = g_list_remove (priv->objects, clip);
+    gstl_remove (layer, clip);
     return FALSE;
   }
 
@@ -341,7 +538,7 @@ ges_simple_layer_add_object (GESSimpleLayer * layer,
       (clip_height_changed_cb), layer);
 
   /* recalculate positions */
-  gstl_recalculate (layer);
+  gstl_invalidate (layer, position, position);
 
   return TRUE;
 }
@@ -360,13 +557,15 @@ ges_simple_layer_add_object (GESSimpleLayer * layer,
 GESClip *
 ges_simple_layer_nth (GESSimpleLayer * layer, gint position)
 {
-  GList *list;
+  GSequenceIter *iter;
   GESSimpleLayerPrivate *priv = layer->priv;
 
-  list = g_list_nth (priv->objects, position);
+  if (position < 0)
+    return NULL;
 
-  if (list)
-    return GES_CLIP (list->data);
+  iter = g_sequence_get_iter_at_pos (priv->objects, position);
+  if (!g_sequence_iter_is_end (iter))
+    return GES_CLIP (g_sequence_get (iter));
 
   return NULL;
 }
@@ -384,8 +583,7 @@ ges_simple_layer_nth (GESSimpleLayer * layer, gint position)
 gint
 ges_simple_layer_index (GESSimpleLayer * layer, GESClip * clip)
 {
-  GESSimpleLayerPrivate *priv = layer->priv;
-  return g_list_index (priv->objects, clip);
+  return gstl_get_position (layer, clip);
 }
 
 /**
@@ -404,7 +602,8 @@ gboolean
 ges_simple_layer_move_object (GESSimpleLayer * layer,
     GESClip * clip, gint newposition)
 {
-  gint idx;
+  gint idx, length;
+  GSequenceIter *iter;
   GESSimpleLayerPrivate *priv = layer->priv;
   GESLayer *clip_layer;
 
@@ -421,26 +620,32 @@ ges_simple_layer_move_object (GESSimpleLayer * layer,
     gst_object_unref (clip_layer);
 
   /* Find it's current position */
-  idx = g_list_index (priv->objects, clip);
-  if (G_UNLIKELY (idx == -1)) {
+  iter = g_hash_table_lookup (priv->iters, clip);
+  if (G_UNLIKELY (iter == NULL)) {
     GST_WARNING ("Clip not controlled by this layer");
     return FALSE;
   }
 
+  idx = g_sequence_iter_get_position (iter);
+
   GST_DEBUG ("Object was previously at position %d", idx);
 
   /* If we don't have to change its position, don't */
   if (idx == newposition)
     return TRUE;
 
-  /* pop it off the list */
-  priv->objects = g_list_remove (priv->objects, clip);
-
-  /* re-add it at the proper position */
-  priv->objects = g_list_insert (priv->objects, clip, newposition);
+  /* Same as popping it off the list and re-adding it at @newposition */
+  length = g_sequence_get_length (priv->objects);
+  if (newposition < 0 || newposition >= length - 1) {
+    g_sequence_move (iter, g_sequence_get_end_iter (priv->objects));
+  } else {
+    g_sequence_move (iter, g_sequence_get_iter_at_pos (priv->objects,
+            newposition < idx ? newposition : newposition + 1));
+  }
 
   /* recalculate positions */
-  gstl_recalculate (layer);
+  gstl_invalidate (layer, MIN (idx, g_sequence_iter_get_position (iter)),
+      MAX (idx, g_sequence_iter_get_position (iter)));
 
   g_signal_emit (layer, gstl_signals[OBJECT_MOVED], 0, clip, idx, newposition);
 
@@ -474,17 +679,27 @@ ges_simple_layer_new (void)
 gboolean
 ges_simple_layer_is_valid (GESSimpleLayer * layer)
 {
+  _ges_simple_layer_flush (layer);
+
   return layer->priv->valid;
 }
 
 static void
 ges_simple_layer_object_removed (GESLayer * layer, GESClip * clip)
 {
+  gint position;
   GESSimpleLayer *sl = (GESSimpleLayer *) layer;
 
+  g_signal_handlers_disconnect_by_func (clip, clip_duration_changed_cb, sl);
+  g_signal_handlers_disconnect_by_func (clip, clip_height_changed_cb, sl);
+
   /* remove clip from our list */
-  sl->priv->objects = g_list_remove (sl->priv->objects, clip);
-  gstl_recalculate (sl);
+  position = gstl_get_position (sl, clip);
+  if (position == -1)
+    return;
+
+  gstl_remove (sl, clip);
+  gstl_invalidate (sl, position, position);
 }
 
 static void
@@ -493,33 +708,49 @@ ges_simple_layer_object_added (GESLayer * layer, GESClip * clip)
   GESSimpleLayer *sl = (GESSimpleLayer *) layer;
 
   if (sl->priv->adding_object == FALSE) {
-    /* remove clip from our list */
-    sl->priv->objects = g_list_append (sl->priv->objects, clip);
-    gstl_recalculate (sl);
+    gint position = g_sequence_get_length (sl->priv->objects);
+
+    /* add clip to the end of our list */
+    gstl_insert (sl, clip, position);
+    gstl_invalidate (sl, position, position);
   }
-  g_signal_connect_swapped (clip, "notify::duration",
-      G_CALLBACK (gstl_recalculate), layer);
+  g_signal_connect (clip, "notify::duration",
+      G_CALLBACK (clip_duration_changed_cb), layer);
+}
+
+static void
+clip_duration_changed_cb (GESClip * clip,
+    GParamSpec * arg G_GNUC_UNUSED, GESSimpleLayer * layer)
+{
+  gint position = gstl_get_position (layer, clip);
+
+  GST_LOG ("layer %p: notify duration changed %p", layer, clip);
+  if (position != -1)
+    gstl_invalidate (layer, position, position);
 }
 
 static void
 clip_height_changed_cb (GESClip * clip,
     GParamSpec * arg G_GNUC_UNUSED, GESSimpleLayer * layer)
 {
+  gint position = gstl_get_position (layer, clip);
+
   GST_LOG ("layer %p: notify height changed %p", layer, clip);
-  gstl_recalculate (layer);
+  if (position != -1)
+    gstl_invalidate (layer, position, position);
 }
 
 static GList *
 get_objects (GESLayer * l)
 {
-  GList *ret;
-  GList *tmp;
+  GList *ret = NULL;
+  GSequenceIter *iter;
   GESSimpleLayer *layer = (GESSimpleLayer *) l;
 
-  ret = g_list_copy (layer->priv->objects);
-
-  for (tmp = ret; tmp; tmp = tmp->next) {
-    gst_object_ref (tmp->data);
+  for (iter = g_sequence_get_end_iter (layer->priv->objects);
+      !g_sequence_iter_is_begin (iter);) {
+    iter = g_sequence_iter_prev (iter);
+    ret = g_list_prepend (ret, gst_object_ref (g_sequence_get (iter)));
   }
 
   return ret;
@@ -46,6 +46,14 @@ typedef struct _PadInfos
   GstPad *mixer_pad;
   GstElement *bin;
   gulong probe_id;
+
+  /* The values last set on mixer_pad, only accessed from the streaming
+   * thread once the probe is installed */
+  gboolean synced;
+  gdouble alpha;
+  gint posx;
+  gint posy;
+  guint zorder;
 } PadInfos;
 
 static void
@@ -66,9 +74,13 @@ destroy_pad (PadInfos * infos)
 }
 
 /* These metadata will get set by the upstream framepositionner element,
-   added in the video sources' bin */
+   added in the video sources' bin.
+
+   The values usually stay the same for many frames, so we only touch the
+   properties of the mixer pad when they actually change, avoiding property
+   lookups, GValue marshalling and notifies on every buffer of every layer */
 static GstPadProbeReturn
-parse_metadata (GstPad * mixer_pad, GstPadProbeInfo * info, gpointer unused)
+parse_metadata (GstPad * mixer_pad, GstPadProbeInfo * info, PadInfos * infos)
 {
   GstFramePositionnerMeta *meta;
 
@@ -81,8 +93,27 @@ parse_metadata (GstPad * mixer_pad, GstPadProbeInfo * info, gpointer unused)
     return GST_PAD_PROBE_OK;
   }
 
-  g_object_set (mixer_pad, "alpha", meta->alpha, "xpos", meta->posx, "ypos",
-      meta->posy, "zorder", meta->zorder, NULL);
+  if (G_LIKELY (infos->synced) && infos->alpha == meta->alpha &&
+      infos->posx == meta->posx && infos->posy == meta->posy &&
+      infos->zorder == meta->zorder)
+    return GST_PAD_PROBE_OK;
+
+  g_object_freeze_notify (G_OBJECT (mixer_pad));
+  if (!infos->synced || infos->alpha != meta->alpha)
+    g_object_set (mixer_pad, "alpha", meta->alpha, NULL);
+  if (!infos->synced || infos->posx != meta->posx)
+    g_object_set (mixer_pad, "xpos", meta->posx, NULL);
+  if (!infos->synced || infos->posy != meta->posy)
+    g_object_set (mixer_pad, "ypos", meta->posy, NULL);
+  if (!infos->synced || infos->zorder != meta->zorder)
+    g_object_set (mixer_pad, "zorder", meta->zorder, NULL);
+  g_object_thaw_notify (G_OBJECT (mixer_pad));
+
+  infos->alpha = meta->alpha;
+  infos->posx = meta->posx;
+  infos->posy = meta->posy;
+  infos->zorder = meta->zorder;
+  infos->synced = TRUE;
 
   return GST_PAD_PROBE_OK;
 }
@@ -138,7 +169,7 @@ _request_new_pad (GstElement * element, GstPadTemplate * templ,
 
   infos->probe_id =
       gst_pad_add_probe (infos->mixer_pad, GST_PAD_PROBE_TYPE_BUFFER,
-      (GstPadProbeCallback) parse_metadata, NULL, NULL);
+      (GstPadProbeCallback) parse_metadata, infos, NULL);
 
   LOCK (self);
   g_hash_table_insert (self->pads_infos, ghost, infos);
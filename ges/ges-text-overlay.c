@@ -60,6 +60,7 @@ static void ges_text_overlay_set_property (GObject * object, guint
     property_id, const GValue * value, GParamSpec * pspec);
 
 static GstElement *ges_text_overlay_create_element (GESTrackElement * self);
+static void ges_text_overlay_release_element (GESTrackElement * self);
 
 static void
 ges_text_overlay_class_init (GESTextOverlayClass * klass)
@@ -75,6 +76,7 @@ ges_text_overlay_class_init (GESTextOverlayClass * klass)
   object_class->finalize = ges_text_overlay_finalize;
 
   bg_class->create_element = ges_text_overlay_create_element;
+  bg_class->release_element = ges_text_overlay_release_element;
 }
 
 static void
@@ -182,6 +184,18 @@ ges_text_overlay_create_element (GESTrackElement * track_element)
   return ret;
 }
 
+static void
+ges_text_overlay_release_element (GESTrackElement * track_element)
+{
+  GESTextOverlay *self = GES_TEXT_OVERLAY (track_element);
+
+  /* The values are kept in @priv and set on the new element */
+  if (self->priv->text_el) {
+    gst_object_unref (self->priv->text_el);
+    self->priv->text_el = NULL;
+  }
+}
+
 /**
  * ges_text_overlay_set_text:
  * @self: the #GESTextOverlay* to set text on
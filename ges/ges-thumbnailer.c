@@ -0,0 +1,851 @@
+/* GStreamer Editing Services
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+/**
+ * SECTION:ges-thumbnailer
+ * @short_description: Generates thumbnails of a timeline or of a media file
+ *
+ * A #GESThumbnailer extracts the frames of a #GESTimeline or of a
+ * #GESUriClipAsset at a list of timestamps. Unlike
+ * ges_pipeline_get_thumbnail(), it does not need a #GESPipeline playing
+ * the timeline: it uses its own decoding pipeline, with no display sink
+ * and no synchronisation on the clock, which only prerolls at each of the
+ * requested timestamps.
+ *
+ * All the frames are scaled and converted in that pipeline to the
+ * #GESThumbnailer:caps, which are only negotiated once for all of them.
+ *
+ * When getting the exact frames of a #GESUriClipAsset with fixed caps, the
+ * thumbnails are first looked up in the media cache of the asset under
+ * these caps, and the ones that had to be decoded are stored there and
+ * written to disk at the end of the batch, see
+ * ges_uri_clip_asset_store_thumbnail().
+ *
+ * |[
+ * GstClockTime timestamps[] = { 0, GST_SECOND, 2 * GST_SECOND };
+ * GESThumbnailer *thumbnailer = ges_thumbnailer_new_for_asset (asset);
+ * GstCaps *caps = gst_caps_from_string ("video/x-raw,format=RGB,width=160,"
+ *     "height=90,pixel-aspect-ratio=1/1");
+ *
+ * ges_thumbnailer_set_caps (thumbnailer, caps);
+ * g_signal_connect (thumbnailer, "thumbnail", G_CALLBACK (thumbnail_cb), NULL);
+ * ges_thumbnailer_get_thumbnails_async (thumbnailer, timestamps, 3, NULL,
+ *     thumbnails_done_cb, NULL);
+ * ]|
+ */
+
+#include "ges-internal.h"
+#include "ges-thumbnailer.h"
+#include "ges.h"
+
+/* How long to wait for the pipeline to preroll */
+#define PREROLL_TIMEOUT (30 * GST_SECOND)
+
+G_DEFINE_TYPE (GESThumbnailer, ges_thumbnailer, G_TYPE_OBJECT);
+
+struct _GESThumbnailerPrivate
+{
+  /* Only one of them is set */
+  GESTimeline *timeline;
+  GESUriClipAsset *asset;
+
+  GMutex lock;
+  GstCaps *caps;
+  gboolean accurate;
+  gboolean busy;
+};
+
+enum
+{
+  PROP_0,
+  PROP_TIMELINE,
+  PROP_ASSET,
+  PROP_CAPS,
+  PROP_ACCURATE,
+  PROP_LAST
+};
+
+static GParamSpec *_properties[PROP_LAST];
+
+enum
+{
+  THUMBNAIL_SIGNAL,
+  LAST_SIGNAL
+};
+
+static guint _signals[LAST_SIGNAL] = { 0 };
+
+/* One call to ges_thumbnailer_get_thumbnails_async() */
+typedef struct
+{
+  GESThumbnailer *thumbnailer;
+  GMainContext *context;
+
+  GstClockTime *timestamps;
+  guint n_timestamps;
+  GstCaps *caps;
+  gboolean accurate;
+
+  /* Whether the thumbnails go to the media cache of the asset, under
+   * @caps */
+  gboolean cacheable;
+  gboolean stored;
+
+  /* Samples in the order of @timestamps, %NULL if not extracted */
+  GPtrArray *samples;
+
+  GstElement *pipeline;
+  GstElement *convert;
+  gboolean linked;
+} ThumbnailsData;
+
+typedef struct
+{
+  GESThumbnailer *thumbnailer;
+  GstClockTime timestamp;
+  GstSample *sample;
+} ThumbnailReady;
+
+static void
+_free_thumbnails_data (ThumbnailsData * data)
+{
+  if (data->samples)
+    g_ptr_array_unref (data->samples);
+  if (data->caps)
+    gst_caps_unref (data->caps);
+  g_main_context_unref (data->context);
+  g_object_unref (data->thumbnailer);
+  g_free (data->timestamps);
+  g_slice_free (ThumbnailsData, data);
+}
+
+static void
+_free_thumbnail_ready (ThumbnailReady * ready)
+{
+  gst_sample_unref (ready->sample);
+  g_object_unref (ready->thumbnailer);
+  g_slice_free (ThumbnailReady, ready);
+}
+
+static gboolean
+_emit_thumbnail (ThumbnailReady * ready)
+{
+  g_signal_emit (ready->thumbnailer, _signals[THUMBNAIL_SIGNAL], 0,
+      ready->timestamp, ready->sample);
+
+  return FALSE;
+}
+
+/* Takes ownership of @sample */
+static void
+_deliver_thumbnail (ThumbnailsData * data, guint index, GstSample * sample)
+{
+  ThumbnailReady *ready = g_slice_new (ThumbnailReady);
+
+  g_ptr_array_index (data->samples, index) = gst_sample_ref (sample);
+
+  ready->thumbnailer = g_object_ref (data->thumbnailer);
+  ready->timestamp = data->timestamps[index];
+  ready->sample = sample;
+  g_main_context_invoke_full (data->context, G_PRIORITY_DEFAULT,
+      (GSourceFunc) _emit_thumbnail, ready,
+      (GDestroyNotify) _free_thumbnail_ready);
+}
+
+/* Delivers the thumbnails already in the media cache of the asset, returns
+ * the number of thumbnails left to decode */
+static guint
+_deliver_cached_thumbnails (ThumbnailsData * data)
+{
+  guint i, missing = 0;
+  GESUriClipAsset *asset = data->thumbnailer->priv->asset;
+
+  if (!data->cacheable)
+    return data->n_timestamps;
+
+  for (i = 0; i < data->n_timestamps; i++) {
+    GList *cached = ges_uri_clip_asset_get_cached_thumbnails (asset,
+        data->caps, data->timestamps[i], data->timestamps[i]);
+
+    if (cached) {
+      _deliver_thumbnail (data, i, cached->data);
+      g_list_free (cached);
+    } else {
+      missing++;
+    }
+  }
+
+  GST_DEBUG_OBJECT (data->thumbnailer, "%u/%u thumbnails in the cache",
+      data->n_timestamps - missing, data->n_timestamps);
+
+  return missing;
+}
+
+/****************************************************
+ *                The decoding pipeline             *
+ ****************************************************/
+static void
+_drain_pad (ThumbnailsData * data, GstPad * pad)
+{
+  GstPad *sinkpad;
+  GstElement *sink = gst_element_factory_make ("fakesink", NULL);
+
+  /* Do not wait for the other streams to preroll */
+  g_object_set (sink, "sync", FALSE, "async", FALSE, NULL);
+  gst_bin_add (GST_BIN (data->pipeline), sink);
+  gst_element_sync_state_with_parent (sink);
+
+  sinkpad = gst_element_get_static_pad (sink, "sink");
+  gst_pad_link (pad, sinkpad);
+  gst_object_unref (sinkpad);
+}
+
+static void
+_link_pad (ThumbnailsData * data, GstPad * pad, gboolean is_video)
+{
+  GstPad *sinkpad;
+
+  if (!is_video || data->linked) {
+    _drain_pad (data, pad);
+
+    return;
+  }
+
+  sinkpad = gst_element_get_static_pad (data->convert, "sink");
+  if (gst_pad_link (pad, sinkpad) == GST_PAD_LINK_OK)
+    data->linked = TRUE;
+  gst_object_unref (sinkpad);
+}
+
+static void
+_timeline_pad_added_cb (GESTimeline * timeline, GstPad * pad,
+    ThumbnailsData * data)
+{
+  GESTrack *track = ges_timeline_get_track_for_pad (timeline, pad);
+
+  _link_pad (data, pad, track && track->type == GES_TRACK_TYPE_VIDEO);
+}
+
+static void
+_decodebin_pad_added_cb (GstElement * decodebin, GstPad * pad,
+    ThumbnailsData * data)
+{
+  GstCaps *caps = gst_pad_query_caps (pad, NULL);
+
+  _link_pad (data, pad, g_str_has_prefix (gst_structure_get_name
+          (gst_caps_get_structure (caps, 0)), "video/"));
+  gst_caps_unref (caps);
+}
+
+static GstElement *
+_make_pipeline (ThumbnailsData * data, GError ** error)
+{
+  GstElement *scale, *sink, *source;
+  GESThumbnailerPrivate *priv = data->thumbnailer->priv;
+
+  data->pipeline = gst_pipeline_new ("ges-thumbnailer");
+  data->convert = gst_element_factory_make ("videoconvert", NULL);
+  scale = gst_element_factory_make ("videoscale", NULL);
+  sink = gst_element_factory_make ("appsink", "sink");
+  if (data->convert == NULL || scale == NULL || sink == NULL) {
+    g_set_error (error, GST_CORE_ERROR, GST_CORE_ERROR_MISSING_PLUGIN,
+        "Could not create the thumbnailing elements");
+
+    return NULL;
+  }
+
+  g_object_set (sink, "sync", FALSE, "enable-last-sample", FALSE, NULL);
+  if (data->caps)
+    g_object_set (sink, "caps", data->caps, NULL);
+  gst_bin_add_many (GST_BIN (data->pipeline), data->convert, scale, sink,
+      NULL);
+  gst_element_link_many (data->convert, scale, sink, NULL);
+
+  if (priv->timeline) {
+    GList *tmp;
+
+    /* The pipeline gets its own reference */
+    source = GST_ELEMENT (priv->timeline);
+    gst_bin_add (GST_BIN (data->pipeline), source);
+    g_signal_connect (source, "pad-added",
+        G_CALLBACK (_timeline_pad_added_cb), data);
+    for (tmp = source->srcpads; tmp; tmp = tmp->next)
+      _timeline_pad_added_cb (priv->timeline, tmp->data, data);
+
+    ges_timeline_commit (priv->timeline);
+  } else {
+    source = gst_element_factory_make ("uridecodebin", NULL);
+    g_object_set (source, "uri", ges_asset_get_id (GES_ASSET (priv->asset)),
+        NULL);
+    g_signal_connect (source, "pad-added",
+        G_CALLBACK (_decodebin_pad_added_cb), data);
+    gst_bin_add (GST_BIN (data->pipeline), source);
+  }
+
+  return sink;
+}
+
+static void
+_release_pipeline (ThumbnailsData * data)
+{
+  GESTimeline *timeline = data->thumbnailer->priv->timeline;
+
+  gst_element_set_state (data->pipeline, GST_STATE_NULL);
+  if (timeline && GST_OBJECT_PARENT (timeline) == GST_OBJECT (data->pipeline)) {
+    g_signal_handlers_disconnect_by_func (timeline, _timeline_pad_added_cb,
+        data);
+    gst_bin_remove (GST_BIN (data->pipeline), GST_ELEMENT (timeline));
+  }
+  gst_object_unref (data->pipeline);
+  data->pipeline = NULL;
+}
+
+/* Waits for the pipeline to be prerolled, getting the error if any */
+static gboolean
+_wait_preroll (ThumbnailsData * data, GError ** error)
+{
+  GstBus *bus;
+  GstMessage *message;
+  GstStateChangeReturn ret;
+
+  ret = gst_element_get_state (data->pipeline, NULL, NULL, PREROLL_TIMEOUT);
+  if (ret != GST_STATE_CHANGE_FAILURE && ret != GST_STATE_CHANGE_ASYNC)
+    return TRUE;
+
+  bus = gst_element_get_bus (data->pipeline);
+  message = gst_bus_pop_filtered (bus, GST_MESSAGE_ERROR);
+  if (message) {
+    gst_message_parse_error (message, error, NULL);
+    gst_message_unref (message);
+  } else {
+    g_set_error (error, GST_CORE_ERROR, GST_CORE_ERROR_STATE_CHANGE,
+        "Could not preroll the thumbnailing pipeline");
+  }
+  gst_object_unref (bus);
+
+  return FALSE;
+}
+
+/* Stores @sample in the media cache under the requested caps, which the
+ * cached thumbnails are looked up with. The negotiated caps can have more
+ * fields than the requested ones, but samples the sink could not convert
+ * to them are not stored */
+static void
+_store_thumbnail (ThumbnailsData * data, GstClockTime timestamp,
+    GstSample * sample)
+{
+  GstSample *stored;
+  GstCaps *caps = gst_sample_get_caps (sample);
+
+  if (caps == NULL || !gst_caps_is_subset (caps, data->caps)) {
+    GST_DEBUG_OBJECT (data->thumbnailer, "Not caching a thumbnail with caps %"
+        GST_PTR_FORMAT, caps);
+
+    return;
+  }
+
+  stored = gst_sample_new (gst_sample_get_buffer (sample), data->caps,
+      NULL, NULL);
+  ges_uri_clip_asset_store_thumbnail (data->thumbnailer->priv->asset,
+      timestamp, stored);
+  gst_sample_unref (stored);
+  data->stored = TRUE;
+}
+
+/* Orders the indexes of the timestamps by timestamp, to only seek
+ * forward */
+static gint
+_compare_timestamps (const guint * a, const guint * b, ThumbnailsData * data)
+{
+  GstClockTime ta = data->timestamps[*a], tb = data->timestamps[*b];
+
+  return ta < tb ? -1 : ta > tb ? 1 : 0;
+}
+
+static void
+_get_thumbnails_in_thread (GSimpleAsyncResult * simple, GObject * object,
+    GCancellable * cancellable)
+{
+  guint i;
+  guint *order;
+  GstElement *sink;
+  GstSeekFlags flags;
+  GError *error = NULL, *save_error = NULL;
+  ThumbnailsData *data = g_simple_async_result_get_op_res_gpointer (simple);
+
+  if (_deliver_cached_thumbnails (data) == 0)
+    goto done;
+
+  sink = _make_pipeline (data, &error);
+  if (sink == NULL)
+    goto done;
+
+  gst_element_set_state (data->pipeline, GST_STATE_PAUSED);
+  if (!_wait_preroll (data, &error))
+    goto done;
+
+  order = g_new (guint, data->n_timestamps);
+  for (i = 0; i < data->n_timestamps; i++)
+    order[i] = i;
+  g_qsort_with_data (order, data->n_timestamps, sizeof (guint),
+      (GCompareDataFunc) _compare_timestamps, data);
+
+  flags = GST_SEEK_FLAG_FLUSH | (data->accurate ? GST_SEEK_FLAG_ACCURATE :
+      GST_SEEK_FLAG_KEY_UNIT | GST_SEEK_FLAG_SNAP_BEFORE);
+  for (i = 0; i < data->n_timestamps; i++) {
+    GstSample *sample = NULL;
+    GstClockTime timestamp = data->timestamps[order[i]];
+
+    if (g_ptr_array_index (data->samples, order[i]))
+      continue;
+
+    if (g_cancellable_set_error_if_cancelled (cancellable, &error))
+      break;
+
+    if (!gst_element_seek_simple (data->pipeline, GST_FORMAT_TIME, flags,
+            timestamp) || !_wait_preroll (data, &error)) {
+      GST_WARNING_OBJECT (data->thumbnailer, "Could not seek to %"
+          GST_TIME_FORMAT, GST_TIME_ARGS (timestamp));
+      if (error)
+        break;
+
+      continue;
+    }
+
+    g_signal_emit_by_name (sink, "pull-preroll", &sample);
+    if (sample == NULL) {
+      GST_INFO_OBJECT (data->thumbnailer, "No frame at %" GST_TIME_FORMAT,
+          GST_TIME_ARGS (timestamp));
+      continue;
+    }
+
+    if (data->cacheable)
+      _store_thumbnail (data, timestamp, sample);
+    _deliver_thumbnail (data, order[i], sample);
+  }
+  g_free (order);
+
+done:
+  if (data->pipeline)
+    _release_pipeline (data);
+
+  if (data->stored && !ges_uri_clip_asset_save_media_cache
+      (data->thumbnailer->priv->asset, &save_error)) {
+    GST_INFO_OBJECT (data->thumbnailer, "Could not save the thumbnails: %s",
+        save_error->message);
+    g_clear_error (&save_error);
+  }
+
+  g_mutex_lock (&data->thumbnailer->priv->lock);
+  data->thumbnailer->priv->busy = FALSE;
+  g_mutex_unlock (&data->thumbnailer->priv->lock);
+
+  if (error)
+    g_simple_async_result_take_error (simple, error);
+}
+
+/****************************************************
+ *              GObject vmethods                    *
+ ****************************************************/
+static void
+_dispose (GObject * object)
+{
+  GESThumbnailerPrivate *priv = GES_THUMBNAILER (object)->priv;
+
+  if (priv->timeline)
+    gst_object_unref (priv->timeline);
+  priv->timeline = NULL;
+  if (priv->asset)
+    g_object_unref (priv->asset);
+  priv->asset = NULL;
+
+  G_OBJECT_CLASS (ges_thumbnailer_parent_class)->dispose (object);
+}
+
+static void
+_finalize (GObject * object)
+{
+  GESThumbnailerPrivate *priv = GES_THUMBNAILER (object)->priv;
+
+  if (priv->caps)
+    gst_caps_unref (priv->caps);
+  g_mutex_clear (&priv->lock);
+
+  G_OBJECT_CLASS (ges_thumbnailer_parent_class)->finalize (object);
+}
+
+static void
+_get_property (GObject * object, guint property_id, GValue * value,
+    GParamSpec * pspec)
+{
+  GESThumbnailer *self = GES_THUMBNAILER (object);
+
+  switch (property_id) {
+    case PROP_TIMELINE:
+      g_value_set_object (value, self->priv->timeline);
+      break;
+    case PROP_ASSET:
+      g_value_set_object (value, self->priv->asset);
+      break;
+    case PROP_CAPS:
+      g_value_take_boxed (value, ges_thumbnailer_get_caps (self));
+      break;
+    case PROP_ACCURATE:
+      g_value_set_boolean (value, ges_thumbnailer_get_accurate (self));
+      break;
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (object, property_id, pspec);
+  }
+}
+
+static void
+_set_property (GObject * object, guint property_id, const GValue * value,
+    GParamSpec * pspec)
+{
+  GESThumbnailer *self = GES_THUMBNAILER (object);
+
+  switch (property_id) {
+    case PROP_TIMELINE:
+      /* Takes over a floating timeline */
+      self->priv->timeline = g_value_get_object (value);
+      if (self->priv->timeline)
+        gst_object_ref_sink (self->priv->timeline);
+      break;
+    case PROP_ASSET:
+      self->priv->asset = g_value_dup_object (value);
+      break;
+    case PROP_CAPS:
+      ges_thumbnailer_set_caps (self, gst_value_get_caps (value));
+      break;
+    case PROP_ACCURATE:
+      ges_thumbnailer_set_accurate (self, g_value_get_boolean (value));
+      break;
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (object, property_id, pspec);
+  }
+}
+
+static void
+ges_thumbnailer_class_init (GESThumbnailerClass * klass)
+{
+  GObjectClass *object_class = G_OBJECT_CLASS (klass);
+
+  g_type_class_add_private (klass, sizeof (GESThumbnailerPrivate));
+
+  object_class->dispose = _dispose;
+  object_class->finalize = _finalize;
+  object_class->get_property = _get_property;
+  object_class->set_property = _set_property;
+
+  /**
+   * GESThumbnailer:timeline:
+   *
+   * The #GESTimeline to get thumbnails of, if any. A floating timeline is
+   * taken over by the thumbnailer.
+   *
+   * The timeline is used exclusively by the thumbnailer while the
+   * thumbnails are being generated: it is added to the decoding pipeline
+   * of the thumbnailer and committed from another thread, so it must not
+   * be in any other pipeline nor be modified or committed meanwhile. It is
+   * removed from that pipeline once done.
+   */
+  _properties[PROP_TIMELINE] = g_param_spec_object ("timeline", "Timeline",
+      "The timeline to get thumbnails of", GES_TYPE_TIMELINE,
+      G_PARAM_READWRITE | G_PARAM_CONSTRUCT_ONLY);
+
+  /**
+   * GESThumbnailer:asset:
+   *
+   * The #GESUriClipAsset to get thumbnails of, if any.
+   */
+  _properties[PROP_ASSET] = g_param_spec_object ("asset", "Asset",
+      "The asset to get thumbnails of", GES_TYPE_URI_CLIP_ASSET,
+      G_PARAM_READWRITE | G_PARAM_CONSTRUCT_ONLY);
+
+  /**
+   * GESThumbnailer:caps:
+   *
+   * The caps the thumbnails are converted and scaled to, %NULL to keep
+   * the decoded format and size.
+   */
+  _properties[PROP_CAPS] = g_param_spec_boxed ("caps", "Caps",
+      "Caps of the thumbnails", GST_TYPE_CAPS, G_PARAM_READWRITE);
+
+  /**
+   * GESThumbnailer:accurate:
+   *
+   * Whether the thumbnails are the frames at the exact requested
+   * timestamps, or the ones of the keyframes right before them, which
+   * are much faster to get.
+   */
+  _properties[PROP_ACCURATE] = g_param_spec_boolean ("accurate", "Accurate",
+      "Whether to get the exact frames instead of the closest keyframes",
+      TRUE, G_PARAM_READWRITE);
+
+  g_object_class_install_properties (object_class, PROP_LAST, _properties);
+
+  /**
+   * GESThumbnailer::thumbnail:
+   * @thumbnailer: the #GESThumbnailer
+   * @timestamp: The requested timestamp
+   * @sample: The #GstSample holding the frame
+   *
+   * Emitted from the main context of the caller of
+   * ges_thumbnailer_get_thumbnails_async() as soon as each thumbnail is
+   * ready.
+   */
+  _signals[THUMBNAIL_SIGNAL] =
+      g_signal_new ("thumbnail", G_TYPE_FROM_CLASS (klass),
+      G_SIGNAL_RUN_LAST, G_STRUCT_OFFSET (GESThumbnailerClass, thumbnail),
+      NULL, NULL, g_cclosure_marshal_generic, G_TYPE_NONE, 2, G_TYPE_UINT64,
+      GST_TYPE_SAMPLE);
+}
+
+static void
+ges_thumbnailer_init (GESThumbnailer * self)
+{
+  self->priv = G_TYPE_INSTANCE_GET_PRIVATE (self, GES_TYPE_THUMBNAILER,
+      GESThumbnailerPrivate);
+
+  g_mutex_init (&self->priv->lock);
+  self->priv->caps = NULL;
+  self->priv->accurate = TRUE;
+  self->priv->busy = FALSE;
+}
+
+/****************************************************
+ *                    API                           *
+ ****************************************************/
+/**
+ * ges_thumbnailer_new_for_timeline:
+ * @timeline: (transfer floating): The #GESTimeline to get thumbnails of
+ *
+ * Creates a new #GESThumbnailer getting its frames out of the video
+ * track of @timeline. See #GESThumbnailer:timeline for how @timeline can
+ * be used while thumbnails are being generated.
+ *
+ * Returns: A new #GESThumbnailer
+ */
+GESThumbnailer *
+ges_thumbnailer_new_for_timeline (GESTimeline * timeline)
+{
+  g_return_val_if_fail (GES_IS_TIMELINE (timeline), NULL);
+
+  return g_object_new (GES_TYPE_THUMBNAILER, "timeline", timeline, NULL);
+}
+
+/**
+ * ges_thumbnailer_new_for_asset:
+ * @asset: The #GESUriClipAsset to get thumbnails of
+ *
+ * Creates a new #GESThumbnailer getting its frames out of the video
+ * stream of the file of @asset.
+ *
+ * Returns: A new #GESThumbnailer
+ */
+GESThumbnailer *
+ges_thumbnailer_new_for_asset (GESUriClipAsset * asset)
+{
+  g_return_val_if_fail (GES_IS_URI_CLIP_ASSET (asset), NULL);
+
+  return g_object_new (GES_TYPE_THUMBNAILER, "asset", asset, NULL);
+}
+
+/**
+ * ges_thumbnailer_set_caps:
+ * @self: a #GESThumbnailer
+ * @caps: (allow-none): The caps of the thumbnails, or %NULL
+ *
+ * Sets the #GESThumbnailer:caps, used from the next call to
+ * ges_thumbnailer_get_thumbnails_async().
+ */
+void
+ges_thumbnailer_set_caps (GESThumbnailer * self, const GstCaps * caps)
+{
+  g_return_if_fail (GES_IS_THUMBNAILER (self));
+
+  g_mutex_lock (&self->priv->lock);
+  if (self->priv->caps)
+    gst_caps_unref (self->priv->caps);
+  self->priv->caps = caps ? gst_caps_copy (caps) : NULL;
+  g_mutex_unlock (&self->priv->lock);
+
+  g_object_notify_by_pspec (G_OBJECT (self), _properties[PROP_CAPS]);
+}
+
+/**
+ * ges_thumbnailer_get_caps:
+ * @self: a #GESThumbnailer
+ *
+ * Returns: (transfer full): The #GESThumbnailer:caps, or %NULL
+ */
+GstCaps *
+ges_thumbnailer_get_caps (GESThumbnailer * self)
+{
+  GstCaps *caps;
+
+  g_return_val_if_fail (GES_IS_THUMBNAILER (self), NULL);
+
+  g_mutex_lock (&self->priv->lock);
+  caps = self->priv->caps ? gst_caps_ref (self->priv->caps) : NULL;
+  g_mutex_unlock (&self->priv->lock);
+
+  return caps;
+}
+
+/**
+ * ges_thumbnailer_set_accurate:
+ * @self: a #GESThumbnailer
+ * @accurate: Whether to get the exact frames
+ *
+ * Sets the #GESThumbnailer:accurate property, used from the next call to
+ * ges_thumbnailer_get_thumbnails_async().
+ */
+void
+ges_thumbnailer_set_accurate (GESThumbnailer * self, gboolean accurate)
+{
+  g_return_if_fail (GES_IS_THUMBNAILER (self));
+
+  g_mutex_lock (&self->priv->lock);
+  self->priv->accurate = accurate;
+  g_mutex_unlock (&self->priv->lock);
+
+  g_object_notify_by_pspec (G_OBJECT (self), _properties[PROP_ACCURATE]);
+}
+
+/**
+ * ges_thumbnailer_get_accurate:
+ * @self: a #GESThumbnailer
+ *
+ * Returns: The #GESThumbnailer:accurate property
+ */
+gboolean
+ges_thumbnailer_get_accurate (GESThumbnailer * self)
+{
+  gboolean accurate;
+
+  g_return_val_if_fail (GES_IS_THUMBNAILER (self), FALSE);
+
+  g_mutex_lock (&self->priv->lock);
+  accurate = self->priv->accurate;
+  g_mutex_unlock (&self->priv->lock);
+
+  return accurate;
+}
+
+/**
+ * ges_thumbnailer_get_thumbnails_async:
+ * @self: a #GESThumbnailer
+ * @timestamps: (array length=n_timestamps): The timestamps to get the frames
+ * at
+ * @n_timestamps: The number of timestamps
+ * @cancellable: (allow-none): A #GCancellable to cancel the operation, or %NULL
+ * @callback: A #GAsyncReadyCallback to call once all the thumbnails are ready
+ * @user_data: The user data to pass to @callback
+ *
+ * Gets the frames at @timestamps from a thread, in the order of the
+ * timestamps. Each of them is notified with the #GESThumbnailer::thumbnail
+ * signal as soon as it is available, and they are all given back by
+ * ges_thumbnailer_get_thumbnails_finish().
+ *
+ * Only one operation can run at a time on a given #GESThumbnailer.
+ */
+void
+ges_thumbnailer_get_thumbnails_async (GESThumbnailer * self,
+    const GstClockTime * timestamps, guint n_timestamps,
+    GCancellable * cancellable, GAsyncReadyCallback callback,
+    gpointer user_data)
+{
+  ThumbnailsData *data;
+  GSimpleAsyncResult *simple;
+  GESThumbnailerPrivate *priv;
+
+  g_return_if_fail (GES_IS_THUMBNAILER (self));
+  g_return_if_fail (timestamps != NULL || n_timestamps == 0);
+
+  priv = self->priv;
+  simple = g_simple_async_result_new (G_OBJECT (self), callback, user_data,
+      ges_thumbnailer_get_thumbnails_async);
+  g_simple_async_result_set_check_cancellable (simple, cancellable);
+
+  g_mutex_lock (&priv->lock);
+  if (priv->busy || (priv->timeline && GST_OBJECT_PARENT (priv->timeline))) {
+    g_mutex_unlock (&priv->lock);
+    g_simple_async_result_set_error (simple, G_IO_ERROR, G_IO_ERROR_BUSY,
+        "The thumbnailer or its timeline is already in use");
+    g_simple_async_result_complete_in_idle (simple);
+    g_object_unref (simple);
+
+    return;
+  }
+  priv->busy = TRUE;
+
+  data = g_slice_new0 (ThumbnailsData);
+  data->thumbnailer = g_object_ref (self);
+  data->context = g_main_context_ref_thread_default ();
+  data->timestamps = g_memdup (timestamps, n_timestamps * sizeof
+      (GstClockTime));
+  data->n_timestamps = n_timestamps;
+  data->caps = priv->caps ? gst_caps_ref (priv->caps) : NULL;
+  data->accurate = priv->accurate;
+  g_mutex_unlock (&priv->lock);
+
+  /* Only the exact frames with fixed caps go to the media cache */
+  data->cacheable = priv->asset && data->accurate && data->caps &&
+      gst_caps_is_fixed (data->caps);
+
+  data->samples = g_ptr_array_new_with_free_func ((GDestroyNotify)
+      gst_sample_unref);
+  g_ptr_array_set_size (data->samples, n_timestamps);
+
+  g_simple_async_result_set_op_res_gpointer (simple, data,
+      (GDestroyNotify) _free_thumbnails_data);
+  g_simple_async_result_run_in_thread (simple, _get_thumbnails_in_thread,
+      G_PRIORITY_DEFAULT, cancellable);
+  g_object_unref (simple);
+}
+
+/**
+ * ges_thumbnailer_get_thumbnails_finish:
+ * @self: a #GESThumbnailer
+ * @result: The #GAsyncResult passed to the #GAsyncReadyCallback
+ * @error: (out) (allow-none): An error to be set in case something wrong happens or %NULL
+ *
+ * Finishes an operation started with ges_thumbnailer_get_thumbnails_async().
+ *
+ * Returns: (transfer full) (element-type GstSample): The thumbnails in the
+ * order of the requested timestamps, with %NULL for the ones that could not
+ * be extracted, or %NULL if an error occured.
+ */
+GPtrArray *
+ges_thumbnailer_get_thumbnails_finish (GESThumbnailer * self,
+    GAsyncResult * result, GError ** error)
+{
+  ThumbnailsData *data;
+  GSimpleAsyncResult *simple = G_SIMPLE_ASYNC_RESULT (result);
+
+  g_return_val_if_fail (g_simple_async_result_is_valid (result,
+          G_OBJECT (self), ges_thumbnailer_get_thumbnails_async), NULL);
+
+  if (g_simple_async_result_propagate_error (simple, error))
+    return NULL;
+
+  data = g_simple_async_result_get_op_res_gpointer (simple);
+
+  return g_ptr_array_ref (data->samples);
+}
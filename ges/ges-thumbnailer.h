@@ -0,0 +1,84 @@
+/* GStreamer Editing Services
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef _GES_THUMBNAILER_
+#define _GES_THUMBNAILER_
+
+#include <glib-object.h>
+#include <gio/gio.h>
+#include <gst/gst.h>
+#include <ges/ges-types.h>
+
+G_BEGIN_DECLS
+
+#define GES_TYPE_THUMBNAILER            ges_thumbnailer_get_type()
+#define GES_THUMBNAILER(obj)            (G_TYPE_CHECK_INSTANCE_CAST ((obj), GES_TYPE_THUMBNAILER, GESThumbnailer))
+#define GES_THUMBNAILER_CLASS(klass)    (G_TYPE_CHECK_CLASS_CAST ((klass), GES_TYPE_THUMBNAILER, GESThumbnailerClass))
+#define GES_IS_THUMBNAILER(obj)         (G_TYPE_CHECK_INSTANCE_TYPE ((obj), GES_TYPE_THUMBNAILER))
+#define GES_IS_THUMBNAILER_CLASS(klass) (G_TYPE_CHECK_CLASS_TYPE ((klass), GES_TYPE_THUMBNAILER))
+#define GES_THUMBNAILER_GET_CLASS(obj)  (G_TYPE_INSTANCE_GET_CLASS ((obj), GES_TYPE_THUMBNAILER, GESThumbnailerClass))
+
+typedef struct _GESThumbnailerPrivate GESThumbnailerPrivate;
+
+GType ges_thumbnailer_get_type (void);
+
+struct _GESThumbnailer
+{
+  GObject parent;
+
+  /* <private> */
+  GESThumbnailerPrivate *priv;
+
+  /* Padding for API extension */
+  gpointer __ges_reserved[GES_PADDING];
+};
+
+struct _GESThumbnailerClass
+{
+  GObjectClass parent_class;
+
+  /* Signals */
+  void (*thumbnail) (GESThumbnailer * self,
+                     GstClockTime timestamp,
+                     GstSample * sample);
+
+  gpointer _ges_reserved[GES_PADDING];
+};
+
+GESThumbnailer * ges_thumbnailer_new_for_timeline   (GESTimeline * timeline);
+GESThumbnailer * ges_thumbnailer_new_for_asset      (GESUriClipAsset * asset);
+
+void             ges_thumbnailer_set_caps           (GESThumbnailer * self,
+                                                     const GstCaps * caps);
+GstCaps *        ges_thumbnailer_get_caps           (GESThumbnailer * self);
+void             ges_thumbnailer_set_accurate       (GESThumbnailer * self,
+                                                     gboolean accurate);
+gboolean         ges_thumbnailer_get_accurate       (GESThumbnailer * self);
+
+void             ges_thumbnailer_get_thumbnails_async  (GESThumbnailer * self,
+                                                        const GstClockTime * timestamps,
+                                                        guint n_timestamps,
+                                                        GCancellable * cancellable,
+                                                        GAsyncReadyCallback callback,
+                                                        gpointer user_data);
+GPtrArray *      ges_thumbnailer_get_thumbnails_finish (GESThumbnailer * self,
+                                                        GAsyncResult * result,
+                                                        GError ** error);
+
+G_END_DECLS
+#endif /* _GES_THUMBNAILER_ */
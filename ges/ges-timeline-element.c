@@ -26,6 +26,8 @@
  * responsible for controlling its timing properties.
  */
 
+#include <string.h>
+
 #include "ges-timeline-element.h"
 #include "ges-extractable.h"
 #include "ges-meta-container.h"
@@ -146,6 +148,98 @@ ges_timeline_element_finalize (GObject * self)
   G_OBJECT_CLASS (ges_timeline_element_parent_class)->finalize (self);
 }
 
+/* The properties of a class that have to be copied through GValues, built
+ * once per class as listing the properties is costly.
+ *
+ * The ->clone implementations copying their fields directly have to chain
+ * up for instances of their subclasses: those can have properties of their
+ * own, only instances of the class itself avoid going through GValues */
+typedef struct
+{
+  guint n_pspecs;
+  GParamSpec **pspecs;
+} CopyTemplate;
+
+static GQuark copy_template_quark;
+G_LOCK_DEFINE_STATIC (copy_template_lock);
+
+static CopyTemplate *
+_get_copy_template (GType type)
+{
+  guint i, n_specs;
+  GParamSpec **specs;
+  CopyTemplate *template;
+
+  G_LOCK (copy_template_lock);
+  template = g_type_get_qdata (type, copy_template_quark);
+  if (template)
+    goto done;
+
+  template = g_slice_new0 (CopyTemplate);
+  specs = g_object_class_list_properties (g_type_class_peek (type), &n_specs);
+  template->pspecs = g_new0 (GParamSpec *, n_specs);
+  for (i = 0; i < n_specs; i++) {
+    /* The GESTimelineElement fields are copied directly */
+    if (specs[i]->owner_type == GES_TYPE_TIMELINE_ELEMENT)
+      continue;
+
+    if ((specs[i]->flags & G_PARAM_READWRITE) == G_PARAM_READWRITE)
+      template->pspecs[template->n_pspecs++] = specs[i];
+  }
+  g_free (specs);
+
+  /* Never freed, as the classes */
+  g_type_set_qdata (type, copy_template_quark, template);
+
+done:
+  G_UNLOCK (copy_template_lock);
+
+  return template;
+}
+
+/* Copies the #GESTimelineElement fields of @self into @copy, the same way
+ * setting the properties after the construction would */
+void
+ges_timeline_element_clone_fields (GESTimelineElement * self,
+    GESTimelineElement * copy)
+{
+  if (self->timeline)
+    ges_timeline_element_set_timeline (copy, self->timeline);
+  ges_timeline_element_set_start (copy, self->start);
+  ges_timeline_element_set_inpoint (copy, self->inpoint);
+  ges_timeline_element_set_duration (copy, self->duration);
+  ges_timeline_element_set_max_duration (copy, self->maxduration);
+  ges_timeline_element_set_priority (copy, self->priority);
+}
+
+static GESTimelineElement *
+_clone (GESTimelineElement * self)
+{
+  guint i;
+  GParameter *params;
+  GESTimelineElement *ret;
+  CopyTemplate *template = _get_copy_template (G_OBJECT_TYPE (self));
+
+  params = g_newa (GParameter, template->n_pspecs + 1);
+  for (i = 0; i < template->n_pspecs; i++) {
+    GParamSpec *pspec = template->pspecs[i];
+
+    params[i].name = pspec->name;
+    memset (&params[i].value, 0, sizeof (GValue));
+    g_value_init (&params[i].value, pspec->value_type);
+    g_object_get_property (G_OBJECT (self), pspec->name, &params[i].value);
+  }
+
+  ret = g_object_newv (G_OBJECT_TYPE (self), template->n_pspecs, params);
+
+  for (i = 0; i < template->n_pspecs; i++)
+    g_value_unset (&params[i].value);
+
+  ges_timeline_element_clone_fields (self, ret);
+
+  return ret;
+}
+
 static void
 ges_timeline_element_class_init (GESTimelineElementClass * klass)
 {
@@ -237,6 +331,10 @@ ges_timeline_element_class_init (GESTimelineElementClass * klass)
   klass->roll_start = NULL;
   klass->roll_end = NULL;
   klass->trim = NULL;
+  klass->clone = _clone;
+
+  copy_template_quark =
+      g_quark_from_static_string ("ges-timeline-element-copy-template");
 }
 
 /*********************************************
@@ -808,10 +906,7 @@ GESTimelineElement *
 ges_timeline_element_copy (GESTimelineElement * self, gboolean deep)
 {
   GESAsset *asset;
-  GParameter *params;
-  GParamSpec **specs;
   GESTimelineElementClass *klass;
-  guint n, n_specs, n_params;
 
   GESTimelineElement *ret = NULL;
 
@@ -819,26 +914,7 @@ ges_timeline_element_copy (GESTimelineElement * self, gboolean deep)
 
   klass = GES_TIMELINE_ELEMENT_GET_CLASS (self);
 
-  specs = g_object_class_list_properties (G_OBJECT_GET_CLASS (self), &n_specs);
-  params = g_new0 (GParameter, n_specs);
-  n_params = 0;
-
-  for (n = 0; n < n_specs; ++n) {
-    if (g_strcmp0 (specs[n]->name, "parent") &&
-        (specs[n]->flags & G_PARAM_READWRITE) == G_PARAM_READWRITE) {
-      params[n_params].name = g_intern_string (specs[n]->name);
-      g_value_init (&params[n_params].value, specs[n]->value_type);
-      g_object_get_property (G_OBJECT (self), specs[n]->name,
-          &params[n_params].value);
-      ++n_params;
-    }
-  }
-
-  ret = g_object_newv (G_OBJECT_TYPE (self), n_params, params);
-
-  g_free (specs);
-  g_free (params);
-
+  ret = klass->clone (self);
 
   asset = ges_extractable_get_asset (GES_EXTRACTABLE (self));
   if (asset)
@@ -150,6 +150,10 @@ struct _GESTimelineElement
  * @roll_end: method to roll an object on its #GES_EDGE_END edge
  * @trim: method to trim an object
  * @deep_copy: Copy the children properties of @self into @copy
+ * @clone: Create a new element with the same properties as @self, used by
+ * ges_timeline_element_copy(). The default implementation sets the
+ * #GESTimelineElement fields directly and only goes through #GValue-s for
+ * the properties the subclasses define.
  *
  * The GESTimelineElement base class. Subclasses should override at least
  * @set_start @set_inpoint @set_duration @ripple @ripple_end @roll_start
@@ -177,10 +181,11 @@ struct _GESTimelineElementClass
   gboolean (*roll_end)         (GESTimelineElement *self, guint64  end);
   gboolean (*trim)             (GESTimelineElement *self, guint64  start);
   void (*deep_copy)            (GESTimelineElement *self, GESTimelineElement *copy);
+  GESTimelineElement * (*clone) (GESTimelineElement *self);
 
   /*< private > */
   /* Padding for API extension */
-  gpointer _ges_reserved[GES_PADDING_LARGE];
+  gpointer _ges_reserved[GES_PADDING_LARGE - 1];
 };
 
 GType ges_timeline_element_get_type (void) G_GNUC_CONST;
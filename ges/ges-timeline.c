@@ -47,6 +47,7 @@
 #include "ges-track.h"
 #include "ges-layer.h"
 #include "ges-auto-transition.h"
+#include "ges-interval-tree.h"
 #include "ges.h"
 
 typedef struct _MoveContext MoveContext;
@@ -54,6 +55,7 @@ typedef struct _MoveContext MoveContext;
 static GPtrArray *select_tracks_for_object_default (GESTimeline * timeline,
     GESClip * clip, GESTrackElement * tr_obj, gpointer user_data);
 static inline void init_movecontext (MoveContext * mv_ctx, gboolean first_init);
+static void flush_pending_index_updates (GESTimeline * timeline);
 static void ges_extractable_interface_init (GESExtractableInterface * iface);
 static void ges_meta_container_interface_init
     (GESMetaContainerInterface * iface);
@@ -93,6 +95,9 @@ typedef struct TrackObjIters
   GSequenceIter *iter_obj;
   GSequenceIter *iter_by_layer;
 
+  /* Node in the interval tree of the layer/track the source is in */
+  GESIntervalNode interval;
+
   GESLayer *layer;
   GESTrackElement *trackelement;
 } TrackObjIters;
@@ -100,6 +105,7 @@ typedef struct TrackObjIters
 static void
 _destroy_obj_iters (TrackObjIters * iters)
 {
+  ges_interval_tree_remove (&iters->interval);
   g_slice_free (TrackObjIters, iters);
 }
 
@@ -170,13 +176,24 @@ struct _GESTimelinePrivate
    * probably through a ges_layer_get_track_elements () method */
   GHashTable *by_layer;         /* {layer: GSequence of TrackElement by start/priorities} */
 
-  /* The set of auto_transitions we control, currently the key is
-   * pointerToPreviousiTrackObjAdresspointerToNextTrackObjAdress as a string,
-   * ... not really optimal but it works */
-  GHashTable *auto_transitions;
+  /* Interval trees of the sources, used to look for overlapping sources
+   * when creating auto transitions */
+  GHashTable *intervals;        /* {layer: {track: GESIntervalTree}} */
+
+  /* The set of auto_transitions we control */
+  GHashTable *auto_transitions; /* {GESAutoTransitionKey: GESAutoTransition} */
+  /* The auto transitions each source is a neighbour of */
+  GHashTable *auto_transitions_by_source;       /* {Source: GList of GESAutoTransition} */
 
   MoveContext movecontext;
 
+  /* Edit transactions, see ges_timeline_begin_edit () */
+  guint edit_depth;
+  GHashTable *pending_index_updates;    /* Set of TrackElement */
+  GHashTable *pending_transitions;      /* Set of Source */
+  GHashTable *pending_layers;   /* Set of GESLayer */
+  gboolean needs_duration_update;
+
   /* This variable is set to %TRUE when it makes sense to update the transitions,
    * and %FALSE otherwize */
   gboolean needs_transitions_update;
@@ -341,12 +358,17 @@ ges_timeline_dispose (GObject * object)
   g_hash_table_unref (priv->by_object);
   g_hash_table_unref (priv->by_layer);
   g_hash_table_unref (priv->obj_iters);
+  g_hash_table_unref (priv->intervals);
   g_sequence_free (priv->starts_ends);
   g_sequence_free (priv->tracksources);
   g_list_free (priv->movecontext.moving_trackelements);
   g_hash_table_unref (priv->movecontext.toplevel_containers);
 
+  g_hash_table_unref (priv->auto_transitions_by_source);
   g_hash_table_unref (priv->auto_transitions);
+  g_hash_table_unref (priv->pending_index_updates);
+  g_hash_table_unref (priv->pending_transitions);
+  g_hash_table_unref (priv->pending_layers);
 
   G_OBJECT_CLASS (ges_timeline_parent_class)->dispose (object);
 }
@@ -547,13 +569,24 @@ ges_timeline_init (GESTimeline * self)
       (GDestroyNotify) g_sequence_free);
   priv->obj_iters = g_hash_table_new_full (g_direct_hash, g_direct_equal, NULL,
       (GDestroyNotify) _destroy_obj_iters);
+  priv->intervals = g_hash_table_new_full (g_direct_hash, g_direct_equal, NULL,
+      (GDestroyNotify) g_hash_table_unref);
   priv->starts_ends = g_sequence_new (g_free);
   priv->tracksources = g_sequence_new (gst_object_unref);
 
   priv->auto_transitions =
-      g_hash_table_new_full (g_str_hash, g_str_equal, NULL, gst_object_unref);
+      g_hash_table_new_full ((GHashFunc) ges_auto_transition_key_hash,
+      (GEqualFunc) ges_auto_transition_key_equal, NULL, gst_object_unref);
+  priv->auto_transitions_by_source =
+      g_hash_table_new_full (g_direct_hash, g_direct_equal, NULL,
+      (GDestroyNotify) g_list_free);
   priv->needs_transitions_update = TRUE;
 
+  priv->pending_index_updates = g_hash_table_new (g_direct_hash,
+      g_direct_equal);
+  priv->pending_transitions = g_hash_table_new (g_direct_hash, g_direct_equal);
+  priv->pending_layers = g_hash_table_new (g_direct_hash, g_direct_equal);
+
   priv->group_id = -1;
 
   g_signal_connect_after (self, "select-tracks-for-object",
@@ -599,9 +632,15 @@ static void
 timeline_update_duration (GESTimeline * timeline)
 {
   GstClockTime *cduration;
-  GSequenceIter *it = g_sequence_get_end_iter (timeline->priv->starts_ends);
+  GSequenceIter *it;
 
-  it = g_sequence_iter_prev (it);
+  if (timeline->priv->edit_depth) {
+    timeline->priv->needs_duration_update = TRUE;
+    return;
+  }
+
+  it = g_sequence_iter_prev (g_sequence_get_end_iter (timeline->priv->
+          starts_ends));
 
   if (g_sequence_iter_is_end (it)) {
     timeline->priv->duration = 0;
@@ -688,6 +727,77 @@ sort_starts_ends_start (GESTimeline * timeline, TrackObjIters * iters)
   timeline_update_duration (timeline);
 }
 
+static GESIntervalTree *
+get_interval_tree (GESTimeline * timeline, GESLayer * layer, GESTrack * track)
+{
+  GESIntervalTree *tree;
+  GHashTable *by_track;
+
+  if (layer == NULL || track == NULL)
+    return NULL;
+
+  by_track = g_hash_table_lookup (timeline->priv->intervals, layer);
+  if (G_UNLIKELY (by_track == NULL))
+    return NULL;
+
+  tree = g_hash_table_lookup (by_track, track);
+  if (tree == NULL) {
+    /* The sources can stay in a track removed from the timeline */
+    if (G_UNLIKELY (!g_list_find (timeline->tracks, track)))
+      return NULL;
+
+    tree = ges_interval_tree_new ();
+    g_hash_table_insert (by_track, track, tree);
+  }
+
+  return tree;
+}
+
+/* Make sure the source is in the interval tree of the layer/track it
+ * is in, with its current start and end */
+static void
+update_interval (GESTimeline * timeline, TrackObjIters * iters)
+{
+  GESTrackElement *source = iters->trackelement;
+  GESIntervalTree *tree = get_interval_tree (timeline, iters->layer,
+      ges_track_element_get_track (source));
+
+  if (tree != iters->interval.tree) {
+    ges_interval_tree_remove (&iters->interval);
+    if (tree)
+      ges_interval_tree_insert (tree, &iters->interval, _START (source),
+          _END (source), source);
+  } else if (tree) {
+    ges_interval_tree_update (&iters->interval, _START (source),
+        _END (source));
+  }
+}
+
+static void
+add_auto_transition_for_source (GESTimeline * timeline,
+    GESTrackElement * source, GESAutoTransition * auto_transition)
+{
+  GHashTable *by_source = timeline->priv->auto_transitions_by_source;
+  GList *auto_transitions = g_hash_table_lookup (by_source, source);
+
+  g_hash_table_steal (by_source, source);
+  g_hash_table_insert (by_source, source,
+      g_list_prepend (auto_transitions, auto_transition));
+}
+
+static void
+remove_auto_transition_for_source (GESTimeline * timeline,
+    GESTrackElement * source, GESAutoTransition * auto_transition)
+{
+  GHashTable *by_source = timeline->priv->auto_transitions_by_source;
+  GList *auto_transitions = g_hash_table_lookup (by_source, source);
+
+  g_hash_table_steal (by_source, source);
+  auto_transitions = g_list_remove (auto_transitions, auto_transition);
+  if (auto_transitions)
+    g_hash_table_insert (by_source, source, auto_transitions);
+}
+
 static void
 _destroy_auto_transition_cb (GESAutoTransition * auto_transition,
     GESTimeline * timeline)
@@ -700,9 +810,36 @@ _destroy_auto_transition_cb (GESAutoTransition * auto_transition,
   g_signal_handlers_disconnect_by_func (auto_transition,
       _destroy_auto_transition_cb, timeline);
 
-  if (!g_hash_table_remove (priv->auto_transitions, auto_transition->key))
+  remove_auto_transition_for_source (timeline,
+      auto_transition->previous_source, auto_transition);
+  remove_auto_transition_for_source (timeline, auto_transition->next_source,
+      auto_transition);
+
+  if (!g_hash_table_remove (priv->auto_transitions, &auto_transition->key))
     GST_WARNING_OBJECT (timeline, "Could not remove auto_transition %"
-        GST_PTR_FORMAT, auto_transition->key);
+        GST_PTR_FORMAT, auto_transition->transition);
+}
+
+/* Destroy all the auto transitions @source is a neighbour of, to be called
+ * when @source is removed from its track */
+static void
+destroy_auto_transitions_for_source (GESTimeline * timeline,
+    GESTrackElement * source)
+{
+  GList *auto_transitions, *tmp;
+
+  auto_transitions = g_list_copy (g_hash_table_lookup
+      (timeline->priv->auto_transitions_by_source, source));
+
+  for (tmp = auto_transitions; tmp; tmp = tmp->next) {
+    GST_DEBUG_OBJECT (timeline, "Neighbour %" GST_PTR_FORMAT
+        " removed from track ... destroying %" GST_PTR_FORMAT, source,
+        ((GESAutoTransition *) tmp->data)->transition);
+
+    _destroy_auto_transition_cb (tmp->data, timeline);
+  }
+
+  g_list_free (auto_transitions);
 }
 
 static GESAutoTransition *
@@ -733,7 +870,9 @@ create_transition (GESTimeline * timeline, GESTrackElement * previous,
       G_CALLBACK (_destroy_auto_transition_cb), timeline);
 
   g_hash_table_insert (timeline->priv->auto_transitions,
-      auto_transition->key, auto_transition);
+      &auto_transition->key, auto_transition);
+  add_auto_transition_for_source (timeline, previous, auto_transition);
+  add_auto_transition_for_source (timeline, next, auto_transition);
 
   return auto_transition;
 }
@@ -747,14 +886,9 @@ _find_transition_from_auto_transitions (GESTimeline * timeline,
     GESLayer * layer, GESTrack * track, GESTrackElement * prev,
     GESTrackElement * next, GstClockTime transition_duration)
 {
-  GESAutoTransition *auto_transition;
-
-  gchar *key = g_strdup_printf ("%p%p", prev, next);
+  GESAutoTransitionKey key = { prev, next };
 
-  auto_transition = g_hash_table_lookup (timeline->priv->auto_transitions, key);
-  g_free (key);
-
-  return auto_transition;
+  return g_hash_table_lookup (timeline->priv->auto_transitions, &key);
 }
 
 static GESAutoTransition *
@@ -805,84 +939,131 @@ _create_auto_transition_from_transitions (GESTimeline * timeline,
   return NULL;
 }
 
+typedef struct
+{
+  GESTrackElement *prev;
+  GESTrackElement *next;
+} TransitionCandidate;
+
+typedef struct
+{
+  GESTrackElement *source;
+  GESIntervalTree *tree;
+  gboolean only_previous;
+  GArray *candidates;
+} OverlapSearch;
+
+static void
+add_transition_candidate_cb (GESTrackElement * other, OverlapSearch * search)
+{
+  TransitionCandidate candidate;
+  GESTrackElement *source = search->source;
+
+  /* Only the sources starting strictly before the other one can need
+   * a transition on their end edge */
+  if (_START (other) < _START (source)) {
+    candidate.prev = other;
+    candidate.next = source;
+  } else if (search->only_previous) {
+    return;
+  } else if (_START (other) > _START (source)) {
+    candidate.prev = source;
+    candidate.next = other;
+  } else {
+    return;
+  }
+
+  g_array_append_val (search->candidates, candidate);
+}
+
+static void
+add_previous_overlaps_cb (GESTrackElement * source, OverlapSearch * search)
+{
+  search->source = source;
+  ges_interval_tree_foreach_overlapping (search->tree, _START (source),
+      _END (source), (GFunc) add_transition_candidate_cb, search);
+}
+
 /* Create all transition that do not exist on @layer.
  * @get_auto_transition is called to check if a particular transition exists
  * if @ track is specified, we will create the transitions only for that particular
- * track */
+ * track. If @initiating_obj is specified only the transitions around it will
+ * be created */
 static void
 _create_transitions_on_layer (GESTimeline * timeline, GESLayer * layer,
     GESTrack * track, GESTrackElement * initiating_obj,
     GetAutoTransitionFunc get_auto_transition)
 {
-  guint32 layer_prio;
-  GSequenceIter *iter;
-  GESAutoTransition *transition;
+  guint i;
+  GHashTableIter iter;
+  GHashTable *by_track;
+  GESIntervalTree *tree;
+  GESTrack *ctrack;
+  OverlapSearch search;
 
-  GESTrack *ctrack = track;
-  GList *entered = NULL;        /* List of TrackElement for wich we walk through the
-                                 * "start" but not the "end" in the starts_ends list */
   GESTimelinePrivate *priv = timeline->priv;
 
   if (!layer || !ges_layer_get_auto_transition (layer))
     return;
 
-  layer_prio = ges_layer_get_priority (layer);
-  for (iter = g_sequence_get_begin_iter (priv->starts_ends);
-      iter && !g_sequence_iter_is_end (iter);
-      iter = g_sequence_iter_next (iter)) {
-    GList *tmp;
-    guint *start_or_end = g_sequence_get (iter);
-    GESTrackElement *next = g_hash_table_lookup (timeline->priv->by_object,
-        start_or_end);
-    GESTimelineElement *toplevel =
-        ges_timeline_element_get_toplevel_parent (GES_TIMELINE_ELEMENT (next));
-
-    /* Only object that are in that layer and track */
-    if (_ges_track_element_get_layer_priority (next) != layer_prio ||
-        (track && track != ges_track_element_get_track (next)))
-      continue;
+  search.candidates = g_array_new (FALSE, FALSE, sizeof (TransitionCandidate));
 
-    if (track == NULL)
-      ctrack = ges_track_element_get_track (next);
+  /* Look for the overlapping sources first, as creating the transitions will
+   * modify the interval trees */
+  if (initiating_obj) {
+    TrackObjIters *iters = g_hash_table_lookup (priv->obj_iters,
+        initiating_obj);
 
-    if (start_or_end == g_hash_table_lookup (priv->by_end, next)) {
-      if (initiating_obj == next) {
-        /* We passed the objects that initiated the research
-         * we are now done */
-        g_list_free (entered);
-        return;
-      }
-      entered = g_list_remove (entered, next);
+    if (iters && iters->interval.tree) {
+      search.source = initiating_obj;
+      search.only_previous = FALSE;
+      ges_interval_tree_foreach_overlapping (iters->interval.tree,
+          _START (initiating_obj), _END (initiating_obj),
+          (GFunc) add_transition_candidate_cb, &search);
+    }
+  } else if ((by_track = g_hash_table_lookup (priv->intervals, layer))) {
+    g_hash_table_iter_init (&iter, by_track);
+    while (g_hash_table_iter_next (&iter, (gpointer *) & ctrack,
+            (gpointer *) & tree)) {
+      if (track && track != ctrack)
+        continue;
 
-      continue;
+      /* Each overlapping pair is found once, from its next source */
+      search.tree = tree;
+      search.only_previous = TRUE;
+      ges_interval_tree_foreach (tree, (GFunc) add_previous_overlaps_cb,
+          &search);
     }
+  }
 
-    for (tmp = entered; tmp; tmp = tmp->next) {
-      gint64 transition_duration;
+  for (i = 0; i < search.candidates->len; i++) {
+    gint64 transition_duration;
+    GESAutoTransition *transition;
+    TransitionCandidate *candidate =
+        &g_array_index (search.candidates, TransitionCandidate, i);
+    GESTrackElement *prev = candidate->prev, *next = candidate->next;
 
-      GESTrackElement *prev = tmp->data;
+    /* The sources might have been removed from the layer meanwhile */
+    ctrack = ges_track_element_get_track (next);
+    if (ctrack == NULL || ctrack != ges_track_element_get_track (prev))
+      continue;
 
-      if (ctrack != ges_track_element_get_track (prev) ||
-          ges_timeline_element_get_toplevel_parent (GES_TIMELINE_ELEMENT (prev))
-          == toplevel)
-        continue;
+    if (get_toplevel_container (prev) == get_toplevel_container (next))
+      continue;
 
-      transition_duration = (_START (prev) + _DURATION (prev)) - _START (next);
-      if (transition_duration > 0 && transition_duration < _DURATION (prev) &&
-          transition_duration < _DURATION (next)) {
-        transition =
-            get_auto_transition (timeline, layer, ctrack, prev, next,
-            transition_duration);
-        if (!transition)
-          transition = create_transition (timeline, prev, next, NULL, layer,
-              _START (next), transition_duration);
-      }
+    transition_duration = (_START (prev) + _DURATION (prev)) - _START (next);
+    if (transition_duration > 0 && transition_duration < _DURATION (prev) &&
+        transition_duration < _DURATION (next)) {
+      transition =
+          get_auto_transition (timeline, layer, ctrack, prev, next,
+          transition_duration);
+      if (!transition)
+        transition = create_transition (timeline, prev, next, NULL, layer,
+            _START (next), transition_duration);
     }
-
-    /* And add that object to the entered list so that it we can possibly set
-     * a transition on its end edge */
-    entered = g_list_append (entered, next);
   }
+
+  g_array_free (search.candidates, TRUE);
 }
 
 /* @track_element must be a GESSource */
@@ -897,6 +1078,13 @@ create_transitions (GESTimeline * timeline, GESTrackElement * track_element)
   if (!priv->needs_transitions_update)
     return;
 
+  if (priv->edit_depth) {
+    GST_LOG_OBJECT (timeline, "In an edit transaction, postponing transitions "
+        "creation around %p", track_element);
+    g_hash_table_add (priv->pending_transitions, track_element);
+    return;
+  }
+
   GST_DEBUG_OBJECT (timeline, "Creating transitions around %p", track_element);
 
   track = ges_track_element_get_track (track_element);
@@ -963,8 +1151,11 @@ stop_tracking_track_element (GESTimeline * timeline,
     g_sequence_remove (iters->iter_start);
     g_sequence_remove (iters->iter_end);
     g_sequence_remove (iters->iter_obj);
+    ges_interval_tree_remove (&iters->interval);
+    g_hash_table_remove (priv->pending_transitions, trackelement);
     timeline_update_duration (timeline);
   }
+  g_hash_table_remove (priv->pending_index_updates, trackelement);
   g_hash_table_remove (priv->obj_iters, trackelement);
 }
 
@@ -1028,6 +1219,7 @@ start_tracking_track_element (GESTimeline * timeline,
     g_hash_table_insert (priv->by_object, pstart, trackelement);
     g_hash_table_insert (priv->by_end, trackelement, pend);
     g_hash_table_insert (priv->by_object, pend, trackelement);
+    update_interval (timeline, iters);
 
     timeline->priv->movecontext.needs_move_ctx = TRUE;
 
@@ -1103,6 +1295,8 @@ ges_timeline_snap_position (GESTimeline * timeline,
   if (snap_distance == 0)
     return NULL;
 
+  flush_pending_index_updates (timeline);
+
   /* If we can just resnap as last snap... do it */
   if (last_snap_ts) {
     off = timecode > *last_snap_ts ?
@@ -1119,42 +1313,49 @@ ges_timeline_snap_position (GESTimeline * timeline,
       (GCompareDataFunc) compare_uint64, NULL);
 
   /* Getting the next/previous  values, and use the closest one if any "respects"
-   * the snap_distance value */
-  nxt_iter = iter;
-  while (!g_sequence_iter_is_end (nxt_iter)) {
-    next_tc = g_sequence_get (iter);
-    tmp_trackelement = g_hash_table_lookup (timeline->priv->by_object, next_tc);
-    tmp_container = get_toplevel_container (tmp_trackelement);
+   * the snap_distance value. As starts_ends is sorted, we can stop looking
+   * as soon as we are further than snap_distance */
+  for (nxt_iter = iter; !g_sequence_iter_is_end (nxt_iter);
+      nxt_iter = g_sequence_iter_next (nxt_iter)) {
+    next_tc = g_sequence_get (nxt_iter);
 
     off = timecode > *next_tc ? timecode - *next_tc : *next_tc - timecode;
-    if (next_tc != current && off <= snap_distance
-        && container != tmp_container) {
+    if (off > snap_distance) {
+      if (*next_tc > timecode)
+        break;
 
+      continue;
+    }
+
+    tmp_trackelement = g_hash_table_lookup (timeline->priv->by_object, next_tc);
+    tmp_container = get_toplevel_container (tmp_trackelement);
+    if (next_tc != current && container != tmp_container) {
       ret = next_tc;
       break;
     }
-
-    nxt_iter = g_sequence_iter_next (nxt_iter);
   }
 
   if (ret == NULL)
     off = G_MAXUINT64;
 
-  prev_iter = g_sequence_iter_prev (iter);
-  while (!g_sequence_iter_is_begin (prev_iter)) {
+  for (prev_iter = iter; !g_sequence_iter_is_begin (prev_iter);) {
+    prev_iter = g_sequence_iter_prev (prev_iter);
     prev_tc = g_sequence_get (prev_iter);
-    tmp_trackelement = g_hash_table_lookup (timeline->priv->by_object, prev_tc);
-    tmp_container = get_toplevel_container (tmp_trackelement);
 
     off1 = timecode > *prev_tc ? timecode - *prev_tc : *prev_tc - timecode;
-    if (prev_tc != current && off1 < off && off1 <= snap_distance &&
-        container != tmp_container) {
-      ret = prev_tc;
+    if (off1 >= off || off1 > snap_distance) {
+      if (*prev_tc < timecode)
+        break;
 
-      break;
+      continue;
     }
 
-    prev_iter = g_sequence_iter_prev (prev_iter);
+    tmp_trackelement = g_hash_table_lookup (timeline->priv->by_object, prev_tc);
+    tmp_container = get_toplevel_container (tmp_trackelement);
+    if (prev_tc != current && container != tmp_container) {
+      ret = prev_tc;
+      break;
+    }
   }
 
 done:
@@ -1285,6 +1486,8 @@ ges_timeline_set_moving_context (GESTimeline * timeline, GESTrackElement * obj,
   MoveContext *mv_ctx = &timeline->priv->movecontext;
   GESClip *clip = GES_CLIP (GES_TIMELINE_ELEMENT_PARENT (obj));
 
+  flush_pending_index_updates (timeline);
+
   /* Still in the same mv_ctx */
   if ((mv_ctx->clip == clip && mv_ctx->mode == mode &&
           mv_ctx->edge == edge && !mv_ctx->needs_move_ctx)) {
@@ -2049,8 +2252,11 @@ layer_object_added_cb (GESLayer * layer, GESClip * clip, GESTimeline * timeline)
     GST_DEBUG ("Clip %p moving from one layer to another, not creating "
         "TrackElement", clip);
     timeline->priv->movecontext.needs_move_ctx = TRUE;
-    _create_transitions_on_layer (timeline, layer, NULL, NULL,
-        _find_transition_from_auto_transitions);
+    if (timeline->priv->edit_depth)
+      g_hash_table_add (timeline->priv->pending_layers, layer);
+    else
+      _create_transitions_on_layer (timeline, layer, NULL, NULL,
+          _find_transition_from_auto_transitions);
     return;
   }
 
@@ -2114,36 +2320,8 @@ layer_object_removed_cb (GESLayer * layer, GESClip * clip,
 }
 
 static void
-trackelement_start_changed_cb (GESTrackElement * child,
-    GParamSpec * arg G_GNUC_UNUSED, GESTimeline * timeline)
-{
-  GESTimelinePrivate *priv = timeline->priv;
-  TrackObjIters *iters = g_hash_table_lookup (priv->obj_iters, child);
-
-  if (G_LIKELY (iters->iter_by_layer))
-    g_sequence_sort_changed (iters->iter_by_layer,
-        (GCompareDataFunc) element_start_compare, NULL);
-
-  if (GES_IS_SOURCE (child)) {
-    sort_track_elements (timeline, iters);
-    sort_starts_ends_start (timeline, iters);
-    sort_starts_ends_end (timeline, iters);
-
-    /* If the timeline is set to snap objects together, we
-     * are sure that all movement of TrackElement-s are done within
-     * the moving context, so we do not need to recalculate the
-     * move context as often */
-    if (timeline->priv->movecontext.ignore_needs_ctx &&
-        timeline->priv->snapping_distance == 0)
-      timeline->priv->movecontext.needs_move_ctx = TRUE;
-
-    create_transitions (timeline, child);
-  }
-}
-
-static void
-trackelement_priority_changed_cb (GESTrackElement * child,
-    GParamSpec * arg G_GNUC_UNUSED, GESTimeline * timeline)
+update_track_element_layer (GESTimeline * timeline, GESTrackElement * child,
+    TrackObjIters * iters)
 {
   GESTimelinePrivate *priv = timeline->priv;
 
@@ -2151,14 +2329,13 @@ trackelement_priority_changed_cb (GESTrackElement * child,
       GINT_TO_POINTER (_ges_track_element_get_layer_priority (child)),
       (GCompareFunc) find_layer_by_prio);
   GESLayer *layer = layer_node ? layer_node->data : NULL;
-  TrackObjIters *iters = g_hash_table_lookup (priv->obj_iters,
-      child);
 
   if (G_UNLIKELY (layer == NULL)) {
     GST_ERROR_OBJECT (timeline,
         "Changing a TrackElement prio, which would not "
         "land in no layer we are controlling");
-    g_sequence_remove (iters->iter_by_layer);
+    if (iters->iter_by_layer)
+      g_sequence_remove (iters->iter_by_layer);
     iters->iter_by_layer = NULL;
     iters->layer = NULL;
   } else {
@@ -2168,11 +2345,12 @@ trackelement_priority_changed_cb (GESTrackElement * child,
           g_hash_table_lookup (priv->by_layer, layer);
 
       GST_DEBUG_OBJECT (child, "Moved from layer %" GST_PTR_FORMAT
-          "(prio %d) to" " %" GST_PTR_FORMAT " (prio %d)", layer,
-          ges_layer_get_priority (layer), iters->layer,
-          ges_layer_get_priority (iters->layer));
+          "(prio %d) to" " %" GST_PTR_FORMAT " (prio %d)", iters->layer,
+          iters->layer ? ges_layer_get_priority (iters->layer) : -1, layer,
+          ges_layer_get_priority (layer));
 
-      g_sequence_remove (iters->iter_by_layer);
+      if (iters->iter_by_layer)
+        g_sequence_remove (iters->iter_by_layer);
       iters->iter_by_layer =
           g_sequence_insert_sorted (by_layer_sequence, child,
           (GCompareDataFunc) element_start_compare, NULL);
@@ -2182,9 +2360,106 @@ trackelement_priority_changed_cb (GESTrackElement * child,
           (GCompareDataFunc) element_start_compare, NULL);
     }
   }
+}
 
+/* Inside an edit transaction the indexes are only updated when needed,
+ * see flush_pending_index_updates() */
+static inline gboolean
+queue_index_update (GESTimeline * timeline, GESTrackElement * child)
+{
+  if (G_LIKELY (timeline->priv->edit_depth == 0))
+    return FALSE;
+
+  g_hash_table_add (timeline->priv->pending_index_updates, child);
   if (GES_IS_SOURCE (child))
+    create_transitions (timeline, child);
+
+  return TRUE;
+}
+
+static void
+flush_pending_index_updates (GESTimeline * timeline)
+{
+  GHashTableIter iter;
+  GESTrackElement *child;
+  GESTimelinePrivate *priv = timeline->priv;
+
+  if (g_hash_table_size (priv->pending_index_updates) == 0)
+    return;
+
+  GST_DEBUG_OBJECT (timeline, "Updating indexes of %d track elements",
+      g_hash_table_size (priv->pending_index_updates));
+
+  g_hash_table_iter_init (&iter, priv->pending_index_updates);
+  while (g_hash_table_iter_next (&iter, (gpointer *) & child, NULL)) {
+    TrackObjIters *iters = g_hash_table_lookup (priv->obj_iters, child);
+
+    if (G_UNLIKELY (iters == NULL))
+      continue;
+
+    update_track_element_layer (timeline, child, iters);
+    if (GES_IS_SOURCE (child)) {
+      sort_track_elements (timeline, iters);
+      sort_starts_ends_start (timeline, iters);
+      sort_starts_ends_end (timeline, iters);
+      update_interval (timeline, iters);
+
+      if (priv->movecontext.ignore_needs_ctx && priv->snapping_distance == 0)
+        priv->movecontext.needs_move_ctx = TRUE;
+    }
+  }
+  g_hash_table_remove_all (priv->pending_index_updates);
+}
+
+static void
+trackelement_start_changed_cb (GESTrackElement * child,
+    GParamSpec * arg G_GNUC_UNUSED, GESTimeline * timeline)
+{
+  GESTimelinePrivate *priv = timeline->priv;
+  TrackObjIters *iters;
+
+  if (queue_index_update (timeline, child))
+    return;
+
+  iters = g_hash_table_lookup (priv->obj_iters, child);
+  if (G_LIKELY (iters->iter_by_layer))
+    g_sequence_sort_changed (iters->iter_by_layer,
+        (GCompareDataFunc) element_start_compare, NULL);
+
+  if (GES_IS_SOURCE (child)) {
+    sort_track_elements (timeline, iters);
+    sort_starts_ends_start (timeline, iters);
+    sort_starts_ends_end (timeline, iters);
+    update_interval (timeline, iters);
+
+    /* If the timeline is set to snap objects together, we
+     * are sure that all movement of TrackElement-s are done within
+     * the moving context, so we do not need to recalculate the
+     * move context as often */
+    if (timeline->priv->movecontext.ignore_needs_ctx &&
+        timeline->priv->snapping_distance == 0)
+      timeline->priv->movecontext.needs_move_ctx = TRUE;
+
+    create_transitions (timeline, child);
+  }
+}
+
+static void
+trackelement_priority_changed_cb (GESTrackElement * child,
+    GParamSpec * arg G_GNUC_UNUSED, GESTimeline * timeline)
+{
+  TrackObjIters *iters;
+
+  if (queue_index_update (timeline, child))
+    return;
+
+  iters = g_hash_table_lookup (timeline->priv->obj_iters, child);
+  update_track_element_layer (timeline, child, iters);
+
+  if (GES_IS_SOURCE (child)) {
     sort_track_elements (timeline, iters);
+    update_interval (timeline, iters);
+  }
 }
 
 static void
@@ -2192,10 +2467,15 @@ trackelement_duration_changed_cb (GESTrackElement * child,
     GParamSpec * arg G_GNUC_UNUSED, GESTimeline * timeline)
 {
   GESTimelinePrivate *priv = timeline->priv;
-  TrackObjIters *iters = g_hash_table_lookup (priv->obj_iters, child);
+  TrackObjIters *iters;
 
+  if (queue_index_update (timeline, child))
+    return;
+
+  iters = g_hash_table_lookup (priv->obj_iters, child);
   if (GES_IS_SOURCE (child)) {
     sort_starts_ends_end (timeline, iters);
+    update_interval (timeline, iters);
 
     /* If the timeline is set to snap objects together, we
      * are sure that all movement of TrackElement-s are done within
@@ -2235,15 +2515,17 @@ track_element_removed_cb (GESTrack * track,
   if (GES_IS_SOURCE (track_element)) {
     /* Make sure to reinitialise the moving context next time */
     timeline->priv->movecontext.needs_move_ctx = TRUE;
+
+    destroy_auto_transitions_for_source (timeline, track_element);
   }
 
   /* Disconnect all signal handlers */
   g_signal_handlers_disconnect_by_func (track_element,
-      trackelement_start_changed_cb, NULL);
+      trackelement_start_changed_cb, timeline);
   g_signal_handlers_disconnect_by_func (track_element,
-      trackelement_duration_changed_cb, NULL);
+      trackelement_duration_changed_cb, timeline);
   g_signal_handlers_disconnect_by_func (track_element,
-      trackelement_priority_changed_cb, NULL);
+      trackelement_priority_changed_cb, timeline);
 
   stop_tracking_track_element (timeline, track_element);
 }
@@ -2450,6 +2732,224 @@ ges_timeline_save_to_uri (GESTimeline * timeline, const gchar * uri,
   return ret;
 }
 
+/* The project is serialized from the calling thread, and only written
+ * from another one */
+typedef struct
+{
+  GSimpleAsyncResult *simple;
+  GESProject *project;
+  gchar *uri;
+  gboolean overwrite;
+  GBytes *serialized;
+} SaveData;
+
+static void
+_free_save_data (SaveData * data)
+{
+  if (data->simple)
+    g_object_unref (data->simple);
+  gst_object_unref (data->project);
+  g_free (data->uri);
+  if (data->serialized)
+    g_bytes_unref (data->serialized);
+  g_slice_free (SaveData, data);
+}
+
+static gboolean
+_write_serialized (GOutputStream * stream, GBytes * serialized,
+    GError ** error)
+{
+  gsize size;
+  gconstpointer bytes = g_bytes_get_data (serialized, &size);
+
+  return g_output_stream_write_all (stream, bytes, size, NULL,
+      g_cancellable_get_current (), error);
+}
+
+static void
+_write_in_thread (GSimpleAsyncResult * write_result, GObject * timeline,
+    GCancellable * cancellable)
+{
+  gboolean ret;
+  GError *error = NULL;
+  SaveData *data = g_simple_async_result_get_op_res_gpointer (write_result);
+
+  ret = ges_formatter_write_uri (data->uri, data->overwrite,
+      (GESFormatterWriteFunc) _write_serialized, data->serialized,
+      cancellable, &error);
+
+  if (error)
+    g_simple_async_result_take_error (write_result, error);
+  else if (!ret)
+    g_simple_async_result_set_error (write_result, G_IO_ERROR,
+        G_IO_ERROR_FAILED, "Could not write %s", data->uri);
+}
+
+/* Back in the calling thread */
+static void
+_written_cb (GObject * timeline, GAsyncResult * write_result, SaveData * data)
+{
+  gchar *project_uri;
+  GError *error = NULL;
+  GSimpleAsyncResult *simple = data->simple;
+
+  if (g_simple_async_result_propagate_error (G_SIMPLE_ASYNC_RESULT
+          (write_result), &error)) {
+    g_simple_async_result_take_error (simple, error);
+    g_simple_async_result_set_op_res_gboolean (simple, FALSE);
+  } else {
+    project_uri = ges_project_get_uri (data->project);
+    if (project_uri == NULL)
+      ges_project_set_uri (data->project, data->uri);
+    g_free (project_uri);
+    g_simple_async_result_set_op_res_gboolean (simple, TRUE);
+  }
+
+  g_simple_async_result_complete (simple);
+}
+
+/**
+ * ges_timeline_save_to_uri_async:
+ * @timeline: a #GESTimeline
+ * @uri: The location to save to
+ * @formatter_asset: (allow-none): The formatter asset to use or %NULL. If %NULL,
+ * will try to save in the same format as the one from which the timeline as been loaded
+ * or default to the formatter with highest rank
+ * @overwrite: %TRUE to overwrite file if it exists
+ * @cancellable: (allow-none): A #GCancellable to cancel the saving, or %NULL
+ * @callback: A #GAsyncReadyCallback to call when the saving is done
+ * @user_data: The user data to pass to @callback
+ *
+ * Asynchronously saves the timeline to the given location, the same way as
+ * ges_timeline_save_to_uri() does. The timeline is serialized right away,
+ * and only written from another thread so that the main loop keeps running
+ * meanwhile. @timeline can thus be modified as soon as that function
+ * returns, the changes will not be part of the saved project. @callback is
+ * called from the thread-default main context of the calling thread, from
+ * which you should call ges_timeline_save_to_uri_finish().
+ *
+ * Formatters that can not serialize to a #GOutputStream save synchronously,
+ * from that function.
+ *
+ * The project is written to a temporary file which replaces @uri once
+ * completely written, so an already existing project is left untouched if
+ * the saving fails or is cancelled.
+ */
+void
+ges_timeline_save_to_uri_async (GESTimeline * timeline, const gchar * uri,
+    GESAsset * formatter_asset, gboolean overwrite, GCancellable * cancellable,
+    GAsyncReadyCallback callback, gpointer user_data)
+{
+  SaveData *data;
+  GESProject *project;
+  GOutputStream *stream;
+  gboolean serialized;
+  GSimpleAsyncResult *simple, *write_result;
+  GError *error = NULL;
+
+  g_return_if_fail (GES_IS_TIMELINE (timeline));
+  g_return_if_fail (uri != NULL);
+
+  simple = g_simple_async_result_new (G_OBJECT (timeline), callback,
+      user_data, ges_timeline_save_to_uri_async);
+  g_simple_async_result_set_check_cancellable (simple, cancellable);
+
+  project =
+      GES_PROJECT (ges_extractable_get_asset (GES_EXTRACTABLE (timeline)));
+  if (project)
+    gst_object_ref (project);
+  else
+    project = ges_project_new (NULL);
+
+  /* Both ges_project_save_to_stream and ges_project_save take ownership of
+   * the formatter asset */
+  if (formatter_asset)
+    gst_object_ref (formatter_asset);
+  stream = g_memory_output_stream_new (NULL, 0, g_realloc, g_free);
+  serialized = ges_project_save_to_stream (project, timeline, uri,
+      formatter_asset, stream, &error) &&
+      g_output_stream_close (stream, NULL, &error);
+
+  if (!serialized && g_error_matches (error, G_IO_ERROR,
+          G_IO_ERROR_NOT_SUPPORTED)) {
+    gboolean saved;
+
+    g_clear_error (&error);
+    saved = ges_project_save (project, timeline, uri, formatter_asset,
+        overwrite, &error);
+    formatter_asset = NULL;
+
+    if (error)
+      g_simple_async_result_take_error (simple, error);
+    g_simple_async_result_set_op_res_gboolean (simple, saved);
+    g_simple_async_result_complete_in_idle (simple);
+
+    goto done;
+  }
+
+  if (formatter_asset)
+    gst_object_unref (formatter_asset);
+
+  if (!serialized) {
+    if (error)
+      g_simple_async_result_take_error (simple, error);
+    else
+      g_simple_async_result_set_error (simple, G_IO_ERROR, G_IO_ERROR_FAILED,
+          "Could not serialize the timeline");
+    g_simple_async_result_set_op_res_gboolean (simple, FALSE);
+    g_simple_async_result_complete_in_idle (simple);
+
+    goto done;
+  }
+
+  data = g_slice_new0 (SaveData);
+  data->simple = g_object_ref (simple);
+  data->project = gst_object_ref (project);
+  data->uri = g_strdup (uri);
+  data->overwrite = overwrite;
+  data->serialized =
+      g_memory_output_stream_steal_as_bytes (G_MEMORY_OUTPUT_STREAM (stream));
+
+  write_result = g_simple_async_result_new (G_OBJECT (timeline),
+      (GAsyncReadyCallback) _written_cb, data, _write_in_thread);
+  g_simple_async_result_set_op_res_gpointer (write_result, data,
+      (GDestroyNotify) _free_save_data);
+  g_simple_async_result_run_in_thread (write_result, _write_in_thread,
+      G_PRIORITY_DEFAULT, cancellable);
+  g_object_unref (write_result);
+
+done:
+  g_object_unref (stream);
+  gst_object_unref (project);
+  g_object_unref (simple);
+}
+
+/**
+ * ges_timeline_save_to_uri_finish:
+ * @timeline: a #GESTimeline
+ * @result: The #GAsyncResult passed to the #GAsyncReadyCallback
+ * @error: (out) (allow-none): An error to be set in case something wrong happens or %NULL
+ *
+ * Finishes an operation started with ges_timeline_save_to_uri_async().
+ *
+ * Returns: %TRUE if the timeline was successfully saved, else %FALSE.
+ */
+gboolean
+ges_timeline_save_to_uri_finish (GESTimeline * timeline, GAsyncResult * result,
+    GError ** error)
+{
+  GSimpleAsyncResult *simple;
+
+  g_return_val_if_fail (g_simple_async_result_is_valid (result,
+          G_OBJECT (timeline), ges_timeline_save_to_uri_async), FALSE);
+
+  simple = G_SIMPLE_ASYNC_RESULT (result);
+  if (g_simple_async_result_propagate_error (simple, error))
+    return FALSE;
+
+  return g_simple_async_result_get_op_res_gboolean (simple);
+}
+
 /**
  * ges_timeline_append_layer:
  * @timeline: a #GESTimeline
@@ -2521,6 +3021,9 @@ ges_timeline_add_layer (GESTimeline * timeline, GESLayer * layer)
   ges_layer_set_timeline (layer, timeline);
 
   g_hash_table_insert (timeline->priv->by_layer, layer, g_sequence_new (NULL));
+  g_hash_table_insert (timeline->priv->intervals, layer,
+      g_hash_table_new_full (g_direct_hash, g_direct_equal, NULL,
+          (GDestroyNotify) ges_interval_tree_free));
 
   /* Connect to 'clip-added'/'clip-removed' signal from the new layer */
   g_signal_connect (layer, "clip-added", G_CALLBACK (layer_object_added_cb),
@@ -2592,6 +3095,8 @@ ges_timeline_remove_layer (GESTimeline * timeline, GESLayer * layer)
       layer_auto_transition_changed_cb, timeline);
 
   g_hash_table_remove (timeline->priv->by_layer, layer);
+  g_hash_table_remove (timeline->priv->intervals, layer);
+  g_hash_table_remove (timeline->priv->pending_layers, layer);
   timeline->layers = g_list_remove (timeline->layers, layer);
   ges_layer_set_timeline (layer, NULL);
 
@@ -2709,9 +3214,11 @@ ges_timeline_add_track (GESTimeline * timeline, GESTrack * track)
 gboolean
 ges_timeline_remove_track (GESTimeline * timeline, GESTrack * track)
 {
-  GList *tmp;
+  GList *tmp, *track_elements;
   TrackPrivate *tr_priv;
   GESTimelinePrivate *priv;
+  GHashTableIter iter;
+  GHashTable *by_track;
 
   g_return_val_if_fail (GES_IS_TRACK (track), FALSE);
   g_return_val_if_fail (GES_IS_TIMELINE (timeline), FALSE);
@@ -2730,6 +3237,21 @@ ges_timeline_remove_track (GESTimeline * timeline, GESTrack * track)
   tr_priv = tmp->data;
   priv->priv_tracks = g_list_remove (priv->priv_tracks, tr_priv);
   UNLOCK_DYN (timeline);
+
+  /* We will not be notified anymore when the sources get removed from the
+   * track, so destroy the auto transitions in between them now */
+  track_elements = ges_track_get_elements (track);
+  for (tmp = track_elements; tmp; tmp = tmp->next) {
+    if (GES_IS_SOURCE (tmp->data))
+      destroy_auto_transitions_for_source (timeline, tmp->data);
+  }
+  g_list_free_full (track_elements, gst_object_unref);
+
+  /* Freeing the interval trees detaches the sources they still contain */
+  g_hash_table_iter_init (&iter, priv->intervals);
+  while (g_hash_table_iter_next (&iter, NULL, (gpointer *) & by_track))
+    g_hash_table_remove (by_track, track);
+
   timeline->tracks = g_list_remove (timeline->tracks, track);
 
   ges_track_set_timeline (track, NULL);
@@ -2840,6 +3362,104 @@ ges_timeline_get_layers (GESTimeline * timeline)
   return res;
 }
 
+/* The simple layers compute the start of their clips lazily inside edit
+ * transactions */
+static void
+flush_simple_layers (GESTimeline * timeline)
+{
+  GList *tmp;
+
+  for (tmp = timeline->layers; tmp; tmp = tmp->next) {
+    if (GES_IS_SIMPLE_LAYER (tmp->data))
+      _ges_simple_layer_flush (tmp->data);
+  }
+}
+
+gboolean
+timeline_is_editing (GESTimeline * timeline)
+{
+  return timeline->priv->edit_depth > 0;
+}
+
+/**
+ * ges_timeline_begin_edit:
+ * @timeline: a #GESTimeline
+ *
+ * Starts an edit transaction on @timeline. Until the matching call to
+ * ges_timeline_end_edit(), the internal indexes, the auto transitions, the
+ * duration of @timeline and the starts of the clips of its
+ * #GESSimpleLayer-s are not updated on each modification of its clips but
+ * only once, when the transaction ends. This makes doing many
+ * modifications at once (for example moving hundreds of clips) much
+ * cheaper.
+ *
+ * Edit transactions can be nested, only the outermost one has an effect.
+ *
+ * Note that the changes still have to be commited with
+ * ges_timeline_commit() after the transaction ended.
+ */
+void
+ges_timeline_begin_edit (GESTimeline * timeline)
+{
+  g_return_if_fail (GES_IS_TIMELINE (timeline));
+
+  timeline->priv->edit_depth++;
+  GST_DEBUG_OBJECT (timeline, "Beginning edit, depth now %d",
+      timeline->priv->edit_depth);
+}
+
+/**
+ * ges_timeline_end_edit:
+ * @timeline: a #GESTimeline
+ *
+ * Ends an edit transaction started with ges_timeline_begin_edit(). When
+ * the outermost transaction ends, all the updates that have been postponed
+ * are done.
+ */
+void
+ges_timeline_end_edit (GESTimeline * timeline)
+{
+  GList *tmp, *elements, *layers;
+  GESTimelinePrivate *priv;
+
+  g_return_if_fail (GES_IS_TIMELINE (timeline));
+  g_return_if_fail (timeline->priv->edit_depth > 0);
+
+  priv = timeline->priv;
+  if (priv->edit_depth > 1) {
+    priv->edit_depth--;
+    return;
+  }
+
+  GST_DEBUG_OBJECT (timeline, "Ending edit, applying pending changes");
+
+  /* Still inside the transaction so that the clips they move are only
+   * reindexed once */
+  flush_simple_layers (timeline);
+  flush_pending_index_updates (timeline);
+
+  elements = g_hash_table_get_keys (priv->pending_transitions);
+  layers = g_hash_table_get_keys (priv->pending_layers);
+  g_hash_table_remove_all (priv->pending_transitions);
+  g_hash_table_remove_all (priv->pending_layers);
+
+  priv->edit_depth = 0;
+  for (tmp = elements; tmp; tmp = tmp->next)
+    create_transitions (timeline, tmp->data);
+
+  for (tmp = layers; tmp; tmp = tmp->next)
+    _create_transitions_on_layer (timeline, tmp->data, NULL, NULL,
+        _find_transition_from_auto_transitions);
+
+  g_list_free (elements);
+  g_list_free (layers);
+
+  if (priv->needs_duration_update) {
+    priv->needs_duration_update = FALSE;
+    timeline_update_duration (timeline);
+  }
+}
+
 /**
  * ges_timeline_commit:
  * @timeline: a #GESTimeline
@@ -2863,6 +3483,13 @@ ges_timeline_commit (GESTimeline * timeline)
 
   GST_DEBUG_OBJECT (timeline, "commiting changes");
 
+  if (timeline->priv->edit_depth)
+    GST_WARNING_OBJECT (timeline, "Commiting while inside an edit transaction,"
+        " the changes done since ges_timeline_begin_edit() might not all be"
+        " taken into account");
+
+  flush_simple_layers (timeline);
+  flush_pending_index_updates (timeline);
   for (tmp = timeline->layers; tmp; tmp = tmp->next) {
     _create_transitions_on_layer (timeline, GES_LAYER (tmp->data),
         NULL, NULL, _find_transition_from_auto_transitions);
@@ -22,6 +22,7 @@
 #define _GES_TIMELINE
 
 #include <glib-object.h>
+#include <gio/gio.h>
 #include <gst/gst.h>
 #include <gst/pbutils/gstdiscoverer.h>
 #include <ges/ges-types.h>
@@ -105,6 +106,11 @@ GESTimeline* ges_timeline_new_from_uri (const gchar *uri, GError **error);
 gboolean ges_timeline_load_from_uri (GESTimeline *timeline, const gchar *uri, GError **error);
 gboolean ges_timeline_save_to_uri (GESTimeline * timeline, const gchar * uri,
     GESAsset *formatter_asset, gboolean overwrite, GError ** error);
+void ges_timeline_save_to_uri_async (GESTimeline * timeline, const gchar * uri,
+    GESAsset *formatter_asset, gboolean overwrite, GCancellable * cancellable,
+    GAsyncReadyCallback callback, gpointer user_data);
+gboolean ges_timeline_save_to_uri_finish (GESTimeline * timeline,
+    GAsyncResult * result, GError ** error);
 gboolean ges_timeline_add_layer (GESTimeline *timeline, GESLayer *layer);
 GESLayer * ges_timeline_append_layer (GESTimeline * timeline);
 gboolean ges_timeline_remove_layer (GESTimeline *timeline, GESLayer *layer);
@@ -118,6 +124,9 @@ GList *ges_timeline_get_tracks (GESTimeline *timeline);
 
 gboolean ges_timeline_commit (GESTimeline * timeline);
 
+void ges_timeline_begin_edit (GESTimeline * timeline);
+void ges_timeline_end_edit (GESTimeline * timeline);
+
 GstClockTime ges_timeline_get_duration (GESTimeline *timeline);
 
 gboolean ges_timeline_get_auto_transition (GESTimeline * timeline);
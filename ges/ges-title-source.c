@@ -59,12 +59,14 @@ static void ges_title_source_set_property (GObject * object, guint
     property_id, const GValue * value, GParamSpec * pspec);
 
 static GstElement *ges_title_source_create_source (GESTrackElement * self);
+static void ges_title_source_release_element (GESTrackElement * self);
 
 static void
 ges_title_source_class_init (GESTitleSourceClass * klass)
 {
   GObjectClass *object_class = G_OBJECT_CLASS (klass);
   GESVideoSourceClass *source_class = GES_VIDEO_SOURCE_CLASS (klass);
+  GESTrackElementClass *track_class = GES_TRACK_ELEMENT_CLASS (klass);
 
   g_type_class_add_private (klass, sizeof (GESTitleSourcePrivate));
 
@@ -73,6 +75,7 @@ ges_title_source_class_init (GESTitleSourceClass * klass)
   object_class->dispose = ges_title_source_dispose;
 
   source_class->create_source = ges_title_source_create_source;
+  track_class->release_element = ges_title_source_release_element;
 }
 
 static void
@@ -184,6 +187,26 @@ ges_title_source_create_source (GESTrackElement * object)
   return topbin;
 }
 
+static void
+ges_title_source_release_element (GESTrackElement * object)
+{
+  GESTitleSourcePrivate *priv = GES_TITLE_SOURCE (object)->priv;
+
+  /* The values are kept in @priv and set on the new elements */
+  if (priv->text_el) {
+    gst_object_unref (priv->text_el);
+    priv->text_el = NULL;
+  }
+
+  if (priv->background_el) {
+    gst_object_unref (priv->background_el);
+    priv->background_el = NULL;
+  }
+
+  GES_TRACK_ELEMENT_CLASS (ges_title_source_parent_class)->release_element
+      (object);
+}
+
 /**
  * ges_title_source_set_text:
  * @self: the #GESTitleSource* to set text on
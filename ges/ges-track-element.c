@@ -59,6 +59,11 @@ struct _GESTrackElementPrivate
    * {GParamaSpec ---> element,}*/
   GHashTable *children_props;
 
+  /* Index of the children properties by name, so we do not need to go
+   * over all of them each time a property is looked up.
+   * {GQuark of "prop-name" and "ElementType::prop-name" ---> ChildProp,} */
+  GHashTable *children_props_index;
+
   GESTrack *track;
 
   gboolean valid;
@@ -69,6 +74,11 @@ struct _GESTrackElementPrivate
                                            and deserialize keyframes */
 
   GList *pending_bindings;
+
+  /* The values of the children properties that changed when the
+   * gnlobject was released, set back when it is created again.
+   * {GParamSpec ---> GValue,} */
+  GHashTable *pending_children_values;
 };
 
 typedef struct
@@ -79,6 +89,12 @@ typedef struct
   gchar *binding_type;
 } PendingBinding;
 
+typedef struct
+{
+  GstElement *element;
+  GParamSpec *pspec;
+} ChildProp;
+
 enum
 {
   PROP_0,
@@ -102,6 +118,9 @@ static GstElement *ges_track_element_create_gnl_object_func (GESTrackElement *
     object);
 
 static void connect_properties_signals (GESTrackElement * object);
+static void _free_child_prop (ChildProp * child_prop);
+static void _free_pending_binding (PendingBinding * pend);
+static void _free_value (GValue * value);
 static void connect_signal (gpointer key, gpointer value, gpointer user_data);
 static void gst_element_prop_changed_cb (GstElement * element, GParamSpec * arg
     G_GNUC_UNUSED, GESTrackElement * track_element);
@@ -166,8 +185,13 @@ ges_track_element_dispose (GObject * object)
   GESTrackElementPrivate *priv = element->priv;
 
   g_hash_table_destroy (priv->children_props);
+  g_hash_table_destroy (priv->children_props_index);
+  g_hash_table_destroy (priv->pending_children_values);
   if (priv->bindings_hashtable)
     g_hash_table_destroy (priv->bindings_hashtable);
+  g_list_free_full (priv->pending_bindings,
+      (GDestroyNotify) _free_pending_binding);
+  priv->pending_bindings = NULL;
 
   if (priv->gnlobject) {
     GstState cstate;
@@ -281,7 +305,11 @@ ges_track_element_init (GESTrackElement * self)
   priv->children_props =
       g_hash_table_new_full ((GHashFunc) pspec_hash, pspec_equal,
       (GDestroyNotify) g_param_spec_unref, gst_object_unref);
-
+  priv->children_props_index = g_hash_table_new_full (g_direct_hash,
+      g_direct_equal, NULL, (GDestroyNotify) _free_child_prop);
+  priv->pending_children_values =
+      g_hash_table_new_full ((GHashFunc) pspec_hash, pspec_equal,
+      (GDestroyNotify) g_param_spec_unref, (GDestroyNotify) _free_value);
 }
 
 static gfloat
@@ -523,6 +551,18 @@ ges_track_element_set_track_type (GESTrackElement * object, GESTrackType type)
   }
 }
 
+/* Copies the #GESTrackElement and #GESTimelineElement fields of @self into
+ * @copy, for the implementations of GESTimelineElementClass.clone */
+void
+ges_track_element_clone_fields (GESTrackElement * self,
+    GESTrackElement * copy)
+{
+  ges_track_element_set_track_type (copy, self->priv->track_type);
+  ges_track_element_set_active (copy, ges_track_element_is_active (self));
+  ges_timeline_element_clone_fields (GES_TIMELINE_ELEMENT (self),
+      GES_TIMELINE_ELEMENT (copy));
+}
+
 GESTrackType
 ges_track_element_get_track_type (GESTrackElement * object)
 {
@@ -708,6 +748,62 @@ done:
   return res;
 }
 
+static void
+_free_child_prop (ChildProp * child_prop)
+{
+  gst_object_unref (child_prop->element);
+  g_param_spec_unref (child_prop->pspec);
+  g_slice_free (ChildProp, child_prop);
+}
+
+static void
+_free_pending_binding (PendingBinding * pend)
+{
+  gst_object_unref (pend->source);
+  g_free (pend->propname);
+  g_free (pend->binding_type);
+  g_slice_free (PendingBinding, pend);
+}
+
+static void
+_free_value (GValue * value)
+{
+  g_value_unset (value);
+  g_slice_free (GValue, value);
+}
+
+static void
+_index_child_prop (GESTrackElement * self, GQuark name, GstElement * element,
+    GParamSpec * pspec)
+{
+  ChildProp *child_prop;
+
+  /* Replace any previous entry so that we agree with priv->children_props,
+   * where the last element added with a given GParamSpec wins */
+  child_prop = g_slice_new (ChildProp);
+  child_prop->element = gst_object_ref (element);
+  child_prop->pspec = g_param_spec_ref (pspec);
+  g_hash_table_insert (self->priv->children_props_index,
+      GUINT_TO_POINTER (name), child_prop);
+}
+
+static void
+_add_child_prop (GESTrackElement * self, GstElement * element,
+    GParamSpec * pspec)
+{
+  gchar *qualified_name;
+
+  g_hash_table_insert (self->priv->children_props,
+      g_param_spec_ref (pspec), gst_object_ref (element));
+
+  _index_child_prop (self, g_quark_from_string (pspec->name), element, pspec);
+  qualified_name = g_strdup_printf ("%s::%s", G_OBJECT_TYPE_NAME (element),
+      pspec->name);
+  _index_child_prop (self, g_quark_from_string (qualified_name), element,
+      pspec);
+  g_free (qualified_name);
+}
+
 static gboolean
 strv_find_str (const gchar ** strv, const char *str)
 {
@@ -770,8 +866,7 @@ ges_track_element_add_children_props (GESTrackElement * self,
       }
 
       if (pspec->flags & G_PARAM_WRITABLE) {
-        g_hash_table_insert (self->priv->children_props,
-            g_param_spec_ref (pspec), gst_object_ref (element));
+        _add_child_prop (self, element, pspec);
         GST_LOG_OBJECT (self,
             "added property %s to controllable properties successfully !",
             whitelist[i]);
@@ -821,8 +916,7 @@ ges_track_element_add_children_props (GESTrackElement * self,
             for (i = 0; i < nb_specs; i++) {
               if ((parray[i]->flags & G_PARAM_WRITABLE) &&
                   (!whitelist || strv_find_str (whitelist, parray[i]->name))) {
-                g_hash_table_insert (self->priv->children_props,
-                    g_param_spec_ref (parray[i]), gst_object_ref (child));
+                _add_child_prop (self, child, parray[i]);
               }
             }
             g_free (parray);
@@ -860,11 +954,6 @@ ges_track_element_add_children_props (GESTrackElement * self,
 }
 
 /* INTERNAL USAGE */
-static void
-_free_pending_binding (PendingBinding * pend)
-{
-  g_slice_free (PendingBinding, pend);
-}
 
 gboolean
 ges_track_element_set_track (GESTrackElement * object, GESTrack * track)
@@ -875,30 +964,11 @@ ges_track_element_set_track (GESTrackElement * object, GESTrack * track)
   object->priv->track = track;
 
   if (object->priv->track) {
-    /* If we already have a gnlobject, we just set its caps properly */
+    /* If we already have a gnlobject, we just set its caps properly,
+     * otherwise the track creates it when loading us */
     if (object->priv->gnlobject) {
       g_object_set (object->priv->gnlobject,
           "caps", ges_track_get_caps (object->priv->track), NULL);
-    } else {
-      ret = ensure_gnl_object (object);
-
-      /* if we had pending control bindings, add them and free them */
-      if (ret && object->priv->pending_bindings) {
-        GList *tmp;
-        PendingBinding *pbinding;
-
-        GST_INFO_OBJECT (object, "Asynchronously adding bindings");
-        for (tmp = object->priv->pending_bindings; tmp; tmp = tmp->next) {
-          pbinding = tmp->data;
-          ges_track_element_set_control_source (pbinding->element,
-              pbinding->source, pbinding->propname, pbinding->binding_type);
-          g_free (pbinding->propname);
-          g_free (pbinding->binding_type);
-        }
-        g_list_free_full (object->priv->pending_bindings,
-            (GDestroyNotify) _free_pending_binding);
-        object->priv->pending_bindings = NULL;
-      }
     }
   }
 
@@ -906,11 +976,146 @@ ges_track_element_set_track (GESTrackElement * object, GESTrack * track)
   return ret;
 }
 
+/* Creates the GnlObject and its content if it does not exist yet, either
+ * when the element is added to a track or later on when the track is
+ * lazy loading */
+gboolean
+ges_track_element_ensure_gnl_object (GESTrackElement * object)
+{
+  gboolean ret;
+  GValue *value;
+  GParamSpec *pspec;
+  GstElement *element;
+  GHashTableIter iter;
+
+  if (object->priv->gnlobject)
+    return TRUE;
+
+  ret = ensure_gnl_object (object) && object->priv->gnlobject;
+
+  /* Set back what had been changed before the GnlObject got released */
+  if (ret && g_hash_table_size (object->priv->pending_children_values)) {
+    g_hash_table_iter_init (&iter, object->priv->pending_children_values);
+    while (g_hash_table_iter_next (&iter, (gpointer *) & pspec,
+            (gpointer *) & value)) {
+      element = g_hash_table_lookup (object->priv->children_props, pspec);
+      if (element)
+        g_object_set_property (G_OBJECT (element), pspec->name, value);
+    }
+    g_hash_table_remove_all (object->priv->pending_children_values);
+  }
+
+  /* if we had pending control bindings, add them and free them */
+  if (ret && object->priv->pending_bindings) {
+    GList *tmp;
+    PendingBinding *pbinding;
+
+    GST_INFO_OBJECT (object, "Asynchronously adding bindings");
+    for (tmp = object->priv->pending_bindings; tmp; tmp = tmp->next) {
+      pbinding = tmp->data;
+      ges_track_element_set_control_source (pbinding->element,
+          pbinding->source, pbinding->propname, pbinding->binding_type);
+    }
+    g_list_free_full (object->priv->pending_bindings,
+        (GDestroyNotify) _free_pending_binding);
+    object->priv->pending_bindings = NULL;
+  }
+
+  return ret;
+}
+
+/* Destroys the GnlObject and its content, keeping what is needed to create
+ * them again as they were: the timing, the children properties that changed
+ * and the control bindings. Used by the track for the elements that are out
+ * of its window, the next _ensure_loaded() creates them again */
+void
+ges_track_element_release_gnl_object (GESTrackElement * object)
+{
+  GValue *value;
+  GParamSpec *pspec;
+  GstElement *element;
+  GHashTableIter iter;
+  const gchar *propname;
+  GstControlBinding *binding;
+  PendingBinding *pbinding;
+  GESTrackElementPrivate *priv = object->priv;
+  GESTrackElementClass *klass = GES_TRACK_ELEMENT_GET_CLASS (object);
+
+  if (priv->gnlobject == NULL)
+    return;
+
+  GST_DEBUG_OBJECT (object, "Releasing %" GST_PTR_FORMAT, priv->gnlobject);
+
+  priv->pending_start = _START (object);
+  priv->pending_inpoint = _INPOINT (object);
+  priv->pending_duration = _DURATION (object);
+  priv->pending_priority = _PRIORITY (object);
+  priv->pending_active = object->active;
+
+  g_hash_table_iter_init (&iter, priv->children_props);
+  while (g_hash_table_iter_next (&iter, (gpointer *) & pspec,
+          (gpointer *) & element)) {
+    if (!(pspec->flags & G_PARAM_READABLE) ||
+        (pspec->flags & G_PARAM_CONSTRUCT_ONLY))
+      continue;
+
+    value = g_slice_new0 (GValue);
+    g_value_init (value, pspec->value_type);
+    g_object_get_property (G_OBJECT (element), pspec->name, value);
+    if (g_param_value_defaults (pspec, value)) {
+      _free_value (value);
+      continue;
+    }
+
+    g_hash_table_insert (priv->pending_children_values,
+        g_param_spec_ref (pspec), value);
+  }
+
+  /* The bindings go away with the elements, their sources are kept */
+  g_hash_table_iter_init (&iter, priv->bindings_hashtable);
+  while (g_hash_table_iter_next (&iter, (gpointer *) & propname,
+          (gpointer *) & binding)) {
+    pbinding = g_slice_new0 (PendingBinding);
+    pbinding->element = object;
+    g_object_get (binding, "control-source", &pbinding->source, NULL);
+    pbinding->propname = g_strdup (propname);
+    pbinding->binding_type = g_strdup ("direct");
+    priv->pending_bindings = g_list_append (priv->pending_bindings, pbinding);
+  }
+  g_hash_table_remove_all (priv->bindings_hashtable);
+
+  if (klass->release_element)
+    klass->release_element (object);
+
+  g_hash_table_remove_all (priv->children_props_index);
+  g_hash_table_remove_all (priv->children_props);
+
+  gst_element_set_state (priv->gnlobject, GST_STATE_NULL);
+  g_object_set_qdata (G_OBJECT (priv->gnlobject),
+      GNL_OBJECT_TRACK_ELEMENT_QUARK, NULL);
+  gst_object_unref (priv->gnlobject);
+  priv->gnlobject = NULL;
+  priv->element = NULL;
+  priv->valid = FALSE;
+}
+
+/* The children properties only exist once the element has been created */
+static inline void
+_ensure_loaded (GESTrackElement * object)
+{
+  if (G_UNLIKELY (object->priv->gnlobject == NULL && object->priv->track))
+    ges_track_element_ensure_gnl_object (object);
+}
+
 GHashTable *
 ges_track_element_get_bindings_hashtable (GESTrackElement * trackelement)
 {
   GESTrackElementPrivate *priv = GES_TRACK_ELEMENT (trackelement)->priv;
 
+  /* The bindings of a released element are only created back with it */
+  if (priv->pending_bindings)
+    _ensure_loaded (trackelement);
+
   return priv->bindings_hashtable;
 }
 
@@ -946,7 +1151,9 @@ ges_track_element_get_track (GESTrackElement * object)
  *
  * Get the GNonLin object this object is controlling.
  *
- * Returns: (transfer none): the GNonLin object this object is controlling.
+ * Returns: (transfer none): the GNonLin object this object is controlling,
+ * %NULL if it has not been created yet or has been released, see
+ * ges_track_set_lazy_loading() and ges_track_set_window_size().
  */
 GstElement *
 ges_track_element_get_gnlobject (GESTrackElement * object)
@@ -963,7 +1170,8 @@ ges_track_element_get_gnlobject (GESTrackElement * object)
  * Get the #GstElement this track element is controlling within GNonLin.
  *
  * Returns: (transfer none): the #GstElement this track element is controlling
- * within GNonLin.
+ * within GNonLin, %NULL if it has not been created yet or has been released,
+ * see ges_track_set_lazy_loading() and ges_track_set_window_size().
  */
 GstElement *
 ges_track_element_get_element (GESTrackElement * object)
@@ -1001,16 +1209,17 @@ ges_track_element_is_active (GESTrackElement * object)
  * @prop_name: name of the property to look up. You can specify the name of the
  *     class as such: "ClassName::property-name", to guarantee that you get the
  *     proper GParamSpec in case various GstElement-s contain the same property
- *     name. If you don't do so, you will get the first element found, having
- *     this property and the and the corresponding GParamSpec.
+ *     name. If you don't do so, you will get the last element found having
+ *     this property and the corresponding GParamSpec.
  * @element: (out) (allow-none) (transfer full): pointer to a #GstElement that
  *     takes the real object to set property on
  * @pspec: (out) (allow-none) (transfer full): pointer to take the #GParamSpec
  *     describing the property
  *
  * Looks up which @element and @pspec would be effected by the given @name. If various
- * contained elements have this property name you will get the first one, unless you
- * specify the class name in @name.
+ * contained elements have this property name you will get the last one, the one
+ * ges_track_element_set_child_property_by_pspec() acts on, unless you specify
+ * the class name in @name.
  *
  * Returns: TRUE if @element and @pspec could be found. FALSE otherwise. In that
  * case the values for @pspec and @element are not modified. Unref @element after
@@ -1022,41 +1231,30 @@ gboolean
 ges_track_element_lookup_child (GESTrackElement * object,
     const gchar * prop_name, GstElement ** element, GParamSpec ** pspec)
 {
-  GHashTableIter iter;
-  gpointer key, value;
-  gchar **names, *name, *classename;
-  gboolean res;
+  GQuark name;
+  ChildProp *child_prop;
 
   g_return_val_if_fail (GES_IS_TRACK_ELEMENT (object), FALSE);
 
-  classename = NULL;
-  res = FALSE;
+  _ensure_loaded (object);
 
-  names = g_strsplit (prop_name, "::", 2);
-  if (names[1] != NULL) {
-    classename = names[0];
-    name = names[1];
-  } else
-    name = names[0];
+  /* A name that has never been interned can not be in the index */
+  name = g_quark_try_string (prop_name);
+  if (!name)
+    return FALSE;
 
-  g_hash_table_iter_init (&iter, object->priv->children_props);
-  while (g_hash_table_iter_next (&iter, &key, &value)) {
-    if (g_strcmp0 (G_PARAM_SPEC (key)->name, name) == 0) {
-      if (classename == NULL ||
-          g_strcmp0 (G_OBJECT_TYPE_NAME (G_OBJECT (value)), classename) == 0) {
-        GST_DEBUG ("The %s property from %s has been found", name, classename);
-        if (element)
-          *element = gst_object_ref (value);
-
-        *pspec = g_param_spec_ref (key);
-        res = TRUE;
-        break;
-      }
-    }
-  }
-  g_strfreev (names);
+  child_prop = g_hash_table_lookup (object->priv->children_props_index,
+      GUINT_TO_POINTER (name));
+  if (!child_prop)
+    return FALSE;
 
-  return res;
+  GST_DEBUG ("The %s property has been found", prop_name);
+  if (element)
+    *element = gst_object_ref (child_prop->element);
+
+  *pspec = g_param_spec_ref (child_prop->pspec);
+
+  return TRUE;
 }
 
 /**
@@ -1076,7 +1274,7 @@ ges_track_element_set_child_property_by_pspec (GESTrackElement * object,
   GstElement *element;
   g_return_if_fail (GES_IS_TRACK_ELEMENT (object));
 
-
+  _ensure_loaded (object);
   element = g_hash_table_lookup (object->priv->children_props, pspec);
   if (!element)
     goto not_found;
@@ -1102,7 +1300,7 @@ not_found:
  * Sets a property of a child of @object. If there are various child elements
  * that have the same property name, you can distinguish them using the following
  * syntax: 'ClasseName::property_name' as property name. If you don't, the
- * corresponding property of the first element found will be set.
+ * corresponding property of the last element found will be set.
  *
  * Since: 0.10.2
  */
@@ -1173,7 +1371,7 @@ cant_copy:
  * Sets a property of a child of @object. If there are various child elements
  * that have the same property name, you can distinguish them using the following
  * syntax: 'ClasseName::property_name' as property name. If you don't, the
- * corresponding property of the first element found will be set.
+ * corresponding property of the last element found will be set.
  *
  * Since: 0.10.2
  */
@@ -1201,7 +1399,7 @@ ges_track_element_set_child_properties (GESTrackElement * object,
  * Gets a property of a child of @object. If there are various child elements
  * that have the same property name, you can distinguish them using the following
  * syntax: 'ClasseName::property_name' as property name. If you don't, the
- * corresponding property of the first element found will be set.
+ * corresponding property of the last element found will be set.
  *
  * Since: 0.10.2
  */
@@ -1273,6 +1471,7 @@ ges_track_element_list_children_properties (GESTrackElement * object,
 
   class = GES_TRACK_ELEMENT_GET_CLASS (object);
 
+  _ensure_loaded (object);
   return class->list_children_properties (object, n_properties);
 }
 
@@ -1319,6 +1518,7 @@ ges_track_element_get_child_property_by_pspec (GESTrackElement * object,
 
   g_return_if_fail (GES_IS_TRACK_ELEMENT (object));
 
+  _ensure_loaded (object);
   element = g_hash_table_lookup (object->priv->children_props, pspec);
   if (!element)
     goto not_found;
@@ -1456,6 +1656,13 @@ ges_track_element_copy_properties (GESTimelineElement * element,
   GValue val = { 0 };
   GESTrackElement *copy = GES_TRACK_ELEMENT (elementcopy);
 
+  /* Nothing can have been changed on an element that has never been loaded,
+   * a released one keeps what changed in its pending children values */
+  if (GES_TRACK_ELEMENT (element)->priv->gnlobject == NULL &&
+      g_hash_table_size (GES_TRACK_ELEMENT (element)->
+          priv->pending_children_values) == 0)
+    return;
+
   ensure_gnl_object (copy);
   specs =
       ges_track_element_list_children_properties (GES_TRACK_ELEMENT (element),
@@ -1475,24 +1682,22 @@ void
 ges_track_element_split_bindings (GESTrackElement * element,
     GESTrackElement * new_element, guint64 position)
 {
-  GParamSpec **specs;
-  guint n, n_specs;
+  GHashTableIter iter;
+  const gchar *property_name;
   GstControlBinding *binding;
   GstTimedValueControlSource *source, *new_source;
 
-  specs =
-      ges_track_element_list_children_properties (GES_TRACK_ELEMENT (element),
-      &n_specs);
-  for (n = 0; n < n_specs; ++n) {
+  /* Only the controlled properties matter, no need to go through all the
+   * children properties */
+  g_hash_table_iter_init (&iter,
+      ges_track_element_get_bindings_hashtable (element));
+  while (g_hash_table_iter_next (&iter, (gpointer *) & property_name,
+          (gpointer *) & binding)) {
     GList *values, *tmp;
     GstTimedValue *last_value = NULL;
     gboolean past_position = FALSE;
     GstInterpolationMode mode;
 
-    binding = ges_track_element_get_control_binding (element, specs[n]->name);
-    if (!binding)
-      continue;
-
     g_object_get (binding, "control_source", &source, NULL);
 
     /* FIXME : this should work as well with other types of control sources */
@@ -1538,10 +1743,8 @@ ges_track_element_split_bindings (GESTrackElement * element,
 
     /* We only manage direct bindings, see TODO in set_control_source */
     ges_track_element_set_control_source (new_element,
-        GST_CONTROL_SOURCE (new_source), specs[n]->name, "direct");
+        GST_CONTROL_SOURCE (new_source), property_name, "direct");
   }
-
-  g_free (specs);
 }
 
 /**
@@ -1652,7 +1855,7 @@ ges_track_element_set_control_source (GESTrackElement * object,
     GST_INFO ("Adding this source to the future bindings");
     pbinding = g_slice_new0 (PendingBinding);
     pbinding->element = object;
-    pbinding->source = source;
+    pbinding->source = gst_object_ref (source);
     pbinding->propname = g_strdup (property_name);
     pbinding->binding_type = g_strdup (binding_type);
     priv->pending_bindings = g_list_append (priv->pending_bindings, pbinding);
@@ -1706,15 +1909,12 @@ GstControlBinding *
 ges_track_element_get_control_binding (GESTrackElement * object,
     const gchar * property_name)
 {
-  GESTrackElementPrivate *priv;
   GstControlBinding *binding;
 
   g_return_val_if_fail (GES_IS_TRACK_ELEMENT (object), NULL);
 
-  priv = GES_TRACK_ELEMENT (object)->priv;
-
   binding =
-      (GstControlBinding *) g_hash_table_lookup (priv->bindings_hashtable,
-      property_name);
+      (GstControlBinding *) g_hash_table_lookup
+      (ges_track_element_get_bindings_hashtable (object), property_name);
   return binding;
 }
@@ -80,6 +80,11 @@ struct _GESTrackElement {
  *                            The default implementation will create an object
  *                            of type @gnlobject_factorytype and call
  *                            @create_element. Since: 0.10.2
+ * @release_element: method called before the element created by
+ *                   @create_element is released, when the #GESTrack drops
+ *                   the GNonLin objects that are outside of its window.
+ *                   Subclasses have to forget what they hold from it there,
+ *                   @create_element is called again when it is needed.
  *
  * Subclasses can override the @create_gnl_object method to override what type
  * of GNonLin object will be created.
@@ -104,9 +109,11 @@ struct _GESTrackElementClass {
   /* virtual methods for subclasses */
   GParamSpec** (*list_children_properties) (GESTrackElement * object,
               guint *n_properties);
+  void (*release_element)      (GESTrackElement *object);
+
   /*< private >*/
   /* Padding for API extension */
-  gpointer _ges_reserved[GES_PADDING_LARGE];
+  gpointer _ges_reserved[GES_PADDING_LARGE - 1];
 };
 
 GType ges_track_element_get_type               (void);
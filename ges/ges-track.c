@@ -56,7 +56,11 @@ struct _GESTrackPrivate
   GESTimeline *timeline;
   GSequence *trackelements_by_start;
   GHashTable *trackelements_iter;
-  GList *gaps;
+  GList *gaps;                  /* Sorted by start */
+
+  /* Statistics about the gaps */
+  guint gaps_created;
+  guint gaps_reused;
 
   guint64 duration;
 
@@ -70,6 +74,27 @@ struct _GESTrackPrivate
 
   gboolean mixing;
   GstElement *mixing_operation;
+
+  /* When lazy loading, the GnlObject-s of the track elements are only
+   * created and added to the composition when needed.
+   * {GESTrackElement -> GESTrackElement} not in the composition yet */
+  gboolean lazy_loading;
+  GHashTable *unloaded_elements;
+
+  /* When @window_size is valid, only the elements in
+   * [window_start, window_start + window_size[ are in the composition.
+   * {GESTrackElement -> GESTrackElement} in the composition */
+  GstClockTime window_size;
+  GstClockTime window_start;
+  GHashTable *window_elements;
+  /* Duration of the longest element ever added, to bound the search of
+   * the elements starting before the window but ending in it */
+  GstClockTime longest_element;
+
+  /* Streaming thread state used to follow the playback */
+  GstSegment segment;
+  gboolean window_update_pending;
+  GstClockTime pending_window_position;
   GstElement *capsfilter;
 
   /* Virtual method to create GstElement that fill gaps */
@@ -93,7 +118,11 @@ static guint ges_track_signals[LAST_SIGNAL] = { 0 };
 
 static GParamSpec *properties[ARG_LAST];
 
+#define WINDOWED(track) GST_CLOCK_TIME_IS_VALID ((track)->priv->window_size)
+
 static void pad_added_cb (GstElement * element, GstPad * pad, GESTrack * track);
+static GstPadProbeReturn window_probe_cb (GstPad * pad,
+    GstPadProbeInfo * info, GESTrack * track);
 static void
 pad_removed_cb (GstElement * element, GstPad * pad, GESTrack * track);
 static void composition_duration_cb (GstElement * composition, GParamSpec * arg
@@ -174,11 +203,51 @@ free_gap (Gap * gap)
   g_slice_free (Gap, gap);
 }
 
-static inline void
-update_gaps (GESTrack * track)
+static void
+free_hole (Gap * hole)
+{
+  g_slice_free (Gap, hole);
+}
+
+static gint
+compare_gaps (Gap * a, Gap * b)
+{
+  if (a->start < b->start)
+    return -1;
+  if (a->start > b->start)
+    return 1;
+
+  return 0;
+}
+
+static void
+gap_update (Gap * gap, GstClockTime start, GstClockTime duration)
+{
+  if (gap->start == start && gap->duration == duration)
+    return;
+
+  GST_DEBUG_OBJECT (gap->track, "Moving gap from %" GST_TIME_FORMAT
+      " duration %" GST_TIME_FORMAT " to %" GST_TIME_FORMAT " duration %"
+      GST_TIME_FORMAT, GST_TIME_ARGS (gap->start),
+      GST_TIME_ARGS (gap->duration), GST_TIME_ARGS (start),
+      GST_TIME_ARGS (duration));
+
+  if (gap->start != start)
+    g_object_set (gap->gnlobj, "start", start, NULL);
+  if (gap->duration != duration)
+    g_object_set (gap->gnlobj, "duration", duration, NULL);
+
+  gap->start = start;
+  gap->duration = duration;
+}
+
+/* Compute the holes in between the track elements as a list of
+ * newly allocated Gap structures (without any gnlobject) sorted by start */
+static GList *
+compute_holes (GESTrack * track)
 {
-  Gap *gap;
-  GList *gaps;
+  Gap *hole;
+  GList *holes = NULL;
   GSequenceIter *it;
 
   GESTrackElement *trackelement;
@@ -186,59 +255,121 @@ update_gaps (GESTrack * track)
 
   GESTrackPrivate *priv = track->priv;
 
-  if (priv->create_element_for_gaps == NULL) {
-    GST_INFO ("Not filling the gaps as no create_element_for_gaps vmethod"
-        " provided");
-    return;
-  }
-
-  gaps = priv->gaps;
-  priv->gaps = NULL;
-
-  /* 1- And recalculate gaps */
   for (it = g_sequence_get_begin_iter (priv->trackelements_by_start);
       g_sequence_iter_is_end (it) == FALSE; it = g_sequence_iter_next (it)) {
     trackelement = g_sequence_get (it);
 
+    /* Not in the composition, a gap is needed there */
+    if (g_hash_table_contains (priv->unloaded_elements, trackelement))
+      continue;
+
     start = _START (trackelement);
     end = start + _DURATION (trackelement);
 
     if (start > duration) {
-      /* 2- Fill gap */
-      gap = gap_new (track, duration, start - duration);
-
-      if (G_LIKELY (gap != NULL))
-        priv->gaps = g_list_prepend (priv->gaps, gap);
+      hole = g_slice_new0 (Gap);
+      hole->start = duration;
+      hole->duration = start - duration;
+      holes = g_list_prepend (holes, hole);
     }
 
     duration = MAX (duration, end);
   }
 
-  /* 4- Add a gap at the end of the timeline if needed */
+  /* Add a gap at the end of the timeline if needed */
   if (priv->timeline) {
     g_object_get (priv->timeline, "duration", &timeline_duration, NULL);
 
     if (duration < timeline_duration) {
-      gap = gap_new (track, duration, timeline_duration - duration);
-
-      if (G_LIKELY (gap != NULL)) {
-        priv->gaps = g_list_prepend (priv->gaps, gap);
-      }
+      hole = g_slice_new0 (Gap);
+      hole->start = duration;
+      hole->duration = timeline_duration - duration;
+      holes = g_list_prepend (holes, hole);
 
       priv->duration = timeline_duration;
     }
   }
 
-  /* 4- Remove old gaps */
-  g_list_free_full (gaps, (GDestroyNotify) free_gap);
+  return g_list_reverse (holes);
 }
 
 static inline void
-resort_and_fill_gaps (GESTrack * track)
+update_gaps (GESTrack * track)
 {
-  g_sequence_sort (track->priv->trackelements_by_start,
-      (GCompareDataFunc) element_start_compare, NULL);
+  Gap *gap, *hole;
+  GList *holes, *tmp, *old, *unmatched_holes = NULL, *spare_gaps = NULL;
+
+  GESTrackPrivate *priv = track->priv;
+
+  if (priv->create_element_for_gaps == NULL) {
+    GST_INFO ("Not filling the gaps as no create_element_for_gaps vmethod"
+        " provided");
+    return;
+  }
+
+  /* 1- Recalculate the holes, sorted by start as priv->gaps is */
+  holes = compute_holes (track);
+  old = priv->gaps;
+  priv->gaps = NULL;
+
+  /* 2- Keep the gaps that did not move, only updating their durations.
+   *    Both lists being sorted by start, this is a simple merge */
+  tmp = holes;
+  while (tmp || old) {
+    hole = tmp ? tmp->data : NULL;
+    gap = old ? old->data : NULL;
+
+    if (hole && gap && gap->start == hole->start) {
+      gap_update (gap, hole->start, hole->duration);
+      priv->gaps = g_list_prepend (priv->gaps, gap);
+      priv->gaps_reused++;
+
+      g_slice_free (Gap, hole);
+      tmp = tmp->next;
+      old = g_list_delete_link (old, old);
+    } else if (hole && (gap == NULL || hole->start < gap->start)) {
+      unmatched_holes = g_list_prepend (unmatched_holes, hole);
+      tmp = tmp->next;
+    } else {
+      spare_gaps = g_list_prepend (spare_gaps, gap);
+      old = g_list_delete_link (old, old);
+    }
+  }
+  g_list_free (holes);
+
+  /* 3- Move the gaps that are not needed anymore to fill the new holes,
+   *    and only create new gaps when we run out of them */
+  for (tmp = unmatched_holes; tmp; tmp = tmp->next) {
+    hole = tmp->data;
 
+    if (spare_gaps) {
+      gap = spare_gaps->data;
+      spare_gaps = g_list_delete_link (spare_gaps, spare_gaps);
+
+      gap_update (gap, hole->start, hole->duration);
+      priv->gaps_reused++;
+    } else {
+      gap = gap_new (track, hole->start, hole->duration);
+
+      if (G_UNLIKELY (gap == NULL))
+        continue;
+
+      priv->gaps_created++;
+    }
+
+    priv->gaps = g_list_prepend (priv->gaps, gap);
+  }
+  g_list_free_full (unmatched_holes, (GDestroyNotify) free_hole);
+
+  /* 4- Remove old gaps that could not be reused */
+  g_list_free_full (spare_gaps, (GDestroyNotify) free_gap);
+
+  priv->gaps = g_list_sort (priv->gaps, (GCompareFunc) compare_gaps);
+}
+
+static inline void
+fill_gaps (GESTrack * track)
+{
   if (track->priv->updating == TRUE) {
     update_gaps (track);
   }
@@ -249,8 +380,21 @@ static void
 sort_track_elements_cb (GESTrackElement * child,
     GParamSpec * arg G_GNUC_UNUSED, GESTrack * track)
 {
-  g_sequence_sort (track->priv->trackelements_by_start,
-      (GCompareDataFunc) element_start_compare, NULL);
+  GSequenceIter *iter = g_hash_table_lookup (track->priv->trackelements_iter,
+      child);
+
+  if (G_UNLIKELY (iter == NULL)) {
+    GST_WARNING_OBJECT (track, "%" GST_PTR_FORMAT " not in the track", child);
+    return;
+  }
+
+  track->priv->longest_element = MAX (track->priv->longest_element,
+      _DURATION (child));
+
+  /* Only @child changed, move it to its new position, keeping
+   * trackelements_by_start sorted */
+  g_sequence_sort_changed (iter, (GCompareDataFunc) element_start_compare,
+      NULL);
 }
 
 static void
@@ -271,6 +415,9 @@ pad_added_cb (GstElement * element, GstPad * pad, GESTrack * track)
   priv->srcpad = gst_ghost_pad_new ("src", capsfilter_src);
   gst_pad_set_active (priv->srcpad, TRUE);
   gst_element_add_pad (GST_ELEMENT (track), priv->srcpad);
+  gst_pad_add_probe (priv->srcpad,
+      GST_PAD_PROBE_TYPE_BUFFER | GST_PAD_PROBE_TYPE_EVENT_BOTH,
+      (GstPadProbeCallback) window_probe_cb, track, NULL);
 
   GST_DEBUG ("done");
 }
@@ -333,7 +480,13 @@ remove_object_internal (GESTrack * track, GESTrackElement * object)
     return FALSE;
   }
 
-  if ((gnlobject = ges_track_element_get_gnlobject (object))) {
+  g_hash_table_remove (priv->unloaded_elements, object);
+  g_hash_table_remove (priv->window_elements, object);
+
+  /* The GnlObject might have been created but not added yet */
+  gnlobject = ges_track_element_get_gnlobject (object);
+  if (gnlobject &&
+      GST_OBJECT_PARENT (gnlobject) == GST_OBJECT (priv->composition)) {
     GST_DEBUG ("Removing GnlObject '%s' from composition '%s'",
         GST_ELEMENT_NAME (gnlobject), GST_ELEMENT_NAME (priv->composition));
 
@@ -345,7 +498,7 @@ remove_object_internal (GESTrack * track, GESTrackElement * object)
     gst_element_set_state (gnlobject, GST_STATE_NULL);
   }
 
-  g_signal_handlers_disconnect_by_func (object, sort_track_elements_cb, NULL);
+  g_signal_handlers_disconnect_by_func (object, sort_track_elements_cb, track);
 
   ges_track_element_set_track (object, NULL);
   ges_timeline_element_set_timeline (GES_TIMELINE_ELEMENT (object), NULL);
@@ -421,6 +574,8 @@ ges_track_dispose (GObject * object)
   g_sequence_foreach (track->priv->trackelements_by_start,
       (GFunc) dispose_trackelements_foreach, track);
   g_sequence_free (priv->trackelements_by_start);
+  g_hash_table_unref (priv->unloaded_elements);
+  g_hash_table_unref (priv->window_elements);
   g_list_free_full (priv->gaps, (GDestroyNotify) free_gap);
 
   if (priv->composition) {
@@ -486,10 +641,279 @@ ges_track_constructed (GObject * object)
   }
 }
 
+static gboolean
+load_element (GESTrack * track, GESTrackElement * object)
+{
+  if (!ges_track_element_ensure_gnl_object (object)) {
+    GST_ERROR_OBJECT (track, "Could not create the GnlObject of %"
+        GST_PTR_FORMAT, object);
+    return FALSE;
+  }
+
+  GST_DEBUG ("Adding object %s to ourself %s",
+      GST_OBJECT_NAME (ges_track_element_get_gnlobject (object)),
+      GST_OBJECT_NAME (track->priv->composition));
+
+  if (G_UNLIKELY (!gst_bin_add (GST_BIN (track->priv->composition),
+              ges_track_element_get_gnlobject (object)))) {
+    GST_WARNING ("Couldn't add object to the GnlComposition");
+    return FALSE;
+  }
+
+  return TRUE;
+}
+
+static void
+unload_element (GESTrack * track, GESTrackElement * object)
+{
+  GstElement *gnlobject = ges_track_element_get_gnlobject (object);
+
+  GST_DEBUG_OBJECT (track, "Removing %" GST_PTR_FORMAT " from the composition",
+      object);
+
+  gst_bin_remove (GST_BIN (track->priv->composition), gnlobject);
+  gst_element_set_state (gnlobject, GST_STATE_NULL);
+  g_hash_table_insert (track->priv->unloaded_elements, object, object);
+
+  /* So that the memory used by the track is bounded by its window, it is
+   * created again the next time it is needed */
+  ges_track_element_release_gnl_object (object);
+}
+
+static inline gboolean
+in_window (GESTrack * track, GESTrackElement * object)
+{
+  GESTrackPrivate *priv = track->priv;
+
+  return _START (object) < priv->window_start + priv->window_size &&
+      _START (object) + _DURATION (object) > priv->window_start;
+}
+
+/* First element starting at or after @position */
+static GSequenceIter *
+first_element_from (GESTrack * track, GstClockTime position)
+{
+  GSequence *elements = track->priv->trackelements_by_start;
+  gint low = 0, high = g_sequence_get_length (elements), mid;
+
+  while (low < high) {
+    mid = (low + high) / 2;
+    if (_START (g_sequence_get (g_sequence_get_iter_at_pos (elements,
+                    mid))) < position)
+      low = mid + 1;
+    else
+      high = mid;
+  }
+
+  return g_sequence_get_iter_at_pos (elements, low);
+}
+
+/* Makes the composition contain exactly the elements that are in the
+ * window, returns whether anything changed */
+static gboolean
+update_window (GESTrack * track)
+{
+  GSequenceIter *it;
+  GHashTableIter iter;
+  GESTrackElement *object;
+  gboolean changed = FALSE;
+  GESTrackPrivate *priv = track->priv;
+
+  /* 1- Remove what is not in the window anymore */
+  g_hash_table_iter_init (&iter, priv->window_elements);
+  while (g_hash_table_iter_next (&iter, (gpointer *) & object, NULL)) {
+    if (!in_window (track, object)) {
+      unload_element (track, object);
+      g_hash_table_iter_remove (&iter);
+      changed = TRUE;
+    }
+  }
+
+  /* 2- Add what entered it, going back from the end of the window until
+   * no element can reach it anymore */
+  it = first_element_from (track, priv->window_start + priv->window_size);
+  while (!g_sequence_iter_is_begin (it)) {
+    it = g_sequence_iter_prev (it);
+    object = g_sequence_get (it);
+
+    if (_START (object) + priv->longest_element <= priv->window_start)
+      break;
+
+    if (in_window (track, object) &&
+        g_hash_table_remove (priv->unloaded_elements, object)) {
+      if (load_element (track, object))
+        g_hash_table_insert (priv->window_elements, object, object);
+      changed = TRUE;
+    }
+  }
+
+  GST_DEBUG_OBJECT (track, "%u elements in the window starting at %"
+      GST_TIME_FORMAT, g_hash_table_size (priv->window_elements),
+      GST_TIME_ARGS (priv->window_start));
+
+  return changed;
+}
+
+/* Adds all the elements the lazy loading delayed to the composition, or
+ * only the ones in the window, returns whether there was any */
+static gboolean
+load_elements (GESTrack * track)
+{
+  GHashTableIter iter;
+  GESTrackElement *object;
+  GESTrackPrivate *priv = track->priv;
+
+  if (WINDOWED (track))
+    return update_window (track);
+
+  if (g_hash_table_size (priv->unloaded_elements) == 0)
+    return FALSE;
+
+  GST_INFO_OBJECT (track, "Loading %u track elements",
+      g_hash_table_size (priv->unloaded_elements));
+
+  g_hash_table_iter_init (&iter, priv->unloaded_elements);
+  while (g_hash_table_iter_next (&iter, (gpointer *) & object, NULL)) {
+    load_element (track, object);
+    g_hash_table_iter_remove (&iter);
+  }
+
+  return TRUE;
+}
+
+static gboolean
+update_window_idle (GESTrack * track)
+{
+  GstClockTime position;
+
+  GST_OBJECT_LOCK (track);
+  position = track->priv->pending_window_position;
+  track->priv->window_update_pending = FALSE;
+  GST_OBJECT_UNLOCK (track);
+
+  if (WINDOWED (track))
+    ges_track_set_window_position (track, position);
+
+  return FALSE;
+}
+
+typedef struct
+{
+  GESTrack *track;
+  GstClockTime position;
+
+  GMutex lock;
+  GCond cond;
+  gboolean done;
+} WindowMove;
+
+/* Called from the default main context, the thread seeking waits for it */
+static gboolean
+move_window_cb (WindowMove * move)
+{
+  if (WINDOWED (move->track))
+    ges_track_set_window_position (move->track, move->position);
+
+  g_mutex_lock (&move->lock);
+  move->done = TRUE;
+  g_cond_signal (&move->cond);
+  g_mutex_unlock (&move->lock);
+
+  return FALSE;
+}
+
+static GstPadProbeReturn
+window_probe_cb (GstPad * pad, GstPadProbeInfo * info, GESTrack * track)
+{
+  GstEvent *event;
+  GstClockTime position;
+  GESTrackPrivate *priv = track->priv;
+
+  if (!WINDOWED (track))
+    return GST_PAD_PROBE_OK;
+
+  if (GST_PAD_PROBE_INFO_TYPE (info) & GST_PAD_PROBE_TYPE_BUFFER) {
+    position = gst_segment_to_stream_time (&priv->segment, GST_FORMAT_TIME,
+        GST_BUFFER_PTS (GST_PAD_PROBE_INFO_BUFFER (info)));
+
+    /* Move the window once half of it has been played, from the main
+     * thread as the composition can not be changed while streaming */
+    GST_OBJECT_LOCK (track);
+    if (GST_CLOCK_TIME_IS_VALID (position) && !priv->window_update_pending &&
+        (position < priv->window_start ||
+            position > priv->window_start + priv->window_size / 2)) {
+      priv->window_update_pending = TRUE;
+      priv->pending_window_position = position;
+      g_idle_add_full (G_PRIORITY_HIGH, (GSourceFunc) update_window_idle,
+          gst_object_ref (track), gst_object_unref);
+    }
+    GST_OBJECT_UNLOCK (track);
+
+    return GST_PAD_PROBE_OK;
+  }
+
+  event = GST_PAD_PROBE_INFO_EVENT (info);
+  if (GST_EVENT_TYPE (event) == GST_EVENT_SEGMENT) {
+    gst_event_copy_segment (event, &priv->segment);
+  } else if (GST_EVENT_TYPE (event) == GST_EVENT_SEEK) {
+    gint64 start;
+    GstFormat format;
+    WindowMove move;
+    GstSeekType start_type;
+
+    gst_event_parse_seek (event, NULL, &format, NULL, &start_type, &start,
+        NULL, NULL);
+
+    if (format != GST_FORMAT_TIME || start_type != GST_SEEK_TYPE_SET ||
+        start < 0)
+      return GST_PAD_PROBE_OK;
+
+    /* The composition needs to have the elements before it seeks, and it
+     * can only be changed from the main context, as any other change to
+     * the track. The window is moved right away if this thread can own the
+     * main context, otherwise the seek waits for the thread running it to
+     * move the window */
+    move.track = track;
+    move.position = start;
+    move.done = FALSE;
+    g_mutex_init (&move.lock);
+    g_cond_init (&move.cond);
+
+    g_main_context_invoke_full (NULL, G_PRIORITY_HIGH,
+        (GSourceFunc) move_window_cb, &move, NULL);
+
+    g_mutex_lock (&move.lock);
+    while (!move.done)
+      g_cond_wait (&move.cond, &move.lock);
+    g_mutex_unlock (&move.lock);
+
+    g_mutex_clear (&move.lock);
+    g_cond_clear (&move.cond);
+  }
+
+  return GST_PAD_PROBE_OK;
+}
+
+static GstStateChangeReturn
+ges_track_change_state (GstElement * element, GstStateChange transition)
+{
+  GESTrack *track = GES_TRACK (element);
+
+  /* The elements need to be in the composition before it starts
+   * prerolling */
+  if (transition == GST_STATE_CHANGE_READY_TO_PAUSED &&
+      g_hash_table_size (track->priv->unloaded_elements))
+    ges_track_commit (track);
+
+  return GST_ELEMENT_CLASS (ges_track_parent_class)->change_state (element,
+      transition);
+}
+
 static void
 ges_track_class_init (GESTrackClass * klass)
 {
   GObjectClass *object_class = G_OBJECT_CLASS (klass);
+  GstElementClass *gstelement_class = GST_ELEMENT_CLASS (klass);
 
   g_type_class_add_private (klass, sizeof (GESTrackPrivate));
 
@@ -499,6 +923,8 @@ ges_track_class_init (GESTrackClass * klass)
   object_class->finalize = ges_track_finalize;
   object_class->constructed = ges_track_constructed;
 
+  gstelement_class->change_state = GST_DEBUG_FUNCPTR (ges_track_change_state);
+
   /**
    * GESTrack:caps:
    *
@@ -604,6 +1030,12 @@ ges_track_init (GESTrack * self)
   self->priv->gaps = NULL;
   self->priv->mixing = TRUE;
   self->priv->restriction_caps = NULL;
+  self->priv->unloaded_elements = g_hash_table_new (g_direct_hash,
+      g_direct_equal);
+  self->priv->window_size = GST_CLOCK_TIME_NONE;
+  self->priv->window_elements = g_hash_table_new (g_direct_hash,
+      g_direct_equal);
+  gst_segment_init (&self->priv->segment, GST_FORMAT_TIME);
 
   g_signal_connect (G_OBJECT (self->priv->composition), "notify::duration",
       G_CALLBACK (composition_duration_cb), self);
@@ -677,7 +1109,7 @@ ges_track_set_timeline (GESTrack * track, GESTimeline * timeline)
   GST_DEBUG ("track:%p, timeline:%p", track, timeline);
 
   track->priv->timeline = timeline;
-  resort_and_fill_gaps (track);
+  fill_gaps (track);
 }
 
 /**
@@ -808,13 +1240,14 @@ ges_track_add_element (GESTrack * track, GESTrackElement * object)
     return FALSE;
   }
 
-  GST_DEBUG ("Adding object %s to ourself %s",
-      GST_OBJECT_NAME (ges_track_element_get_gnlobject (object)),
-      GST_OBJECT_NAME (track->priv->composition));
+  track->priv->longest_element = MAX (track->priv->longest_element,
+      _DURATION (object));
 
-  if (G_UNLIKELY (!gst_bin_add (GST_BIN (track->priv->composition),
-              ges_track_element_get_gnlobject (object)))) {
-    GST_WARNING ("Couldn't add object to the GnlComposition");
+  if (track->priv->lazy_loading || WINDOWED (track)) {
+    GST_DEBUG_OBJECT (track, "Delaying the loading of %" GST_PTR_FORMAT,
+        object);
+    g_hash_table_insert (track->priv->unloaded_elements, object, object);
+  } else if (!load_element (track, object)) {
     return FALSE;
   }
 
@@ -891,7 +1324,8 @@ ges_track_remove_element (GESTrack * track, GESTrackElement * object)
 
   it = g_hash_table_lookup (priv->trackelements_iter, object);
   g_sequence_remove (it);
-  resort_and_fill_gaps (track);
+  g_hash_table_remove (priv->trackelements_iter, object);
+  fill_gaps (track);
 
   if (remove_object_internal (track, object) == TRUE) {
     ges_timeline_element_set_timeline (GES_TIMELINE_ELEMENT (object), NULL);
@@ -976,7 +1410,8 @@ ges_track_commit (GESTrack * track)
 
   g_return_val_if_fail (GES_IS_TRACK (track), FALSE);
 
-  resort_and_fill_gaps (track);
+  load_elements (track);
+  fill_gaps (track);
   g_signal_emit_by_name (track->priv->composition, "commit", TRUE, &ret);
 
   return ret;
@@ -1001,3 +1436,178 @@ ges_track_set_create_element_for_gap_func (GESTrack * track,
 
   track->priv->create_element_for_gaps = func;
 }
+
+/**
+ * ges_track_set_lazy_loading:
+ * @track: a #GESTrack
+ * @lazy_loading: Whether the GNonLin objects of the track elements should
+ * only be created when needed
+ *
+ * Sets whether @track creates the GNonLin objects and GstElement-s of the
+ * #GESTrackElement-s added to it right away, or only keeps their timing
+ * and properties until the next commit, until @track goes to
+ * %GST_STATE_PAUSED, or until their children properties are accessed.
+ * This saves a lot of memory and time for timelines that are only being
+ * edited.
+ *
+ * While lazy loading, ges_track_element_get_gnlobject() and
+ * ges_track_element_get_element() return %NULL for the elements that have
+ * not been loaded yet. Disabling it loads all the pending elements.
+ */
+void
+ges_track_set_lazy_loading (GESTrack * track, gboolean lazy_loading)
+{
+  g_return_if_fail (GES_IS_TRACK (track));
+
+  track->priv->lazy_loading = lazy_loading;
+  if (!lazy_loading)
+    load_elements (track);
+}
+
+/**
+ * ges_track_get_lazy_loading:
+ * @track: a #GESTrack
+ *
+ * Gets whether @track delays the creation of the GNonLin objects of its
+ * elements, see ges_track_set_lazy_loading().
+ *
+ * Returns: %TRUE if @track is lazy loading its elements, %FALSE otherwise.
+ */
+gboolean
+ges_track_get_lazy_loading (GESTrack * track)
+{
+  g_return_val_if_fail (GES_IS_TRACK (track), FALSE);
+
+  return track->priv->lazy_loading;
+}
+
+/**
+ * ges_track_set_window_size:
+ * @track: a #GESTrack
+ * @size: The duration of the part of the timeline to keep in the
+ * composition, or %GST_CLOCK_TIME_NONE to keep everything
+ *
+ * Sets the size of the window around the current position that @track
+ * keeps in its #GnlComposition. Only the elements in the window are added
+ * to the composition, as with ges_track_set_lazy_loading(), and the
+ * rest of the timeline is filled with gaps. The GNonLin objects of the
+ * elements leaving the window are destroyed, and created again when they
+ * come back. This way memory usage and commit time depend on the window
+ * size and not on the timeline size, which makes very long timelines
+ * manageable.
+ *
+ * The window follows the seeks happening on @track and the playback,
+ * which is done from the default #GMainContext, so a #GMainLoop needs
+ * to be running. Seeks done from any other thread than the one running
+ * it wait for the window to be moved there before reaching the
+ * composition, so that thread must not be waiting for them. The window
+ * can also be moved with ges_track_set_window_position().
+ * It only makes sense for tracks that fill the gaps, like #GESVideoTrack
+ * and #GESAudioTrack, and changing the size is taken into account on the
+ * next commit.
+ */
+void
+ges_track_set_window_size (GESTrack * track, GstClockTime size)
+{
+  GSequenceIter *it;
+  GESTrackElement *object;
+  GESTrackPrivate *priv;
+
+  g_return_if_fail (GES_IS_TRACK (track));
+  g_return_if_fail (size != 0);
+
+  priv = track->priv;
+  if (!WINDOWED (track) && GST_CLOCK_TIME_IS_VALID (size)) {
+    /* The elements already in the composition are now in the window */
+    for (it = g_sequence_get_begin_iter (priv->trackelements_by_start);
+        !g_sequence_iter_is_end (it); it = g_sequence_iter_next (it)) {
+      object = g_sequence_get (it);
+
+      if (!g_hash_table_contains (priv->unloaded_elements, object))
+        g_hash_table_insert (priv->window_elements, object, object);
+    }
+  } else if (!GST_CLOCK_TIME_IS_VALID (size)) {
+    g_hash_table_remove_all (priv->window_elements);
+  }
+
+  priv->window_size = size;
+  if (!WINDOWED (track) && !priv->lazy_loading)
+    load_elements (track);
+}
+
+/**
+ * ges_track_get_window_size:
+ * @track: a #GESTrack
+ *
+ * Gets the size of the window of the timeline @track keeps in its
+ * composition, see ges_track_set_window_size().
+ *
+ * Returns: The size of the window, %GST_CLOCK_TIME_NONE if the whole
+ * timeline is in the composition.
+ */
+GstClockTime
+ges_track_get_window_size (GESTrack * track)
+{
+  g_return_val_if_fail (GES_IS_TRACK (track), GST_CLOCK_TIME_NONE);
+
+  return track->priv->window_size;
+}
+
+/**
+ * ges_track_set_window_position:
+ * @track: a #GESTrack
+ * @position: The position the window should be around
+ *
+ * Moves the window of the timeline @track keeps in its composition around
+ * @position, committing @track if this changes the elements in the
+ * composition. A quarter of the window is kept before @position as the
+ * playback goes forward. See ges_track_set_window_size().
+ */
+void
+ges_track_set_window_position (GESTrack * track, GstClockTime position)
+{
+  GstClockTime start;
+
+  g_return_if_fail (GES_IS_TRACK (track));
+  g_return_if_fail (WINDOWED (track));
+  g_return_if_fail (GST_CLOCK_TIME_IS_VALID (position));
+
+  start = position > track->priv->window_size / 4 ?
+      position - track->priv->window_size / 4 : 0;
+  if (start == track->priv->window_start)
+    return;
+
+  GST_DEBUG_OBJECT (track, "Moving the window to %" GST_TIME_FORMAT,
+      GST_TIME_ARGS (start));
+
+  GST_OBJECT_LOCK (track);
+  track->priv->window_start = start;
+  GST_OBJECT_UNLOCK (track);
+
+  if (update_window (track))
+    ges_track_commit (track);
+}
+
+/**
+ * ges_track_get_gaps_stats:
+ * @track: a #GESTrack
+ * @created: (out) (allow-none): Return location for the number of gaps
+ * created since @track was created
+ * @reused: (out) (allow-none): Return location for the number of times an
+ * already existing gap has been kept to fill a hole
+ *
+ * Gets statistics about the gaps that have been filled in @track. When
+ * committing, gaps that are still needed are reused, only updating their
+ * start and duration when they actually changed, so a @created value that
+ * stays stable while editing means no new GstElement had to be built.
+ */
+void
+ges_track_get_gaps_stats (GESTrack * track, guint * created, guint * reused)
+{
+  g_return_if_fail (GES_IS_TRACK (track));
+
+  if (created)
+    *created = track->priv->gaps_created;
+  if (reused)
+    *reused = track->priv->gaps_reused;
+}
@@ -92,6 +92,12 @@ void               ges_track_set_create_element_for_gap_func (GESTrack *track, G
 void               ges_track_set_mixing                      (GESTrack *track, gboolean mixing);
 gboolean           ges_track_get_mixing                      (GESTrack *track);
 void               ges_track_set_restriction_caps            (GESTrack *track, const GstCaps *caps);
+void               ges_track_get_gaps_stats                  (GESTrack *track, guint *created, guint *reused);
+void               ges_track_set_lazy_loading                (GESTrack *track, gboolean lazy_loading);
+gboolean           ges_track_get_lazy_loading                (GESTrack *track);
+void               ges_track_set_window_size                 (GESTrack *track, GstClockTime size);
+GstClockTime       ges_track_get_window_size                 (GESTrack *track);
+void               ges_track_set_window_position             (GESTrack *track, GstClockTime position);
 
 /* standard methods */
 GType              ges_track_get_type                        (void);
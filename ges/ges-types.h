@@ -170,6 +170,9 @@ typedef struct _GESUriSourceAssetClass GESUriSourceAssetClass;
 typedef struct _GESProject GESProject;
 typedef struct _GESProjectClass GESProjectClass;
 
+typedef struct _GESThumbnailer GESThumbnailer;
+typedef struct _GESThumbnailerClass GESThumbnailerClass;
+
 typedef struct _GESExtractable GESExtractable;
 typedef struct _GESExtractableInterface GESExtractableInterface;
 
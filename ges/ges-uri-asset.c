@@ -27,10 +27,14 @@
  * let you get information about the medias. Also, the tags found in the media file are
  * set as Metadatas of the Asser.
  */
+#include <errno.h>
 #include <gst/pbutils/pbutils.h>
+#include <glib/gstdio.h>
 #include "ges.h"
 #include "ges-internal.h"
 #include "ges-track-element-asset.h"
+#include "ges-media-cache.h"
+#include "ges-audio-peaks.h"
 
 static GHashTable *parent_newparent_table = NULL;
 static void
@@ -55,26 +59,321 @@ enum
 };
 static GParamSpec *properties[PROP_LAST];
 
+/* The discoverers used to load assets asynchronously, the first one being
+ * GESUriClipAssetClass.discoverer. They are created when needed, up to
+ * discoverer_pool_size of them, and each new discovery goes to the least
+ * busy one. When the pool shrinks, the discoverers in excess are retired
+ * as soon as they are done with their pending discoveries. */
+typedef struct
+{
+  GstDiscoverer *discoverer;
+  guint pending;
+} DiscovererWorker;
+
+static GMutex discoverers_lock;
+static GPtrArray *discoverers = NULL;
+static guint discoverer_pool_size = 1;
+static GstClockTime discoverer_timeout = GST_SECOND;
+
 static void discoverer_discovered_cb (GstDiscoverer * discoverer,
-    GstDiscovererInfo * info, GError * err, gpointer user_data);
+    GstDiscovererInfo * info, GError * err, DiscovererWorker * worker);
+static gboolean _load_from_discoverer_cache (GESUriClipAsset * self);
 
 struct _GESUriClipAssetPrivate
 {
   GstDiscovererInfo *info;
   GstClockTime duration;
   gboolean is_image;
+  /* Loaded from the discoverer cache, @info is only discovered when
+   * requested */
+  gboolean from_cache;
+  /* Channels of the first audio stream, 0 if unknown */
+  guint n_audio_channels;
 
   GList *asset_trackfilesources;
+
+  /* The media caches, opened when first used */
+  GMutex media_cache_lock;
+  GHashTable *peaks_caches;     /* "bucket duration/channels" -> GESPeaksCache */
+  GHashTable *thumbnail_caches; /* caps string -> GESThumbnailCache */
 };
 
 struct _GESUriSourceAssetPrivate
 {
   GstDiscovererStreamInfo *sinfo;
   GESUriClipAsset *parent_asset;
+  gboolean is_image;
 
   const gchar *uri;
 };
 
+/* Discoverer cache
+ *
+ * What we need from the GstDiscovererInfo of local files is kept on disk so
+ * that reopening a project does not need to discover all its files again.
+ * Each file has its own GKeyFile, named after the checksum of its URI, and
+ * entries are only used if the modification time and size of the file
+ * did not change since they have been written. */
+#define DISCOVERER_CACHE_GROUP "discoverer"
+#define DISCOVERER_CACHE_STREAM_PREFIX "stream-"
+
+static gchar *
+_get_cache_filename (const gchar * uri)
+{
+  gchar *checksum, *filename;
+
+  checksum = g_compute_checksum_for_string (G_CHECKSUM_SHA1, uri, -1);
+  filename = g_build_filename (g_get_user_cache_dir (), "gstreamer-1.0",
+      "ges", "discoverer", checksum, NULL);
+  g_free (checksum);
+
+  return filename;
+}
+
+static gboolean
+_get_file_stamp (const gchar * uri, guint64 * mtime, guint64 * size)
+{
+  GFile *file;
+  GFileInfo *finfo;
+
+  if (!gst_uri_has_protocol (uri, "file"))
+    return FALSE;
+
+  file = g_file_new_for_uri (uri);
+  finfo = g_file_query_info (file, G_FILE_ATTRIBUTE_TIME_MODIFIED ","
+      G_FILE_ATTRIBUTE_STANDARD_SIZE, G_FILE_QUERY_INFO_NONE, NULL, NULL);
+  g_object_unref (file);
+
+  if (finfo == NULL)
+    return FALSE;
+
+  *mtime = g_file_info_get_attribute_uint64 (finfo,
+      G_FILE_ATTRIBUTE_TIME_MODIFIED);
+  *size = g_file_info_get_size (finfo);
+  g_object_unref (finfo);
+
+  return TRUE;
+}
+
+static void
+_save_to_discoverer_cache (GESUriClipAsset * self, GstDiscovererInfo * info)
+{
+  GKeyFile *kf;
+  GList *tmp, *stream_list;
+  gchar *data, *filename, *dirname;
+  guint64 mtime, size;
+  const GstTagList *tags;
+  guint nstream = 0;
+  gsize length;
+  GError *error = NULL;
+  const gchar *uri = ges_asset_get_id (GES_ASSET (self));
+
+  if (!_get_file_stamp (uri, &mtime, &size))
+    return;
+
+  kf = g_key_file_new ();
+  g_key_file_set_string (kf, DISCOVERER_CACHE_GROUP, "uri", uri);
+  g_key_file_set_uint64 (kf, DISCOVERER_CACHE_GROUP, "mtime", mtime);
+  g_key_file_set_uint64 (kf, DISCOVERER_CACHE_GROUP, "size", size);
+  g_key_file_set_uint64 (kf, DISCOVERER_CACHE_GROUP, "duration",
+      gst_discoverer_info_get_duration (info));
+
+  tags = gst_discoverer_info_get_tags (info);
+  if (tags) {
+    gchar *tags_str = gst_tag_list_to_string (tags);
+
+    g_key_file_set_string (kf, DISCOVERER_CACHE_GROUP, "tags", tags_str);
+    g_free (tags_str);
+  }
+
+  stream_list = gst_discoverer_info_get_stream_list (info);
+  for (tmp = stream_list; tmp; tmp = tmp->next) {
+    gchar *group;
+    const gchar *type;
+    GstDiscovererStreamInfo *sinf = (GstDiscovererStreamInfo *) tmp->data;
+    const gchar *stream_id = gst_discoverer_stream_info_get_stream_id (sinf);
+
+    if (GST_IS_DISCOVERER_AUDIO_INFO (sinf))
+      type = "audio";
+    else if (GST_IS_DISCOVERER_VIDEO_INFO (sinf))
+      type = gst_discoverer_video_info_is_image ((GstDiscovererVideoInfo *)
+          sinf) ? "image" : "video";
+    else
+      continue;
+
+    if (stream_id == NULL) {
+      GST_DEBUG_OBJECT (self, "Stream without ID, not caching");
+      goto done;
+    }
+
+    group = g_strdup_printf (DISCOVERER_CACHE_STREAM_PREFIX "%u", nstream++);
+    g_key_file_set_string (kf, group, "type", type);
+    g_key_file_set_string (kf, group, "stream-id", stream_id);
+    if (GST_IS_DISCOVERER_AUDIO_INFO (sinf))
+      g_key_file_set_integer (kf, group, "channels",
+          gst_discoverer_audio_info_get_channels ((GstDiscovererAudioInfo *)
+              sinf));
+    g_free (group);
+  }
+
+  filename = _get_cache_filename (uri);
+  dirname = g_path_get_dirname (filename);
+  data = g_key_file_to_data (kf, &length, NULL);
+  if (g_mkdir_with_parents (dirname, 0755) != 0 ||
+      !g_file_set_contents (filename, data, length, &error)) {
+    GST_INFO_OBJECT (self, "Could not write discoverer cache %s: %s",
+        filename, error ? error->message : g_strerror (errno));
+    g_clear_error (&error);
+  }
+  g_free (data);
+  g_free (dirname);
+  g_free (filename);
+
+done:
+  if (stream_list)
+    gst_discoverer_stream_info_list_free (stream_list);
+  g_key_file_free (kf);
+}
+
+/* Media cache
+ *
+ * The audio peaks and thumbnails UIs compute out of local files are kept
+ * on disk, see ges-media-cache.c. Each resolution has its own file, named
+ * after the checksum of the URI, modification time and size of the media
+ * file and of the resolution, so outdated entries are never looked up.
+ * The resolution of the peaks is their bucket duration and number of
+ * channels, the one of the thumbnails their whole caps. */
+static gchar *
+_get_media_cache_filename (GESUriClipAsset * self, const gchar * kind,
+    const gchar * resolution)
+{
+  guint64 mtime, size;
+  gchar *key, *checksum, *filename;
+  const gchar *uri = ges_asset_get_id (GES_ASSET (self));
+
+  /* Other files only get a cache in memory */
+  if (!_get_file_stamp (uri, &mtime, &size))
+    return NULL;
+
+  key = g_strdup_printf ("%s|%" G_GUINT64_FORMAT "|%" G_GUINT64_FORMAT
+      "|%s|%s", uri, mtime, size, kind, resolution);
+  checksum = g_compute_checksum_for_string (G_CHECKSUM_SHA1, key, -1);
+  filename = g_build_filename (g_get_user_cache_dir (), "gstreamer-1.0",
+      "ges", "media", checksum, NULL);
+  g_free (checksum);
+  g_free (key);
+
+  return filename;
+}
+
+static inline guint64
+_get_n_buckets (GESUriClipAsset * self, GstClockTime bucket_duration)
+{
+  return (self->priv->duration + bucket_duration - 1) / bucket_duration;
+}
+
+/* Must be called with the media cache lock held */
+static GESPeaksCache *
+_get_peaks_cache (GESUriClipAsset * self, GstClockTime bucket_duration,
+    guint n_channels)
+{
+  gchar *key, *filename;
+  GESPeaksCache *cache;
+  GESUriClipAssetPrivate *priv = self->priv;
+
+  if (!GST_CLOCK_TIME_IS_VALID (priv->duration))
+    return NULL;
+
+  /* The channels are part of the layout of the file, so each number of
+   * channels has its own cache */
+  key = g_strdup_printf ("%" G_GUINT64_FORMAT "/%u", bucket_duration,
+      n_channels);
+  cache = g_hash_table_lookup (priv->peaks_caches, key);
+  if (cache) {
+    g_free (key);
+
+    return cache;
+  }
+
+  filename = _get_media_cache_filename (self, "peaks", key);
+  cache = ges_peaks_cache_new (filename, bucket_duration, n_channels,
+      _get_n_buckets (self, bucket_duration));
+  g_hash_table_insert (priv->peaks_caches, key, cache);
+  g_free (filename);
+
+  return cache;
+}
+
+/* Must be called with the media cache lock held */
+static gboolean
+_has_complete_peaks (GESUriClipAsset * self, GstClockTime bucket_duration,
+    guint n_channels)
+{
+  GESPeaksCache *cache = _get_peaks_cache (self, bucket_duration, n_channels);
+
+  return cache && ges_peaks_cache_is_complete (cache);
+}
+
+/* Must be called with the media cache lock held */
+static GESThumbnailCache *
+_get_thumbnail_cache (GESUriClipAsset * self, const GstCaps * caps)
+{
+  gchar *key, *filename;
+  GESThumbnailCache *cache;
+  GESUriClipAssetPrivate *priv = self->priv;
+
+  key = gst_caps_to_string (caps);
+  cache = g_hash_table_lookup (priv->thumbnail_caches, key);
+  if (cache) {
+    g_free (key);
+
+    return cache;
+  }
+
+  filename = _get_media_cache_filename (self, "thumbnails", key);
+  cache = ges_thumbnail_cache_new (filename);
+  g_hash_table_insert (priv->thumbnail_caches, key, cache);
+  g_free (filename);
+
+  return cache;
+}
+
+/* Must be called with the media cache lock held */
+static gboolean
+_save_media_caches (GESUriClipAsset * self, GError ** error)
+{
+  GHashTableIter iter;
+  gpointer cache;
+  gboolean ret = TRUE;
+
+  g_hash_table_iter_init (&iter, self->priv->peaks_caches);
+  while (ret && g_hash_table_iter_next (&iter, NULL, &cache))
+    ret = ges_peaks_cache_save (cache, error);
+
+  g_hash_table_iter_init (&iter, self->priv->thumbnail_caches);
+  while (ret && g_hash_table_iter_next (&iter, NULL, &cache))
+    ret = ges_thumbnail_cache_save (cache, error);
+
+  return ret;
+}
+
+static void
+ges_uri_clip_asset_finalize (GObject * object)
+{
+  GError *error = NULL;
+  GESUriClipAsset *self = GES_URI_CLIP_ASSET (object);
+
+  if (!_save_media_caches (self, &error)) {
+    GST_INFO_OBJECT (self, "Could not save the media caches: %s",
+        error->message);
+    g_clear_error (&error);
+  }
+  g_hash_table_unref (self->priv->peaks_caches);
+  g_hash_table_unref (self->priv->thumbnail_caches);
+  g_mutex_clear (&self->priv->media_cache_lock);
+
+  G_OBJECT_CLASS (ges_uri_clip_asset_parent_class)->finalize (object);
+}
 
 static void
 ges_uri_clip_asset_get_property (GObject * object, guint property_id,
@@ -106,18 +405,85 @@ ges_uri_clip_asset_set_property (GObject * object, guint property_id,
   }
 }
 
+static DiscovererWorker *
+_discoverer_worker_new (GstDiscoverer * discoverer)
+{
+  DiscovererWorker *worker = g_slice_new0 (DiscovererWorker);
+
+  if (discoverer == NULL)
+    discoverer = gst_discoverer_new (discoverer_timeout, NULL);
+
+  worker->discoverer = discoverer;
+  g_signal_connect (discoverer, "discovered",
+      G_CALLBACK (discoverer_discovered_cb), worker);
+
+  /* We just start the discoverer and let it live */
+  gst_discoverer_start (discoverer);
+
+  return worker;
+}
+
+static void
+_discoverer_worker_free (DiscovererWorker * worker)
+{
+  g_signal_handlers_disconnect_by_func (worker->discoverer,
+      discoverer_discovered_cb, worker);
+  gst_discoverer_stop (worker->discoverer);
+  gst_object_unref (worker->discoverer);
+  g_slice_free (DiscovererWorker, worker);
+}
+
+static gboolean
+_retire_discoverer_worker (DiscovererWorker * worker)
+{
+  _discoverer_worker_free (worker);
+
+  return FALSE;
+}
+
+/* Must be called with discoverers_lock */
+static DiscovererWorker *
+_get_discoverer_worker (void)
+{
+  guint i;
+  DiscovererWorker *worker = NULL;
+
+  for (i = 0; i < MIN (discoverers->len, discoverer_pool_size); i++) {
+    DiscovererWorker *tmp = g_ptr_array_index (discoverers, i);
+
+    if (worker == NULL || tmp->pending < worker->pending)
+      worker = tmp;
+  }
+
+  if (worker->pending && discoverers->len < discoverer_pool_size) {
+    worker = _discoverer_worker_new (NULL);
+    g_ptr_array_add (discoverers, worker);
+  }
+
+  return worker;
+}
+
 static GESAssetLoadingReturn
 _start_loading (GESAsset * asset, GError ** error)
 {
   gboolean ret;
   const gchar *uri;
-  GESUriClipAssetClass *class = GES_URI_CLIP_ASSET_GET_CLASS (asset);
+  DiscovererWorker *worker;
 
   GST_DEBUG ("Started loading %p", asset);
 
   uri = ges_asset_get_id (asset);
 
-  ret = gst_discoverer_discover_uri_async (class->discoverer, uri);
+  if (_load_from_discoverer_cache (GES_URI_CLIP_ASSET (asset)))
+    return GES_ASSET_LOADING_OK;
+
+  g_mutex_lock (&discoverers_lock);
+  worker = _get_discoverer_worker ();
+  ret = gst_discoverer_discover_uri_async (worker->discoverer, uri);
+  if (ret)
+    worker->pending++;
+  g_mutex_unlock (&discoverers_lock);
+
   if (ret)
     return GES_ASSET_LOADING_ASYNC;
 
@@ -179,6 +545,7 @@ ges_uri_clip_asset_class_init (GESUriClipAssetClass * klass)
 
   object_class->get_property = ges_uri_clip_asset_get_property;
   object_class->set_property = ges_uri_clip_asset_set_property;
+  object_class->finalize = ges_uri_clip_asset_finalize;
 
   GES_ASSET_CLASS (klass)->start_loading = _start_loading;
   GES_ASSET_CLASS (klass)->request_id_update = _request_id_update;
@@ -196,13 +563,16 @@ ges_uri_clip_asset_class_init (GESUriClipAssetClass * klass)
   g_object_class_install_property (object_class, PROP_DURATION,
       properties[PROP_DURATION]);
 
-  klass->discoverer = gst_discoverer_new (GST_SECOND, NULL);
-  klass->sync_discoverer = gst_discoverer_new (GST_SECOND, NULL);
-  g_signal_connect (klass->discoverer, "discovered",
-      G_CALLBACK (discoverer_discovered_cb), NULL);
+  klass->discoverer = gst_discoverer_new (discoverer_timeout, NULL);
+  klass->sync_discoverer = gst_discoverer_new (discoverer_timeout, NULL);
 
-  /* We just start the discoverer and let it live */
-  gst_discoverer_start (klass->discoverer);
+  discoverers = g_ptr_array_new ();
+  g_ptr_array_add (discoverers, _discoverer_worker_new (klass->discoverer));
+#if GLIB_CHECK_VERSION(2, 36, 0)
+  discoverer_pool_size = MAX (g_get_num_processors (), 1);
+#else
+  discoverer_pool_size = 2;
+#endif
   if (parent_newparent_table == NULL) {
     parent_newparent_table = g_hash_table_new_full (g_file_hash,
         (GEqualFunc) g_file_equal, gst_object_unref, gst_object_unref);
@@ -220,23 +590,23 @@ ges_uri_clip_asset_init (GESUriClipAsset * self)
   priv->info = NULL;
   priv->duration = GST_CLOCK_TIME_NONE;
   priv->is_image = FALSE;
+  priv->from_cache = FALSE;
+
+  g_mutex_init (&priv->media_cache_lock);
+  priv->peaks_caches = g_hash_table_new_full (g_str_hash, g_str_equal,
+      g_free, (GDestroyNotify) ges_peaks_cache_free);
+  priv->thumbnail_caches = g_hash_table_new_full (g_str_hash, g_str_equal,
+      g_free, (GDestroyNotify) ges_thumbnail_cache_free);
 }
 
 static void
 _create_uri_source_asset (GESUriClipAsset * asset,
-    GstDiscovererStreamInfo * sinfo, GESTrackType type)
+    GstDiscovererStreamInfo * sinfo, const gchar * stream_id,
+    GESTrackType type, gboolean is_image)
 {
   GESAsset *tck_filesource_asset;
   GESUriSourceAssetPrivate *priv_tckasset;
   GESUriClipAssetPrivate *priv = asset->priv;
-  gchar *stream_id =
-      g_strdup (gst_discoverer_stream_info_get_stream_id (sinfo));
-
-  if (stream_id == NULL) {
-    GST_WARNING ("No stream ID found, using the pointer instead");
-
-    stream_id = g_strdup_printf ("%i", GPOINTER_TO_INT (sinfo));
-  }
 
   if (type == GES_TRACK_TYPE_VIDEO)
     tck_filesource_asset = ges_asset_request (GES_TYPE_VIDEO_URI_SOURCE,
@@ -244,12 +614,14 @@ _create_uri_source_asset (GESUriClipAsset * asset,
   else
     tck_filesource_asset = ges_asset_request (GES_TYPE_AUDIO_URI_SOURCE,
         stream_id, NULL);
-  g_free (stream_id);
 
   priv_tckasset = GES_URI_SOURCE_ASSET (tck_filesource_asset)->priv;
   priv_tckasset->uri = ges_asset_get_id (GES_ASSET (asset));
-  priv_tckasset->sinfo = gst_object_ref (sinfo);
+  if (priv_tckasset->sinfo)
+    gst_object_unref (priv_tckasset->sinfo);
+  priv_tckasset->sinfo = sinfo ? gst_object_ref (sinfo) : NULL;
   priv_tckasset->parent_asset = asset;
+  priv_tckasset->is_image = is_image;
   ges_track_element_asset_set_track_type (GES_TRACK_ELEMENT_ASSET
       (tck_filesource_asset), type);
 
@@ -257,6 +629,22 @@ _create_uri_source_asset (GESUriClipAsset * asset,
       gst_object_ref (tck_filesource_asset));
 }
 
+/* Forget about what a previous loading found */
+static void
+_reset_streams (GESUriClipAsset * self)
+{
+  GESUriClipAssetPrivate *priv = self->priv;
+
+  g_list_free_full (priv->asset_trackfilesources, gst_object_unref);
+  priv->asset_trackfilesources = NULL;
+  if (priv->info)
+    gst_object_unref (priv->info);
+  priv->info = NULL;
+  priv->is_image = FALSE;
+  priv->from_cache = FALSE;
+  priv->n_audio_channels = 0;
+}
+
 static void
 ges_uri_clip_asset_set_info (GESUriClipAsset * self, GstDiscovererInfo * info)
 {
@@ -265,9 +653,13 @@ ges_uri_clip_asset_set_info (GESUriClipAsset * self, GstDiscovererInfo * info)
   GESTrackType supportedformats = GES_TRACK_TYPE_UNKNOWN;
   GESUriClipAssetPrivate *priv = GES_URI_CLIP_ASSET (self)->priv;
 
+  _reset_streams (self);
+
   /* Extract infos from the GstDiscovererInfo */
   stream_list = gst_discoverer_info_get_stream_list (info);
   for (tmp = stream_list; tmp; tmp = tmp->next) {
+    gchar *stream_id;
+    gboolean is_image = FALSE;
     GESTrackType type = GES_TRACK_TYPE_UNKNOWN;
     GstDiscovererStreamInfo *sinf = (GstDiscovererStreamInfo *) tmp->data;
 
@@ -278,20 +670,34 @@ ges_uri_clip_asset_set_info (GESUriClipAsset * self, GstDiscovererInfo * info)
         supportedformats |= GES_TRACK_TYPE_AUDIO;
 
       type = GES_TRACK_TYPE_AUDIO;
+      if (priv->n_audio_channels == 0)
+        priv->n_audio_channels =
+            gst_discoverer_audio_info_get_channels ((GstDiscovererAudioInfo *)
+            sinf);
     } else if (GST_IS_DISCOVERER_VIDEO_INFO (sinf)) {
       if (supportedformats == GES_TRACK_TYPE_UNKNOWN)
         supportedformats = GES_TRACK_TYPE_VIDEO;
       else
         supportedformats |= GES_TRACK_TYPE_VIDEO;
       if (gst_discoverer_video_info_is_image ((GstDiscovererVideoInfo *)
-              sinf))
+              sinf)) {
         priv->is_image = TRUE;
+        is_image = TRUE;
+      }
       type = GES_TRACK_TYPE_VIDEO;
     }
 
     GST_DEBUG_OBJECT (self, "Creating GESUriSourceAsset for stream: %s",
         gst_discoverer_stream_info_get_stream_id (sinf));
-    _create_uri_source_asset (self, sinf, type);
+
+    stream_id = g_strdup (gst_discoverer_stream_info_get_stream_id (sinf));
+    if (stream_id == NULL) {
+      GST_WARNING ("No stream ID found, using the pointer instead");
+
+      stream_id = g_strdup_printf ("%i", GPOINTER_TO_INT (sinf));
+    }
+    _create_uri_source_asset (self, sinf, stream_id, type, is_image);
+    g_free (stream_id);
   }
   ges_clip_asset_set_supported_formats (GES_CLIP_ASSET
       (self), supportedformats);
@@ -317,9 +723,179 @@ _set_meta_foreach (const GstTagList * tags, const gchar * tag,
   g_value_unset (&value);
 }
 
+static gboolean
+_check_cached_stream (GKeyFile * kf, const gchar * group)
+{
+  gchar *type, *stream_id;
+  gboolean ret;
+
+  type = g_key_file_get_string (kf, group, "type", NULL);
+  stream_id = g_key_file_get_string (kf, group, "stream-id", NULL);
+
+  ret = stream_id && (!g_strcmp0 (type, "audio") || !g_strcmp0 (type, "video")
+      || !g_strcmp0 (type, "image"));
+
+  g_free (type);
+  g_free (stream_id);
+
+  return ret;
+}
+
+/* Fills @self from the discoverer cache, returns %FALSE if there is no
+ * up to date entry for it */
+static gboolean
+_load_from_discoverer_cache (GESUriClipAsset * self)
+{
+  GKeyFile *kf;
+  gchar *filename, *cached_uri, *tags_str, **groups;
+  guint64 mtime, size;
+  gsize i;
+  GESTrackType supportedformats = GES_TRACK_TYPE_UNKNOWN;
+  gboolean ret = FALSE;
+  GESUriClipAssetPrivate *priv = self->priv;
+  const gchar *uri = ges_asset_get_id (GES_ASSET (self));
+
+  if (!_get_file_stamp (uri, &mtime, &size))
+    return FALSE;
+
+  kf = g_key_file_new ();
+  filename = _get_cache_filename (uri);
+  if (!g_key_file_load_from_file (kf, filename, G_KEY_FILE_NONE, NULL)) {
+    g_free (filename);
+    g_key_file_free (kf);
+
+    return FALSE;
+  }
+
+  cached_uri = g_key_file_get_string (kf, DISCOVERER_CACHE_GROUP, "uri", NULL);
+  if (g_strcmp0 (cached_uri, uri) ||
+      g_key_file_get_uint64 (kf, DISCOVERER_CACHE_GROUP, "mtime",
+          NULL) != mtime ||
+      g_key_file_get_uint64 (kf, DISCOVERER_CACHE_GROUP, "size", NULL) != size
+      || !g_key_file_has_key (kf, DISCOVERER_CACHE_GROUP, "duration", NULL)) {
+    GST_DEBUG_OBJECT (self, "Discoverer cache entry %s is outdated", filename);
+    goto done;
+  }
+
+  groups = g_key_file_get_groups (kf, NULL);
+  for (i = 0; groups[i]; i++) {
+    if (g_str_has_prefix (groups[i], DISCOVERER_CACHE_STREAM_PREFIX) &&
+        !_check_cached_stream (kf, groups[i])) {
+      GST_DEBUG_OBJECT (self, "Invalid discoverer cache entry %s", filename);
+      g_strfreev (groups);
+      goto done;
+    }
+  }
+
+  _reset_streams (self);
+  for (i = 0; groups[i]; i++) {
+    gchar *type, *stream_id;
+    GESTrackType track_type;
+
+    if (!g_str_has_prefix (groups[i], DISCOVERER_CACHE_STREAM_PREFIX))
+      continue;
+
+    type = g_key_file_get_string (kf, groups[i], "type", NULL);
+    stream_id = g_key_file_get_string (kf, groups[i], "stream-id", NULL);
+
+    track_type = g_strcmp0 (type, "audio") ? GES_TRACK_TYPE_VIDEO :
+        GES_TRACK_TYPE_AUDIO;
+    if (track_type == GES_TRACK_TYPE_AUDIO && priv->n_audio_channels == 0)
+      priv->n_audio_channels = MAX (0, g_key_file_get_integer (kf, groups[i],
+              "channels", NULL));
+    if (!g_strcmp0 (type, "image"))
+      priv->is_image = TRUE;
+    if (supportedformats == GES_TRACK_TYPE_UNKNOWN)
+      supportedformats = track_type;
+    else
+      supportedformats |= track_type;
+
+    _create_uri_source_asset (self, NULL, stream_id, track_type,
+        !g_strcmp0 (type, "image"));
+
+    g_free (type);
+    g_free (stream_id);
+  }
+  g_strfreev (groups);
+
+  ges_clip_asset_set_supported_formats (GES_CLIP_ASSET (self),
+      supportedformats);
+  if (priv->is_image == FALSE)
+    priv->duration = g_key_file_get_uint64 (kf, DISCOVERER_CACHE_GROUP,
+        "duration", NULL);
+
+  tags_str = g_key_file_get_string (kf, DISCOVERER_CACHE_GROUP, "tags", NULL);
+  if (tags_str) {
+    GstTagList *tags = gst_tag_list_new_from_string (tags_str);
+
+    if (tags) {
+      gst_tag_list_foreach (tags, (GstTagForeachFunc) _set_meta_foreach, self);
+      gst_tag_list_unref (tags);
+    }
+    g_free (tags_str);
+  }
+
+  priv->from_cache = TRUE;
+  ret = TRUE;
+  GST_DEBUG_OBJECT (self, "Loaded from discoverer cache %s", filename);
+
+done:
+  g_free (cached_uri);
+  g_free (filename);
+  g_key_file_free (kf);
+
+  return ret;
+}
+
+/* Discovers the GstDiscovererInfo of an asset loaded from the cache */
+static void
+_discover_cached_asset (GESUriClipAsset * self)
+{
+  GList *tmp, *stream_list, *sources;
+  GError *error = NULL;
+  GstDiscovererInfo *info;
+  GESUriClipAssetPrivate *priv = self->priv;
+  const gchar *uri = ges_asset_get_id (GES_ASSET (self));
+
+  priv->from_cache = FALSE;
+  info = gst_discoverer_discover_uri (GES_URI_CLIP_ASSET_GET_CLASS
+      (self)->sync_discoverer, uri, &error);
+  if (info == NULL || error) {
+    GST_WARNING_OBJECT (self, "Could not discover %s: %s", uri,
+        error ? error->message : "");
+    g_clear_error (&error);
+    if (info)
+      gst_object_unref (info);
+
+    return;
+  }
+
+  priv->info = info;
+  stream_list = gst_discoverer_info_get_stream_list (info);
+  for (tmp = stream_list; tmp; tmp = tmp->next) {
+    const gchar *stream_id = gst_discoverer_stream_info_get_stream_id
+        (tmp->data);
+
+    for (sources = priv->asset_trackfilesources; sources;
+        sources = sources->next) {
+      GESUriSourceAssetPrivate *spriv = GES_URI_SOURCE_ASSET
+          (sources->data)->priv;
+
+      if (spriv->sinfo == NULL &&
+          !g_strcmp0 (ges_asset_get_id (sources->data), stream_id)) {
+        spriv->sinfo = gst_object_ref (tmp->data);
+        break;
+      }
+    }
+  }
+
+  if (stream_list)
+    gst_discoverer_stream_info_list_free (stream_list);
+}
+
 static void
 discoverer_discovered_cb (GstDiscoverer * discoverer,
-    GstDiscovererInfo * info, GError * err, gpointer user_data)
+    GstDiscovererInfo * info, GError * err, DiscovererWorker * worker)
 {
   const GstTagList *tags;
 
@@ -327,12 +903,27 @@ discoverer_discovered_cb (GstDiscoverer * discoverer,
   GESUriClipAsset *mfs =
       GES_URI_CLIP_ASSET (ges_asset_cache_lookup (GES_TYPE_URI_CLIP, uri));
 
+  g_mutex_lock (&discoverers_lock);
+  worker->pending--;
+
+  /* Idle and in excess after the pool shrank, the discoverer can not be
+   * stopped while it emits the signal */
+  if (worker->pending == 0 && worker != g_ptr_array_index (discoverers, 0) &&
+      discoverers->len > discoverer_pool_size &&
+      g_ptr_array_remove (discoverers, worker)) {
+    GST_DEBUG ("Retiring discoverer %p", discoverer);
+    g_idle_add ((GSourceFunc) _retire_discoverer_worker, worker);
+  }
+  g_mutex_unlock (&discoverers_lock);
+
   tags = gst_discoverer_info_get_tags (info);
   if (tags)
     gst_tag_list_foreach (tags, (GstTagForeachFunc) _set_meta_foreach, mfs);
 
-  if (err == NULL)
+  if (err == NULL) {
     ges_uri_clip_asset_set_info (mfs, info);
+    _save_to_discoverer_cache (mfs, info);
+  }
   ges_asset_cache_set_loaded (GES_TYPE_URI_CLIP, uri, err);
 }
 
@@ -343,6 +934,9 @@ discoverer_discovered_cb (GstDiscoverer * discoverer,
  *
  * Gets #GstDiscovererInfo about the file
  *
+ * Note that if @self has been loaded from the discoverer cache, the file
+ * is discovered synchronously the first time this is called.
+ *
  * Returns: (transfer none): #GstDiscovererInfo of specified asset
  */
 GstDiscovererInfo *
@@ -350,6 +944,9 @@ ges_uri_clip_asset_get_info (const GESUriClipAsset * self)
 {
   g_return_val_if_fail (GES_IS_URI_CLIP_ASSET (self), NULL);
 
+  if (self->priv->info == NULL && self->priv->from_cache)
+    _discover_cached_asset ((GESUriClipAsset *) self);
+
   return self->priv->info;
 }
 
@@ -463,6 +1060,13 @@ ges_uri_clip_asset_request_sync (const gchar * uri, GError ** error)
 
   asset = g_object_new (GES_TYPE_URI_CLIP_ASSET, "id", uri,
       "extractable-type", GES_TYPE_URI_CLIP, NULL);
+  if (_load_from_discoverer_cache (asset)) {
+    ges_asset_cache_put (gst_object_ref (asset), NULL);
+    ges_asset_cache_set_loaded (GES_TYPE_URI_CLIP, uri, NULL);
+
+    return asset;
+  }
+
   discoverer = GES_URI_CLIP_ASSET_GET_CLASS (asset)->sync_discoverer;
   info = gst_discoverer_discover_uri (discoverer, uri, &lerror);
   if (info == NULL || lerror != NULL) {
@@ -475,6 +1079,8 @@ ges_uri_clip_asset_request_sync (const gchar * uri, GError ** error)
 
   ges_asset_cache_put (gst_object_ref (asset), NULL);
   ges_uri_clip_asset_set_info (asset, info);
+  _save_to_discoverer_cache (asset, info);
+  gst_object_unref (info);
   ges_asset_cache_set_loaded (GES_TYPE_URI_CLIP, uri, lerror);
 
   return asset;
@@ -491,12 +1097,56 @@ void
 ges_uri_clip_asset_class_set_timeout (GESUriClipAssetClass * class,
     GstClockTime timeout)
 {
+  guint i;
+
   g_return_if_fail (GES_IS_URI_CLIP_ASSET_CLASS (class));
 
-  g_object_set (class->discoverer, "timeout", timeout, NULL);
+  g_mutex_lock (&discoverers_lock);
+  discoverer_timeout = timeout;
+  for (i = 0; i < discoverers->len; i++)
+    g_object_set (((DiscovererWorker *) g_ptr_array_index (discoverers,
+                i))->discoverer, "timeout", timeout, NULL);
+  g_mutex_unlock (&discoverers_lock);
+
   g_object_set (class->sync_discoverer, "timeout", timeout, NULL);
 }
 
+/**
+ * ges_uri_clip_asset_class_set_discoverer_pool_size:
+ * @class: The #GESUriClipAssetClass on which to set the number of discoverers
+ * @size: The maximum number of files discovered at the same time, must be
+ * at least 1
+ *
+ * Sets how many #GstDiscoverer-s can be used at the same time to load
+ * #GESUriClipAsset-s asynchronously. It defaults to the number of
+ * processors of the machine.
+ */
+void
+ges_uri_clip_asset_class_set_discoverer_pool_size (GESUriClipAssetClass *
+    class, guint size)
+{
+  guint i;
+
+  g_return_if_fail (GES_IS_URI_CLIP_ASSET_CLASS (class));
+  g_return_if_fail (size > 0);
+
+  g_mutex_lock (&discoverers_lock);
+  discoverer_pool_size = size;
+
+  /* The busy discoverers are retired once they are done, see
+   * discoverer_discovered_cb() */
+  for (i = discoverers->len - 1; i > 0 && discoverers->len > size; i--) {
+    DiscovererWorker *worker = g_ptr_array_index (discoverers, i);
+
+    if (worker->pending)
+      continue;
+
+    g_ptr_array_remove_index (discoverers, i);
+    _discoverer_worker_free (worker);
+  }
+  g_mutex_unlock (&discoverers_lock);
+}
+
 /**
  * ges_uri_clip_asset_get_stream_assets:
  * @self: A #GESUriClipAsset
@@ -514,6 +1164,684 @@ ges_uri_clip_asset_get_stream_assets (GESUriClipAsset * self)
   return self->priv->asset_trackfilesources;
 }
 
+/**
+ * ges_uri_clip_asset_store_peaks:
+ * @self: A #GESUriClipAsset
+ * @bucket_duration: The duration covered by each bucket
+ * @n_channels: The number of audio channels
+ * @first_bucket: The index of the first bucket to store, the bucket
+ * starting at @first_bucket * @bucket_duration
+ * @n_buckets: The number of buckets to store
+ * @peaks: (array): @n_buckets times @n_channels #GESAudioPeak, the channels
+ * of each bucket being consecutive
+ *
+ * Stores the audio peaks of @self at the @bucket_duration resolution in
+ * the media cache, so that they can be given back by
+ * ges_uri_clip_asset_get_cached_peaks(), including in the next sessions
+ * for local files.
+ *
+ * The peaks are written to disk as soon as all the buckets of the file
+ * have been stored, or when ges_uri_clip_asset_save_media_cache() is called.
+ */
+void
+ges_uri_clip_asset_store_peaks (GESUriClipAsset * self,
+    GstClockTime bucket_duration, guint n_channels, guint64 first_bucket,
+    guint n_buckets, const GESAudioPeak * peaks)
+{
+  GError *error = NULL;
+  GESPeaksCache *cache;
+
+  g_return_if_fail (GES_IS_URI_CLIP_ASSET (self));
+  g_return_if_fail (GST_CLOCK_TIME_IS_VALID (bucket_duration) &&
+      bucket_duration > 0);
+  g_return_if_fail (n_channels > 0);
+  g_return_if_fail (peaks != NULL || n_buckets == 0);
+
+  g_mutex_lock (&self->priv->media_cache_lock);
+  cache = _get_peaks_cache (self, bucket_duration, n_channels);
+  if (cache == NULL) {
+    GST_INFO_OBJECT (self, "Unknown duration, can not store peaks");
+    goto done;
+  }
+
+  ges_peaks_cache_store (cache, first_bucket, n_buckets, peaks);
+  if (ges_peaks_cache_is_complete (cache) &&
+      !ges_peaks_cache_save (cache, &error)) {
+    GST_INFO_OBJECT (self, "Could not save the peaks: %s", error->message);
+    g_clear_error (&error);
+  }
+
+done:
+  g_mutex_unlock (&self->priv->media_cache_lock);
+}
+
+/**
+ * ges_uri_clip_asset_get_cached_peaks:
+ * @self: A #GESUriClipAsset
+ * @bucket_duration: The duration covered by each bucket
+ * @n_channels: The number of audio channels
+ * @first_bucket: The index of the first bucket to get
+ * @n_buckets: The number of buckets to get
+ * @peaks: (out caller-allocates) (array): Return location for @n_buckets
+ * times @n_channels #GESAudioPeak
+ *
+ * Gets the audio peaks of @self at the @bucket_duration resolution from the
+ * media cache, without decoding anything. While the peaks are being
+ * computed, only the part of the range that is already available is given
+ * back, the next calls will give more of it.
+ *
+ * Returns: The number of buckets, from @first_bucket, copied to @peaks
+ */
+guint
+ges_uri_clip_asset_get_cached_peaks (GESUriClipAsset * self,
+    GstClockTime bucket_duration, guint n_channels, guint64 first_bucket,
+    guint n_buckets, GESAudioPeak * peaks)
+{
+  guint ret = 0;
+  GESPeaksCache *cache;
+
+  g_return_val_if_fail (GES_IS_URI_CLIP_ASSET (self), 0);
+  g_return_val_if_fail (GST_CLOCK_TIME_IS_VALID (bucket_duration) &&
+      bucket_duration > 0, 0);
+  g_return_val_if_fail (n_channels > 0, 0);
+  g_return_val_if_fail (peaks != NULL || n_buckets == 0, 0);
+
+  g_mutex_lock (&self->priv->media_cache_lock);
+  cache = _get_peaks_cache (self, bucket_duration, n_channels);
+  if (cache)
+    ret = ges_peaks_cache_lookup (cache, first_bucket, n_buckets, peaks);
+  g_mutex_unlock (&self->priv->media_cache_lock);
+
+  return ret;
+}
+
+/**
+ * ges_uri_clip_asset_store_thumbnail:
+ * @self: A #GESUriClipAsset
+ * @timestamp: The position of the thumbnail in the media file
+ * @sample: The thumbnail, its caps must be fixed
+ *
+ * Stores @sample in the media cache of the thumbnails with its caps, so
+ * that it can be given back by ges_uri_clip_asset_get_cached_thumbnails(),
+ * including in the next sessions for local files. Thumbnails can be raw or
+ * encoded, for example as JPEG. Thumbnails with different caps, even if
+ * only their format or pixel aspect ratio differs, are kept apart.
+ *
+ * The thumbnails are written to disk when
+ * ges_uri_clip_asset_save_media_cache() is called, which #GESThumbnailer
+ * does after each of its batches.
+ */
+void
+ges_uri_clip_asset_store_thumbnail (GESUriClipAsset * self,
+    GstClockTime timestamp, GstSample * sample)
+{
+  GstCaps *caps;
+
+  g_return_if_fail (GES_IS_URI_CLIP_ASSET (self));
+  g_return_if_fail (GST_CLOCK_TIME_IS_VALID (timestamp));
+  g_return_if_fail (GST_IS_SAMPLE (sample));
+
+  caps = gst_sample_get_caps (sample);
+  g_return_if_fail (caps != NULL && gst_caps_is_fixed (caps));
+
+  g_mutex_lock (&self->priv->media_cache_lock);
+  ges_thumbnail_cache_store (_get_thumbnail_cache (self, caps), timestamp,
+      sample);
+  g_mutex_unlock (&self->priv->media_cache_lock);
+}
+
+/**
+ * ges_uri_clip_asset_get_cached_thumbnails:
+ * @self: A #GESUriClipAsset
+ * @caps: The fixed caps the thumbnails were stored with
+ * @start: The first position to get thumbnails at
+ * @stop: The last position to get thumbnails at
+ *
+ * Gets the thumbnails with @caps stored in the media cache between
+ * @start and @stop included, without decoding anything. The PTS of their
+ * buffers is the timestamp they were stored at.
+ *
+ * Returns: (transfer full) (element-type GstSample): The thumbnails, sorted
+ * by timestamp
+ */
+GList *
+ges_uri_clip_asset_get_cached_thumbnails (GESUriClipAsset * self,
+    const GstCaps * caps, GstClockTime start, GstClockTime stop)
+{
+  GList *ret;
+
+  g_return_val_if_fail (GES_IS_URI_CLIP_ASSET (self), NULL);
+  g_return_val_if_fail (GST_IS_CAPS (caps) && gst_caps_is_fixed (caps),
+      NULL);
+
+  g_mutex_lock (&self->priv->media_cache_lock);
+  ret = ges_thumbnail_cache_lookup (_get_thumbnail_cache (self, caps), start,
+      stop);
+  g_mutex_unlock (&self->priv->media_cache_lock);
+
+  return ret;
+}
+
+/**
+ * ges_uri_clip_asset_save_media_cache:
+ * @self: A #GESUriClipAsset
+ * @error: (allow-none): An error to be set in case something wrong happens or %NULL
+ *
+ * Writes the peaks and thumbnails stored since they were last saved to the
+ * media cache on disk. Only local files have their media cache saved.
+ *
+ * Returns: %TRUE if everything could be saved
+ */
+gboolean
+ges_uri_clip_asset_save_media_cache (GESUriClipAsset * self, GError ** error)
+{
+  gboolean ret;
+
+  g_return_val_if_fail (GES_IS_URI_CLIP_ASSET (self), FALSE);
+
+  g_mutex_lock (&self->priv->media_cache_lock);
+  ret = _save_media_caches (self, error);
+  g_mutex_unlock (&self->priv->media_cache_lock);
+
+  return ret;
+}
+
+/* Peaks computation
+ *
+ * The audio stream is decoded once, as fast as possible, and each decoded
+ * buffer is reduced to all the requested resolutions from the streaming
+ * thread of the appsink, see ges-audio-peaks.c. The other streams are not
+ * decoded. The finished buckets are stored in the media cache as they
+ * come, so ges_uri_clip_asset_get_cached_peaks() gives the beginning of
+ * the waveform while the rest is being computed. */
+typedef struct
+{
+  GESUriClipAsset *asset;
+  GMainContext *context;
+
+  GstClockTime *bucket_durations;
+  guint n_resolutions;
+  GESPeaksProgressCallback progress_callback;
+  gpointer progress_data;
+
+  GstElement *pipeline;
+  GstElement *convert;
+  gboolean linked;
+  GList *other_decoders;
+
+  /* Only used from the streaming thread while the pipeline runs */
+  GESPeaksReducer **reducers;
+  guint n_channels;
+  gint rate;
+  guint64 n_frames;
+  gfloat *planar;
+  gsize planar_size;
+  gint percent;
+} PeaksData;
+
+typedef struct
+{
+  GESUriClipAsset *asset;
+  GESPeaksProgressCallback callback;
+  gpointer user_data;
+  gdouble progress;
+} PeaksProgress;
+
+static void
+_free_peaks_data (PeaksData * data)
+{
+  guint i;
+
+  if (data->reducers) {
+    for (i = 0; i < data->n_resolutions; i++) {
+      if (data->reducers[i])
+        ges_peaks_reducer_free (data->reducers[i]);
+    }
+    g_free (data->reducers);
+  }
+  if (data->other_decoders)
+    gst_plugin_feature_list_free (data->other_decoders);
+  g_free (data->planar);
+  g_free (data->bucket_durations);
+  g_main_context_unref (data->context);
+  g_object_unref (data->asset);
+  g_slice_free (PeaksData, data);
+}
+
+static void
+_free_peaks_progress (PeaksProgress * progress)
+{
+  g_object_unref (progress->asset);
+  g_slice_free (PeaksProgress, progress);
+}
+
+static gboolean
+_notify_peaks_progress (PeaksProgress * progress)
+{
+  progress->callback (progress->asset, progress->progress,
+      progress->user_data);
+
+  return FALSE;
+}
+
+static void
+_report_peaks_progress (PeaksData * data, gdouble value)
+{
+  PeaksProgress *progress;
+  gint percent = value * 100;
+
+  /* Only notify each percent */
+  if (data->progress_callback == NULL || percent <= data->percent)
+    return;
+  data->percent = percent;
+
+  progress = g_slice_new (PeaksProgress);
+  progress->asset = g_object_ref (data->asset);
+  progress->callback = data->progress_callback;
+  progress->user_data = data->progress_data;
+  progress->progress = value;
+  g_main_context_invoke_full (data->context, G_PRIORITY_DEFAULT,
+      (GSourceFunc) _notify_peaks_progress, progress,
+      (GDestroyNotify) _free_peaks_progress);
+}
+
+static void
+_store_finished_peaks (PeaksData * data, guint resolution)
+{
+  guint n_buckets;
+  guint64 first_bucket;
+  GESAudioPeak *peaks = ges_peaks_reducer_take (data->reducers[resolution],
+      &first_bucket, &n_buckets);
+
+  if (peaks == NULL)
+    return;
+
+  ges_uri_clip_asset_store_peaks (data->asset,
+      data->bucket_durations[resolution], data->n_channels, first_bucket,
+      n_buckets, peaks);
+  g_free (peaks);
+}
+
+static GstFlowReturn
+_peaks_new_sample_cb (GstElement * sink, PeaksData * data)
+{
+  guint i, n_frames;
+  GstMapInfo info;
+  GstBuffer *buffer;
+  gboolean discont;
+  GstSegment *segment;
+  GstSample *sample = NULL;
+  GstClockTime timestamp, duration = data->asset->priv->duration;
+  guint64 frame = GES_PEAKS_REDUCER_NO_POSITION;
+
+  g_signal_emit_by_name (sink, "pull-sample", &sample);
+  if (sample == NULL)
+    return GST_FLOW_EOS;
+
+  if (data->reducers == NULL) {
+    gint channels = 0;
+    GstStructure *structure =
+        gst_caps_get_structure (gst_sample_get_caps (sample), 0);
+
+    if (!gst_structure_get_int (structure, "channels", &channels) ||
+        !gst_structure_get_int (structure, "rate", &data->rate) ||
+        channels <= 0 || data->rate <= 0) {
+      gst_sample_unref (sample);
+      GST_ELEMENT_ERROR (sink, STREAM, FORMAT, (NULL),
+          ("Can not compute peaks with these caps"));
+
+      return GST_FLOW_ERROR;
+    }
+
+    data->n_channels = channels;
+    data->reducers = g_new0 (GESPeaksReducer *, data->n_resolutions);
+    for (i = 0; i < data->n_resolutions; i++)
+      data->reducers[i] = ges_peaks_reducer_new (data->bucket_durations[i],
+          channels, data->rate);
+  }
+
+  /* The buckets are placed according to the timestamps, so that streams
+   * not starting at 0 or with gaps get their peaks at the right place */
+  buffer = gst_sample_get_buffer (sample);
+  discont = GST_BUFFER_FLAG_IS_SET (buffer, GST_BUFFER_FLAG_DISCONT);
+  timestamp = GST_BUFFER_PTS (buffer);
+  segment = gst_sample_get_segment (sample);
+  if (GST_CLOCK_TIME_IS_VALID (timestamp) && segment &&
+      segment->format == GST_FORMAT_TIME)
+    timestamp = gst_segment_to_stream_time (segment, GST_FORMAT_TIME,
+        timestamp);
+  if (GST_CLOCK_TIME_IS_VALID (timestamp))
+    frame = gst_util_uint64_scale_round (timestamp, data->rate, GST_SECOND);
+
+  gst_buffer_map (buffer, &info, GST_MAP_READ);
+  n_frames = info.size / (sizeof (gfloat) * data->n_channels);
+  if (data->planar_size < info.size) {
+    data->planar = g_realloc (data->planar, info.size);
+    data->planar_size = info.size;
+  }
+  ges_audio_peaks_deinterleave ((const gfloat *) info.data, n_frames,
+      data->n_channels, data->planar);
+  gst_buffer_unmap (buffer, &info);
+  gst_sample_unref (sample);
+
+  for (i = 0; i < data->n_resolutions; i++) {
+    ges_peaks_reducer_push_at (data->reducers[i], frame, discont,
+        data->planar, n_frames);
+    _store_finished_peaks (data, i);
+  }
+
+  if (frame != GES_PEAKS_REDUCER_NO_POSITION)
+    data->n_frames = frame;
+  data->n_frames += n_frames;
+  if (GST_CLOCK_TIME_IS_VALID (duration) && duration > 0)
+    _report_peaks_progress (data, MIN (1.0,
+            (gdouble) gst_util_uint64_scale (data->n_frames, GST_SECOND,
+                data->rate) / duration));
+
+  return GST_FLOW_OK;
+}
+
+/* Only the audio streams are decoded, the other ones are exposed as soon
+ * as they could be given to a decoder */
+static gboolean
+_peaks_autoplug_continue_cb (GstElement * decodebin, GstPad * pad,
+    GstCaps * caps, PeaksData * data)
+{
+  GList *decoders = gst_element_factory_list_filter (data->other_decoders,
+      caps, GST_PAD_SINK, FALSE);
+  gboolean ret = decoders == NULL;
+
+  gst_plugin_feature_list_free (decoders);
+
+  return ret;
+}
+
+static void
+_peaks_pad_added_cb (GstElement * decodebin, GstPad * pad, PeaksData * data)
+{
+  GstPad *sinkpad;
+  GstElement *fakesink;
+  GstCaps *caps = gst_pad_query_caps (pad, NULL);
+  gboolean is_audio = g_str_has_prefix (gst_structure_get_name
+      (gst_caps_get_structure (caps, 0)), "audio/");
+
+  gst_caps_unref (caps);
+  if (is_audio && !data->linked) {
+    sinkpad = gst_element_get_static_pad (data->convert, "sink");
+    if (gst_pad_link (pad, sinkpad) == GST_PAD_LINK_OK)
+      data->linked = TRUE;
+    gst_object_unref (sinkpad);
+
+    return;
+  }
+
+  fakesink = gst_element_factory_make ("fakesink", NULL);
+  g_object_set (fakesink, "sync", FALSE, "async", FALSE, NULL);
+  gst_bin_add (GST_BIN (data->pipeline), fakesink);
+  gst_element_sync_state_with_parent (fakesink);
+  sinkpad = gst_element_get_static_pad (fakesink, "sink");
+  gst_pad_link (pad, sinkpad);
+  gst_object_unref (sinkpad);
+}
+
+static void
+_peaks_no_more_pads_cb (GstElement * decodebin, PeaksData * data)
+{
+  GstPad *sinkpad;
+
+  if (data->linked)
+    return;
+
+  /* No audio, let the pipeline finish */
+  sinkpad = gst_element_get_static_pad (data->convert, "sink");
+  gst_pad_send_event (sinkpad, gst_event_new_eos ());
+  gst_object_unref (sinkpad);
+}
+
+static gboolean
+_make_peaks_pipeline (PeaksData * data, GError ** error)
+{
+  GstCaps *caps;
+  GstElement *decodebin, *sink;
+
+  data->pipeline = gst_pipeline_new ("ges-peaks");
+  decodebin = gst_element_factory_make ("uridecodebin", NULL);
+  data->convert = gst_element_factory_make ("audioconvert", NULL);
+  sink = gst_element_factory_make ("appsink", NULL);
+  if (decodebin == NULL || data->convert == NULL || sink == NULL) {
+    g_set_error (error, GST_CORE_ERROR, GST_CORE_ERROR_MISSING_PLUGIN,
+        "Could not create the peaks computation elements");
+    if (decodebin)
+      gst_object_unref (decodebin);
+    if (data->convert)
+      gst_object_unref (data->convert);
+    if (sink)
+      gst_object_unref (sink);
+
+    return FALSE;
+  }
+
+  caps = gst_caps_new_simple ("audio/x-raw", "format", G_TYPE_STRING,
+      G_BYTE_ORDER == G_LITTLE_ENDIAN ? "F32LE" : "F32BE", "layout",
+      G_TYPE_STRING, "interleaved", NULL);
+  g_object_set (sink, "caps", caps, "sync", FALSE, "emit-signals", TRUE,
+      NULL);
+  gst_caps_unref (caps);
+  g_signal_connect (sink, "new-sample", G_CALLBACK (_peaks_new_sample_cb),
+      data);
+
+  data->other_decoders =
+      gst_element_factory_list_get_elements (GST_ELEMENT_FACTORY_TYPE_DECODER |
+      GST_ELEMENT_FACTORY_TYPE_MEDIA_VIDEO |
+      GST_ELEMENT_FACTORY_TYPE_MEDIA_IMAGE |
+      GST_ELEMENT_FACTORY_TYPE_MEDIA_SUBTITLE, GST_RANK_MARGINAL);
+  g_object_set (decodebin, "uri", ges_asset_get_id (GES_ASSET (data->asset)),
+      NULL);
+  g_signal_connect (decodebin, "autoplug-continue",
+      G_CALLBACK (_peaks_autoplug_continue_cb), data);
+  g_signal_connect (decodebin, "pad-added", G_CALLBACK (_peaks_pad_added_cb),
+      data);
+  g_signal_connect (decodebin, "no-more-pads",
+      G_CALLBACK (_peaks_no_more_pads_cb), data);
+
+  gst_bin_add_many (GST_BIN (data->pipeline), decodebin, data->convert, sink,
+      NULL);
+  gst_element_link (data->convert, sink);
+
+  return TRUE;
+}
+
+static void
+_compute_peaks_in_thread (GSimpleAsyncResult * simple, GObject * object,
+    GCancellable * cancellable)
+{
+  guint i;
+  GstBus *bus;
+  GError *error = NULL;
+  PeaksData *data = g_simple_async_result_get_op_res_gpointer (simple);
+  GESUriClipAsset *self = data->asset;
+
+  /* Nothing to decode if all the resolutions are in the media cache, the
+   * audio is decoded to as many channels as the discoverer found */
+  g_mutex_lock (&self->priv->media_cache_lock);
+  data->n_channels = self->priv->n_audio_channels;
+  for (i = 0; i < data->n_resolutions && data->n_channels; i++) {
+    if (!_has_complete_peaks (self, data->bucket_durations[i],
+            data->n_channels))
+      data->n_channels = 0;
+  }
+  g_mutex_unlock (&self->priv->media_cache_lock);
+
+  if (data->n_channels) {
+    GST_DEBUG_OBJECT (self, "Peaks found in the media cache");
+    _report_peaks_progress (data, 1.0);
+
+    return;
+  }
+
+  if (!_make_peaks_pipeline (data, &error))
+    goto done;
+
+  bus = gst_element_get_bus (data->pipeline);
+  gst_element_set_state (data->pipeline, GST_STATE_PLAYING);
+  while (error == NULL) {
+    GstMessage *message;
+
+    if (g_cancellable_set_error_if_cancelled (cancellable, &error))
+      break;
+
+    message = gst_bus_timed_pop_filtered (bus, 100 * GST_MSECOND,
+        GST_MESSAGE_EOS | GST_MESSAGE_ERROR);
+    if (message == NULL)
+      continue;
+
+    if (GST_MESSAGE_TYPE (message) == GST_MESSAGE_ERROR)
+      gst_message_parse_error (message, &error, NULL);
+    gst_message_unref (message);
+
+    if (error == NULL)
+      break;
+  }
+  gst_object_unref (bus);
+
+  /* The streaming threads are stopped, the reducers can be used from here */
+  gst_element_set_state (data->pipeline, GST_STATE_NULL);
+  if (error)
+    goto done;
+
+  if (data->reducers == NULL) {
+    g_set_error (&error, GST_STREAM_ERROR, GST_STREAM_ERROR_WRONG_TYPE,
+        "%s has no audio stream", ges_asset_get_id (GES_ASSET (self)));
+    goto done;
+  }
+
+  for (i = 0; i < data->n_resolutions; i++) {
+    guint64 n_buckets, total = _get_n_buckets (self,
+        data->bucket_durations[i]);
+
+    ges_peaks_reducer_drain (data->reducers[i]);
+    _store_finished_peaks (data, i);
+
+    /* The audio can be a bit shorter than the file */
+    n_buckets = ges_peaks_reducer_get_n_buckets (data->reducers[i]);
+    if (GST_CLOCK_TIME_IS_VALID (self->priv->duration) && n_buckets < total) {
+      GESAudioPeak *silence = g_new0 (GESAudioPeak,
+          (total - n_buckets) * data->n_channels);
+
+      ges_uri_clip_asset_store_peaks (self, data->bucket_durations[i],
+          data->n_channels, n_buckets, total - n_buckets, silence);
+      g_free (silence);
+    }
+  }
+  _report_peaks_progress (data, 1.0);
+
+done:
+  if (data->pipeline) {
+    gst_element_set_state (data->pipeline, GST_STATE_NULL);
+    gst_object_unref (data->pipeline);
+    data->pipeline = NULL;
+  }
+
+  if (error)
+    g_simple_async_result_take_error (simple, error);
+}
+
+/**
+ * ges_uri_clip_asset_compute_peaks_async:
+ * @self: A #GESUriClipAsset
+ * @bucket_durations: (array length=n_resolutions): The durations covered
+ * by each bucket, one per resolution to compute
+ * @n_resolutions: The number of resolutions
+ * @cancellable: (allow-none): A #GCancellable to cancel the computation, or %NULL
+ * @progress_callback: (allow-none): A #GESPeaksProgressCallback
+ * to call as the file is processed, or %NULL
+ * @progress_data: The user data to pass to @progress_callback
+ * @callback: A #GAsyncReadyCallback to call once the computation is done
+ * @user_data: The user data to pass to @callback
+ *
+ * Computes the waveform of the audio stream of @self at all the given
+ * resolutions, decoding the file only once from a thread. For each bucket
+ * and each channel, the lowest and highest samples and their root mean
+ * square are computed.
+ *
+ * The peaks are stored in the media cache of @self, and can be retrieved
+ * with ges_uri_clip_asset_get_cached_peaks() as soon as they are computed,
+ * without waiting for the whole file to be processed. If all the resolutions
+ * are already in the media cache, nothing is decoded.
+ *
+ * @progress_callback and @callback are called from the thread default main
+ * context of the caller.
+ */
+void
+ges_uri_clip_asset_compute_peaks_async (GESUriClipAsset * self,
+    const GstClockTime * bucket_durations, guint n_resolutions,
+    GCancellable * cancellable, GESPeaksProgressCallback progress_callback,
+    gpointer progress_data, GAsyncReadyCallback callback, gpointer user_data)
+{
+  guint i;
+  PeaksData *data;
+  GSimpleAsyncResult *simple;
+
+  g_return_if_fail (GES_IS_URI_CLIP_ASSET (self));
+  g_return_if_fail (bucket_durations != NULL && n_resolutions > 0);
+  for (i = 0; i < n_resolutions; i++)
+    g_return_if_fail (GST_CLOCK_TIME_IS_VALID (bucket_durations[i]) &&
+        bucket_durations[i] > 0);
+
+  data = g_slice_new0 (PeaksData);
+  data->asset = g_object_ref (self);
+  data->context = g_main_context_ref_thread_default ();
+  data->bucket_durations = g_memdup (bucket_durations,
+      n_resolutions * sizeof (GstClockTime));
+  data->n_resolutions = n_resolutions;
+  data->progress_callback = progress_callback;
+  data->progress_data = progress_data;
+  data->percent = -1;
+
+  simple = g_simple_async_result_new (G_OBJECT (self), callback, user_data,
+      ges_uri_clip_asset_compute_peaks_async);
+  g_simple_async_result_set_check_cancellable (simple, cancellable);
+  g_simple_async_result_set_op_res_gpointer (simple, data,
+      (GDestroyNotify) _free_peaks_data);
+  g_simple_async_result_run_in_thread (simple, _compute_peaks_in_thread,
+      G_PRIORITY_DEFAULT, cancellable);
+  g_object_unref (simple);
+}
+
+/**
+ * ges_uri_clip_asset_compute_peaks_finish:
+ * @self: A #GESUriClipAsset
+ * @result: The #GAsyncResult passed to the #GAsyncReadyCallback
+ * @n_channels: (out) (allow-none): Return location for the number of
+ * channels of the peaks, or %NULL
+ * @error: (out) (allow-none): An error to be set in case something wrong happens or %NULL
+ *
+ * Finishes a computation started with
+ * ges_uri_clip_asset_compute_peaks_async(). The peaks can then be
+ * retrieved with ges_uri_clip_asset_get_cached_peaks().
+ *
+ * Returns: %TRUE if the peaks have been computed
+ */
+gboolean
+ges_uri_clip_asset_compute_peaks_finish (GESUriClipAsset * self,
+    GAsyncResult * result, guint * n_channels, GError ** error)
+{
+  PeaksData *data;
+  GSimpleAsyncResult *simple = G_SIMPLE_ASYNC_RESULT (result);
+
+  g_return_val_if_fail (g_simple_async_result_is_valid (result,
+          G_OBJECT (self), ges_uri_clip_asset_compute_peaks_async), FALSE);
+
+  if (g_simple_async_result_propagate_error (simple, error))
+    return FALSE;
+
+  data = g_simple_async_result_get_op_res_gpointer (simple);
+  if (n_channels)
+    *n_channels = data->n_channels;
+
+  return TRUE;
+}
+
 /*****************************************************************
  *            GESUriSourceAsset implementation             *
  *****************************************************************/
@@ -534,11 +1862,8 @@ _extract (GESAsset * asset, GError ** error)
   GESTrackElement *trackelement;
   GESUriSourceAssetPrivate *priv = GES_URI_SOURCE_ASSET (asset)->priv;
 
-  if (GST_IS_DISCOVERER_STREAM_INFO (priv->sinfo) == FALSE) {
-    GST_WARNING_OBJECT (asset, "Can not extract as no strean info set");
-
-    return NULL;
-  }
+  GESTrackType type =
+      ges_track_element_asset_get_track_type (GES_TRACK_ELEMENT_ASSET (asset));
 
   if (priv->uri == NULL) {
     GST_WARNING_OBJECT (asset, "Can not extract as no uri set");
@@ -546,20 +1871,17 @@ _extract (GESAsset * asset, GError ** error)
     return NULL;
   }
 
-  if (GST_IS_DISCOVERER_VIDEO_INFO (priv->sinfo) &&
-      gst_discoverer_video_info_is_image ((GstDiscovererVideoInfo *)
-          priv->sinfo))
+  if (type == GES_TRACK_TYPE_VIDEO && priv->is_image)
     trackelement =
         GES_TRACK_ELEMENT (ges_image_source_new (g_strdup (priv->uri)));
-  else if (GST_IS_DISCOVERER_VIDEO_INFO (priv->sinfo))
+  else if (type == GES_TRACK_TYPE_VIDEO)
     trackelement =
         GES_TRACK_ELEMENT (ges_video_uri_source_new (g_strdup (priv->uri)));
   else
     trackelement =
         GES_TRACK_ELEMENT (ges_audio_uri_source_new (g_strdup (priv->uri)));
 
-  ges_track_element_set_track_type (trackelement,
-      ges_track_element_asset_get_track_type (GES_TRACK_ELEMENT_ASSET (asset)));
+  ges_track_element_set_track_type (trackelement, type);
 
   return GES_EXTRACTABLE (trackelement);
 }
@@ -582,6 +1904,7 @@ ges_uri_source_asset_init (GESUriSourceAsset * self)
 
   priv->sinfo = NULL;
   priv->parent_asset = NULL;
+  priv->is_image = FALSE;
   priv->uri = NULL;
 }
 
@@ -598,6 +1921,10 @@ ges_uri_source_asset_get_stream_info (GESUriSourceAsset * asset)
 {
   g_return_val_if_fail (GES_IS_URI_SOURCE_ASSET (asset), NULL);
 
+  /* Loaded from the discoverer cache */
+  if (asset->priv->sinfo == NULL && asset->priv->parent_asset)
+    ges_uri_clip_asset_get_info (asset->priv->parent_asset);
+
   return asset->priv->sinfo;
 }
 
@@ -43,6 +43,36 @@ G_BEGIN_DECLS
 
 typedef struct _GESUriClipAssetPrivate GESUriClipAssetPrivate;
 
+/**
+ * GESAudioPeak:
+ * @min: The lowest sample of the bucket
+ * @max: The highest sample of the bucket
+ * @rms: The root mean square of the samples of the bucket
+ *
+ * The peaks of one channel of the audio of a #GESUriClipAsset over a
+ * bucket of time, the samples being normalized between -1.0 and 1.0.
+ */
+typedef struct
+{
+  gfloat min;
+  gfloat max;
+  gfloat rms;
+} GESAudioPeak;
+
+/**
+ * GESPeaksProgressCallback:
+ * @asset: The #GESUriClipAsset whose peaks are being computed
+ * @progress: The part of the media file already processed, between 0.0
+ * and 1.0
+ * @user_data: The user data passed to
+ * ges_uri_clip_asset_compute_peaks_async()
+ *
+ * Reports the progress of ges_uri_clip_asset_compute_peaks_async().
+ */
+typedef void (*GESPeaksProgressCallback)            (GESUriClipAsset *asset,
+                                                     gdouble progress,
+                                                     gpointer user_data);
+
 GType ges_uri_clip_asset_get_type (void);
 
 struct _GESUriClipAsset
@@ -77,8 +107,44 @@ void ges_uri_clip_asset_new                         (const gchar *uri,
 GESUriClipAsset* ges_uri_clip_asset_request_sync    (const gchar *uri, GError **error);
 void ges_uri_clip_asset_class_set_timeout           (GESUriClipAssetClass *class,
                                                      GstClockTime timeout);
+void ges_uri_clip_asset_class_set_discoverer_pool_size (GESUriClipAssetClass *class,
+                                                        guint size);
 const GList * ges_uri_clip_asset_get_stream_assets  (GESUriClipAsset *self);
 
+void ges_uri_clip_asset_store_peaks                 (GESUriClipAsset *self,
+                                                     GstClockTime bucket_duration,
+                                                     guint n_channels,
+                                                     guint64 first_bucket,
+                                                     guint n_buckets,
+                                                     const GESAudioPeak *peaks);
+guint ges_uri_clip_asset_get_cached_peaks           (GESUriClipAsset *self,
+                                                     GstClockTime bucket_duration,
+                                                     guint n_channels,
+                                                     guint64 first_bucket,
+                                                     guint n_buckets,
+                                                     GESAudioPeak *peaks);
+void ges_uri_clip_asset_store_thumbnail             (GESUriClipAsset *self,
+                                                     GstClockTime timestamp,
+                                                     GstSample *sample);
+GList * ges_uri_clip_asset_get_cached_thumbnails    (GESUriClipAsset *self,
+                                                     const GstCaps *caps,
+                                                     GstClockTime start,
+                                                     GstClockTime stop);
+gboolean ges_uri_clip_asset_save_media_cache        (GESUriClipAsset *self,
+                                                     GError **error);
+void ges_uri_clip_asset_compute_peaks_async         (GESUriClipAsset *self,
+                                                     const GstClockTime *bucket_durations,
+                                                     guint n_resolutions,
+                                                     GCancellable *cancellable,
+                                                     GESPeaksProgressCallback progress_callback,
+                                                     gpointer progress_data,
+                                                     GAsyncReadyCallback callback,
+                                                     gpointer user_data);
+gboolean ges_uri_clip_asset_compute_peaks_finish    (GESUriClipAsset *self,
+                                                     GAsyncResult *result,
+                                                     guint *n_channels,
+                                                     GError **error);
+
 #define GES_TYPE_URI_SOURCE_ASSET ges_uri_source_asset_get_type()
 #define GES_URI_SOURCE_ASSET(obj) \
     (G_TYPE_CHECK_INSTANCE_CAST ((obj), GES_TYPE_URI_SOURCE_ASSET, GESUriSourceAsset))
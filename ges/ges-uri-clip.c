@@ -136,6 +136,25 @@ ges_uri_clip_finalize (GObject * object)
   G_OBJECT_CLASS (parent_class)->finalize (object);
 }
 
+static GESTimelineElement *
+ges_uri_clip_clone (GESTimelineElement * element)
+{
+  GESUriClip *copy, *self = GES_URI_CLIP (element);
+
+  if (G_OBJECT_TYPE (self) != GES_TYPE_URI_CLIP)
+    return GES_TIMELINE_ELEMENT_CLASS (parent_class)->clone (element);
+
+  copy = g_object_new (GES_TYPE_URI_CLIP, NULL);
+  copy->priv->uri = g_strdup (self->priv->uri);
+  copy->priv->mute = self->priv->mute;
+  copy->priv->is_image = self->priv->is_image;
+  ges_clip_set_supported_formats (GES_CLIP (copy),
+      ges_clip_get_supported_formats (GES_CLIP (self)));
+  ges_timeline_element_clone_fields (element, GES_TIMELINE_ELEMENT (copy));
+
+  return GES_TIMELINE_ELEMENT (copy);
+}
+
 static void
 ges_uri_clip_class_init (GESUriClipClass * klass)
 {
@@ -188,6 +207,7 @@ ges_uri_clip_class_init (GESUriClipClass * klass)
           G_PARAM_READWRITE | G_PARAM_CONSTRUCT));
 
   element_class->set_max_duration = filesource_set_max_duration;
+  element_class->clone = ges_uri_clip_clone;
 
   timobj_class->create_track_elements = ges_uri_clip_create_track_elements;
   timobj_class->create_track_element = ges_uri_clip_create_track_element;
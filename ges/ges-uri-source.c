@@ -232,6 +232,17 @@ ges_uri_source_create_element (GESTrackElement * trksrc)
   return topbin;
 }
 
+static void
+ges_uri_source_release_element (GESTrackElement * trksrc)
+{
+  GESTimelineElement *parent = GES_TIMELINE_ELEMENT_PARENT (trksrc);
+
+  if (parent)
+    g_signal_handlers_disconnect_by_func (parent, update_z_order_cb, trksrc);
+
+  GES_URI_SOURCE (trksrc)->priv->positionner = NULL;
+}
+
 /* Extractable interface implementation */
 
 static gchar *
@@ -338,6 +349,7 @@ ges_track_filesource_class_init (GESUriSourceClass * klass)
           NULL, G_PARAM_READWRITE | G_PARAM_CONSTRUCT_ONLY));
 
   track_class->create_element = ges_uri_source_create_element;
+  track_class->release_element = ges_uri_source_release_element;
 }
 
 static void
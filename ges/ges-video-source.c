@@ -124,6 +124,26 @@ ges_video_source_create_element (GESTrackElement * trksrc)
   return topbin;
 }
 
+static void
+ges_video_source_release_element (GESTrackElement * trksrc)
+{
+  GESVideoSourcePrivate *priv = GES_VIDEO_SOURCE (trksrc)->priv;
+  GESTimelineElement *parent = GES_TIMELINE_ELEMENT_PARENT (trksrc);
+
+  /* Connected again when the positionner is created back */
+  if (priv->layer) {
+    g_signal_handlers_disconnect_by_func (priv->layer,
+        layer_priority_changed_cb, trksrc);
+    priv->layer = NULL;
+  }
+
+  if (parent)
+    g_signal_handlers_disconnect_by_func (parent, layer_changed_cb, trksrc);
+
+  priv->positionner = NULL;
+  priv->capsfilter = NULL;
+}
+
 static gboolean
 _set_parent (GESTimelineElement * self, GESTimelineElement * parent)
 {
@@ -158,6 +178,7 @@ ges_video_source_class_init (GESVideoSourceClass * klass)
   element_class->set_parent = _set_parent;
   track_class->gnlobject_factorytype = "gnlsource";
   track_class->create_element = ges_video_source_create_element;
+  track_class->release_element = ges_video_source_release_element;
   video_source_class->create_source = NULL;
 }
 
@@ -24,6 +24,7 @@
 
 #include "ges-video-track.h"
 #include "ges-smart-video-mixer.h"
+#include "ges-parse-cache.h"
 
 struct _GESVideoTrackPrivate
 {
@@ -37,9 +38,8 @@ G_DEFINE_TYPE (GESVideoTrack, ges_video_track, GES_TYPE_TRACK);
 static GstElement *
 create_element_for_raw_video_gap (GESTrack * track)
 {
-  return gst_parse_bin_from_description
-      ("videotestsrc pattern=2 name=src ! capsfilter caps=video/x-raw", TRUE,
-      NULL);
+  return ges_parse_cache_get_bin
+      ("videotestsrc pattern=2 name=src ! capsfilter caps=video/x-raw", NULL);
 }
 
 static void
@@ -87,6 +87,8 @@ ges_video_transition_duration_changed (GESTrackElement * self,
 
 static GstElement *ges_video_transition_create_element (GESTrackElement * self);
 
+static void ges_video_transition_release_element (GESTrackElement * self);
+
 static void ges_video_transition_dispose (GObject * object);
 
 static void ges_video_transition_finalize (GObject * object);
@@ -158,6 +160,7 @@ ges_video_transition_class_init (GESVideoTransitionClass * klass)
 
   toclass = GES_TRACK_ELEMENT_CLASS (klass);
   toclass->create_element = ges_video_transition_create_element;
+  toclass->release_element = ges_video_transition_release_element;
 }
 
 static void
@@ -367,6 +370,28 @@ ges_video_transition_create_element (GESTrackElement * object)
   return topbin;
 }
 
+static void
+ges_video_transition_release_element (GESTrackElement * object)
+{
+  GESVideoTransitionPrivate *priv = GES_VIDEO_TRANSITION (object)->priv;
+
+  /* What was set on the elements becomes pending again */
+  g_object_get (priv->smpte, "border", &priv->pending_border_value,
+      "invert", &priv->pending_inverted, NULL);
+  priv->pending_type = priv->type;
+  priv->type = GES_VIDEO_STANDARD_TRANSITION_TYPE_NONE;
+  priv->smpte = NULL;
+
+  gst_object_unref (priv->crossfade_control_source);
+  priv->crossfade_control_source = NULL;
+  gst_object_unref (priv->smpte_control_source);
+  priv->smpte_control_source = NULL;
+
+  release_mixer (&priv->mixer, &priv->mixer_sinka, &priv->mixer_sinkb);
+
+  g_signal_handlers_disconnect_by_func (object, duration_changed_cb, NULL);
+}
+
 static GObject *
 link_element_to_mixer_with_smpte (GstBin * bin, GstElement * element,
     GstElement * mixer, gint type, GstElement ** smpteref,
@@ -529,7 +554,7 @@ ges_video_transition_get_border (GESVideoTransition * self)
   gint value;
 
   if (!self->priv->smpte) {
-    return -1;
+    return self->priv->pending_border_value;
   }
 
   g_object_get (self->priv->smpte, "border", &value, NULL);
@@ -570,7 +595,7 @@ ges_video_transition_is_inverted (GESVideoTransition * self)
   gboolean inverted;
 
   if (!self->priv->smpte) {
-    return FALSE;
+    return !self->priv->pending_inverted;
   }
 
   g_object_get (self->priv->smpte, "invert", &inverted, NULL);
@@ -144,10 +144,28 @@ ges_video_uri_source_dispose (GObject * object)
   G_OBJECT_CLASS (ges_video_uri_source_parent_class)->dispose (object);
 }
 
+static GESTimelineElement *
+ges_video_uri_source_clone (GESTimelineElement * element)
+{
+  GESVideoUriSource *copy, *self = GES_VIDEO_URI_SOURCE (element);
+
+  if (G_OBJECT_TYPE (self) != GES_TYPE_VIDEO_URI_SOURCE)
+    return GES_TIMELINE_ELEMENT_CLASS
+        (ges_video_uri_source_parent_class)->clone (element);
+
+  copy = g_object_new (GES_TYPE_VIDEO_URI_SOURCE, NULL);
+  copy->uri = g_strdup (self->uri);
+  ges_track_element_clone_fields (GES_TRACK_ELEMENT (self),
+      GES_TRACK_ELEMENT (copy));
+
+  return GES_TIMELINE_ELEMENT (copy);
+}
+
 static void
 ges_video_uri_source_class_init (GESVideoUriSourceClass * klass)
 {
   GObjectClass *object_class = G_OBJECT_CLASS (klass);
+  GESTimelineElementClass *element_class = GES_TIMELINE_ELEMENT_CLASS (klass);
   GESVideoSourceClass *source_class = GES_VIDEO_SOURCE_CLASS (klass);
 
   g_type_class_add_private (klass, sizeof (GESVideoUriSourcePrivate));
@@ -155,6 +173,7 @@ ges_video_uri_source_class_init (GESVideoUriSourceClass * klass)
   object_class->get_property = ges_video_uri_source_get_property;
   object_class->set_property = ges_video_uri_source_set_property;
   object_class->dispose = ges_video_uri_source_dispose;
+  element_class->clone = ges_video_uri_source_clone;
 
   /**
    * GESVideoUriSource:uri:
@@ -43,8 +43,6 @@ struct _GESXmlFormatterPrivate
 {
   gboolean ges_opened;
   gboolean project_opened;
-
-  GString *str;
 };
 
 static inline void
@@ -686,74 +684,130 @@ _error_parsing (GMarkupParseContext * context, GError * error,
  ***********************************************/
 
 /* XML writting utils */
-static inline void
-append_escaped (GString * str, gchar * tmpstr)
+
+/* The output is accumulated in a buffer, reused all along the saving, which
+ * is flushed to the output stream whenever it gets bigger than that */
+#define WRITE_BUFFER_SIZE (64 * 1024)
+
+typedef struct
 {
-  g_string_append (str, tmpstr);
-  g_free (tmpstr);
-}
+  GOutputStream *stream;
+  GCancellable *cancellable;
+  GString *buffer;
+
+  /* The first error that happened while writing, once set nothing is
+   * written anymore */
+  GError *error;
+} XmlWriter;
 
-static inline gboolean
-_can_serialize_spec (GParamSpec * spec)
+static void
+_flush (XmlWriter * w)
 {
-  if (spec->flags & G_PARAM_WRITABLE && !(spec->flags & G_PARAM_CONSTRUCT_ONLY)
-      && !g_type_is_a (G_PARAM_SPEC_VALUE_TYPE (spec), G_TYPE_OBJECT)
-      && g_strcmp0 (spec->name, "name")
-      && G_PARAM_SPEC_VALUE_TYPE (spec) != G_TYPE_GTYPE)
-    return TRUE;
+  if (w->error == NULL && w->buffer->len)
+    g_output_stream_write_all (w->stream, w->buffer->str, w->buffer->len,
+        NULL, w->cancellable, &w->error);
 
-  return FALSE;
+  g_string_truncate (w->buffer, 0);
 }
 
 static inline void
-_init_value_from_spec_for_serialization (GValue * value, GParamSpec * spec)
+_maybe_flush (XmlWriter * w)
 {
+  if (G_UNLIKELY (w->buffer->len >= WRITE_BUFFER_SIZE))
+    _flush (w);
+}
 
-  if (g_type_is_a (spec->value_type, G_TYPE_ENUM) ||
-      g_type_is_a (spec->value_type, G_TYPE_FLAGS))
-    g_value_init (value, G_TYPE_INT);
-  else
-    g_value_init (value, spec->value_type);
+static inline void
+_write (XmlWriter * w, const gchar * str)
+{
+  g_string_append (w->buffer, str);
+  _maybe_flush (w);
 }
 
-static gchar *
-_serialize_properties (GObject * object, const gchar * fieldname, ...)
+static void _write_printf (XmlWriter * w, const gchar * format, ...)
+    G_GNUC_PRINTF (2, 3);
+
+static void
+_write_printf (XmlWriter * w, const gchar * format, ...)
 {
-  gchar *ret;
-  guint n_props, j;
-  GParamSpec *spec, **pspecs;
-  GObjectClass *class = G_OBJECT_GET_CLASS (object);
-  GstStructure *structure = gst_structure_new_empty ("properties");
-
-  pspecs = g_object_class_list_properties (class, &n_props);
-  for (j = 0; j < n_props; j++) {
-    GValue val = { 0 };
-
-    spec = pspecs[j];
-    if (_can_serialize_spec (spec)) {
-      _init_value_from_spec_for_serialization (&val, spec);
-      g_object_get_property (object, spec->name, &val);
-      gst_structure_set_value (structure, spec->name, &val);
-      g_value_unset (&val);
+  va_list args;
+
+  va_start (args, format);
+  g_string_append_vprintf (w->buffer, format, args);
+  va_end (args);
+
+  _maybe_flush (w);
+}
+
+/* Escapes @text the same way as g_markup_escape_text() does, but directly
+ * in the output buffer */
+static void
+_write_escaped (XmlWriter * w, const gchar * text)
+{
+  const gchar *p, *run;
+
+  /* Keep what g_markup_printf_escaped() used to output */
+  if (text == NULL)
+    text = "(null)";
+
+  for (p = run = text; *p; p++) {
+    const gchar *entity = NULL;
+    guchar c = *p, next = p[1];
+
+    switch (c) {
+      case '&':
+        entity = "&amp;";
+        break;
+      case '<':
+        entity = "&lt;";
+        break;
+      case '>':
+        entity = "&gt;";
+        break;
+      case '\'':
+        entity = "&apos;";
+        break;
+      case '"':
+        entity = "&quot;";
+        break;
+      default:
+        if ((c >= 0x1 && c <= 0x8) || (c >= 0xb && c <= 0xc) ||
+            (c >= 0xe && c <= 0x1f) || c == 0x7f) {
+          g_string_append_len (w->buffer, run, p - run);
+          g_string_append_printf (w->buffer, "&#x%x;", c);
+          run = p + 1;
+        } else if (c == 0xc2 && next >= 0x80 && next <= 0x9f) {
+          /* C1 control characters */
+          g_string_append_len (w->buffer, run, p - run);
+          g_string_append_printf (w->buffer, "&#x%x;", next);
+          p++;
+          run = p + 1;
+        }
+        continue;
     }
-  }
-  g_free (pspecs);
 
-  if (fieldname) {
-    va_list varargs;
-    va_start (varargs, fieldname);
-    gst_structure_remove_fields_valist (structure, fieldname, varargs);
-    va_end (varargs);
+    g_string_append_len (w->buffer, run, p - run);
+    g_string_append (w->buffer, entity);
+    run = p + 1;
   }
+  g_string_append_len (w->buffer, run, p - run);
 
-  ret = gst_structure_to_string (structure);
-  gst_structure_free (structure);
+  _maybe_flush (w);
+}
 
-  return ret;
+/* Writes ` @name='@value'`, escaping @value */
+static inline void
+_write_attr (XmlWriter * w, const gchar * name, const gchar * value)
+{
+  g_string_append_c (w->buffer, ' ');
+  g_string_append (w->buffer, name);
+  g_string_append (w->buffer, "='");
+  _write_escaped (w, value);
+  g_string_append_c (w->buffer, '\'');
 }
 
 static inline void
-_save_assets (GString * str, GESProject * project)
+_save_assets (XmlWriter * w, GESProject * project)
 {
   char *properties, *metas;
   GESAsset *asset;
@@ -762,14 +816,16 @@ _save_assets (GString * str, GESProject * project)
   assets = ges_project_list_assets (project, GES_TYPE_EXTRACTABLE);
   for (tmp = assets; tmp; tmp = tmp->next) {
     asset = GES_ASSET (tmp->data);
-    properties = _serialize_properties (G_OBJECT (asset), NULL);
+    properties =
+        ges_base_xml_formatter_serialize_properties (G_OBJECT (asset), NULL);
     metas = ges_meta_container_metas_to_string (GES_META_CONTAINER (asset));
-    append_escaped (str,
-        g_markup_printf_escaped
-        ("      <asset id='%s' extractable-type-name='%s' properties='%s' metadatas='%s' />\n",
-            ges_asset_get_id (asset),
-            g_type_name (ges_asset_get_extractable_type (asset)), properties,
-            metas));
+    _write (w, "      <asset");
+    _write_attr (w, "id", ges_asset_get_id (asset));
+    _write_attr (w, "extractable-type-name",
+        g_type_name (ges_asset_get_extractable_type (asset)));
+    _write_attr (w, "properties", properties);
+    _write_attr (w, "metadatas", metas);
+    _write (w, " />\n");
     g_free (properties);
     g_free (metas);
   }
@@ -777,7 +833,7 @@ _save_assets (GString * str, GESProject * project)
 }
 
 static inline void
-_save_proxies (GString * str, GESProject * project)
+_save_proxies (XmlWriter * w, GESProject * project)
 {
   char *properties, *metas;
   GESAsset *asset;
@@ -786,15 +842,17 @@ _save_proxies (GString * str, GESProject * project)
   assets = ges_project_list_proxies (project, GES_TYPE_EXTRACTABLE);
   for (tmp = assets; tmp; tmp = tmp->next) {
     asset = GES_ASSET (tmp->data);
-    properties = _serialize_properties (G_OBJECT (asset), NULL);
+    properties =
+        ges_base_xml_formatter_serialize_properties (G_OBJECT (asset), NULL);
     metas = ges_meta_container_metas_to_string (GES_META_CONTAINER (asset));
-    append_escaped (str,
-        g_markup_printf_escaped
-        ("        <asset id='%s' parent_id='%s' extractable-type-name='%s' properties='%s' metadatas='%s' />\n",
-            ges_asset_get_id (asset),
-            ges_asset_get_parent_id (asset),
-            g_type_name (ges_asset_get_extractable_type (asset)), properties,
-            metas));
+    _write (w, "        <asset");
+    _write_attr (w, "id", ges_asset_get_id (asset));
+    _write_attr (w, "parent_id", ges_asset_get_parent_id (asset));
+    _write_attr (w, "extractable-type-name",
+        g_type_name (ges_asset_get_extractable_type (asset)));
+    _write_attr (w, "properties", properties);
+    _write_attr (w, "metadatas", metas);
+    _write (w, " />\n");
     g_free (properties);
     g_free (metas);
   }
@@ -802,7 +860,7 @@ _save_proxies (GString * str, GESProject * project)
 }
 
 static inline void
-_save_tracks (GString * str, GESTimeline * timeline)
+_save_tracks (XmlWriter * w, GESTimeline * timeline)
 {
   gchar *strtmp, *metas;
   GESTrack *track;
@@ -815,10 +873,12 @@ _save_tracks (GString * str, GESTimeline * timeline)
     track = GES_TRACK (tmp->data);
     strtmp = gst_caps_to_string (ges_track_get_caps (track));
     metas = ges_meta_container_metas_to_string (GES_META_CONTAINER (track));
-    append_escaped (str,
-        g_markup_printf_escaped
-        ("      <track caps='%s' track-type='%i' track-id='%i' metadatas='%s'/>\n",
-            strtmp, track->type, nb_tracks++, metas));
+    _write (w, "      <track");
+    _write_attr (w, "caps", strtmp);
+    _write_printf (w, " track-type='%i' track-id='%i'", track->type,
+        nb_tracks++);
+    _write_attr (w, "metadatas", metas);
+    _write (w, "/>\n");
     g_free (strtmp);
     g_free (metas);
   }
@@ -827,7 +887,7 @@ _save_tracks (GString * str, GESTimeline * timeline)
 
 /* TODO : Use this function for every track element with controllable properties */
 static inline void
-_save_keyframes (GString * str, GESTrackElement * trackelement, gint index)
+_save_keyframes (XmlWriter * w, GESTrackElement * trackelement, gint index)
 {
   GHashTable *bindings_hashtable;
   GHashTableIter iter;
@@ -851,14 +911,11 @@ _save_keyframes (GString * str, GESTrackElement * trackelement, gint index)
         GList *timed_values, *tmp;
         GstInterpolationMode mode;
 
-        append_escaped (str,
-            g_markup_printf_escaped
-            ("            <binding type='direct' source_type='interpolation' property='%s'",
-                (gchar *) key));
+        _write (w, "            <binding type='direct'"
+            " source_type='interpolation'");
+        _write_attr (w, "property", (gchar *) key);
         g_object_get (source, "mode", &mode, NULL);
-        append_escaped (str, g_markup_printf_escaped (" mode='%d'", mode));
-        append_escaped (str, g_markup_printf_escaped (" track_id='%d'", index));
-        append_escaped (str, g_markup_printf_escaped (" values ='"));
+        _write_printf (w, " mode='%d' track_id='%d' values ='", mode, index);
         timed_values =
             gst_timed_value_control_source_get_all
             (GST_TIMED_VALUE_CONTROL_SOURCE (source));
@@ -867,28 +924,28 @@ _save_keyframes (GString * str, GESTrackElement * trackelement, gint index)
           GstTimedValue *value;
 
           value = (GstTimedValue *) tmp->data;
-          append_escaped (str, g_markup_printf_escaped (" %" G_GUINT64_FORMAT
-                  ":%s ", value->timestamp, g_ascii_dtostr (strbuf,
-                      G_ASCII_DTOSTR_BUF_SIZE, value->value)));
+          _write_printf (w, " %" G_GUINT64_FORMAT ":%s ", value->timestamp,
+              g_ascii_dtostr (strbuf, G_ASCII_DTOSTR_BUF_SIZE, value->value));
         }
-        append_escaped (str, g_markup_printf_escaped ("'/>\n"));
+        g_list_free (timed_values);
+        _write (w, "'/>\n");
       } else
         GST_DEBUG ("control source not in [interpolation]");
+
+      gst_object_unref (source);
     } else
       GST_DEBUG ("Binding type not in [direct]");
   }
 }
 
 static inline void
-_save_effect (GString * str, guint clip_id, GESTrackElement * trackelement,
+_save_effect (XmlWriter * w, guint clip_id, GESTrackElement * trackelement,
     GESTimeline * timeline)
 {
   GESTrack *tck;
   GList *tmp, *tracks;
-  GstStructure *structure;
   gchar *properties, *metas;
-  GParamSpec **pspecs, *spec;
-  guint j, n_props = 0, track_id = 0;
+  guint track_id = 0;
 
   tck = ges_track_element_get_track (trackelement);
   if (tck == NULL) {
@@ -905,66 +962,57 @@ _save_effect (GString * str, guint clip_id, GESTrackElement * trackelement,
   }
   g_list_free_full (tracks, gst_object_unref);
 
-  properties = _serialize_properties (G_OBJECT (trackelement), "start",
-      "in-point", "duration", "locked", "max-duration", "name", NULL);
+  properties =
+      ges_base_xml_formatter_serialize_properties (G_OBJECT (trackelement),
+      "start", "in-point", "duration", "locked", "max-duration", "name", NULL);
   metas =
       ges_meta_container_metas_to_string (GES_META_CONTAINER (trackelement));
-  append_escaped (str,
-      g_markup_printf_escaped ("          <effect asset-id='%s' clip-id='%u'"
-          " type-name='%s' track-type='%i' track-id='%i' properties='%s' metadatas='%s'",
-          ges_extractable_get_id (GES_EXTRACTABLE (trackelement)), clip_id,
-          g_type_name (G_OBJECT_TYPE (trackelement)), tck->type, track_id,
-          properties, metas));
+  _write (w, "          <effect");
+  _write_attr (w, "asset-id",
+      ges_extractable_get_id (GES_EXTRACTABLE (trackelement)));
+  _write_printf (w, " clip-id='%u'", clip_id);
+  _write_attr (w, "type-name", g_type_name (G_OBJECT_TYPE (trackelement)));
+  _write_printf (w, " track-type='%i' track-id='%i'", tck->type, track_id);
+  _write_attr (w, "properties", properties);
+  _write_attr (w, "metadatas", metas);
   g_free (properties);
   g_free (metas);
 
-  pspecs = ges_track_element_list_children_properties (trackelement, &n_props);
-  structure = gst_structure_new_empty ("properties");
-  for (j = 0; j < n_props; j++) {
-    GValue val = { 0 };
-
-    spec = pspecs[j];
-    if (_can_serialize_spec (spec)) {
-      _init_value_from_spec_for_serialization (&val, spec);
-      ges_track_element_get_child_property_by_pspec (trackelement, spec, &val);
-      gst_structure_set_value (structure, spec->name, &val);
-      g_value_unset (&val);
-    }
-    g_param_spec_unref (spec);
-  }
-  g_free (pspecs);
-
-  append_escaped (str,
-      g_markup_printf_escaped (" children-properties='%s'>\n",
-          gst_structure_to_string (structure)));
+  properties =
+      ges_base_xml_formatter_serialize_children_properties (trackelement);
+  _write_attr (w, "children-properties", properties);
+  _write (w, ">\n");
+  g_free (properties);
 
-  _save_keyframes (str, trackelement, -1);
+  _save_keyframes (w, trackelement, -1);
 
-  append_escaped (str, g_markup_printf_escaped ("          </effect>\n"));
-  gst_structure_free (structure);
+  _write (w, "          </effect>\n");
 }
 
 static inline void
-_save_layers (GString * str, GESTimeline * timeline)
+_save_layers (XmlWriter * w, GESTimeline * timeline)
 {
   gchar *properties, *metas;
   GESLayer *layer;
   GESClip *clip;
-  GList *tmplayer, *tmpclip, *clips;
+  GList *tmplayer, *tmpclip, *clips, *tracks;
 
   guint nbclips = 0;
 
+  tracks = ges_timeline_get_tracks (timeline);
   for (tmplayer = timeline->layers; tmplayer; tmplayer = tmplayer->next) {
     guint priority;
     layer = GES_LAYER (tmplayer->data);
 
     priority = ges_layer_get_priority (layer);
-    properties = _serialize_properties (G_OBJECT (layer), "priority", NULL);
+    properties =
+        ges_base_xml_formatter_serialize_properties (G_OBJECT (layer),
+        "priority", NULL);
     metas = ges_meta_container_metas_to_string (GES_META_CONTAINER (layer));
-    append_escaped (str,
-        g_markup_printf_escaped
-        ("      <layer priority='%i' properties='%s' metadatas='%s'>\n",
-            priority, properties, metas));
+    _write_printf (w, "      <layer priority='%i'", priority);
+    _write_attr (w, "properties", properties);
+    _write_attr (w, "metadatas", metas);
+    _write (w, ">\n");
     g_free (properties);
     g_free (metas);
 
@@ -972,32 +1020,33 @@ _save_layers (GString * str, GESTimeline * timeline)
     for (tmpclip = clips; tmpclip; tmpclip = tmpclip->next) {
       GList *effects, *tmpeffect;
       GList *tmptrackelement;
-      GList *tracks;
 
       clip = GES_CLIP (tmpclip->data);
       effects = ges_clip_get_top_effects (clip);
 
       /* We escape all mandatrorry properties that are handled sparetely
        * and vtype for StandarTransition as it is the asset ID */
-      properties = _serialize_properties (G_OBJECT (clip),
+      properties =
+          ges_base_xml_formatter_serialize_properties (G_OBJECT (clip),
           "supported-formats", "rate", "in-point", "start", "duration",
           "max-duration", "priority", "vtype", "uri", NULL);
-      append_escaped (str,
-          g_markup_printf_escaped ("        <clip id='%i' asset-id='%s'"
-              " type-name='%s' layer-priority='%i' track-types='%i' start='%"
-              G_GUINT64_FORMAT "' duration='%" G_GUINT64_FORMAT "' inpoint='%"
-              G_GUINT64_FORMAT "' rate='%d' properties='%s' >\n", nbclips,
-              ges_extractable_get_id (GES_EXTRACTABLE (clip)),
-              g_type_name (G_OBJECT_TYPE (clip)), priority,
-              ges_clip_get_supported_formats (clip), _START (clip),
-              _DURATION (clip), _INPOINT (clip), 0, properties));
+      _write_printf (w, "        <clip id='%i'", nbclips);
+      _write_attr (w, "asset-id",
+          ges_extractable_get_id (GES_EXTRACTABLE (clip)));
+      _write_attr (w, "type-name", g_type_name (G_OBJECT_TYPE (clip)));
+      _write_printf (w, " layer-priority='%i' track-types='%i' start='%"
+          G_GUINT64_FORMAT "' duration='%" G_GUINT64_FORMAT "' inpoint='%"
+          G_GUINT64_FORMAT "' rate='%d'", priority,
+          ges_clip_get_supported_formats (clip), _START (clip),
+          _DURATION (clip), _INPOINT (clip), 0);
+      _write_attr (w, "properties", properties);
+      _write (w, " >\n");
       g_free (properties);
 
       for (tmpeffect = effects; tmpeffect; tmpeffect = tmpeffect->next)
-        _save_effect (str, nbclips, GES_TRACK_ELEMENT (tmpeffect->data),
+        _save_effect (w, nbclips, GES_TRACK_ELEMENT (tmpeffect->data),
             timeline);
-
-      tracks = ges_timeline_get_tracks (timeline);
+      g_list_free_full (effects, gst_object_unref);
 
       for (tmptrackelement = GES_CONTAINER_CHILDREN (clip); tmptrackelement;
           tmptrackelement = tmptrackelement->next) {
@@ -1009,89 +1058,106 @@ _save_layers (GString * str, GESTimeline * timeline)
         index =
             g_list_index (tracks,
             ges_track_element_get_track (tmptrackelement->data));
-        _save_keyframes (str, tmptrackelement->data, index);
+        _save_keyframes (w, tmptrackelement->data, index);
       }
 
-      g_list_free_full (tracks, gst_object_unref);
-
-      g_string_append (str, "        </clip>\n");
+      _write (w, "        </clip>\n");
 
       nbclips++;
     }
-    g_string_append (str, "      </layer>\n");
+    g_list_free_full (clips, gst_object_unref);
+
+    _write (w, "      </layer>\n");
   }
+  g_list_free_full (tracks, gst_object_unref);
 }
 
 
 static inline void
-_save_timeline (GString * str, GESTimeline * timeline)
+_save_timeline (XmlWriter * w, GESTimeline * timeline)
 {
   gchar *properties = NULL, *metas = NULL;
 
-  properties = _serialize_properties (G_OBJECT (timeline), "update", "name",
-      "async-handling", "message-forward", NULL);
+  properties =
+      ges_base_xml_formatter_serialize_properties (G_OBJECT (timeline),
+      "update", "name", "async-handling", "message-forward", NULL);
 
   ges_meta_container_set_uint64 (GES_META_CONTAINER (timeline), "duration",
       ges_timeline_get_duration (timeline));
   metas = ges_meta_container_metas_to_string (GES_META_CONTAINER (timeline));
-  append_escaped (str,
-      g_markup_printf_escaped
-      ("    <timeline properties='%s' metadatas='%s'>\n", properties, metas));
+  _write (w, "    <timeline");
+  _write_attr (w, "properties", properties);
+  _write_attr (w, "metadatas", metas);
+  _write (w, ">\n");
 
-  _save_tracks (str, timeline);
-  _save_layers (str, timeline);
+  _save_tracks (w, timeline);
+  _save_layers (w, timeline);
 
-  g_string_append (str, "    </timeline>\n");
+  _write (w, "    </timeline>\n");
 
   g_free (properties);
   g_free (metas);
 }
 
 static void
-_save_stream_profiles (GString * str, GstEncodingProfile * sprof,
+_save_stream_profiles (XmlWriter * w, GstEncodingProfile * sprof,
     const gchar * profilename, guint id)
 {
   gchar *tmpc;
   GstCaps *tmpcaps;
   const gchar *preset, *preset_name, *name, *description;
 
-  append_escaped (str,
-      g_markup_printf_escaped
-      ("        <stream-profile parent='%s' id='%d' type='%s' "
-          "presence='%d' ", profilename, id,
-          gst_encoding_profile_get_type_nick (sprof),
-          gst_encoding_profile_get_presence (sprof)));
+  _write (w, "        <stream-profile");
+  _write_attr (w, "parent", profilename);
+  _write_printf (w, " id='%d'", id);
+  _write_attr (w, "type", gst_encoding_profile_get_type_nick (sprof));
+  _write_printf (w, " presence='%d' ",
+      gst_encoding_profile_get_presence (sprof));
 
   tmpcaps = gst_encoding_profile_get_format (sprof);
   if (tmpcaps) {
     tmpc = gst_caps_to_string (tmpcaps);
-    append_escaped (str, g_markup_printf_escaped ("format='%s' ", tmpc));
+    _write (w, "format='");
+    _write_escaped (w, tmpc);
+    _write (w, "' ");
     gst_caps_unref (tmpcaps);
     g_free (tmpc);
   }
 
   name = gst_encoding_profile_get_name (sprof);
-  if (name)
-    append_escaped (str, g_markup_printf_escaped ("name='%s' ", name));
+  if (name) {
+    _write (w, "name='");
+    _write_escaped (w, name);
+    _write (w, "' ");
+  }
 
   description = gst_encoding_profile_get_description (sprof);
-  if (description)
-    append_escaped (str, g_markup_printf_escaped ("description='%s' ",
-            description));
+  if (description) {
+    _write (w, "description='");
+    _write_escaped (w, description);
+    _write (w, "' ");
+  }
 
   preset = gst_encoding_profile_get_preset (sprof);
-  if (preset)
-    append_escaped (str, g_markup_printf_escaped ("preset='%s' ", preset));
+  if (preset) {
+    _write (w, "preset='");
+    _write_escaped (w, preset);
+    _write (w, "' ");
+  }
 
   preset_name = gst_encoding_profile_get_preset_name (sprof);
-  if (preset_name)
-    append_escaped (str, g_markup_printf_escaped ("preset-name='%s' ",
-            preset_name));
+  if (preset_name) {
+    _write (w, "preset-name='");
+    _write_escaped (w, preset_name);
+    _write (w, "' ");
+  }
 
   tmpcaps = gst_encoding_profile_get_restriction (sprof);
   if (tmpcaps) {
     tmpc = gst_caps_to_string (tmpcaps);
-    append_escaped (str, g_markup_printf_escaped ("restriction='%s' ", tmpc));
+    _write (w, "restriction='");
+    _write_escaped (w, tmpc);
+    _write (w, "' ");
     gst_caps_unref (tmpcaps);
     g_free (tmpc);
   }
@@ -1099,17 +1165,16 @@ _save_stream_profiles (GString * str, GstEncodingProfile * sprof,
   if (GST_IS_ENCODING_VIDEO_PROFILE (sprof)) {
     GstEncodingVideoProfile *vp = (GstEncodingVideoProfile *) sprof;
 
-    append_escaped (str,
-        g_markup_printf_escaped ("pass='%d' variableframerate='%i' ",
-            gst_encoding_video_profile_get_pass (vp),
-            gst_encoding_video_profile_get_variableframerate (vp)));
+    _write_printf (w, "pass='%d' variableframerate='%i' ",
+        gst_encoding_video_profile_get_pass (vp),
+        gst_encoding_video_profile_get_variableframerate (vp));
   }
 
-  g_string_append (str, "/>\n");
+  _write (w, "/>\n");
 }
 
 static inline void
-_save_encoding_profiles (GString * str, GESProject * project)
+_save_encoding_profiles (XmlWriter * w, GESProject * project)
 {
   GstCaps *profformat;
   const gchar *profname, *profdesc, *profpreset, *proftype, *profpresetname;
@@ -1125,28 +1190,35 @@ _save_encoding_profiles (GString * str, GESProject * project)
     profpresetname = gst_encoding_profile_get_preset_name (prof);
     proftype = gst_encoding_profile_get_type_nick (prof);
 
-    append_escaped (str,
-        g_markup_printf_escaped
-        ("      <encoding-profile name='%s' description='%s' type='%s' ",
-            profname, profdesc, proftype));
+    _write (w, "      <encoding-profile");
+    _write_attr (w, "name", profname);
+    _write_attr (w, "description", profdesc);
+    _write_attr (w, "type", proftype);
+    _write (w, " ");
 
-    if (profpreset)
-      append_escaped (str, g_markup_printf_escaped ("preset='%s' ",
-              profpreset));
+    if (profpreset) {
+      _write (w, "preset='");
+      _write_escaped (w, profpreset);
+      _write (w, "' ");
+    }
 
-    if (profpresetname)
-      append_escaped (str, g_markup_printf_escaped ("preset-name='%s' ",
-              profpresetname));
+    if (profpresetname) {
+      _write (w, "preset-name='");
+      _write_escaped (w, profpresetname);
+      _write (w, "' ");
+    }
 
     profformat = gst_encoding_profile_get_format (prof);
     if (profformat) {
       gchar *format = gst_caps_to_string (profformat);
-      append_escaped (str, g_markup_printf_escaped ("format='%s' ", format));
+      _write (w, "format='");
+      _write_escaped (w, format);
+      _write (w, "' ");
       g_free (format);
       gst_caps_unref (profformat);
     }
 
-    g_string_append (str, ">\n");
+    _write (w, ">\n");
 
     if (GST_IS_ENCODING_CONTAINER_PROFILE (prof)) {
       guint i = 0;
@@ -1157,55 +1229,64 @@ _save_encoding_profiles (GString * str, GESProject * project)
       for (tmp2 = gst_encoding_container_profile_get_profiles (container_prof);
           tmp2; tmp2 = tmp2->next, i++) {
         GstEncodingProfile *sprof = (GstEncodingProfile *) tmp2->data;
-        _save_stream_profiles (str, sprof, profname, i);
+        _save_stream_profiles (w, sprof, profname, i);
       }
     }
-    append_escaped (str,
-        g_markup_printf_escaped ("      </encoding-profile>\n"));
+    _write (w, "      </encoding-profile>\n");
   }
 }
 
-static GString *
-_save (GESFormatter * formatter, GESTimeline * timeline, GError ** error)
+static gboolean
+_save_to_stream (GESFormatter * formatter, GESTimeline * timeline,
+    GOutputStream * stream, GError ** error)
 {
-  GString *str;
+  XmlWriter w;
   GESProject *project;
 
   gchar *properties = NULL, *metas = NULL;
-  GESXmlFormatterPrivate *priv;
 
-
-  priv = _GET_PRIV (formatter);
   project = formatter->project;
-  str = priv->str = g_string_new (NULL);
 
-  g_string_append_printf (str, "<ges version='%i.%i'>\n", API_VERSION,
-      MINOR_VERSION);
-  properties = _serialize_properties (G_OBJECT (project), NULL);
+  w.stream = stream;
+  w.cancellable = g_cancellable_get_current ();
+  w.buffer = g_string_sized_new (WRITE_BUFFER_SIZE + 4096);
+  w.error = NULL;
+
+  _write_printf (&w, "<ges version='%i.%i'>\n", API_VERSION, MINOR_VERSION);
+  properties =
+      ges_base_xml_formatter_serialize_properties (G_OBJECT (project), NULL);
   metas = ges_meta_container_metas_to_string (GES_META_CONTAINER (project));
-  append_escaped (str,
-      g_markup_printf_escaped ("  <project properties='%s' metadatas='%s'>\n",
-          properties, metas));
+  _write (&w, "  <project");
+  _write_attr (&w, "properties", properties);
+  _write_attr (&w, "metadatas", metas);
+  _write (&w, ">\n");
   g_free (properties);
   g_free (metas);
 
-  g_string_append (str, "    <encoding-profiles>\n");
-  _save_encoding_profiles (str, project);
-  g_string_append (str, "    </encoding-profiles>\n");
+  _write (&w, "    <encoding-profiles>\n");
+  _save_encoding_profiles (&w, project);
+  _write (&w, "    </encoding-profiles>\n");
+
+  _write (&w, "    <ressources>\n");
+  _save_assets (&w, project);
+  _write (&w, "      <proxies>\n");
+  _save_proxies (&w, project);
+  _write (&w, "      </proxies>\n");
+  _write (&w, "    </ressources>\n");
 
-  g_string_append (str, "    <ressources>\n");
-  _save_assets (str, project);
-  g_string_append (str, "      <proxies>\n");
-  _save_proxies (str, project);
-  g_string_append (str, "      </proxies>\n");
-  g_string_append (str, "    </ressources>\n");
+  _save_timeline (&w, timeline);
+  _write (&w, "</project>\n</ges>");
 
-  _save_timeline (str, timeline);
-  g_string_append (str, "</project>\n</ges>");
+  _flush (&w);
+  g_string_free (w.buffer, TRUE);
 
-  priv->str = NULL;
+  if (w.error) {
+    g_propagate_error (error, w.error);
+
+    return FALSE;
+  }
 
-  return str;
+  return TRUE;
 }
 
 /***********************************************
@@ -1256,7 +1337,7 @@ ges_xml_formatter_class_init (GESXmlFormatterClass * self_class)
       "ges", "GStreamer Editing Services project files",
       "xges", "application/ges", VERSION, GST_RANK_PRIMARY);
 
-  basexmlformatter_class->save = _save;
+  GES_FORMATTER_CLASS (self_class)->save_to_stream = _save_to_stream;
 }
 
 #undef COLLECT_STR_OPT
@@ -85,6 +85,7 @@ ges_init (void)
   /* FIXME PITIVI Formatter disabled
    * GES_TYPE_PITIVI_FORMATTER; */
   GES_TYPE_XML_FORMATTER;
+  GES_TYPE_BINARY_FORMATTER;
 
   /* Register track elements */
   GES_TYPE_EFFECT;
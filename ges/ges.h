@@ -54,6 +54,7 @@
 #include <ges/ges-extractable.h>
 #include <ges/ges-base-xml-formatter.h>
 #include <ges/ges-xml-formatter.h>
+#include <ges/ges-binary-formatter.h>
 
 #include <ges/ges-track.h>
 #include <ges/ges-track-element.h>
@@ -75,6 +76,8 @@
 #include <ges/ges-formatter.h>
 /* DISABLED #include <ges/ges-pitivi-formatter.h> */
 #include <ges/ges-utils.h>
+#include <ges/ges-parallel-render.h>
+#include <ges/ges-thumbnailer.h>
 #include <ges/ges-meta-container.h>
 #include <ges/ges-gerror.h>
 #include <ges/ges-audio-track.h>
@@ -0,0 +1,101 @@
+/* Gstreamer Editing Services
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#include <ges/ges.h>
+
+#define DURATION (5 * GST_SECOND)
+
+static const guint layer_counts[] = { 1, 2, 4, 8, 16 };
+
+static void
+benchmark_layers (guint n_layers)
+{
+  guint i;
+  GstBus *bus;
+  GESLayer *layer;
+  GESClip *clip;
+  GstElement *sink;
+  GstMessage *msg;
+  GESPipeline *pipeline;
+  GESTimeline *timeline;
+  GstClockTime start, end;
+
+  timeline = ges_timeline_new ();
+  ges_timeline_add_track (timeline, GES_TRACK (ges_video_track_new ()));
+
+  for (i = 0; i < n_layers; i++) {
+    layer = ges_timeline_append_layer (timeline);
+    clip = GES_CLIP (ges_test_clip_new ());
+    g_object_set (clip, "duration", DURATION, NULL);
+    ges_layer_add_clip (layer, clip);
+  }
+
+  /* Composite as fast as possible */
+  sink = gst_element_factory_make ("fakesink", NULL);
+  g_object_set (sink, "sync", FALSE, NULL);
+
+  pipeline = ges_pipeline_new ();
+  ges_pipeline_preview_set_video_sink (pipeline, sink);
+  ges_pipeline_add_timeline (pipeline, timeline);
+
+  /* Only time the compositing, not the building and preroll of the
+   * compositions */
+  ges_timeline_commit (timeline);
+  bus = gst_element_get_bus (GST_ELEMENT (pipeline));
+  gst_element_set_state (GST_ELEMENT (pipeline), GST_STATE_PAUSED);
+  msg = gst_bus_timed_pop_filtered (bus, GST_CLOCK_TIME_NONE,
+      GST_MESSAGE_ASYNC_DONE | GST_MESSAGE_ERROR);
+  if (GST_MESSAGE_TYPE (msg) == GST_MESSAGE_ERROR) {
+    g_printerr ("%2u layers: error while prerolling\n", n_layers);
+    goto done;
+  }
+  gst_message_unref (msg);
+
+  start = gst_util_get_timestamp ();
+  gst_element_set_state (GST_ELEMENT (pipeline), GST_STATE_PLAYING);
+  msg = gst_bus_timed_pop_filtered (bus, GST_CLOCK_TIME_NONE,
+      GST_MESSAGE_EOS | GST_MESSAGE_ERROR);
+  end = gst_util_get_timestamp ();
+
+  if (GST_MESSAGE_TYPE (msg) == GST_MESSAGE_ERROR)
+    g_printerr ("%2u layers: error while compositing\n", n_layers);
+  else
+    g_print ("%2u layers: %" GST_TIME_FORMAT " to composite %"
+        GST_TIME_FORMAT "\n", n_layers, GST_TIME_ARGS (end - start),
+        GST_TIME_ARGS (DURATION));
+
+done:
+  gst_message_unref (msg);
+  gst_object_unref (bus);
+  gst_element_set_state (GST_ELEMENT (pipeline), GST_STATE_NULL);
+  gst_object_unref (pipeline);
+}
+
+gint
+main (gint argc, gchar * argv[])
+{
+  guint i;
+
+  gst_init (&argc, &argv);
+  ges_init ();
+
+  for (i = 0; i < G_N_ELEMENTS (layer_counts); i++)
+    benchmark_layers (layer_counts[i]);
+
+  return 0;
+}
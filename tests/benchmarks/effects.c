@@ -0,0 +1,101 @@
+/* Gstreamer Editing Services
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ * Boston, MA 02111-1307, USA.
+ */
+
+#include <ges/ges.h>
+#include "../../ges/ges-parse-cache.h"
+
+#define NUM_OBJECTS 10000
+
+/* What GESEffect builds for an agingtv effect in a video track */
+#define DESCRIPTION "videoconvert name=pre_video_convert ! agingtv " \
+  "! videoconvert name=post_video_convert"
+
+/* Can be overriden by passing the number of effects as first argument */
+static guint num_objects = NUM_OBJECTS;
+
+static void
+benchmark_bins (const gchar * name, GstElement * (*create) (void))
+{
+  guint i;
+  GstClockTime start, end;
+
+  start = gst_util_get_timestamp ();
+  for (i = 0; i < num_objects; i++)
+    gst_object_unref (gst_object_ref_sink (create ()));
+  end = gst_util_get_timestamp ();
+
+  g_print ("%" GST_TIME_FORMAT " - creating %u bins %s\n",
+      GST_TIME_ARGS (end - start), num_objects, name);
+}
+
+static GstElement *
+parse_bin (void)
+{
+  return gst_parse_bin_from_description (DESCRIPTION, TRUE, NULL);
+}
+
+static GstElement *
+cached_bin (void)
+{
+  return ges_parse_cache_get_bin (DESCRIPTION, NULL);
+}
+
+gint
+main (gint argc, gchar * argv[])
+{
+  guint i;
+  GESAsset *asset;
+  GList *clips, *tmp;
+  GESLayer *layer;
+  GESTimeline *timeline;
+  GstClockTime start, end;
+
+  gst_init (&argc, &argv);
+  ges_init ();
+
+  if (argc > 1)
+    num_objects = MAX (1, g_ascii_strtoull (argv[1], NULL, 10));
+
+  benchmark_bins ("parsing the description", parse_bin);
+  benchmark_bins ("from the parse cache", cached_bin);
+
+  timeline = ges_timeline_new ();
+  ges_timeline_add_track (timeline, GES_TRACK (ges_video_track_new ()));
+  layer = ges_timeline_append_layer (timeline);
+
+  asset = ges_asset_request (GES_TYPE_TEST_CLIP, NULL, NULL);
+  for (i = 0; i < num_objects; i++)
+    ges_layer_add_asset (layer, asset, i * GST_SECOND, 0, GST_SECOND,
+        GES_TRACK_TYPE_UNKNOWN);
+  gst_object_unref (asset);
+
+  /* Each effect creates its bin when added to the track */
+  clips = ges_layer_get_clips (layer);
+  start = gst_util_get_timestamp ();
+  for (tmp = clips; tmp; tmp = tmp->next)
+    ges_container_add (tmp->data,
+        GES_TIMELINE_ELEMENT (ges_effect_new ("agingtv")));
+  end = gst_util_get_timestamp ();
+  g_print ("%" GST_TIME_FORMAT " - adding %u effects\n",
+      GST_TIME_ARGS (end - start), num_objects);
+
+  g_list_free_full (clips, gst_object_unref);
+  gst_object_unref (timeline);
+
+  return 0;
+}
@@ -0,0 +1,144 @@
+/* Gstreamer Editing Services
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ * Boston, MA 02111-1307, USA.
+ */
+
+#include <ges/ges.h>
+#include <glib/gstdio.h>
+
+#define NUM_CLIPS 5000
+#define NUM_LAYERS 10
+
+/* Can be overriden by passing the number of clips as first argument */
+static guint num_clips = NUM_CLIPS;
+
+static void
+project_loaded_cb (GESProject * project, GESTimeline * timeline,
+    GMainLoop * mainloop)
+{
+  g_main_loop_quit (mainloop);
+}
+
+static GESTimeline *
+create_timeline (void)
+{
+  guint i;
+  GESAsset *asset;
+  GESTimeline *timeline;
+  GESLayer *layers[NUM_LAYERS];
+  GESProject *project = ges_project_new (NULL);
+
+  /* The timeline needs to come from a project to be saved */
+  timeline = GES_TIMELINE (ges_asset_extract (GES_ASSET (project), NULL));
+  ges_timeline_add_track (timeline, GES_TRACK (ges_video_track_new ()));
+  ges_timeline_add_track (timeline, GES_TRACK (ges_audio_track_new ()));
+  gst_object_unref (project);
+
+  asset = ges_asset_request (GES_TYPE_TEST_CLIP, NULL, NULL);
+  for (i = 0; i < NUM_LAYERS; i++)
+    layers[i] = ges_timeline_append_layer (timeline);
+
+  for (i = 0; i < num_clips; i++) {
+    GESClip *clip = ges_layer_add_asset (layers[i % NUM_LAYERS], asset,
+        (i / NUM_LAYERS) * GST_SECOND, 0, GST_SECOND, GES_TRACK_TYPE_UNKNOWN);
+
+    if (i % 10 == 0)
+      ges_container_add (GES_CONTAINER (clip),
+          GES_TIMELINE_ELEMENT (ges_effect_new ("agingtv")));
+  }
+  gst_object_unref (asset);
+
+  return timeline;
+}
+
+static void
+benchmark_formatter (GESTimeline * timeline, const gchar * formatter_id,
+    const gchar * extension)
+{
+  GFile *file;
+  GFileInfo *info;
+  gchar *location, *uri;
+  GESProject *project;
+  GESAsset *formatter_asset;
+  GESTimeline *loaded_timeline;
+  GstClockTime start, end;
+  GMainLoop *mainloop = g_main_loop_new (NULL, FALSE);
+
+  location = g_strdup_printf ("%s/ges-benchmark-formatters.%s",
+      g_get_tmp_dir (), extension);
+  uri = gst_filename_to_uri (location, NULL);
+
+  /* Consumed by ges_project_save() */
+  formatter_asset = ges_asset_request (GES_TYPE_FORMATTER, formatter_id, NULL);
+  project = GES_PROJECT (ges_extractable_get_asset (GES_EXTRACTABLE
+          (timeline)));
+
+  start = gst_util_get_timestamp ();
+  if (!ges_project_save (project, timeline, uri, formatter_asset, TRUE, NULL))
+    g_error ("Could not save %s", uri);
+  end = gst_util_get_timestamp ();
+
+  file = g_file_new_for_uri (uri);
+  info = g_file_query_info (file, G_FILE_ATTRIBUTE_STANDARD_SIZE,
+      G_FILE_QUERY_INFO_NONE, NULL, NULL);
+  g_print ("%" GST_TIME_FORMAT " - saving %u clips with the '%s' formatter"
+      " (%" G_GINT64_FORMAT " bytes)\n", GST_TIME_ARGS (end - start),
+      num_clips, formatter_id, info ? g_file_info_get_size (info) : -1);
+  if (info)
+    g_object_unref (info);
+  g_object_unref (file);
+
+  project = ges_project_new (uri);
+  g_signal_connect (project, "loaded", (GCallback) project_loaded_cb, mainloop);
+  loaded_timeline = ges_timeline_new ();
+
+  start = gst_util_get_timestamp ();
+  if (!ges_project_load (project, loaded_timeline, NULL))
+    g_error ("Could not load %s", uri);
+  g_main_loop_run (mainloop);
+  end = gst_util_get_timestamp ();
+  g_print ("%" GST_TIME_FORMAT " - loading %u clips with the '%s' formatter\n",
+      GST_TIME_ARGS (end - start), num_clips, formatter_id);
+
+  gst_object_unref (loaded_timeline);
+  gst_object_unref (project);
+  g_main_loop_unref (mainloop);
+
+  g_unlink (location);
+  g_free (location);
+  g_free (uri);
+}
+
+gint
+main (gint argc, gchar * argv[])
+{
+  GESTimeline *timeline;
+
+  gst_init (&argc, &argv);
+  ges_init ();
+
+  if (argc > 1)
+    num_clips = MAX (1, g_ascii_strtoull (argv[1], NULL, 10));
+
+  timeline = create_timeline ();
+
+  benchmark_formatter (timeline, "ges", "xges");
+  benchmark_formatter (timeline, "gesb", "gesb");
+
+  gst_object_unref (timeline);
+
+  return 0;
+}
@@ -0,0 +1,105 @@
+/* Gstreamer Editing Services
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ * Boston, MA 02111-1307, USA.
+ */
+
+#include <string.h>
+#include <ges/ges.h>
+
+#define NUM_OBJECTS 20000
+
+/* Can be overriden by passing the number of clips as first argument */
+static guint num_objects = NUM_OBJECTS;
+
+/* Resident memory in kB, 0 if it can not be known */
+static guint64
+get_resident_memory (void)
+{
+  gchar *contents, *line;
+  guint64 ret = 0;
+
+  if (!g_file_get_contents ("/proc/self/status", &contents, NULL, NULL))
+    return 0;
+
+  line = strstr (contents, "VmRSS:");
+  if (line)
+    ret = g_ascii_strtoull (line + strlen ("VmRSS:"), NULL, 10);
+  g_free (contents);
+
+  return ret;
+}
+
+static void
+benchmark_timeline (gboolean lazy_loading)
+{
+  guint i;
+  GESAsset *asset;
+  GESLayer *layer;
+  GESTrack *tracks[2];
+  GESTimeline *timeline;
+  guint64 memory;
+  GstClockTime start, end;
+  const gchar *name = lazy_loading ? "lazy" : "eager";
+
+  memory = get_resident_memory ();
+  start = gst_util_get_timestamp ();
+
+  timeline = ges_timeline_new ();
+  tracks[0] = GES_TRACK (ges_video_track_new ());
+  tracks[1] = GES_TRACK (ges_audio_track_new ());
+  for (i = 0; i < G_N_ELEMENTS (tracks); i++) {
+    ges_track_set_lazy_loading (tracks[i], lazy_loading);
+    ges_timeline_add_track (timeline, tracks[i]);
+  }
+  layer = ges_timeline_append_layer (timeline);
+
+  asset = ges_asset_request (GES_TYPE_TEST_CLIP, NULL, NULL);
+  for (i = 0; i < num_objects; i++)
+    ges_layer_add_asset (layer, asset, i * GST_SECOND, 0, GST_SECOND,
+        GES_TRACK_TYPE_UNKNOWN);
+  gst_object_unref (asset);
+
+  end = gst_util_get_timestamp ();
+  g_print ("%" GST_TIME_FORMAT " - %s: adding %u clips (%" G_GUINT64_FORMAT
+      " kB of resident memory more)\n", GST_TIME_ARGS (end - start), name,
+      num_objects, get_resident_memory () - memory);
+
+  start = gst_util_get_timestamp ();
+  ges_timeline_commit (timeline);
+  end = gst_util_get_timestamp ();
+  g_print ("%" GST_TIME_FORMAT " - %s: first commit (%" G_GUINT64_FORMAT
+      " kB of resident memory more)\n", GST_TIME_ARGS (end - start), name,
+      get_resident_memory () - memory);
+
+  gst_object_unref (timeline);
+}
+
+gint
+main (gint argc, gchar * argv[])
+{
+  gst_init (&argc, &argv);
+  ges_init ();
+
+  if (argc > 1)
+    num_objects = MAX (1, g_ascii_strtoull (argv[1], NULL, 10));
+
+  /* The lazy case goes first as the memory freed by the first run is not
+   * necessarily given back to the system */
+  benchmark_timeline (TRUE);
+  benchmark_timeline (FALSE);
+
+  return 0;
+}
@@ -0,0 +1,131 @@
+/* Gstreamer Editing Services
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ * Boston, MA 02111-1307, USA.
+ */
+
+#include <ges/ges.h>
+
+#define NUM_OBJECTS 10000
+
+/* Can be overriden by passing the number of clips as first argument */
+static guint num_objects = NUM_OBJECTS;
+
+/* How ges_timeline_element_copy() used to work, going through every
+ * GParamSpec of the class */
+static GESTimelineElement *
+reflective_copy (GESTimelineElement * self)
+{
+  GParameter *params;
+  GParamSpec **specs;
+  GESTimelineElement *ret;
+  guint n, n_specs, n_params = 0;
+
+  specs = g_object_class_list_properties (G_OBJECT_GET_CLASS (self), &n_specs);
+  params = g_new0 (GParameter, n_specs);
+
+  for (n = 0; n < n_specs; ++n) {
+    if (g_strcmp0 (specs[n]->name, "parent") &&
+        (specs[n]->flags & G_PARAM_READWRITE) == G_PARAM_READWRITE) {
+      params[n_params].name = g_intern_string (specs[n]->name);
+      g_value_init (&params[n_params].value, specs[n]->value_type);
+      g_object_get_property (G_OBJECT (self), specs[n]->name,
+          &params[n_params].value);
+      ++n_params;
+    }
+  }
+
+  ret = g_object_newv (G_OBJECT_TYPE (self), n_params, params);
+
+  for (n = 0; n < n_params; ++n)
+    g_value_unset (&params[n].value);
+  g_free (specs);
+  g_free (params);
+
+  return ret;
+}
+
+static void
+benchmark_copy (GList * clips, const gchar * name,
+    GESTimelineElement * (*copy) (GESTimelineElement *))
+{
+  GList *tmp, *child;
+  guint n_copies = 0;
+  GstClockTime start, end;
+
+  start = gst_util_get_timestamp ();
+  for (tmp = clips; tmp; tmp = tmp->next) {
+    gst_object_unref (gst_object_ref_sink (copy (tmp->data)));
+    n_copies++;
+
+    for (child = GES_CONTAINER_CHILDREN (tmp->data); child;
+        child = child->next) {
+      gst_object_unref (gst_object_ref_sink (copy (child->data)));
+      n_copies++;
+    }
+  }
+  end = gst_util_get_timestamp ();
+
+  g_print ("%" GST_TIME_FORMAT " - %u %s copies\n",
+      GST_TIME_ARGS (end - start), n_copies, name);
+}
+
+static GESTimelineElement *
+fast_copy (GESTimelineElement * self)
+{
+  return ges_timeline_element_copy (self, FALSE);
+}
+
+gint
+main (gint argc, gchar * argv[])
+{
+  guint i;
+  GList *clips, *tmp;
+  GESAsset *asset;
+  GESLayer *layer;
+  GESTimeline *timeline;
+  GstClockTime start, end;
+
+  gst_init (&argc, &argv);
+  ges_init ();
+
+  if (argc > 1)
+    num_objects = MAX (1, g_ascii_strtoull (argv[1], NULL, 10));
+
+  asset = ges_asset_request (GES_TYPE_TEST_CLIP, NULL, NULL);
+  timeline = ges_timeline_new_audio_video ();
+  layer = ges_timeline_append_layer (timeline);
+
+  for (i = 0; i < num_objects; i++)
+    ges_layer_add_asset (layer, asset, i * 2 * GST_SECOND, 0,
+        2 * GST_SECOND, GES_TRACK_TYPE_UNKNOWN);
+
+  clips = ges_layer_get_clips (layer);
+  benchmark_copy (clips, "reflective", reflective_copy);
+  benchmark_copy (clips, "template based", fast_copy);
+
+  start = gst_util_get_timestamp ();
+  for (tmp = clips; tmp; tmp = tmp->next)
+    ges_clip_split (tmp->data, GES_TIMELINE_ELEMENT_START (tmp->data) + GST_SECOND);
+  end = gst_util_get_timestamp ();
+  g_print ("%" GST_TIME_FORMAT " - splitting %u clips\n",
+      GST_TIME_ARGS (end - start), num_objects);
+
+  g_list_free_full (clips, gst_object_unref);
+  gst_object_unref (timeline);
+  gst_object_unref (asset);
+
+  return 0;
+}
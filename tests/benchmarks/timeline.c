@@ -23,6 +23,56 @@
 
 #define NUM_OBJECTS 1000
 
+/* Can be overriden by passing the number of clips as first argument */
+static guint num_objects = NUM_OBJECTS;
+
+static void
+benchmark_gaps (GESAsset * asset)
+{
+  guint i, created, reused;
+  GList *tracks, *tmp;
+  GESLayer *layer;
+  GESTimeline *timeline;
+  GESClip **clips = g_new0 (GESClip *, num_objects);
+  GstClockTime start, end;
+
+  layer = ges_layer_new ();
+  timeline = ges_timeline_new_audio_video ();
+  ges_timeline_add_layer (timeline, layer);
+
+  /* Leave a hole after each clip */
+  for (i = 0; i < num_objects; i++)
+    clips[i] = ges_layer_add_asset (layer, asset, i * 2000, 0,
+        1000, GES_TRACK_TYPE_UNKNOWN);
+
+  start = gst_util_get_timestamp ();
+  ges_timeline_commit (timeline);
+  end = gst_util_get_timestamp ();
+  g_print ("%" GST_TIME_FORMAT " - committing with %d gaps\n",
+      GST_TIME_ARGS (end - start), i);
+
+  start = gst_util_get_timestamp ();
+  for (i = 0; i < MIN (100, num_objects); i++) {
+    ges_timeline_element_set_start (GES_TIMELINE_ELEMENT (clips[i]),
+        i * 2000 + 500);
+    ges_timeline_commit (timeline);
+  }
+  end = gst_util_get_timestamp ();
+  g_print ("%" GST_TIME_FORMAT " - moving and committing %d times\n",
+      GST_TIME_ARGS (end - start), i);
+
+  tracks = ges_timeline_get_tracks (timeline);
+  for (tmp = tracks; tmp; tmp = tmp->next) {
+    ges_track_get_gaps_stats (tmp->data, &created, &reused);
+    g_print ("    %s track: %u gaps created, %u reused\n",
+        ges_track_type_name (GES_TRACK (tmp->data)->type), created, reused);
+  }
+  g_list_free_full (tracks, gst_object_unref);
+
+  gst_object_unref (timeline);
+  g_free (clips);
+}
+
 gint
 main (gint argc, gchar * argv[])
 {
@@ -36,6 +86,9 @@ main (gint argc, gchar * argv[])
 
   gst_init (&argc, &argv);
   ges_init ();
+
+  if (argc > 1)
+    num_objects = MAX (1, g_ascii_strtoull (argv[1], NULL, 10));
   asset = ges_asset_request (GES_TYPE_TEST_CLIP, NULL, NULL);
 
   layer = ges_layer_new ();
@@ -46,7 +99,7 @@ main (gint argc, gchar * argv[])
   container = GES_CONTAINER (ges_layer_add_asset (layer, asset, 0,
           0, 1000, GES_TRACK_TYPE_UNKNOWN));
 
-  for (i = 1; i < NUM_OBJECTS; i++)
+  for (i = 1; i < num_objects; i++)
     ges_layer_add_asset (layer, asset, i * 1000, 0,
         1000, GES_TRACK_TYPE_UNKNOWN);
   end = gst_util_get_timestamp ();
@@ -93,5 +146,7 @@ main (gint argc, gchar * argv[])
   g_print ("%" GST_TIME_FORMAT " - freeing the timeline\n",
       GST_TIME_ARGS (end - start));
 
+  benchmark_gaps (asset);
+
   return 0;
 }
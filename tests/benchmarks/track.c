@@ -0,0 +1,77 @@
+/* Gstreamer Editing Services
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#include <ges/ges.h>
+
+#define NUM_EDITS 1000
+
+static const guint track_sizes[] = { 100, 1000, 10000, 50000 };
+
+static void
+benchmark_track_size (guint size)
+{
+  guint i;
+  GESTrack *track;
+  GESTrackElement *element, *edited = NULL;
+  GstClockTime start, end, total = 0, max_edit_time = 0;
+
+  track = GES_TRACK (ges_video_track_new ());
+  gst_object_ref_sink (track);
+
+  for (i = 0; i < size; i++) {
+    element = GES_TRACK_ELEMENT (ges_video_test_source_new ());
+    g_object_set (element, "start", (guint64) i * 1000,
+        "duration", (guint64) 1000, NULL);
+    ges_track_add_element (track, element);
+
+    if (i == size / 2)
+      edited = element;
+  }
+
+  /* Each edit changes the 3 properties the track sorts its elements on */
+  for (i = 1; i <= NUM_EDITS; i++) {
+    start = gst_util_get_timestamp ();
+    g_object_set (edited, "start", (guint64) (size / 2) * 1000 + i,
+        "duration", (guint64) 1000 + i, "priority", i % 2, NULL);
+    end = gst_util_get_timestamp ();
+
+    total += end - start;
+    max_edit_time = MAX (max_edit_time, end - start);
+  }
+
+  g_print ("%6u elements: %" GST_TIME_FORMAT " - %d edits, mean: %"
+      G_GUINT64_FORMAT " ns max: %" GST_TIME_FORMAT "\n", size,
+      GST_TIME_ARGS (total), NUM_EDITS, total / NUM_EDITS,
+      GST_TIME_ARGS (max_edit_time));
+
+  gst_object_unref (track);
+}
+
+gint
+main (gint argc, gchar * argv[])
+{
+  guint i;
+
+  gst_init (&argc, &argv);
+  ges_init ();
+
+  for (i = 0; i < G_N_ELEMENTS (track_sizes); i++)
+    benchmark_track_size (track_sizes[i]);
+
+  return 0;
+}
@@ -396,6 +396,102 @@ GST_START_TEST (test_gap_filling_empty_track)
 
 GST_END_TEST;
 
+GST_START_TEST (test_gap_filling_reuse)
+{
+  GList *tmp;
+  GESTrack *track;
+  GESTimeline *timeline;
+  GstElement *composition;
+  GESLayer *layer;
+  GESClip *clip, *clip1, *clip2;
+  guint created, reused;
+
+  GstElement *gap = NULL, *gap1;
+
+  ges_init ();
+
+  track = GES_TRACK (ges_audio_track_new ());
+  composition = find_composition (track);
+  fail_unless (composition != NULL);
+
+  layer = ges_layer_new ();
+  timeline = ges_timeline_new ();
+  fail_unless (ges_timeline_add_layer (timeline, layer));
+  fail_unless (ges_timeline_add_track (timeline, track));
+
+  clip = GES_CLIP (ges_test_clip_new ());
+  g_object_set (clip, "start", (guint64) 0, "duration", (guint64) 5, NULL);
+  ges_layer_add_clip (layer, clip);
+
+  clip1 = GES_CLIP (ges_test_clip_new ());
+  g_object_set (clip1, "start", (guint64) 15, "duration", (guint64) 5, NULL);
+  ges_layer_add_clip (layer, clip1);
+  ges_timeline_commit (timeline);
+
+  ges_track_get_gaps_stats (track, &created, NULL);
+  assert_equals_int (created, 1);
+  assert_equals_int (g_list_length (GST_BIN_CHILDREN (composition)), 4);
+
+  for (tmp = GST_BIN_CHILDREN (composition); tmp; tmp = tmp->next) {
+    guint prio;
+
+    g_object_get (tmp->data, "priority", &prio, NULL);
+    if (prio == 1)
+      gap = tmp->data;
+  }
+  fail_unless (gap != NULL);
+  gap_object_check (gap, 5, 10, 1);
+
+  /* Moving the clip must only update the already existing gap */
+  ges_timeline_element_set_start (GES_TIMELINE_ELEMENT (clip1), 17);
+  ges_timeline_commit (timeline);
+  ges_track_get_gaps_stats (track, &created, &reused);
+  assert_equals_int (created, 1);
+  assert_equals_int (reused, 1);
+  assert_equals_int (g_list_length (GST_BIN_CHILDREN (composition)), 4);
+  fail_unless (g_list_find (GST_BIN_CHILDREN (composition), gap) != NULL);
+  gap_object_check (gap, 5, 12, 1);
+
+  /* Committing without any change does not create anything */
+  ges_timeline_commit (timeline);
+  ges_track_get_gaps_stats (track, &created, &reused);
+  assert_equals_int (created, 1);
+  assert_equals_int (reused, 2);
+
+  /* A new hole needs a new gap, the first one is kept untouched */
+  clip2 = GES_CLIP (ges_test_clip_new ());
+  g_object_set (clip2, "start", (guint64) 30, "duration", (guint64) 5, NULL);
+  ges_layer_add_clip (layer, clip2);
+  ges_timeline_commit (timeline);
+  ges_track_get_gaps_stats (track, &created, &reused);
+  assert_equals_int (created, 2);
+  assert_equals_int (reused, 3);
+  assert_equals_int (g_list_length (GST_BIN_CHILDREN (composition)), 6);
+  gap_object_check (gap, 5, 12, 1);
+
+  /* Filling the first hole moves the gap that became useless */
+  ges_timeline_element_set_start (GES_TIMELINE_ELEMENT (clip1), 5);
+  ges_timeline_commit (timeline);
+  ges_track_get_gaps_stats (track, &created, &reused);
+  assert_equals_int (created, 2);
+  assert_equals_int (g_list_length (GST_BIN_CHILDREN (composition)), 5);
+
+  gap1 = NULL;
+  for (tmp = GST_BIN_CHILDREN (composition); tmp; tmp = tmp->next) {
+    guint prio;
+
+    g_object_get (tmp->data, "priority", &prio, NULL);
+    if (prio == 1)
+      gap1 = tmp->data;
+  }
+  fail_unless (gap1 != NULL);
+  gap_object_check (gap1, 10, 20, 1);
+
+  gst_object_unref (timeline);
+}
+
+GST_END_TEST;
+
 static Suite *
 ges_suite (void)
 {
@@ -409,6 +505,7 @@ ges_suite (void)
   tcase_add_test (tc_chain, test_test_source_in_layer);
   tcase_add_test (tc_chain, test_gap_filling_basic);
   tcase_add_test (tc_chain, test_gap_filling_empty_track);
+  tcase_add_test (tc_chain, test_gap_filling_reuse);
 
   return s;
 }
@@ -23,6 +23,7 @@
 
 #include <ges/ges.h>
 #include <gst/check/gstcheck.h>
+#include <gst/controller/gstinterpolationcontrolsource.h>
 
 GST_START_TEST (test_ges_init)
 {
@@ -706,6 +707,277 @@ GST_START_TEST (test_ges_pipeline_change_state)
 
 GST_END_TEST;
 
+GST_START_TEST (test_ges_track_lazy_loading)
+{
+  GESLayer *layer;
+  GESTrack *track;
+  GESClip *clip1, *clip2;
+  GESTimeline *timeline;
+  GESTrackElement *element1, *element2;
+  GstElement *gnlobject;
+  guint64 start;
+
+  ges_init ();
+
+  timeline = ges_timeline_new ();
+  track = GES_TRACK (ges_video_track_new ());
+  ges_track_set_lazy_loading (track, TRUE);
+  fail_unless (ges_track_get_lazy_loading (track));
+  fail_unless (ges_timeline_add_track (timeline, track));
+  layer = ges_timeline_append_layer (timeline);
+
+  clip1 = GES_CLIP (ges_test_clip_new ());
+  clip2 = GES_CLIP (ges_test_clip_new ());
+  g_object_set (clip2, "start", 10 * GST_SECOND, NULL);
+  fail_unless (ges_layer_add_clip (layer, clip1));
+  fail_unless (ges_layer_add_clip (layer, clip2));
+
+  /* Only the timing is kept until the elements are needed */
+  element1 = GES_CONTAINER_CHILDREN (clip1)->data;
+  element2 = GES_CONTAINER_CHILDREN (clip2)->data;
+  fail_unless (ges_track_element_get_track (element1) == track);
+  fail_unless (ges_track_element_get_gnlobject (element1) == NULL);
+  fail_unless (ges_track_element_get_gnlobject (element2) == NULL);
+
+  ges_timeline_element_set_start (GES_TIMELINE_ELEMENT (clip1), 42);
+  fail_unless_equals_uint64 (_START (element1), 42);
+
+  /* Accessing the children properties loads the element */
+  ges_track_element_set_child_properties (element2, "pattern",
+      GES_VIDEO_TEST_PATTERN_RED, NULL);
+  fail_unless (ges_track_element_get_gnlobject (element2) != NULL);
+  fail_unless (ges_track_element_get_gnlobject (element1) == NULL);
+
+  /* Committing loads everything */
+  ges_timeline_commit (timeline);
+  gnlobject = ges_track_element_get_gnlobject (element1);
+  fail_unless (gnlobject != NULL);
+  g_object_get (gnlobject, "start", &start, NULL);
+  fail_unless_equals_uint64 (start, 42);
+  fail_unless (GST_OBJECT_PARENT (gnlobject) != NULL);
+  fail_unless (GST_OBJECT_PARENT (ges_track_element_get_gnlobject (element2)) ==
+      GST_OBJECT_PARENT (gnlobject));
+
+  /* Removing an element that has not been loaded */
+  clip1 = GES_CLIP (ges_test_clip_new ());
+  fail_unless (ges_layer_add_clip (layer, clip1));
+  fail_unless (ges_track_element_get_gnlobject
+      (GES_CONTAINER_CHILDREN (clip1)->data) == NULL);
+  fail_unless (ges_layer_remove_clip (layer, clip1));
+
+  gst_object_unref (timeline);
+}
+
+GST_END_TEST;
+
+#define IN_COMPOSITION(clip) \
+  (ges_track_element_get_gnlobject (GES_CONTAINER_CHILDREN (clip)->data) && \
+   GST_OBJECT_PARENT (ges_track_element_get_gnlobject ( \
+       GES_CONTAINER_CHILDREN (clip)->data)) != NULL)
+
+typedef struct
+{
+  GESTrack *track;
+  GstClockTime position;
+  GESClip *clip;
+  gboolean in_composition;
+  GMainLoop *mainloop;
+} SeekData;
+
+static gboolean
+quit_mainloop (GMainLoop * mainloop)
+{
+  g_main_loop_quit (mainloop);
+
+  return FALSE;
+}
+
+static gpointer
+send_seek (SeekData * data)
+{
+  GstPad *srcpad =
+      gst_element_get_static_pad (GST_ELEMENT (data->track), "src");
+
+  gst_pad_send_event (srcpad, gst_event_new_seek (1.0, GST_FORMAT_TIME,
+          GST_SEEK_FLAG_FLUSH, GST_SEEK_TYPE_SET, data->position,
+          GST_SEEK_TYPE_NONE, -1));
+  gst_object_unref (srcpad);
+
+  /* The window has to be there once the seek went through */
+  data->in_composition = IN_COMPOSITION (data->clip);
+  if (data->mainloop)
+    g_idle_add ((GSourceFunc) quit_mainloop, data->mainloop);
+
+  return NULL;
+}
+
+GST_START_TEST (test_ges_track_window)
+{
+  guint i;
+  SeekData data;
+  GThread *thread;
+  GESAsset *asset;
+  GESLayer *layer;
+  GESTrack *track;
+  GMainLoop *mainloop;
+  GESTimeline *timeline;
+  GESClip *clips[10];
+
+  ges_init ();
+
+  timeline = ges_timeline_new ();
+  track = GES_TRACK (ges_video_track_new ());
+  fail_unless (ges_timeline_add_track (timeline, track));
+  layer = ges_timeline_append_layer (timeline);
+
+  asset = ges_asset_request (GES_TYPE_TEST_CLIP, NULL, NULL);
+  for (i = 0; i < G_N_ELEMENTS (clips); i++)
+    clips[i] = ges_layer_add_asset (layer, asset, i * 5 * GST_SECOND, 0,
+        5 * GST_SECOND, GES_TRACK_TYPE_UNKNOWN);
+  gst_object_unref (asset);
+  ges_timeline_commit (timeline);
+  for (i = 0; i < G_N_ELEMENTS (clips); i++)
+    fail_unless (IN_COMPOSITION (clips[i]));
+
+  /* Only [0, 10s[ is kept */
+  ges_track_set_window_size (track, 10 * GST_SECOND);
+  fail_unless_equals_uint64 (ges_track_get_window_size (track),
+      10 * GST_SECOND);
+  ges_timeline_commit (timeline);
+  for (i = 0; i < G_N_ELEMENTS (clips); i++)
+    fail_unless (IN_COMPOSITION (clips[i]) == (i < 2), "clip %u", i);
+
+  /* [19.5s, 29.5s[ */
+  ges_track_set_window_position (track, 22 * GST_SECOND);
+  for (i = 0; i < G_N_ELEMENTS (clips); i++)
+    fail_unless (IN_COMPOSITION (clips[i]) == (i >= 3 && i <= 5),
+        "clip %u", i);
+
+  /* Elements moving in and out of the window */
+  ges_timeline_element_set_start (GES_TIMELINE_ELEMENT (clips[0]),
+      20 * GST_SECOND);
+  ges_timeline_element_set_start (GES_TIMELINE_ELEMENT (clips[4]),
+      60 * GST_SECOND);
+  ges_timeline_commit (timeline);
+  fail_unless (IN_COMPOSITION (clips[0]));
+  fail_if (IN_COMPOSITION (clips[4]));
+
+  /* Nothing runs the main context, the thread seeking moves the window
+   * itself: [0, 10s[ */
+  data.track = track;
+  data.position = 2 * GST_SECOND;
+  data.clip = clips[1];
+  data.mainloop = NULL;
+  thread = g_thread_new ("seeking", (GThreadFunc) send_seek, &data);
+  g_thread_join (thread);
+  fail_unless (data.in_composition);
+  fail_if (IN_COMPOSITION (clips[3]));
+
+  /* The main context is owned here, the seek waits for it to move the
+   * window: [19.5s, 29.5s[ */
+  mainloop = g_main_loop_new (NULL, FALSE);
+  fail_unless (g_main_context_acquire (NULL));
+  data.position = 22 * GST_SECOND;
+  data.clip = clips[3];
+  data.mainloop = mainloop;
+  thread = g_thread_new ("seeking", (GThreadFunc) send_seek, &data);
+  g_main_loop_run (mainloop);
+  g_thread_join (thread);
+  g_main_context_release (NULL);
+  g_main_loop_unref (mainloop);
+  fail_unless (data.in_composition);
+  fail_if (IN_COMPOSITION (clips[1]));
+
+  /* Everything is back */
+  ges_track_set_window_size (track, GST_CLOCK_TIME_NONE);
+  ges_timeline_commit (timeline);
+  for (i = 0; i < G_N_ELEMENTS (clips); i++)
+    fail_unless (IN_COMPOSITION (clips[i]), "clip %u", i);
+
+  gst_object_unref (timeline);
+}
+
+GST_END_TEST;
+
+static guint
+count_gnlobjects (GESTrack * track)
+{
+  guint n = 0;
+  GList *tmp, *elements = ges_track_get_elements (track);
+
+  for (tmp = elements; tmp; tmp = tmp->next) {
+    if (ges_track_element_get_gnlobject (tmp->data))
+      n++;
+  }
+  g_list_free_full (elements, gst_object_unref);
+
+  return n;
+}
+
+GST_START_TEST (test_ges_track_window_release)
+{
+  guint i;
+  gint posx;
+  GESAsset *asset;
+  GESLayer *layer;
+  GESTrack *track;
+  GESClip *clips[50];
+  GESTimeline *timeline;
+  GESTrackElement *source;
+  GstControlBinding *binding;
+  GstControlSource *control_source, *bound_source;
+
+  ges_init ();
+
+  timeline = ges_timeline_new ();
+  track = GES_TRACK (ges_video_track_new ());
+  fail_unless (ges_timeline_add_track (timeline, track));
+  layer = ges_timeline_append_layer (timeline);
+
+  asset = ges_asset_request (GES_TYPE_TEST_CLIP, NULL, NULL);
+  for (i = 0; i < G_N_ELEMENTS (clips); i++)
+    clips[i] = ges_layer_add_asset (layer, asset, i * GST_SECOND, 0,
+        GST_SECOND, GES_TRACK_TYPE_UNKNOWN);
+  gst_object_unref (asset);
+
+  /* What has to be there again once the element is created back */
+  source = GES_CONTAINER_CHILDREN (clips[0])->data;
+  ges_track_element_set_child_properties (source, "posx", 42, NULL);
+  control_source = gst_interpolation_control_source_new ();
+  gst_timed_value_control_source_set (GST_TIMED_VALUE_CONTROL_SOURCE
+      (control_source), 0, 0.5);
+  fail_unless (ges_track_element_set_control_source (source, control_source,
+          "alpha", "direct"));
+
+  /* 4 clips at most are in [position - 1s, position + 3s[ */
+  ges_track_set_window_size (track, 4 * GST_SECOND);
+  ges_timeline_commit (timeline);
+  fail_unless (count_gnlobjects (track) <= 4);
+
+  for (i = 0; i < G_N_ELEMENTS (clips); i++) {
+    ges_track_set_window_position (track, i * GST_SECOND);
+    fail_unless (count_gnlobjects (track) <= 4, "%u GnlObjects at %us",
+        count_gnlobjects (track), i);
+  }
+  fail_if (ges_track_element_get_gnlobject (source));
+  fail_if (ges_track_element_get_element (source));
+
+  ges_track_set_window_position (track, 0);
+  fail_unless (IN_COMPOSITION (clips[0]));
+  ges_track_element_get_child_properties (source, "posx", &posx, NULL);
+  assert_equals_int (posx, 42);
+  binding = ges_track_element_get_control_binding (source, "alpha");
+  fail_unless (binding != NULL);
+  g_object_get (binding, "control-source", &bound_source, NULL);
+  fail_unless (bound_source == control_source);
+  gst_object_unref (bound_source);
+
+  gst_object_unref (control_source);
+  gst_object_unref (timeline);
+}
+
+GST_END_TEST;
+
 static Suite *
 ges_suite (void)
 {
@@ -721,6 +993,9 @@ ges_suite (void)
   tcase_add_test (tc_chain, test_ges_timeline_remove_track);
   tcase_add_test (tc_chain, test_ges_timeline_multiple_tracks);
   tcase_add_test (tc_chain, test_ges_pipeline_change_state);
+  tcase_add_test (tc_chain, test_ges_track_lazy_loading);
+  tcase_add_test (tc_chain, test_ges_track_window);
+  tcase_add_test (tc_chain, test_ges_track_window_release);
 
   return s;
 }
@@ -18,6 +18,7 @@
  */
 
 #include "test-utils.h"
+#include "../../../ges/ges-parse-cache.h"
 #include <ges/ges.h>
 #include <gst/check/gstcheck.h>
 
@@ -38,6 +39,41 @@ GST_START_TEST (test_effect_basic)
 
 GST_END_TEST;
 
+GST_START_TEST (test_effect_copy)
+{
+  gchar *description;
+  GESEffect *effect, *copy;
+
+  ges_init ();
+
+  effect = ges_effect_new ("agingtv");
+  g_object_set (effect, "start", 5 * GST_SECOND, "in-point", GST_SECOND,
+      "duration", 2 * GST_SECOND, "priority", 3, NULL);
+  ges_track_element_set_active (GES_TRACK_ELEMENT (effect), FALSE);
+
+  copy = GES_EFFECT (ges_timeline_element_copy (GES_TIMELINE_ELEMENT (effect),
+          FALSE));
+  fail_unless (G_OBJECT_TYPE (copy) == GES_TYPE_EFFECT);
+  g_object_get (copy, "bin-description", &description, NULL);
+  fail_unless_equals_string (description, "agingtv");
+  fail_unless_equals_uint64 (_START (copy), 5 * GST_SECOND);
+  fail_unless_equals_uint64 (_INPOINT (copy), GST_SECOND);
+  fail_unless_equals_uint64 (_DURATION (copy), 2 * GST_SECOND);
+  fail_unless_equals_int (_PRIORITY (copy), 3);
+  fail_unless_equals_int (ges_track_element_get_track_type
+      (GES_TRACK_ELEMENT (copy)), ges_track_element_get_track_type
+      (GES_TRACK_ELEMENT (effect)));
+  fail_if (ges_track_element_is_active (GES_TRACK_ELEMENT (copy)));
+  fail_unless (ges_extractable_get_asset (GES_EXTRACTABLE (copy)) ==
+      ges_extractable_get_asset (GES_EXTRACTABLE (effect)));
+
+  g_free (description);
+  gst_object_unref (copy);
+  gst_object_unref (effect);
+}
+
+GST_END_TEST;
+
 GST_START_TEST (test_add_effect_to_clip)
 {
   GESTimeline *timeline;
@@ -394,6 +430,15 @@ GST_START_TEST (test_effect_set_properties)
   fail_unless (scratch_line == 17);
   fail_unless (color_aging == FALSE);
 
+  fail_unless (ges_track_element_lookup_child (effect,
+          "GstAgingTV::scratch-lines", NULL, &spec));
+  fail_unless_equals_string (spec->name, "scratch-lines");
+  g_param_spec_unref (spec);
+  fail_if (ges_track_element_lookup_child (effect,
+          "GstVideoBalance::scratch-lines", NULL, &spec));
+  fail_if (ges_track_element_lookup_child (effect,
+          "not-a-property-name-anywhere", NULL, &spec));
+
   pspecs = ges_track_element_list_children_properties (effect, &n_props);
   fail_unless (n_props == 7);
 
@@ -423,6 +468,70 @@ GST_START_TEST (test_effect_set_properties)
 
 GST_END_TEST;
 
+GST_START_TEST (test_effect_same_child_property)
+{
+  GESTimeline *timeline;
+  GESLayer *layer;
+  GESTrack *track_video;
+  GESEffectClip *effect_clip;
+  GESTrackElement *effect;
+  GstElement *element, *qualified_element;
+  GParamSpec *spec;
+  guint scratch_line;
+  GValue val = { 0 };
+
+  ges_init ();
+
+  timeline = ges_timeline_new ();
+  layer = (GESLayer *) ges_simple_layer_new ();
+  track_video = GES_TRACK (ges_video_track_new ());
+
+  ges_timeline_add_track (timeline, track_video);
+  ges_timeline_add_layer (timeline, layer);
+
+  effect_clip = ges_effect_clip_new ("agingtv", NULL);
+  g_object_set (effect_clip, "duration", 25 * GST_SECOND, NULL);
+  ges_simple_layer_add_object ((GESSimpleLayer *) (layer),
+      (GESClip *) effect_clip, 0);
+
+  /* Both children expose the very same properties */
+  effect = GES_TRACK_ELEMENT (ges_effect_new ("agingtv ! agingtv"));
+  fail_unless (ges_container_add (GES_CONTAINER (effect_clip),
+          GES_TIMELINE_ELEMENT (effect)));
+
+  fail_unless (ges_track_element_lookup_child (effect, "scratch-lines",
+          &element, &spec));
+  g_param_spec_unref (spec);
+  fail_unless (ges_track_element_lookup_child (effect,
+          "GstAgingTV::scratch-lines", &qualified_element, &spec));
+  fail_unless (element == qualified_element);
+  gst_object_unref (qualified_element);
+
+  /* Setting by name and by pspec must end up on the same child */
+  g_value_init (&val, G_TYPE_UINT);
+  g_value_set_uint (&val, 13);
+  ges_track_element_set_child_property_by_pspec (effect, spec, &val);
+  g_object_get (element, "scratch-lines", &scratch_line, NULL);
+  assert_equals_int (scratch_line, 13);
+
+  ges_track_element_set_child_properties (effect, "scratch-lines", 11, NULL);
+  g_value_reset (&val);
+  ges_track_element_get_child_property_by_pspec (effect, spec, &val);
+  assert_equals_int (g_value_get_uint (&val), 11);
+  g_object_get (element, "scratch-lines", &scratch_line, NULL);
+  assert_equals_int (scratch_line, 11);
+
+  g_value_unset (&val);
+  g_param_spec_unref (spec);
+  gst_object_unref (element);
+
+  ges_layer_remove_clip (layer, (GESClip *) effect_clip);
+
+  gst_object_unref (timeline);
+}
+
+GST_END_TEST;
+
 static void
 effect_added_cb (GESClip * clip, GESBaseEffect * trop, gboolean * effect_added)
 {
@@ -496,6 +605,70 @@ GST_START_TEST (test_clip_signals)
 }
 
 GST_END_TEST;
+
+GST_START_TEST (test_parse_cache)
+{
+  guint hits, misses, scratch_lines;
+  GstElement *bin, *bin2, *effect;
+  GstPad *pad;
+  const gchar *description =
+      "videoconvert ! agingtv name=aging scratch-lines=3 ! videoconvert";
+
+  ges_init ();
+  ges_parse_cache_clear ();
+
+  bin = ges_parse_cache_get_bin (description, NULL);
+  fail_unless (GST_IS_BIN (bin));
+  bin2 = ges_parse_cache_get_bin (description, NULL);
+  fail_unless (GST_IS_BIN (bin2));
+  fail_unless (bin != bin2);
+
+  ges_parse_cache_get_stats (&hits, &misses);
+  assert_equals_int (hits, 1);
+  assert_equals_int (misses, 1);
+
+  /* The bin built from the cache is the same as the parsed one */
+  assert_equals_int (g_list_length (GST_BIN_CHILDREN (bin2)), 3);
+  effect = gst_bin_get_by_name (GST_BIN (bin2), "aging");
+  fail_unless (effect != NULL);
+  g_object_get (effect, "scratch-lines", &scratch_lines, NULL);
+  assert_equals_int (scratch_lines, 3);
+  pad = gst_element_get_static_pad (effect, "sink");
+  fail_unless (gst_pad_is_linked (pad));
+  gst_object_unref (pad);
+  pad = gst_element_get_static_pad (effect, "src");
+  fail_unless (gst_pad_is_linked (pad));
+  gst_object_unref (pad);
+  gst_object_unref (effect);
+
+  pad = gst_element_get_static_pad (bin2, "sink");
+  fail_unless (GST_IS_GHOST_PAD (pad));
+  gst_object_unref (pad);
+  pad = gst_element_get_static_pad (bin2, "src");
+  fail_unless (GST_IS_GHOST_PAD (pad));
+  gst_object_unref (pad);
+
+  gst_object_unref (bin);
+  gst_object_unref (bin2);
+
+  /* Elements with sometimes pads can not be reproduced, they are parsed
+   * each time */
+  bin = ges_parse_cache_get_bin ("decodebin", NULL);
+  fail_unless (GST_IS_BIN (bin));
+  gst_object_unref (bin);
+  bin = ges_parse_cache_get_bin ("decodebin", NULL);
+  fail_unless (GST_IS_BIN (bin));
+  gst_object_unref (bin);
+
+  ges_parse_cache_get_stats (&hits, &misses);
+  assert_equals_int (hits, 1);
+  assert_equals_int (misses, 3);
+
+  ges_parse_cache_clear ();
+}
+
+GST_END_TEST;
+
 static Suite *
 ges_suite (void)
 {
@@ -505,12 +678,15 @@ ges_suite (void)
   suite_add_tcase (s, tc_chain);
 
   tcase_add_test (tc_chain, test_effect_basic);
+  tcase_add_test (tc_chain, test_effect_copy);
   tcase_add_test (tc_chain, test_add_effect_to_clip);
   tcase_add_test (tc_chain, test_get_effects_from_tl);
   tcase_add_test (tc_chain, test_effect_clip);
   tcase_add_test (tc_chain, test_priorities_clip);
   tcase_add_test (tc_chain, test_effect_set_properties);
+  tcase_add_test (tc_chain, test_effect_same_child_property);
   tcase_add_test (tc_chain, test_clip_signals);
+  tcase_add_test (tc_chain, test_parse_cache);
 
   return s;
 }
@@ -988,6 +988,254 @@ GST_END_TEST;
   ADD_RENDERING_TESTS(name)
 
 
+typedef struct
+{
+  /* The average luma of each video frame */
+  GArray *frame_lumas;
+  GstClockTime next_frame_pts;
+  gboolean video_continuous;
+
+  guint64 n_audio_samples;
+  gint rate;
+  gboolean audio_continuous;
+} DecodedFile;
+
+static GstPadProbeReturn
+video_frame_cb (GstPad * pad, GstPadProbeInfo * info, DecodedFile * decoded)
+{
+  gsize i;
+  guint64 sum = 0;
+  GstMapInfo map;
+  GstBuffer *buffer = GST_PAD_PROBE_INFO_BUFFER (info);
+  gdouble luma;
+
+  /* Each frame starts where the previous one ended */
+  if (GST_CLOCK_TIME_IS_VALID (decoded->next_frame_pts) &&
+      (GST_BUFFER_PTS (buffer) + GST_MSECOND < decoded->next_frame_pts ||
+          GST_BUFFER_PTS (buffer) > decoded->next_frame_pts + GST_MSECOND))
+    decoded->video_continuous = FALSE;
+  decoded->next_frame_pts = GST_BUFFER_PTS (buffer) +
+      GST_BUFFER_DURATION (buffer);
+
+  gst_buffer_map (buffer, &map, GST_MAP_READ);
+  for (i = 0; i < map.size; i++)
+    sum += map.data[i];
+  gst_buffer_unmap (buffer, &map);
+
+  luma = (gdouble) sum / map.size;
+  g_array_append_val (decoded->frame_lumas, luma);
+
+  return GST_PAD_PROBE_OK;
+}
+
+static GstPadProbeReturn
+audio_samples_cb (GstPad * pad, GstPadProbeInfo * info, DecodedFile * decoded)
+{
+  GstBuffer *buffer = GST_PAD_PROBE_INFO_BUFFER (info);
+  GstClockTime expected;
+
+  if (decoded->rate == 0) {
+    GstCaps *caps = gst_pad_get_current_caps (pad);
+
+    gst_structure_get_int (gst_caps_get_structure (caps, 0), "rate",
+        &decoded->rate);
+    gst_caps_unref (caps);
+  }
+
+  /* No sample is missing nor repeated, to the sample */
+  expected = gst_util_uint64_scale_round (decoded->n_audio_samples,
+      GST_SECOND, decoded->rate);
+  if (decoded->n_audio_samples && (GST_BUFFER_PTS (buffer) + GST_SECOND /
+          decoded->rate < expected ||
+          GST_BUFFER_PTS (buffer) > expected + GST_SECOND / decoded->rate))
+    decoded->audio_continuous = FALSE;
+  decoded->n_audio_samples += gst_buffer_get_size (buffer) / 2;
+
+  return GST_PAD_PROBE_OK;
+}
+
+static void
+add_buffer_probe (GstElement * pipeline, const gchar * sink_name,
+    GstPadProbeCallback callback, DecodedFile * decoded)
+{
+  GstPad *sinkpad;
+  GstElement *sink = gst_bin_get_by_name (GST_BIN (pipeline), sink_name);
+
+  sinkpad = gst_element_get_static_pad (sink, "sink");
+  gst_pad_add_probe (sinkpad, GST_PAD_PROBE_TYPE_BUFFER, callback, decoded,
+      NULL);
+  gst_object_unref (sinkpad);
+  gst_object_unref (sink);
+}
+
+/* Plays @uri to the end, gathering what its audio and video look like */
+static void
+decode_file (const gchar * uri, DecodedFile * decoded)
+{
+  GstBus *bus;
+  GstMessage *message;
+  GstElement *decoder;
+  GError *error = NULL;
+  GstElement *player =
+      gst_parse_launch ("uridecodebin name=decoder "
+      "decoder. ! video/x-raw ! queue ! videoconvert ! "
+      "video/x-raw,format=GRAY8 ! fakesink name=vsink "
+      "decoder. ! audio/x-raw ! queue ! audioconvert ! "
+      "audio/x-raw,format=S16LE,channels=1 ! fakesink name=asink", &error);
+
+  g_assert_no_error (error);
+  decoder = gst_bin_get_by_name (GST_BIN (player), "decoder");
+  g_object_set (decoder, "uri", uri, NULL);
+  gst_object_unref (decoder);
+
+  decoded->frame_lumas = g_array_new (FALSE, FALSE, sizeof (gdouble));
+  decoded->next_frame_pts = GST_CLOCK_TIME_NONE;
+  decoded->video_continuous = decoded->audio_continuous = TRUE;
+  decoded->n_audio_samples = 0;
+  decoded->rate = 0;
+  add_buffer_probe (player, "vsink", (GstPadProbeCallback) video_frame_cb,
+      decoded);
+  add_buffer_probe (player, "asink", (GstPadProbeCallback) audio_samples_cb,
+      decoded);
+
+  bus = gst_pipeline_get_bus (GST_PIPELINE (player));
+  gst_element_set_state (player, GST_STATE_PLAYING);
+  message = gst_bus_timed_pop_filtered (bus, GST_CLOCK_TIME_NONE,
+      GST_MESSAGE_EOS | GST_MESSAGE_ERROR);
+  fail_unless_equals_int (GST_MESSAGE_TYPE (message), GST_MESSAGE_EOS);
+  gst_message_unref (message);
+  gst_object_unref (bus);
+
+  gst_element_set_state (player, GST_STATE_NULL);
+  gst_object_unref (player);
+}
+
+static void
+render_parallel_done_cb (GESTimeline * timeline, GAsyncResult * result,
+    gboolean * rendered)
+{
+  GError *error = NULL;
+
+  *rendered = ges_timeline_render_parallel_finish (timeline, result, &error);
+  g_assert_no_error (error);
+  g_main_loop_quit (loop);
+}
+
+GST_START_TEST (test_parallel_render)
+{
+  guint i;
+  GstBus *bus;
+  GESTrack *track;
+  GESLayer *layer;
+  GESAsset *asset;
+  GESClip *clip;
+  GstMessage *message;
+  GstCaps *caps, *format;
+  GESTimeline *timeline;
+  GstEncodingContainerProfile *profile;
+  DecodedFile single, parallel;
+  gboolean rendered = FALSE;
+  gchar *single_uri = ges_test_file_name ("assets/parallel.single.ogv");
+  gchar *parallel_uri = ges_test_file_name ("assets/parallel.rendered.ogv");
+
+  caps = gst_caps_from_string ("video/x-raw,width=320,height=240,"
+      "framerate=25/1");
+  format = gst_caps_from_string ("application/ogg");
+  profile = gst_encoding_container_profile_new ("ogg", NULL, format, NULL);
+  gst_caps_unref (format);
+  format = gst_caps_from_string ("video/x-theora");
+  gst_encoding_container_profile_add_profile (profile, (GstEncodingProfile *)
+      gst_encoding_video_profile_new (format, NULL, caps, 0));
+  gst_caps_unref (format);
+  format = gst_caps_from_string ("audio/x-vorbis");
+  gst_encoding_container_profile_add_profile (profile, (GstEncodingProfile *)
+      gst_encoding_audio_profile_new (format, NULL, NULL, 0));
+  gst_caps_unref (format);
+
+  timeline = ges_timeline_new ();
+  track = GES_TRACK (ges_video_track_new ());
+  ges_track_set_restriction_caps (track, caps);
+  ges_timeline_add_track (timeline, track);
+  ges_timeline_add_track (timeline, GES_TRACK (ges_audio_track_new ()));
+  layer = ges_timeline_append_layer (timeline);
+
+  /**
+   * Our timeline, cut into 3 segments at 1.2 and 2.4, where what is
+   * rendered changes, so that any frame off at the boundaries shows
+   *
+   *  time     0------------1.2-----------2.4--2.5-------3.6
+   *           |    smpte    |    snow     | gap |  smpte   |
+   *           |    sine     |    sine     |     |  sine    |
+   */
+  asset = ges_asset_request (GES_TYPE_TEST_CLIP, NULL, NULL);
+  ges_layer_add_asset (layer, asset, 0, 0, 1.2 * GST_SECOND,
+      GES_TRACK_TYPE_UNKNOWN);
+  clip = ges_layer_add_asset (layer, asset, 1.2 * GST_SECOND, 0,
+      1.2 * GST_SECOND, GES_TRACK_TYPE_UNKNOWN);
+  g_object_set (clip, "vpattern", GES_VIDEO_TEST_PATTERN_SNOW, NULL);
+  ges_layer_add_asset (layer, asset, 2.5 * GST_SECOND, 0, 1.1 * GST_SECOND,
+      GES_TRACK_TYPE_UNKNOWN);
+  gst_object_unref (asset);
+  ges_timeline_commit (timeline);
+
+  /* Render it in a single pipeline as a reference */
+  pipeline = ges_pipeline_new ();
+  fail_unless (ges_pipeline_add_timeline (pipeline, gst_object_ref (timeline)));
+  fail_unless (ges_pipeline_set_render_settings (pipeline, single_uri,
+          (GstEncodingProfile *) profile));
+  fail_unless (ges_pipeline_set_mode (pipeline, TIMELINE_MODE_RENDER));
+  bus = gst_pipeline_get_bus (GST_PIPELINE (pipeline));
+  gst_element_set_state (GST_ELEMENT (pipeline), GST_STATE_PLAYING);
+  message = gst_bus_timed_pop_filtered (bus, GST_CLOCK_TIME_NONE,
+      GST_MESSAGE_EOS | GST_MESSAGE_ERROR);
+  fail_unless_equals_int (GST_MESSAGE_TYPE (message), GST_MESSAGE_EOS);
+  gst_message_unref (message);
+  gst_object_unref (bus);
+  gst_element_set_state (GST_ELEMENT (pipeline), GST_STATE_NULL);
+  gst_object_unref (pipeline);
+  pipeline = NULL;
+
+  ges_timeline_render_parallel_async (timeline, parallel_uri,
+      (GstEncodingProfile *) profile, 3, NULL,
+      (GAsyncReadyCallback) render_parallel_done_cb, &rendered);
+  g_main_loop_run (loop);
+  fail_unless (rendered);
+
+  decode_file (single_uri, &single);
+  decode_file (parallel_uri, &parallel);
+
+  /* Every frame is there once, and shows the same thing as in the
+   * reference, up to the encoding losses */
+  assert_equals_int (single.frame_lumas->len, 90);
+  assert_equals_int (parallel.frame_lumas->len, 90);
+  fail_unless (parallel.video_continuous);
+  for (i = 0; i < parallel.frame_lumas->len; i++) {
+    gdouble expected = g_array_index (single.frame_lumas, gdouble, i);
+    gdouble luma = g_array_index (parallel.frame_lumas, gdouble, i);
+
+    fail_unless (ABS (luma - expected) < 8, "Frame %u has a luma of %f "
+        "instead of %f", i, luma, expected);
+  }
+
+  /* And the audio is exactly the same length without any hole */
+  fail_unless (single.n_audio_samples > 0);
+  fail_unless (parallel.audio_continuous);
+  assert_equals_uint64 (parallel.n_audio_samples, single.n_audio_samples);
+
+  check_rendered_file_properties ("assets/parallel.rendered.ogv",
+      ges_timeline_get_duration (timeline));
+
+  g_array_free (single.frame_lumas, TRUE);
+  g_array_free (parallel.frame_lumas, TRUE);
+  gst_object_unref (timeline);
+  gst_encoding_profile_unref (profile);
+  gst_caps_unref (caps);
+  g_free (single_uri);
+  g_free (parallel_uri);
+}
+
+GST_END_TEST;
+
 /* *INDENT-OFF* */
 CREATE_TEST_FULL(basic)
 CREATE_TEST_FULL(basic_audio)
@@ -1042,6 +1290,10 @@ ges_suite (void)
   ADD_PLAYBACK_TESTS (seeking_paused_audio_noplay);
   ADD_PLAYBACK_TESTS (seeking_paused_video_noplay);
 
+  tcase_add_test (tc_chain, test_parallel_render);
+  tests_names = g_list_prepend (tests_names,
+      g_strdup ("test_parallel_render"));
+
   /* TODO : next test case : complex timeline created from project. */
   /* TODO : deep checking of rendered clips */
   /* TODO : might be interesting to try all profiles, and maintain a list of currently working profiles ? */
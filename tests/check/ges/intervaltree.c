@@ -0,0 +1,240 @@
+/* GStreamer Editing Services
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#include "../../../ges/ges-interval-tree.h"
+#include <gst/check/gstcheck.h>
+
+#define N_INTERVALS 500
+
+typedef struct
+{
+  GESIntervalNode node;
+  GstClockTime start;
+  GstClockTime end;
+  gboolean inserted;
+} Interval;
+
+static void
+_append_cb (Interval * interval, GPtrArray * found)
+{
+  g_ptr_array_add (found, interval);
+}
+
+static GPtrArray *
+_list_overlapping (GESIntervalTree * tree, GstClockTime start,
+    GstClockTime end)
+{
+  GPtrArray *found = g_ptr_array_new ();
+
+  ges_interval_tree_foreach_overlapping (tree, start, end,
+      (GFunc) _append_cb, found);
+
+  return found;
+}
+
+static void
+_check_sorted (GPtrArray * found)
+{
+  guint i;
+
+  for (i = 1; i < found->len; i++)
+    fail_unless (((Interval *) g_ptr_array_index (found, i - 1))->start <=
+        ((Interval *) g_ptr_array_index (found, i))->start);
+}
+
+/* Compares the result of the tree with going through all the intervals */
+static void
+_check_overlapping (GESIntervalTree * tree, Interval * intervals,
+    GstClockTime start, GstClockTime end)
+{
+  guint i, n_expected = 0;
+  GPtrArray *found = _list_overlapping (tree, start, end);
+
+  _check_sorted (found);
+  for (i = 0; i < N_INTERVALS; i++) {
+    gboolean overlaps = intervals[i].inserted && intervals[i].start < end &&
+        intervals[i].end > start;
+    gboolean reported = FALSE;
+    guint j;
+
+    for (j = 0; j < found->len && !reported; j++)
+      reported = g_ptr_array_index (found, j) == &intervals[i];
+
+    fail_unless (overlaps == reported, "Interval [%" G_GUINT64_FORMAT ", %"
+        G_GUINT64_FORMAT ") %s reported overlapping [%" G_GUINT64_FORMAT
+        ", %" G_GUINT64_FORMAT ")", intervals[i].start, intervals[i].end,
+        reported ? "wrongly" : "not", start, end);
+    if (overlaps)
+      n_expected++;
+  }
+  assert_equals_int (found->len, n_expected);
+
+  g_ptr_array_free (found, TRUE);
+}
+
+GST_START_TEST (test_interval_tree_basic)
+{
+  GPtrArray *found;
+  Interval a = { {0}, 0, 10 }, b = { {0}, 5, 15 }, c = { {0}, 20, 30 };
+  GESIntervalTree *tree = ges_interval_tree_new ();
+
+  assert_equals_int (ges_interval_tree_get_size (tree), 0);
+  found = _list_overlapping (tree, 0, 100);
+  assert_equals_int (found->len, 0);
+  g_ptr_array_free (found, TRUE);
+
+  ges_interval_tree_insert (tree, &c.node, c.start, c.end, &c);
+  ges_interval_tree_insert (tree, &a.node, a.start, a.end, &a);
+  ges_interval_tree_insert (tree, &b.node, b.start, b.end, &b);
+  assert_equals_int (ges_interval_tree_get_size (tree), 3);
+  fail_unless (a.node.tree == tree);
+
+  /* Everything, sorted by start */
+  found = g_ptr_array_new ();
+  ges_interval_tree_foreach (tree, (GFunc) _append_cb, found);
+  assert_equals_int (found->len, 3);
+  fail_unless (g_ptr_array_index (found, 0) == &a);
+  fail_unless (g_ptr_array_index (found, 1) == &b);
+  fail_unless (g_ptr_array_index (found, 2) == &c);
+  g_ptr_array_free (found, TRUE);
+
+  /* The intervals are half open */
+  found = _list_overlapping (tree, 10, 20);
+  assert_equals_int (found->len, 1);
+  fail_unless (g_ptr_array_index (found, 0) == &b);
+  g_ptr_array_free (found, TRUE);
+
+  found = _list_overlapping (tree, 15, 20);
+  assert_equals_int (found->len, 0);
+  g_ptr_array_free (found, TRUE);
+
+  found = _list_overlapping (tree, 9, 21);
+  assert_equals_int (found->len, 3);
+  g_ptr_array_free (found, TRUE);
+
+  /* Removing */
+  ges_interval_tree_remove (&b.node);
+  assert_equals_int (ges_interval_tree_get_size (tree), 2);
+  fail_unless (b.node.tree == NULL);
+  found = _list_overlapping (tree, 10, 20);
+  assert_equals_int (found->len, 0);
+  g_ptr_array_free (found, TRUE);
+
+  /* Removing a node that is not in a tree does nothing */
+  ges_interval_tree_remove (&b.node);
+  assert_equals_int (ges_interval_tree_get_size (tree), 2);
+
+  /* Moving */
+  ges_interval_tree_update (&c.node, 12, 18);
+  assert_equals_int (ges_interval_tree_get_size (tree), 2);
+  found = _list_overlapping (tree, 10, 20);
+  assert_equals_int (found->len, 1);
+  fail_unless (g_ptr_array_index (found, 0) == &c);
+  g_ptr_array_free (found, TRUE);
+  found = _list_overlapping (tree, 20, 30);
+  assert_equals_int (found->len, 0);
+  g_ptr_array_free (found, TRUE);
+
+  /* The nodes still in the tree are detached when freeing it */
+  ges_interval_tree_free (tree);
+  fail_unless (a.node.tree == NULL);
+  fail_unless (c.node.tree == NULL);
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_interval_tree_random)
+{
+  guint i, j;
+  GstClockTime start;
+  GRand *rand = g_rand_new_with_seed (42);
+  Interval *intervals = g_new0 (Interval, N_INTERVALS);
+  GESIntervalTree *tree = ges_interval_tree_new ();
+
+  /* Same starts and empty intervals included */
+  for (i = 0; i < N_INTERVALS; i++) {
+    intervals[i].start = g_rand_int_range (rand, 0, 1000);
+    intervals[i].end = intervals[i].start + g_rand_int_range (rand, 0, 100);
+    intervals[i].inserted = TRUE;
+    ges_interval_tree_insert (tree, &intervals[i].node, intervals[i].start,
+        intervals[i].end, &intervals[i]);
+  }
+  assert_equals_int (ges_interval_tree_get_size (tree), N_INTERVALS);
+
+  for (i = 0; i < 50; i++) {
+    start = g_rand_int_range (rand, 0, 1100);
+    _check_overlapping (tree, intervals, start,
+        start + g_rand_int_range (rand, 1, 200));
+  }
+
+  /* Remove half of them, and move some others */
+  for (i = 0; i < N_INTERVALS; i += 2) {
+    ges_interval_tree_remove (&intervals[i].node);
+    intervals[i].inserted = FALSE;
+  }
+  assert_equals_int (ges_interval_tree_get_size (tree), N_INTERVALS / 2);
+
+  for (i = 1; i < N_INTERVALS; i += 4) {
+    intervals[i].start = g_rand_int_range (rand, 0, 1000);
+    intervals[i].end = intervals[i].start + g_rand_int_range (rand, 0, 100);
+    ges_interval_tree_update (&intervals[i].node, intervals[i].start,
+        intervals[i].end);
+  }
+  assert_equals_int (ges_interval_tree_get_size (tree), N_INTERVALS / 2);
+
+  for (i = 0; i < 50; i++) {
+    start = g_rand_int_range (rand, 0, 1100);
+    _check_overlapping (tree, intervals, start,
+        start + g_rand_int_range (rand, 1, 200));
+  }
+  _check_overlapping (tree, intervals, 0, GST_CLOCK_TIME_NONE);
+
+  /* Empty it */
+  for (i = 0, j = 0; i < N_INTERVALS; i++) {
+    if (intervals[i].inserted) {
+      ges_interval_tree_remove (&intervals[i].node);
+      intervals[i].inserted = FALSE;
+      j++;
+    }
+  }
+  assert_equals_int (j, N_INTERVALS / 2);
+  assert_equals_int (ges_interval_tree_get_size (tree), 0);
+  _check_overlapping (tree, intervals, 0, GST_CLOCK_TIME_NONE);
+
+  ges_interval_tree_free (tree);
+  g_free (intervals);
+  g_rand_free (rand);
+}
+
+GST_END_TEST;
+
+static Suite *
+ges_suite (void)
+{
+  Suite *s = suite_create ("ges-interval-tree");
+  TCase *tc_chain = tcase_create ("intervaltree");
+
+  suite_add_tcase (s, tc_chain);
+
+  tcase_add_test (tc_chain, test_interval_tree_basic);
+  tcase_add_test (tc_chain, test_interval_tree_random);
+
+  return s;
+}
+
+GST_CHECK_MAIN (ges);
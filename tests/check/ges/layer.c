@@ -325,6 +325,75 @@ GST_START_TEST (test_timeline_auto_transition)
 
 GST_END_TEST;
 
+GST_START_TEST (test_batched_automatic_transition)
+{
+  GESAsset *asset;
+  GESTimeline *timeline;
+  GList *objects;
+  GESLayer *layer;
+  GESTimelineElement *src, *src1;
+
+  ges_init ();
+
+  asset = ges_asset_request (GES_TYPE_TEST_CLIP, NULL, NULL);
+  fail_unless (GES_IS_ASSET (asset));
+
+  timeline = ges_timeline_new_audio_video ();
+  layer = ges_layer_new ();
+  fail_unless (ges_timeline_add_layer (timeline, layer));
+  ges_layer_set_auto_transition (layer, TRUE);
+
+  GST_DEBUG ("Adding overlapping clips inside an edit transaction");
+  ges_timeline_begin_edit (timeline);
+  src = GES_TIMELINE_ELEMENT (ges_layer_add_asset (layer, asset, 0, 0,
+          1000, GES_TRACK_TYPE_UNKNOWN));
+  fail_unless (GES_IS_CLIP (src));
+
+  /* Transactions nest */
+  ges_timeline_begin_edit (timeline);
+  src1 = GES_TIMELINE_ELEMENT (ges_layer_add_asset (layer, asset, 1000,
+          0, 1000, GES_TRACK_TYPE_UNKNOWN));
+  fail_unless (GES_IS_CLIP (src1));
+  ges_timeline_element_set_start (src1, 500);
+  ges_timeline_end_edit (timeline);
+
+  /*
+   *        500__transition__1000
+   * 0___________src_________1000
+   *        500___________src1_________1500
+   */
+  assert_equals_uint64 (_START (src1), 500);
+
+  GST_DEBUG ("Checking that nothing has been updated yet");
+  objects = ges_layer_get_clips (layer);
+  assert_equals_int (g_list_length (objects), 2);
+  g_list_free_full (objects, gst_object_unref);
+  assert_equals_uint64 (ges_timeline_get_duration (timeline), 0);
+
+  ges_timeline_end_edit (timeline);
+
+  GST_DEBUG ("Checking that the transition has been added");
+  objects = ges_layer_get_clips (layer);
+  assert_equals_int (g_list_length (objects), 4);
+  assert_is_type (objects->next->data, GES_TYPE_TRANSITION_CLIP);
+  assert_equals_uint64 (_START (objects->next->data), 500);
+  assert_equals_uint64 (_DURATION (objects->next->data), 500);
+  assert_is_type (objects->next->next->data, GES_TYPE_TRANSITION_CLIP);
+  g_list_free_full (objects, gst_object_unref);
+  assert_equals_uint64 (ges_timeline_get_duration (timeline), 1500);
+
+  GST_DEBUG ("Moving the clip away outside of a transaction");
+  ges_timeline_element_set_start (src1, 1000);
+  objects = ges_layer_get_clips (layer);
+  assert_equals_int (g_list_length (objects), 2);
+  g_list_free_full (objects, gst_object_unref);
+  assert_equals_uint64 (ges_timeline_get_duration (timeline), 2000);
+
+  gst_object_unref (timeline);
+}
+
+GST_END_TEST;
+
 GST_START_TEST (test_single_layer_automatic_transition)
 {
   GESAsset *asset;
@@ -1789,6 +1858,7 @@ ges_suite (void)
   tcase_add_test (tc_chain, test_layer_priorities);
   tcase_add_test (tc_chain, test_timeline_auto_transition);
   tcase_add_test (tc_chain, test_single_layer_automatic_transition);
+  tcase_add_test (tc_chain, test_batched_automatic_transition);
   tcase_add_test (tc_chain, test_multi_layer_automatic_transition);
   tcase_add_test (tc_chain, test_layer_activate_automatic_transition);
   tcase_add_test (tc_chain, test_layer_meta_string);
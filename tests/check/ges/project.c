@@ -19,8 +19,10 @@
  */
 
 #include "test-utils.h"
+#include "../../../ges/ges-internal.h"
 #include <ges/ges.h>
 #include <gst/check/gstcheck.h>
+#include <glib/gstdio.h>
 #include <gst/controller/gstdirectcontrolbinding.h>
 #include <gst/controller/gstinterpolationcontrolsource.h>
 
@@ -530,6 +532,68 @@ GST_START_TEST (test_project_load_xges)
 
 GST_END_TEST;
 
+GST_START_TEST (test_project_binary_formatter)
+{
+  gsize len;
+  gboolean saved;
+  GMainLoop *mainloop;
+  GESProject *project;
+  GESTimeline *timeline;
+  GESAsset *formatter_asset;
+  gchar *location, *contents;
+  gchar *uri = ges_test_file_uri ("test-project.xges");
+
+  project = ges_project_new (uri);
+  mainloop = g_main_loop_new (NULL, FALSE);
+
+  g_signal_connect (project, "loaded", (GCallback) project_loaded_cb, mainloop);
+  g_signal_connect (project, "missing-uri", (GCallback) _set_new_uri, NULL);
+
+  timeline = GES_TIMELINE (ges_asset_extract (GES_ASSET (project), NULL));
+  g_main_loop_run (mainloop);
+  _test_project (project, timeline);
+  _add_keyframes (timeline);
+  g_free (uri);
+
+  uri = get_tmp_uri ("test-project_TMP.gesb");
+  formatter_asset = ges_asset_request (GES_TYPE_FORMATTER, "gesb", NULL);
+  fail_unless (formatter_asset != NULL);
+  saved =
+      ges_project_save (project, timeline, uri, formatter_asset, TRUE, NULL);
+  fail_unless (saved);
+  gst_object_unref (timeline);
+  gst_object_unref (project);
+
+  location = g_filename_from_uri (uri, NULL, NULL);
+  fail_unless (g_file_get_contents (location, &contents, &len, NULL));
+  fail_unless (len > 4);
+  fail_unless (memcmp (contents, "GESB", 4) == 0);
+  g_free (contents);
+
+  /* The right formatter has to be found from the file content */
+  project = ges_project_new (uri);
+  g_signal_connect (project, "loaded", (GCallback) project_loaded_cb, mainloop);
+
+  GST_LOG ("Loading saved binary project");
+  timeline = GES_TIMELINE (ges_asset_extract (GES_ASSET (project), NULL));
+  fail_unless (GES_IS_TIMELINE (timeline));
+  g_main_loop_run (mainloop);
+  _test_project (project, timeline);
+  _check_keyframes (timeline);
+
+  gst_object_unref (timeline);
+  g_signal_handlers_disconnect_by_func (project, (GCallback) project_loaded_cb,
+      mainloop);
+  gst_object_unref (project);
+
+  g_unlink (location);
+  g_free (location);
+  g_free (uri);
+  g_main_loop_unref (mainloop);
+}
+
+GST_END_TEST;
+
 GST_START_TEST (test_project_auto_transition)
 {
   GList *layers;
@@ -612,6 +676,71 @@ GST_START_TEST (test_project_auto_transition)
 
 GST_END_TEST;
 
+/* The layers share the same serialized properties in a binary project */
+GST_START_TEST (test_project_binary_auto_transition)
+{
+  GList *layers, *tmp;
+  GMainLoop *mainloop;
+  GESProject *project;
+  GESTimeline *timeline;
+  GESAsset *formatter_asset;
+  gboolean saved;
+  gchar *location, *tmpuri, *uri =
+      ges_test_file_uri ("test-auto-transition.xges");
+
+  project = ges_project_new (uri);
+  mainloop = g_main_loop_new (NULL, FALSE);
+
+  g_signal_connect (project, "loaded", (GCallback) project_loaded_cb, mainloop);
+  g_signal_connect (project, "missing-uri", (GCallback) _set_new_uri, NULL);
+
+  timeline = GES_TIMELINE (ges_asset_extract (GES_ASSET (project), NULL));
+  g_main_loop_run (mainloop);
+  g_free (uri);
+
+  layers = ges_timeline_get_layers (timeline);
+  assert_equals_int (g_list_length (layers), 2);
+  g_list_free_full (layers, gst_object_unref);
+  ges_timeline_set_auto_transition (timeline, TRUE);
+
+  tmpuri = get_tmp_uri ("test-auto-transition-save.gesb");
+  formatter_asset = ges_asset_request (GES_TYPE_FORMATTER, "gesb", NULL);
+  fail_unless (formatter_asset != NULL);
+  saved =
+      ges_project_save (project, timeline, tmpuri, formatter_asset, TRUE, NULL);
+  fail_unless (saved);
+  gst_object_unref (timeline);
+  gst_object_unref (project);
+
+  project = ges_project_new (tmpuri);
+  g_signal_connect (project, "loaded", (GCallback) project_loaded_cb, mainloop);
+
+  GST_LOG ("Loading saved binary project");
+  timeline = GES_TIMELINE (ges_asset_extract (GES_ASSET (project), NULL));
+  fail_unless (GES_IS_TIMELINE (timeline));
+  g_main_loop_run (mainloop);
+
+  /* Every layer must get its auto-transition back, not only the first one */
+  layers = ges_timeline_get_layers (timeline);
+  assert_equals_int (g_list_length (layers), 2);
+  for (tmp = layers; tmp; tmp = tmp->next)
+    fail_unless (ges_layer_get_auto_transition (tmp->data));
+  g_list_free_full (layers, gst_object_unref);
+
+  gst_object_unref (timeline);
+  g_signal_handlers_disconnect_by_func (project, (GCallback) project_loaded_cb,
+      mainloop);
+  gst_object_unref (project);
+
+  location = g_filename_from_uri (tmpuri, NULL, NULL);
+  g_unlink (location);
+  g_free (location);
+  g_free (tmpuri);
+  g_main_loop_unref (mainloop);
+}
+
+GST_END_TEST;
+
 static GstEncodingProfile *
 _create_ogg_theora_profile (void)
 {
@@ -698,6 +827,627 @@ GST_START_TEST (test_project_proxy_editing)
 
 GST_END_TEST;
 
+static void
+proxy_creation_progress_cb (GESProject * project, GESAsset * asset,
+    gdouble progress, gboolean * got_progress)
+{
+  fail_unless (GES_IS_URI_CLIP_ASSET (asset));
+  fail_unless (progress >= 0.0 && progress <= 1.0);
+  *got_progress = TRUE;
+}
+
+GST_START_TEST (test_project_parallel_proxies)
+{
+  guint i;
+  GList *proxies, *tmp;
+  GMainLoop *mainloop;
+  GESProject *project;
+  GstEncodingProfile *profile;
+  gboolean got_progress = FALSE;
+  const gchar *files[] = { "audio_only.ogg", "audio_video.ogg" };
+
+  ges_init ();
+
+  project = ges_project_new (NULL);
+  mainloop = g_main_loop_new (NULL, FALSE);
+  fail_unless (GES_IS_PROJECT (project));
+
+  for (i = 0; i < G_N_ELEMENTS (files); i++) {
+    GESUriClipAsset *asset;
+    gchar *proxyfile, *proxyname, *uri = ges_test_file_uri (files[i]);
+
+    asset = ges_uri_clip_asset_request_sync (uri, NULL);
+    fail_unless (GES_IS_URI_CLIP_ASSET (asset));
+    fail_unless (ges_project_add_asset (project, GES_ASSET (asset)));
+    gst_object_unref (asset);
+    g_free (uri);
+
+    /* Make sure the proxies actually get transcoded */
+    proxyname = g_strconcat (files[i], ".proxy", NULL);
+    proxyfile = g_build_filename (g_get_tmp_dir (), proxyname, NULL);
+    g_unlink (proxyfile);
+    g_free (proxyfile);
+    g_free (proxyname);
+  }
+
+  g_object_set (project, "max-concurrent-proxies",
+      (guint) G_N_ELEMENTS (files), NULL);
+  fail_unless (ges_project_set_proxies_location (project, g_get_tmp_dir ()));
+
+  profile = _create_ogg_theora_profile ();
+  ges_project_set_proxy_profile (project, profile, NULL);
+
+  g_signal_connect (project, "proxies-created",
+      (GCallback) project_proxies_created_cb, mainloop);
+  g_signal_connect (project, "proxy-creation-progress",
+      (GCallback) proxy_creation_progress_cb, &got_progress);
+
+  fail_unless_equals_int (ges_project_get_proxy_state (project),
+      GST_STATE_NULL);
+  fail_unless (ges_project_start_proxy_creation (project, NULL, NULL));
+  fail_unless_equals_int (ges_project_get_proxy_state (project),
+      GST_STATE_PLAYING);
+
+  g_main_loop_run (mainloop);
+
+  fail_unless (got_progress);
+  fail_unless_equals_int (ges_project_get_proxy_state (project),
+      GST_STATE_NULL);
+
+  proxies = ges_project_list_proxies (project, GES_TYPE_EXTRACTABLE);
+  assert_equals_int (g_list_length (proxies), G_N_ELEMENTS (files));
+  for (tmp = proxies; tmp; tmp = tmp->next) {
+    gchar *parent_name, *proxy_name, *expected_name;
+
+    /* Every proxy is linked to the asset it has been created from */
+    parent_name = g_path_get_basename (ges_asset_get_parent_id (tmp->data));
+    proxy_name = g_path_get_basename (ges_asset_get_id (tmp->data));
+    expected_name = g_strconcat (parent_name, ".proxy", NULL);
+    assert_equals_string (proxy_name, expected_name);
+
+    g_free (parent_name);
+    g_free (proxy_name);
+    g_free (expected_name);
+  }
+  g_list_free_full (proxies, gst_object_unref);
+
+  gst_object_unref (profile);
+  gst_object_unref (project);
+  g_main_loop_unref (mainloop);
+}
+
+GST_END_TEST;
+
+static void
+_timeline_saved_cb (GESTimeline * timeline, GAsyncResult * res,
+    GMainLoop * mainloop)
+{
+  GError *error = NULL;
+
+  fail_unless (ges_timeline_save_to_uri_finish (timeline, res, &error));
+  fail_unless (error == NULL);
+
+  g_main_loop_quit (mainloop);
+}
+
+GST_START_TEST (test_project_save_async)
+{
+  GDir *dir;
+  GList *clips;
+  GESLayer *layer;
+  GESClip *clip;
+  gchar *location;
+  const gchar *name;
+  GMainLoop *mainloop;
+  GESTimeline *timeline, *loaded;
+  GError *error = NULL;
+  gchar *uri = get_tmp_uri ("test-save-async_TMP.xges");
+
+  location = g_filename_from_uri (uri, NULL, NULL);
+  g_unlink (location);
+
+  mainloop = g_main_loop_new (NULL, FALSE);
+  timeline = ges_timeline_new_audio_video ();
+  layer = ges_timeline_append_layer (timeline);
+  clip = GES_CLIP (ges_test_clip_new ());
+  g_object_set (clip, "start", (guint64) 10, "duration", (guint64) 20, NULL);
+  ges_layer_add_clip (layer, clip);
+
+  ges_timeline_save_to_uri_async (timeline, uri, NULL, FALSE, NULL,
+      (GAsyncReadyCallback) _timeline_saved_cb, mainloop);
+  /* What is saved is the timeline as it was when saving was requested */
+  g_object_set (clip, "start", (guint64) 100, NULL);
+  g_main_loop_run (mainloop);
+  fail_unless (g_file_test (location, G_FILE_TEST_EXISTS));
+
+  /* The temporary file has been renamed */
+  dir = g_dir_open (g_get_tmp_dir (), 0, NULL);
+  while ((name = g_dir_read_name (dir)))
+    fail_if (g_str_has_prefix (name, ".test-save-async_TMP.xges."));
+  g_dir_close (dir);
+
+  /* Not overwriting an existing file */
+  fail_if (ges_timeline_save_to_uri (timeline, uri, NULL, FALSE, &error));
+  fail_unless (g_error_matches (error, G_IO_ERROR, G_IO_ERROR_EXISTS));
+  g_clear_error (&error);
+
+  loaded = ges_timeline_new_from_uri (uri, NULL);
+  fail_unless (GES_IS_TIMELINE (loaded));
+  assert_equals_int (g_list_length (loaded->layers), 1);
+  clips = ges_layer_get_clips (loaded->layers->data);
+  assert_equals_int (g_list_length (clips), 1);
+  assert_equals_uint64 (_START (clips->data), 10);
+  assert_equals_uint64 (_DURATION (clips->data), 20);
+  g_list_free_full (clips, gst_object_unref);
+
+  gst_object_unref (loaded);
+  gst_object_unref (timeline);
+  g_main_loop_unref (mainloop);
+  g_unlink (location);
+  g_free (location);
+  g_free (uri);
+}
+
+GST_END_TEST;
+
+#define SYNTHETIC_CLIPS 5000
+#define SYNTHETIC_PADDING (48 * 1024 * 1024)
+
+/* Creates a project with @n_clips test clips, padded with comments so that
+ * the file is at least @padding bytes big. It has no track so that the
+ * timeline itself stays small in memory */
+static gchar *
+_create_synthetic_project (const gchar * filename, guint n_clips,
+    gsize padding)
+{
+  FILE *f;
+  guint i, j;
+  gchar *location, *uri, comment[4096];
+  gsize n_comments = padding / sizeof (comment) / n_clips + 1;
+
+  memset (comment, 'x', sizeof (comment));
+  memcpy (comment, "<!--", 4);
+  memcpy (comment + sizeof (comment) - 4, "-->\n", 4);
+
+  location = g_build_filename (g_get_tmp_dir (), filename, NULL);
+  f = g_fopen (location, "w");
+  fail_unless (f != NULL);
+
+  fprintf (f, "<ges version='0.1'>\n  <project>\n    <resources>\n"
+      "      <asset id='GESTestClip' extractable-type-name='GESTestClip'/>\n"
+      "    </resources>\n    <timeline>\n      <layer priority='0'>\n");
+  for (i = 0; i < n_clips; i++) {
+    fprintf (f, "        <clip id='%u' asset-id='GESTestClip' "
+        "type-name='GESTestClip' layer-priority='0' track-types='4' "
+        "start='%" G_GUINT64_FORMAT "' duration='%" G_GUINT64_FORMAT "'/>\n",
+        i, (guint64) i * GST_SECOND, (guint64) GST_SECOND);
+    for (j = 0; j < n_comments; j++)
+      fwrite (comment, sizeof (comment), 1, f);
+  }
+  fprintf (f, "      </layer>\n    </timeline>\n  </project>\n</ges>\n");
+  fclose (f);
+
+  uri = gst_filename_to_uri (location, NULL);
+  g_free (location);
+
+  return uri;
+}
+
+static void
+_remove_synthetic_project (gchar * uri)
+{
+  gchar *location = g_filename_from_uri (uri, NULL, NULL);
+
+  g_unlink (location);
+  g_free (location);
+  g_free (uri);
+}
+
+static void
+_loading_progress_cb (GESProject * project, gdouble progress,
+    GArray * progresses)
+{
+  g_array_append_val (progresses, progress);
+}
+
+static void
+_cancel_half_way_cb (GESProject * project, gdouble progress,
+    GCancellable * cancellable)
+{
+  if (progress >= 0.5)
+    g_cancellable_cancel (cancellable);
+}
+
+GST_START_TEST (test_project_load_progress)
+{
+  guint i;
+  GArray *progresses;
+  GList *layers, *clips;
+  GMainLoop *mainloop;
+  GESProject *project;
+  GESTimeline *timeline;
+  GError *error = NULL;
+  GCancellable *cancellable;
+  gchar *uri = _create_synthetic_project ("test-progress_TMP.xges", 100,
+      4 * 1024 * 1024);
+
+  mainloop = g_main_loop_new (NULL, FALSE);
+  progresses = g_array_new (FALSE, FALSE, sizeof (gdouble));
+
+  project = ges_project_new (uri);
+  g_signal_connect (project, "loading-progress",
+      (GCallback) _loading_progress_cb, progresses);
+  g_signal_connect (project, "loaded", (GCallback) project_loaded_cb, mainloop);
+
+  timeline = ges_timeline_new ();
+  fail_unless (ges_project_load (project, timeline, NULL));
+  g_main_loop_run (mainloop);
+
+  layers = ges_timeline_get_layers (timeline);
+  clips = ges_layer_get_clips (layers->data);
+  assert_equals_int (g_list_length (clips), 100);
+  g_list_free_full (clips, gst_object_unref);
+  g_list_free_full (layers, gst_object_unref);
+
+  fail_unless (progresses->len > 10);
+  for (i = 1; i < progresses->len; i++)
+    fail_unless (g_array_index (progresses, gdouble, i) >
+        g_array_index (progresses, gdouble, i - 1));
+  assert_equals_float (g_array_index (progresses, gdouble,
+          progresses->len - 1), 1.0);
+
+  gst_object_unref (timeline);
+  g_signal_handlers_disconnect_by_func (project,
+      (GCallback) _loading_progress_cb, progresses);
+  g_signal_handlers_disconnect_by_func (project, (GCallback) project_loaded_cb,
+      mainloop);
+  gst_object_unref (project);
+
+  /* Cancel the load once half of the file has been parsed */
+  project = ges_project_new (uri);
+  cancellable = g_cancellable_new ();
+  g_signal_connect (project, "loading-progress",
+      (GCallback) _cancel_half_way_cb, cancellable);
+
+  timeline = ges_timeline_new ();
+  fail_if (ges_project_load_with_cancellable (project, timeline, cancellable,
+          &error));
+  fail_unless (g_error_matches (error, G_IO_ERROR, G_IO_ERROR_CANCELLED));
+
+  g_error_free (error);
+  gst_object_unref (timeline);
+  g_signal_handlers_disconnect_by_func (project,
+      (GCallback) _cancel_half_way_cb, cancellable);
+  gst_object_unref (project);
+  g_object_unref (cancellable);
+
+  g_array_free (progresses, TRUE);
+  g_main_loop_unref (mainloop);
+  _remove_synthetic_project (uri);
+}
+
+GST_END_TEST;
+
+/* A formatter counting how many times it checks a ".sniffcount" file */
+typedef GESFormatter GESTestSniffCountFormatter;
+typedef GESFormatterClass GESTestSniffCountFormatterClass;
+
+static GType ges_test_sniff_count_formatter_get_type (void);
+G_DEFINE_TYPE (GESTestSniffCountFormatter, ges_test_sniff_count_formatter,
+    GES_TYPE_FORMATTER);
+
+static guint n_sniffed = 0;
+
+static gboolean
+ges_test_sniff_count_formatter_can_load_uri (GESFormatter * dummy_instance,
+    const gchar * uri, GError ** error)
+{
+  if (!g_str_has_suffix (uri, ".sniffcount"))
+    return FALSE;
+
+  n_sniffed++;
+
+  return TRUE;
+}
+
+static void
+ges_test_sniff_count_formatter_class_init (GESTestSniffCountFormatterClass *
+    klass)
+{
+  klass->can_load_uri = ges_test_sniff_count_formatter_can_load_uri;
+
+  ges_formatter_class_register_metas (klass, "sniffcount",
+      "Counts the checked files", "sniffcount", "application/x-sniffcount",
+      0.1, GST_RANK_MARGINAL);
+}
+
+static void
+ges_test_sniff_count_formatter_init (GESTestSniffCountFormatter * self)
+{
+}
+
+static gchar *
+_create_sniffcount_file (guint i)
+{
+  gchar *location, *uri, *name = g_strdup_printf ("test-sniff-%u_TMP"
+      ".sniffcount", i);
+
+  location = g_build_filename (g_get_tmp_dir (), name, NULL);
+  fail_unless (g_file_set_contents (location, name, -1, NULL));
+  uri = gst_filename_to_uri (location, NULL);
+  g_free (location);
+  g_free (name);
+
+  return uri;
+}
+
+GST_START_TEST (test_project_formatter_sniffing_cache)
+{
+  guint i;
+  gchar *location, *uris[GES_FORMATTER_MAX_SNIFFED_URIS + 1];
+
+  /* Makes the formatter available */
+  gst_object_unref (ges_asset_request
+      (ges_test_sniff_count_formatter_get_type (), NULL, NULL));
+
+  /* A file is only checked once, the next times the cached formatter is
+   * used */
+  uris[0] = _create_sniffcount_file (0);
+  fail_unless (ges_formatter_can_load_uri (uris[0], NULL));
+  assert_equals_int (n_sniffed, 1);
+  fail_unless (ges_formatter_can_load_uri (uris[0], NULL));
+  fail_unless (ges_formatter_can_load_uri (uris[0], NULL));
+  assert_equals_int (n_sniffed, 1);
+
+  /* Once modified, it is checked again */
+  location = g_filename_from_uri (uris[0], NULL, NULL);
+  fail_unless (g_file_set_contents (location, "modified", -1, NULL));
+  fail_unless (ges_formatter_can_load_uri (uris[0], NULL));
+  assert_equals_int (n_sniffed, 2);
+  fail_unless (ges_formatter_can_load_uri (uris[0], NULL));
+  assert_equals_int (n_sniffed, 2);
+
+  /* Only the most recently used files are remembered, the first file is
+   * used after each new one so it is never the least recently used one */
+  for (i = 1; i <= GES_FORMATTER_MAX_SNIFFED_URIS; i++) {
+    uris[i] = _create_sniffcount_file (i);
+    fail_unless (ges_formatter_can_load_uri (uris[i], NULL));
+    fail_unless (ges_formatter_can_load_uri (uris[0], NULL));
+  }
+  assert_equals_int (n_sniffed, GES_FORMATTER_MAX_SNIFFED_URIS + 2);
+
+  /* The second file got dropped from the cache, not the third one */
+  fail_unless (ges_formatter_can_load_uri (uris[2], NULL));
+  assert_equals_int (n_sniffed, GES_FORMATTER_MAX_SNIFFED_URIS + 2);
+  fail_unless (ges_formatter_can_load_uri (uris[1], NULL));
+  assert_equals_int (n_sniffed, GES_FORMATTER_MAX_SNIFFED_URIS + 3);
+
+  g_free (location);
+  for (i = 0; i <= GES_FORMATTER_MAX_SNIFFED_URIS; i++)
+    _remove_synthetic_project (uris[i]);
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_project_formatter_sniffing)
+{
+  FILE *f;
+  gchar *location;
+  gchar *uri = _create_synthetic_project ("test-sniffing_TMP.xges", 10,
+      1024 * 1024);
+
+  location = g_filename_from_uri (uri, NULL, NULL);
+
+  /* Only the beginning of the file is checked, so a broken end does not
+   * matter */
+  f = g_fopen (location, "a");
+  fail_unless (f != NULL);
+  fprintf (f, "<broken");
+  fclose (f);
+  fail_unless (ges_formatter_can_load_uri (uri, NULL));
+
+  /* The file changed, its format has to be checked again */
+  fail_unless (g_file_set_contents (location, "GESB\001\000", 6, NULL));
+  fail_unless (ges_formatter_can_load_uri (uri, NULL));
+
+  fail_unless (g_file_set_contents (location, "Not a project", -1, NULL));
+  fail_if (ges_formatter_can_load_uri (uri, NULL));
+
+  g_free (location);
+  _remove_synthetic_project (uri);
+}
+
+GST_END_TEST;
+
+/* An extractable type whose assets count how many of them are being
+ * loaded at the same time. They are loaded synchronously, the requests
+ * only complete from the main loop */
+typedef GESAsset GESTestCountedAsset;
+typedef GESAssetClass GESTestCountedAssetClass;
+typedef GObject GESTestCounted;
+typedef GObjectClass GESTestCountedClass;
+
+static GType ges_test_counted_asset_get_type (void);
+static void ges_test_counted_extractable_init (GESExtractableInterface * iface);
+
+G_DEFINE_TYPE (GESTestCountedAsset, ges_test_counted_asset, GES_TYPE_ASSET);
+G_DEFINE_TYPE_WITH_CODE (GESTestCounted, ges_test_counted, G_TYPE_OBJECT,
+    G_IMPLEMENT_INTERFACE (GES_TYPE_EXTRACTABLE,
+        ges_test_counted_extractable_init));
+
+static guint n_counted_started = 0;
+static guint n_counted_added = 0;
+static guint max_counted_in_flight = 0;
+
+static GESAssetLoadingReturn
+ges_test_counted_asset_start_loading (GESAsset * asset, GError ** error)
+{
+  n_counted_started++;
+  max_counted_in_flight = MAX (max_counted_in_flight,
+      n_counted_started - n_counted_added);
+
+  return GES_ASSET_LOADING_OK;
+}
+
+static void
+ges_test_counted_asset_class_init (GESTestCountedAssetClass * klass)
+{
+  klass->start_loading = ges_test_counted_asset_start_loading;
+}
+
+static void
+ges_test_counted_asset_init (GESTestCountedAsset * self)
+{
+}
+
+static gchar *
+ges_test_counted_check_id (GType type, const gchar * id, GError ** error)
+{
+  return g_strdup (id);
+}
+
+static void
+ges_test_counted_extractable_init (GESExtractableInterface * iface)
+{
+  iface->asset_type = ges_test_counted_asset_get_type ();
+  iface->check_id = ges_test_counted_check_id;
+}
+
+static void
+ges_test_counted_class_init (GESTestCountedClass * klass)
+{
+}
+
+static void
+ges_test_counted_init (GESTestCounted * self)
+{
+}
+
+static void
+_counted_asset_added_cb (GESProject * project, GESAsset * asset)
+{
+  if (G_OBJECT_TYPE (asset) == ges_test_counted_asset_get_type ())
+    n_counted_added++;
+}
+
+GST_START_TEST (test_project_load_many_assets)
+{
+  FILE *f;
+  guint i, bound, n_assets;
+  GList *assets;
+  GMainLoop *mainloop;
+  GESProject *project;
+  GESTimeline *timeline;
+  gchar *location, *uri;
+
+  /* The bound of the formatter */
+#if GLIB_CHECK_VERSION(2, 36, 0)
+  bound = 2 * MAX (g_get_num_processors (), 1);
+#else
+  bound = 4;
+#endif
+  n_assets = 3 * bound + 1;
+
+  location = g_build_filename (g_get_tmp_dir (), "test-many-assets_TMP.xges",
+      NULL);
+  f = g_fopen (location, "w");
+  fail_unless (f != NULL);
+  fprintf (f, "<ges version='0.1'>\n  <project>\n    <resources>\n");
+  for (i = 0; i < n_assets; i++)
+    fprintf (f, "      <asset id='counted-%u' "
+        "extractable-type-name='%s'/>\n", i,
+        g_type_name (ges_test_counted_get_type ()));
+  fprintf (f, "    </resources>\n    <timeline>\n      <layer priority='0'>\n"
+      "      </layer>\n    </timeline>\n  </project>\n</ges>\n");
+  fclose (f);
+  uri = gst_filename_to_uri (location, NULL);
+  g_free (location);
+
+  mainloop = g_main_loop_new (NULL, FALSE);
+  project = ges_project_new (uri);
+  g_signal_connect (project, "asset-added",
+      (GCallback) _counted_asset_added_cb, NULL);
+  g_signal_connect (project, "loaded", (GCallback) project_loaded_cb, mainloop);
+
+  timeline = ges_timeline_new ();
+  fail_unless (ges_project_load (project, timeline, NULL));
+  g_main_loop_run (mainloop);
+
+  /* All the assets got loaded, never more than the bound at a time */
+  assert_equals_int (n_counted_started, n_assets);
+  assert_equals_int (n_counted_added, n_assets);
+  fail_unless (max_counted_in_flight > 0);
+  fail_unless (max_counted_in_flight <= bound,
+      "%u assets loaded at the same time, the bound is %u",
+      max_counted_in_flight, bound);
+
+  assets = ges_project_list_assets (project, ges_test_counted_get_type ());
+  assert_equals_int (g_list_length (assets), n_assets);
+  g_list_free_full (assets, gst_object_unref);
+
+  gst_object_unref (timeline);
+  g_signal_handlers_disconnect_by_func (project,
+      (GCallback) _counted_asset_added_cb, NULL);
+  g_signal_handlers_disconnect_by_func (project, (GCallback) project_loaded_cb,
+      mainloop);
+  gst_object_unref (project);
+  g_main_loop_unref (mainloop);
+  _remove_synthetic_project (uri);
+}
+
+GST_END_TEST;
+
+#ifdef __linux__
+static gsize
+_get_peak_rss (void)
+{
+  gchar *status, *hwm;
+  gsize peak = 0;
+
+  fail_unless (g_file_get_contents ("/proc/self/status", &status, NULL,
+          NULL));
+  hwm = strstr (status, "VmHWM:");
+  if (hwm)
+    peak = g_ascii_strtoull (hwm + strlen ("VmHWM:"), NULL, 10) * 1024;
+  g_free (status);
+
+  return peak;
+}
+
+GST_START_TEST (test_project_load_peak_memory)
+{
+  gsize peak;
+  GMainLoop *mainloop;
+  GESProject *project;
+  GESTimeline *timeline;
+  gchar *uri = _create_synthetic_project ("test-large_TMP.xges",
+      SYNTHETIC_CLIPS, SYNTHETIC_PADDING);
+
+  mainloop = g_main_loop_new (NULL, FALSE);
+  project = ges_project_new (uri);
+  g_signal_connect (project, "loaded", (GCallback) project_loaded_cb, mainloop);
+
+  peak = _get_peak_rss ();
+  timeline = ges_timeline_new ();
+  fail_unless (ges_project_load (project, timeline, NULL));
+  g_main_loop_run (mainloop);
+
+  /* The file is parsed chunk by chunk, it is never fully in memory */
+  fail_unless (_get_peak_rss () - peak < SYNTHETIC_PADDING / 2,
+      "Peak memory grew by %" G_GSIZE_FORMAT " bytes while loading",
+      _get_peak_rss () - peak);
+
+  gst_object_unref (timeline);
+  g_signal_handlers_disconnect_by_func (project, (GCallback) project_loaded_cb,
+      mainloop);
+  gst_object_unref (project);
+  g_main_loop_unref (mainloop);
+  _remove_synthetic_project (uri);
+}
+
+GST_END_TEST;
+#endif
+
 /*  FIXME This test does not pass for some bad reason */
 #if 0
 static void
@@ -797,8 +1547,19 @@ ges_suite (void)
   tcase_add_test (tc_chain, test_project_add_assets);
   tcase_add_test (tc_chain, test_project_load_xges);
   tcase_add_test (tc_chain, test_project_add_keyframes);
+  tcase_add_test (tc_chain, test_project_binary_formatter);
   tcase_add_test (tc_chain, test_project_auto_transition);
+  tcase_add_test (tc_chain, test_project_binary_auto_transition);
   tcase_add_test (tc_chain, test_project_proxy_editing);
+  tcase_add_test (tc_chain, test_project_parallel_proxies);
+  tcase_add_test (tc_chain, test_project_load_progress);
+  tcase_add_test (tc_chain, test_project_formatter_sniffing);
+  tcase_add_test (tc_chain, test_project_formatter_sniffing_cache);
+  tcase_add_test (tc_chain, test_project_save_async);
+  tcase_add_test (tc_chain, test_project_load_many_assets);
+#ifdef __linux__
+  tcase_add_test (tc_chain, test_project_load_peak_memory);
+#endif
   /*tcase_add_test (tc_chain, test_load_xges_and_play); */
   tcase_add_test (tc_chain, test_project_unexistant_effect);
 
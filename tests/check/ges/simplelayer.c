@@ -436,6 +436,223 @@ GST_START_TEST (test_gsl_with_transitions)
 
 GST_END_TEST;
 
+#define N_CLIPS 50
+
+static void
+check_sequence (GESSimpleLayer * layer, guint n_clips)
+{
+  guint i;
+  GESClip *clip;
+  guint64 start = 0;
+  guint32 priority = GES_LAYER (layer)->min_gnl_priority;
+
+  for (i = 0; i < n_clips; i++) {
+    clip = ges_simple_layer_nth (layer, i);
+
+    fail_unless (clip != NULL);
+    fail_unless_equals_int (ges_simple_layer_index (layer, clip), i);
+    fail_unless_equals_uint64 (_START (clip), start);
+    fail_unless_equals_int (_PRIORITY (clip), priority);
+    start += _DURATION (clip);
+    priority += GES_CONTAINER_HEIGHT (clip);
+  }
+  fail_if (ges_simple_layer_nth (layer, n_clips));
+}
+
+GST_START_TEST (test_gsl_many_objects)
+{
+  guint i;
+  GESTimeline *timeline;
+  GESLayer *layer;
+  GESTrack *track;
+  GESClip *clip, *clips[N_CLIPS];
+
+  ges_init ();
+
+  timeline = ges_timeline_new ();
+  layer = (GESLayer *) ges_simple_layer_new ();
+  fail_unless (ges_timeline_add_layer (timeline, layer));
+  track = ges_track_new (GES_TRACK_TYPE_CUSTOM, gst_caps_new_any ());
+  fail_unless (ges_timeline_add_track (timeline, track));
+
+  /* Always inserting at the front */
+  for (i = 0; i < N_CLIPS; i++) {
+    clips[i] = GES_CLIP (ges_test_clip_new ());
+    g_object_set (clips[i], "duration", (i + 1) * GST_SECOND, NULL);
+    fail_unless (ges_simple_layer_add_object (GES_SIMPLE_LAYER (layer),
+            clips[i], 0));
+  }
+  check_sequence (GES_SIMPLE_LAYER (layer), N_CLIPS);
+  fail_unless (ges_simple_layer_nth (GES_SIMPLE_LAYER (layer), 0) ==
+      clips[N_CLIPS - 1]);
+
+  /* Front to back, back to front, and within the middle */
+  fail_unless (ges_simple_layer_move_object (GES_SIMPLE_LAYER (layer),
+          clips[N_CLIPS - 1], -1));
+  fail_unless_equals_int (ges_simple_layer_index (GES_SIMPLE_LAYER (layer),
+          clips[N_CLIPS - 1]), N_CLIPS - 1);
+  check_sequence (GES_SIMPLE_LAYER (layer), N_CLIPS);
+
+  fail_unless (ges_simple_layer_move_object (GES_SIMPLE_LAYER (layer),
+          clips[N_CLIPS - 1], 0));
+  fail_unless_equals_int (ges_simple_layer_index (GES_SIMPLE_LAYER (layer),
+          clips[N_CLIPS - 1]), 0);
+  check_sequence (GES_SIMPLE_LAYER (layer), N_CLIPS);
+
+  clip = ges_simple_layer_nth (GES_SIMPLE_LAYER (layer), 10);
+  fail_unless (ges_simple_layer_move_object (GES_SIMPLE_LAYER (layer),
+          clip, 30));
+  fail_unless_equals_int (ges_simple_layer_index (GES_SIMPLE_LAYER (layer),
+          clip), 30);
+  check_sequence (GES_SIMPLE_LAYER (layer), N_CLIPS);
+
+  fail_unless (ges_simple_layer_move_object (GES_SIMPLE_LAYER (layer),
+          clip, 5));
+  fail_unless_equals_int (ges_simple_layer_index (GES_SIMPLE_LAYER (layer),
+          clip), 5);
+  check_sequence (GES_SIMPLE_LAYER (layer), N_CLIPS);
+
+  /* Changing the duration of a clip in the middle */
+  g_object_set (clip, "duration", 100 * GST_SECOND, NULL);
+  check_sequence (GES_SIMPLE_LAYER (layer), N_CLIPS);
+
+  /* And removing it */
+  fail_unless (ges_layer_remove_clip (layer, clip));
+  fail_unless_equals_int (ges_simple_layer_index (GES_SIMPLE_LAYER (layer),
+          clip), -1);
+  check_sequence (GES_SIMPLE_LAYER (layer), N_CLIPS - 1);
+
+  gst_object_unref (timeline);
+}
+
+GST_END_TEST;
+
+static void
+count_notify_cb (GObject * object, GParamSpec * pspec, guint * count)
+{
+  (*count)++;
+}
+
+GST_START_TEST (test_gsl_edit_transaction)
+{
+  guint i, n_start_changes = 0;
+  GESTimeline *timeline;
+  GESLayer *layer;
+  GESTrack *track;
+  GESClip *clips[N_CLIPS];
+
+  ges_init ();
+
+  timeline = ges_timeline_new ();
+  layer = (GESLayer *) ges_simple_layer_new ();
+  fail_unless (ges_timeline_add_layer (timeline, layer));
+  track = ges_track_new (GES_TRACK_TYPE_CUSTOM, gst_caps_new_any ());
+  fail_unless (ges_timeline_add_track (timeline, track));
+
+  clips[0] = GES_CLIP (ges_test_clip_new ());
+  g_object_set (clips[0], "duration", GST_SECOND, NULL);
+  fail_unless (ges_simple_layer_add_object (GES_SIMPLE_LAYER (layer),
+          clips[0], 0));
+  g_signal_connect (clips[0], "notify::start",
+      G_CALLBACK (count_notify_cb), &n_start_changes);
+
+  /* Inserting at the front only moves the clips once the transaction
+   * ends */
+  ges_timeline_begin_edit (timeline);
+  for (i = 1; i < N_CLIPS; i++) {
+    clips[i] = GES_CLIP (ges_test_clip_new ());
+    g_object_set (clips[i], "duration", GST_SECOND, NULL);
+    fail_unless (ges_simple_layer_add_object (GES_SIMPLE_LAYER (layer),
+            clips[i], 0));
+  }
+  fail_unless_equals_uint64 (_START (clips[0]), 0);
+  fail_unless_equals_int (n_start_changes, 0);
+  ges_timeline_end_edit (timeline);
+
+  fail_unless_equals_int (n_start_changes, 1);
+  fail_unless_equals_uint64 (_START (clips[0]), (N_CLIPS - 1) * GST_SECOND);
+  check_sequence (GES_SIMPLE_LAYER (layer), N_CLIPS);
+
+  /* Checking the validity applies the pending changes */
+  ges_timeline_begin_edit (timeline);
+  g_object_set (clips[N_CLIPS - 1], "duration", 2 * GST_SECOND, NULL);
+  fail_unless_equals_int (n_start_changes, 1);
+  fail_unless (ges_simple_layer_is_valid (GES_SIMPLE_LAYER (layer)));
+  fail_unless_equals_int (n_start_changes, 2);
+  check_sequence (GES_SIMPLE_LAYER (layer), N_CLIPS);
+  ges_timeline_end_edit (timeline);
+  fail_unless_equals_int (n_start_changes, 2);
+
+  gst_object_unref (timeline);
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_gsl_many_transitions)
+{
+  guint i;
+  GESTimeline *timeline;
+  GESLayer *layer;
+  GESTrack *track;
+  GESSimpleLayer *gstl;
+  GESClip *sources[N_CLIPS], *transitions[N_CLIPS - 1];
+
+  ges_init ();
+
+  timeline = ges_timeline_new ();
+  layer = (GESLayer *) ges_simple_layer_new ();
+  gstl = GES_SIMPLE_LAYER (layer);
+  fail_unless (ges_timeline_add_layer (timeline, layer));
+  track = ges_track_new (GES_TRACK_TYPE_VIDEO, gst_caps_new_any ());
+  fail_unless (ges_timeline_add_track (timeline, track));
+
+  /* Sources of 1s with transitions of 0.5s between all of them */
+  for (i = 0; i < N_CLIPS; i++) {
+    sources[i] = GES_CLIP (ges_test_clip_new ());
+    g_object_set (sources[i], "duration", GST_SECOND, NULL);
+    fail_unless (ges_simple_layer_add_object (gstl, sources[i], -1));
+
+    if (i == N_CLIPS - 1)
+      break;
+
+    transitions[i] = GES_CLIP (ges_transition_clip_new
+        (GES_VIDEO_STANDARD_TRANSITION_TYPE_CROSSFADE));
+    g_object_set (transitions[i], "duration", GST_SECOND / 2, NULL);
+    fail_unless (ges_simple_layer_add_object (gstl, transitions[i], -1));
+  }
+  fail_unless (ges_simple_layer_is_valid (gstl));
+
+  /* A source in the middle gets shorter than its transitions */
+  g_object_set (sources[N_CLIPS / 2], "duration", GST_SECOND / 4, NULL);
+  fail_if (ges_simple_layer_is_valid (gstl));
+
+  /* Also breaking the rules at the end, and fixing the middle */
+  g_object_set (sources[N_CLIPS - 1], "duration", GST_SECOND / 4, NULL);
+  fail_if (ges_simple_layer_is_valid (gstl));
+  g_object_set (sources[N_CLIPS / 2], "duration", GST_SECOND, NULL);
+  fail_if (ges_simple_layer_is_valid (gstl));
+
+  /* Removing the transition that was too long */
+  fail_unless (ges_layer_remove_clip (layer, transitions[N_CLIPS - 2]));
+  fail_unless (ges_simple_layer_is_valid (gstl));
+
+  /* Two transitions now overlap */
+  g_object_set (sources[1], "duration", GST_SECOND / 2, NULL);
+  fail_if (ges_simple_layer_is_valid (gstl));
+  g_object_set (sources[1], "duration", GST_SECOND, NULL);
+  fail_unless (ges_simple_layer_is_valid (gstl));
+
+  /* The layer ends with a transition */
+  fail_unless (ges_layer_remove_clip (layer, sources[N_CLIPS - 1]));
+  fail_unless (ges_simple_layer_is_valid (gstl));
+  fail_unless (ges_layer_remove_clip (layer, sources[N_CLIPS - 2]));
+  fail_if (ges_simple_layer_is_valid (gstl));
+
+  gst_object_unref (timeline);
+}
+
+GST_END_TEST;
+
 static Suite *
 ges_suite (void)
 {
@@ -447,6 +664,9 @@ ges_suite (void)
   tcase_add_test (tc_chain, test_gsl_add);
   tcase_add_test (tc_chain, test_gsl_move_simple);
   tcase_add_test (tc_chain, test_gsl_with_transitions);
+  tcase_add_test (tc_chain, test_gsl_many_objects);
+  tcase_add_test (tc_chain, test_gsl_edit_transaction);
+  tcase_add_test (tc_chain, test_gsl_many_transitions);
 
   return s;
 }
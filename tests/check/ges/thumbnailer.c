@@ -0,0 +1,252 @@
+/* GStreamer Editing Services
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#include "test-utils.h"
+#include <ges/ges.h>
+#include <gst/check/gstcheck.h>
+
+typedef struct
+{
+  GMainLoop *mainloop;
+  GPtrArray *samples;
+  GError *error;
+  guint n_signals;
+  gboolean done;
+} ThumbnailsResult;
+
+static void
+thumbnail_cb (GESThumbnailer * thumbnailer, GstClockTime timestamp,
+    GstSample * sample, ThumbnailsResult * result)
+{
+  fail_unless (GST_IS_SAMPLE (sample));
+  result->n_signals++;
+}
+
+static void
+thumbnails_done_cb (GESThumbnailer * thumbnailer, GAsyncResult * res,
+    ThumbnailsResult * result)
+{
+  result->samples = ges_thumbnailer_get_thumbnails_finish (thumbnailer, res,
+      &result->error);
+  result->done = TRUE;
+  if (result->mainloop)
+    g_main_loop_quit (result->mainloop);
+}
+
+static void
+check_thumbnail (GstSample * sample, gint expected_width,
+    gint expected_height)
+{
+  gint width, height;
+  GstStructure *structure;
+
+  fail_unless (sample != NULL);
+  fail_unless (gst_sample_get_buffer (sample) != NULL);
+
+  structure = gst_caps_get_structure (gst_sample_get_caps (sample), 0);
+  fail_unless (gst_structure_get_int (structure, "width", &width));
+  fail_unless (gst_structure_get_int (structure, "height", &height));
+  assert_equals_int (width, expected_width);
+  assert_equals_int (height, expected_height);
+  assert_equals_string (gst_structure_get_string (structure, "format"), "RGB");
+}
+
+static GstCaps *
+thumbnail_caps (void)
+{
+  return gst_caps_from_string ("video/x-raw,format=RGB,width=160,height=90,"
+      "pixel-aspect-ratio=1/1");
+}
+
+GST_START_TEST (test_thumbnailer_asset)
+{
+  guint i;
+  gchar *uri;
+  GstCaps *caps;
+  GESUriClipAsset *asset;
+  GESThumbnailer *thumbnailer;
+  GError *error = NULL;
+  ThumbnailsResult result = { NULL, };
+  /* Not sorted on purpose */
+  GstClockTime timestamps[] = { GST_SECOND, 0, GST_SECOND / 2 };
+
+  ges_init ();
+
+  uri = ges_test_file_uri ("audio_video.ogg");
+  asset = ges_uri_clip_asset_request_sync (uri, &error);
+  fail_unless (asset != NULL, "%s", error ? error->message : "");
+  g_free (uri);
+
+  thumbnailer = ges_thumbnailer_new_for_asset (asset);
+  fail_unless (GES_IS_THUMBNAILER (thumbnailer));
+  fail_unless (ges_thumbnailer_get_accurate (thumbnailer));
+  fail_unless (ges_thumbnailer_get_caps (thumbnailer) == NULL);
+
+  caps = thumbnail_caps ();
+  ges_thumbnailer_set_caps (thumbnailer, caps);
+  gst_caps_unref (caps);
+  g_signal_connect (thumbnailer, "thumbnail", G_CALLBACK (thumbnail_cb),
+      &result);
+
+  result.mainloop = g_main_loop_new (NULL, FALSE);
+  ges_thumbnailer_get_thumbnails_async (thumbnailer, timestamps,
+      G_N_ELEMENTS (timestamps), NULL,
+      (GAsyncReadyCallback) thumbnails_done_cb, &result);
+  g_main_loop_run (result.mainloop);
+
+  fail_unless (result.error == NULL, "%s", result.error ?
+      result.error->message : "");
+  assert_equals_int (result.samples->len, G_N_ELEMENTS (timestamps));
+  assert_equals_int (result.n_signals, G_N_ELEMENTS (timestamps));
+  for (i = 0; i < result.samples->len; i++)
+    check_thumbnail (g_ptr_array_index (result.samples, i), 160, 90);
+
+  /* The thumbnails are given back in the order of the timestamps */
+  fail_unless (GST_BUFFER_PTS (gst_sample_get_buffer (g_ptr_array_index
+              (result.samples, 1))) <
+      GST_BUFFER_PTS (gst_sample_get_buffer (g_ptr_array_index
+              (result.samples, 2))));
+
+  g_ptr_array_unref (result.samples);
+  g_main_loop_unref (result.mainloop);
+  g_object_unref (thumbnailer);
+  g_object_unref (asset);
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_thumbnailer_timeline)
+{
+  GstCaps *caps;
+  GESLayer *layer;
+  GESTestClip *clip;
+  GESTimeline *timeline;
+  GESThumbnailer *thumbnailer;
+  ThumbnailsResult result = { NULL, };
+  GstClockTime timestamps[] = { 0, GST_SECOND, 2 * GST_SECOND };
+
+  ges_init ();
+
+  timeline = ges_timeline_new_audio_video ();
+  layer = ges_timeline_append_layer (timeline);
+  clip = ges_test_clip_new ();
+  g_object_set (clip, "duration", 3 * GST_SECOND, NULL);
+  fail_unless (ges_layer_add_clip (layer, GES_CLIP (clip)));
+
+  /* Keep our own reference */
+  gst_object_ref_sink (timeline);
+  thumbnailer = ges_thumbnailer_new_for_timeline (timeline);
+  ASSERT_OBJECT_REFCOUNT (timeline, "timeline", 2);
+  ges_thumbnailer_set_accurate (thumbnailer, FALSE);
+  fail_if (ges_thumbnailer_get_accurate (thumbnailer));
+  caps = thumbnail_caps ();
+  g_object_set (thumbnailer, "caps", caps, NULL);
+  gst_caps_unref (caps);
+
+  result.mainloop = g_main_loop_new (NULL, FALSE);
+  ges_thumbnailer_get_thumbnails_async (thumbnailer, timestamps,
+      G_N_ELEMENTS (timestamps), NULL,
+      (GAsyncReadyCallback) thumbnails_done_cb, &result);
+  g_main_loop_run (result.mainloop);
+
+  fail_unless (result.error == NULL, "%s", result.error ?
+      result.error->message : "");
+  assert_equals_int (result.samples->len, G_N_ELEMENTS (timestamps));
+  check_thumbnail (g_ptr_array_index (result.samples, 0), 160, 90);
+  check_thumbnail (g_ptr_array_index (result.samples, 2), 160, 90);
+  g_ptr_array_unref (result.samples);
+
+  /* The timeline is given back once done */
+  fail_unless (GST_OBJECT_PARENT (timeline) == NULL);
+
+  /* And can be used again */
+  ges_thumbnailer_get_thumbnails_async (thumbnailer, timestamps, 1, NULL,
+      (GAsyncReadyCallback) thumbnails_done_cb, &result);
+  g_main_loop_run (result.mainloop);
+  fail_unless (result.error == NULL);
+  assert_equals_int (result.samples->len, 1);
+  check_thumbnail (g_ptr_array_index (result.samples, 0), 160, 90);
+  g_ptr_array_unref (result.samples);
+
+  g_main_loop_unref (result.mainloop);
+  g_object_unref (thumbnailer);
+  gst_object_unref (timeline);
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_thumbnailer_busy)
+{
+  GESLayer *layer;
+  GESTestClip *clip;
+  GESTimeline *timeline;
+  GESThumbnailer *thumbnailer;
+  ThumbnailsResult result = { NULL, };
+  ThumbnailsResult busy_result = { NULL, };
+  GstClockTime timestamp = GST_SECOND;
+
+  ges_init ();
+
+  timeline = ges_timeline_new_audio_video ();
+  layer = ges_timeline_append_layer (timeline);
+  clip = ges_test_clip_new ();
+  g_object_set (clip, "duration", 2 * GST_SECOND, NULL);
+  fail_unless (ges_layer_add_clip (layer, GES_CLIP (clip)));
+
+  /* The floating timeline is taken over */
+  thumbnailer = ges_thumbnailer_new_for_timeline (timeline);
+  fail_if (g_object_is_floating (timeline));
+  ASSERT_OBJECT_REFCOUNT (timeline, "timeline", 1);
+
+  ges_thumbnailer_get_thumbnails_async (thumbnailer, &timestamp, 1, NULL,
+      (GAsyncReadyCallback) thumbnails_done_cb, &result);
+  ges_thumbnailer_get_thumbnails_async (thumbnailer, &timestamp, 1, NULL,
+      (GAsyncReadyCallback) thumbnails_done_cb, &busy_result);
+
+  /* The second request fails right away, the first one still completes */
+  while (!result.done || !busy_result.done)
+    g_main_context_iteration (NULL, TRUE);
+  fail_unless (busy_result.samples == NULL);
+  fail_unless (g_error_matches (busy_result.error, G_IO_ERROR,
+          G_IO_ERROR_BUSY));
+  g_error_free (busy_result.error);
+  fail_unless (result.error == NULL);
+  fail_unless (g_ptr_array_index (result.samples, 0) != NULL);
+  g_ptr_array_unref (result.samples);
+
+  g_object_unref (thumbnailer);
+}
+
+GST_END_TEST;
+
+static Suite *
+ges_suite (void)
+{
+  Suite *s = suite_create ("ges-thumbnailer");
+  TCase *tc_chain = tcase_create ("thumbnailer");
+
+  suite_add_tcase (s, tc_chain);
+
+  tcase_add_test (tc_chain, test_thumbnailer_asset);
+  tcase_add_test (tc_chain, test_thumbnailer_timeline);
+  tcase_add_test (tc_chain, test_thumbnailer_busy);
+
+  return s;
+}
+
+GST_CHECK_MAIN (ges);
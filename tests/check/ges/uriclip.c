@@ -18,8 +18,14 @@
  */
 
 #include "test-utils.h"
+#include "../../../ges/ges-image-cache.h"
+#include "../../../ges/ges-media-cache.h"
+#include "../../../ges/ges-audio-peaks.h"
 #include <ges/ges.h>
 #include <gst/check/gstcheck.h>
+#include <glib/gstdio.h>
+#include <string.h>
+#include <math.h>
 
 /* This test uri will eventually have to be fixed */
 #define TEST_URI "http://nowhere/blahblahblah"
@@ -27,8 +33,74 @@
 
 static gchar *av_uri;
 static gchar *image_uri;
+static gchar *cache_dir;
 GMainLoop *mainloop;
 
+static void
+remove_directory (const gchar * path)
+{
+  const gchar *name;
+  GDir *dir = g_dir_open (path, 0, NULL);
+
+  if (dir == NULL)
+    return;
+
+  while ((name = g_dir_read_name (dir))) {
+    gchar *child = g_build_filename (path, name, NULL);
+
+    if (g_file_test (child, G_FILE_TEST_IS_DIR))
+      remove_directory (child);
+    else
+      g_unlink (child);
+    g_free (child);
+  }
+  g_dir_close (dir);
+  g_rmdir (path);
+}
+
+/* The caches of GES live in a temporary $XDG_CACHE_HOME, emptied before
+ * each test */
+static void
+clear_caches (void)
+{
+  gchar *path = g_build_filename (cache_dir, "gstreamer-1.0", "ges", NULL);
+
+  remove_directory (path);
+  g_free (path);
+}
+
+/* Returns the paths of the files of the @kind cache */
+static GList *
+list_cache_files (const gchar * kind)
+{
+  GDir *dir;
+  const gchar *name;
+  GList *files = NULL;
+  gchar *path = g_build_filename (cache_dir, "gstreamer-1.0", "ges", kind,
+      NULL);
+
+  dir = g_dir_open (path, 0, NULL);
+  if (dir) {
+    while ((name = g_dir_read_name (dir)))
+      files = g_list_prepend (files, g_build_filename (path, name, NULL));
+    g_dir_close (dir);
+  }
+  g_free (path);
+
+  return files;
+}
+
+static guint
+count_cache_files (const gchar * kind)
+{
+  GList *files = list_cache_files (kind);
+  guint ret = g_list_length (files);
+
+  g_list_free_full (files, g_free);
+
+  return ret;
+}
+
 typedef struct _AssetUri
 {
   const gchar *uri;
@@ -114,6 +186,66 @@ create_asset (AssetUri * asset_uri)
   return FALSE;
 }
 
+GST_START_TEST (test_filesource_split)
+{
+  GList *tmp, *copies;
+  GESLayer *layer;
+  GESTimeline *timeline;
+  GESUriClipAsset *asset;
+  GESClip *clip, *copy;
+
+  ges_init ();
+
+  timeline = ges_timeline_new_audio_video ();
+  layer = ges_timeline_append_layer (timeline);
+  asset = ges_uri_clip_asset_request_sync (av_uri, NULL);
+  fail_unless (GES_IS_URI_CLIP_ASSET (asset));
+  clip = ges_layer_add_asset (layer, GES_ASSET (asset), 0, 0, GST_SECOND,
+      GES_TRACK_TYPE_UNKNOWN);
+  gst_object_unref (asset);
+  ges_uri_clip_set_mute (GES_URI_CLIP (clip), TRUE);
+
+  /* The clip and its sources are cloned without going through GValues,
+   * nothing should be lost */
+  copy = ges_clip_split (clip, GST_SECOND / 2);
+  fail_unless (G_OBJECT_TYPE (copy) == GES_TYPE_URI_CLIP);
+  fail_unless_equals_string (ges_uri_clip_get_uri (GES_URI_CLIP (copy)),
+      av_uri);
+  fail_unless (ges_uri_clip_is_muted (GES_URI_CLIP (copy)));
+  fail_if (ges_uri_clip_is_image (GES_URI_CLIP (copy)));
+  fail_unless_equals_int (ges_clip_get_supported_formats (copy),
+      ges_clip_get_supported_formats (clip));
+  fail_unless_equals_uint64 (_START (copy), GST_SECOND / 2);
+  fail_unless_equals_uint64 (_INPOINT (copy), GST_SECOND / 2);
+  fail_unless_equals_uint64 (_DURATION (copy), GST_SECOND / 2);
+  fail_unless_equals_uint64 (GES_TIMELINE_ELEMENT_MAX_DURATION (copy),
+      GES_TIMELINE_ELEMENT_MAX_DURATION (clip));
+
+  copies = GES_CONTAINER_CHILDREN (copy);
+  assert_equals_int (g_list_length (copies),
+      g_list_length (GES_CONTAINER_CHILDREN (clip)));
+  for (tmp = copies; tmp; tmp = tmp->next) {
+    gchar *uri;
+    GESTrackElement *element = tmp->data;
+
+    fail_unless (GES_IS_VIDEO_URI_SOURCE (element) ||
+        GES_IS_AUDIO_URI_SOURCE (element));
+    g_object_get (element, "uri", &uri, NULL);
+    fail_unless_equals_string (uri, av_uri);
+    g_free (uri);
+    fail_unless_equals_uint64 (_START (element), GST_SECOND / 2);
+    fail_unless_equals_uint64 (_INPOINT (element), GST_SECOND / 2);
+
+    /* Muting only deactivates the audio */
+    fail_unless (ges_track_element_is_active (element) ==
+        GES_IS_VIDEO_URI_SOURCE (element));
+  }
+
+  gst_object_unref (timeline);
+}
+
+GST_END_TEST;
+
 GST_START_TEST (test_filesource_properties)
 {
   GESClip *clip;
@@ -264,6 +396,929 @@ GST_START_TEST (test_filesource_images)
 
 GST_END_TEST;
 
+static void
+asset_reloaded_cb (GObject * source, GAsyncResult * res, GESAsset * reference)
+{
+  GError *error = NULL;
+  GESUriClipAsset *asset;
+
+  asset = GES_URI_CLIP_ASSET (ges_asset_request_finish (res, &error));
+  fail_unless (error == NULL);
+  fail_unless (GES_IS_URI_CLIP_ASSET (asset));
+
+  /* The asset has been filled from the cache the first load filled, which
+   * has been given another duration */
+  assert_equals_uint64 (ges_uri_clip_asset_get_duration (asset),
+      2 * GST_SECOND);
+  assert_equals_int (ges_clip_asset_get_supported_formats (GES_CLIP_ASSET
+          (asset)), GES_TRACK_TYPE_VIDEO | GES_TRACK_TYPE_AUDIO);
+  assert_equals_int (g_list_length ((GList *)
+          ges_uri_clip_asset_get_stream_assets (asset)), 2);
+
+  /* Discovering still works */
+  fail_unless (GST_IS_DISCOVERER_INFO (ges_uri_clip_asset_get_info (asset)));
+  assert_equals_uint64 (gst_discoverer_info_get_duration
+      (ges_uri_clip_asset_get_info (asset)), GST_SECOND);
+
+  gst_object_unref (asset);
+  g_main_loop_quit (mainloop);
+}
+
+GST_START_TEST (test_filesource_discoverer_cache)
+{
+  GList *files;
+  GKeyFile *kf;
+  gchar *data;
+  gsize length;
+  GESUriClipAsset *asset;
+
+  ges_init ();
+
+  mainloop = g_main_loop_new (NULL, FALSE);
+
+  /* Nothing is in the cache, the file is discovered and cached */
+  assert_equals_int (count_cache_files ("discoverer"), 0);
+  asset = ges_uri_clip_asset_request_sync (av_uri, NULL);
+  fail_unless (GES_IS_URI_CLIP_ASSET (asset));
+  assert_equals_uint64 (ges_uri_clip_asset_get_duration (asset), GST_SECOND);
+  files = list_cache_files ("discoverer");
+  assert_equals_int (g_list_length (files), 1);
+
+  /* Change the cached duration, to tell an asset filled from the cache
+   * from a discovered one */
+  kf = g_key_file_new ();
+  fail_unless (g_key_file_load_from_file (kf, files->data, G_KEY_FILE_NONE,
+          NULL));
+  assert_equals_uint64 (g_key_file_get_uint64 (kf, "discoverer", "duration",
+          NULL), GST_SECOND);
+  g_key_file_set_uint64 (kf, "discoverer", "duration", 2 * GST_SECOND);
+  data = g_key_file_to_data (kf, &length, NULL);
+  fail_unless (g_file_set_contents (files->data, data, length, NULL));
+  g_free (data);
+  g_key_file_free (kf);
+  g_list_free_full (files, g_free);
+
+  fail_unless (ges_asset_needs_reload (GES_TYPE_URI_CLIP, av_uri));
+  ges_asset_request_async (GES_TYPE_URI_CLIP, av_uri, NULL,
+      (GAsyncReadyCallback) asset_reloaded_cb, asset);
+  g_main_loop_run (mainloop);
+
+  g_main_loop_unref (mainloop);
+}
+
+GST_END_TEST;
+
+static void
+concurrent_asset_loaded_cb (GObject * source, GAsyncResult * res,
+    guint * n_loaded)
+{
+  GError *error = NULL;
+  GESAsset *asset = ges_asset_request_finish (res, &error);
+
+  fail_unless (error == NULL, "%s", error ? error->message : "");
+  fail_unless (GES_IS_URI_CLIP_ASSET (asset));
+  assert_equals_uint64 (ges_uri_clip_asset_get_duration (GES_URI_CLIP_ASSET
+          (asset)), GST_SECOND);
+  gst_object_unref (asset);
+
+  if (++(*n_loaded) == 8)
+    g_main_loop_quit (mainloop);
+}
+
+GST_START_TEST (test_filesource_concurrent_loading)
+{
+  guint i, n_loaded = 0;
+  gsize length;
+  gchar *filename, *contents, *copies[8], *uris[8];
+  GESUriClipAssetClass *klass;
+
+  ges_init ();
+
+  mainloop = g_main_loop_new (NULL, FALSE);
+  klass = g_type_class_ref (GES_TYPE_URI_CLIP_ASSET);
+
+  /* Different files, so that each of them has to be discovered */
+  filename = g_filename_from_uri (av_uri, NULL, NULL);
+  fail_unless (g_file_get_contents (filename, &contents, &length, NULL));
+  for (i = 0; i < G_N_ELEMENTS (copies); i++) {
+    gchar *basename = g_strdup_printf ("test-concurrent-%u_TMP.ogg", i);
+
+    copies[i] = g_build_filename (g_get_tmp_dir (), basename, NULL);
+    fail_unless (g_file_set_contents (copies[i], contents, length, NULL));
+    uris[i] = gst_filename_to_uri (copies[i], NULL);
+    g_free (basename);
+  }
+
+  /* The pool shrinks while its discoverers are busy with the first
+   * assets, the ones in excess are retired once done */
+  ges_uri_clip_asset_class_set_discoverer_pool_size (klass, 4);
+  for (i = 0; i < 6; i++)
+    ges_asset_request_async (GES_TYPE_URI_CLIP, uris[i], NULL,
+        (GAsyncReadyCallback) concurrent_asset_loaded_cb, &n_loaded);
+  ges_uri_clip_asset_class_set_discoverer_pool_size (klass, 1);
+
+  /* And the remaining one still discovers the next ones */
+  for (; i < G_N_ELEMENTS (uris); i++)
+    ges_asset_request_async (GES_TYPE_URI_CLIP, uris[i], NULL,
+        (GAsyncReadyCallback) concurrent_asset_loaded_cb, &n_loaded);
+
+  g_main_loop_run (mainloop);
+  assert_equals_int (n_loaded, G_N_ELEMENTS (uris));
+  while (g_main_context_iteration (NULL, FALSE));
+
+#if GLIB_CHECK_VERSION(2, 36, 0)
+  ges_uri_clip_asset_class_set_discoverer_pool_size (klass,
+      MAX (g_get_num_processors (), 1));
+#else
+  ges_uri_clip_asset_class_set_discoverer_pool_size (klass, 2);
+#endif
+
+  for (i = 0; i < G_N_ELEMENTS (copies); i++) {
+    g_unlink (copies[i]);
+    g_free (copies[i]);
+    g_free (uris[i]);
+  }
+  g_free (contents);
+  g_free (filename);
+  g_type_class_unref (klass);
+  g_main_loop_unref (mainloop);
+}
+
+GST_END_TEST;
+
+typedef struct
+{
+  GMutex lock;
+  GCond cond;
+  guint n_results;
+  GstSample *samples[5];
+  GThread *threads[5];
+  GError *error;
+} ImageResults;
+
+static void
+image_ready_cb (GstSample * sample, const GError * error,
+    ImageResults * results)
+{
+  g_mutex_lock (&results->lock);
+  fail_unless (results->n_results < G_N_ELEMENTS (results->samples));
+  results->samples[results->n_results] =
+      sample ? gst_sample_ref (sample) : NULL;
+  results->threads[results->n_results] = g_thread_self ();
+  if (error)
+    results->error = g_error_copy (error);
+  results->n_results++;
+  g_cond_signal (&results->cond);
+  g_mutex_unlock (&results->lock);
+}
+
+static void
+wait_images (ImageResults * results, guint n_results)
+{
+  g_mutex_lock (&results->lock);
+  while (results->n_results < n_results)
+    g_cond_wait (&results->cond, &results->lock);
+  g_mutex_unlock (&results->lock);
+}
+
+GST_START_TEST (test_image_cache)
+{
+  guint i;
+  gsize memory, length;
+  gchar *uri, *filename, *copy, *copy_uri, *contents;
+  guint hits, misses, evictions;
+  ImageResults results = { {0,}, };
+
+  ges_init ();
+
+  g_mutex_init (&results.lock);
+  g_cond_init (&results.cond);
+  uri = ges_test_file_uri ("image.png");
+  ges_image_cache_clear ();
+
+  /* The image is decoded once, from a thread of the cache, for both
+   * requests */
+  ges_image_cache_get_async (uri, (GESImageCacheCallback) image_ready_cb,
+      &results);
+  ges_image_cache_get_async (uri, (GESImageCacheCallback) image_ready_cb,
+      &results);
+  wait_images (&results, 2);
+  fail_unless (GST_IS_SAMPLE (results.samples[0]));
+  fail_unless (results.samples[0] == results.samples[1]);
+  fail_unless (results.threads[0] != g_thread_self ());
+
+  ges_image_cache_get_stats (&hits, &misses, &evictions, &memory);
+  assert_equals_int (hits, 1);
+  assert_equals_int (misses, 1);
+  assert_equals_int (evictions, 0);
+  assert_equals_uint64 (memory,
+      gst_buffer_get_size (gst_sample_get_buffer (results.samples[0])));
+
+  /* Cached frames are given right away */
+  ges_image_cache_get_async (uri, (GESImageCacheCallback) image_ready_cb,
+      &results);
+  assert_equals_int (results.n_results, 3);
+  fail_unless (results.samples[2] == results.samples[0]);
+  fail_unless (results.threads[2] == g_thread_self ());
+
+  /* Another image does not fit in the budget with the first one, which
+   * is evicted */
+  filename = g_filename_from_uri (uri, NULL, NULL);
+  fail_unless (g_file_get_contents (filename, &contents, &length, NULL));
+  copy = g_build_filename (cache_dir, "image-copy.png", NULL);
+  fail_unless (g_file_set_contents (copy, contents, length, NULL));
+  copy_uri = gst_filename_to_uri (copy, NULL);
+
+  ges_image_cache_set_budget (1);
+  ges_image_cache_get_async (copy_uri, (GESImageCacheCallback)
+      image_ready_cb, &results);
+  wait_images (&results, 4);
+  fail_unless (GST_IS_SAMPLE (results.samples[3]));
+  fail_unless (results.samples[3] != results.samples[0]);
+
+  ges_image_cache_get_stats (&hits, &misses, &evictions, &memory);
+  assert_equals_int (hits, 2);
+  assert_equals_int (misses, 2);
+  assert_equals_int (evictions, 1);
+  assert_equals_uint64 (memory,
+      gst_buffer_get_size (gst_sample_get_buffer (results.samples[3])));
+
+  /* The evicted frame is still usable by the ones holding it */
+  fail_unless (GST_IS_BUFFER (gst_sample_get_buffer (results.samples[0])));
+
+  /* Failures always come with an error */
+  ges_image_cache_get_async ("file:///nonexistent/image.png",
+      (GESImageCacheCallback) image_ready_cb, &results);
+  wait_images (&results, 5);
+  fail_unless (results.samples[4] == NULL);
+  fail_unless (results.error != NULL);
+
+  for (i = 0; i < results.n_results; i++) {
+    if (results.samples[i])
+      gst_sample_unref (results.samples[i]);
+  }
+  g_clear_error (&results.error);
+  g_mutex_clear (&results.lock);
+  g_cond_clear (&results.cond);
+
+  ges_image_cache_set_budget (GES_IMAGE_CACHE_DEFAULT_BUDGET);
+  ges_image_cache_clear ();
+  g_unlink (copy);
+  g_free (copy);
+  g_free (copy_uri);
+  g_free (contents);
+  g_free (filename);
+  g_free (uri);
+}
+
+GST_END_TEST;
+
+static GstPadProbeReturn
+frame_probe_cb (GstPad * pad, GstPadProbeInfo * info, gconstpointer * frame)
+{
+  GstMapInfo map;
+  GstBuffer *buffer = GST_PAD_PROBE_INFO_BUFFER (info);
+
+  gst_buffer_map (buffer, &map, GST_MAP_READ);
+  *frame = map.data;
+  gst_buffer_unmap (buffer, &map);
+
+  return GST_PAD_PROBE_OK;
+}
+
+static gint
+is_appsrc (const GValue * value, gconstpointer unused)
+{
+  GstElement *element = g_value_get_object (value);
+  GstElementFactory *factory = gst_element_get_factory (element);
+
+  return factory && !g_strcmp0 (GST_OBJECT_NAME (factory), "appsrc") ? 0 : 1;
+}
+
+GST_START_TEST (test_image_sources_share_frame)
+{
+  guint i;
+  GstBus *bus;
+  GstPad *pad;
+  GstMessage *msg;
+  GstIterator *it;
+  GstElement *sink, *appsrc;
+  GValue value = { 0, };
+  GESTimeline *timeline;
+  GESPipeline *pipeline;
+  GESUriClipAsset *asset;
+  GESTrackElement *source;
+  GESClip *clip;
+  gconstpointer frames[2] = { NULL, NULL };
+
+  ges_init ();
+
+  timeline = ges_timeline_new ();
+  fail_unless (ges_timeline_add_track (timeline,
+          GES_TRACK (ges_video_track_new ())));
+  asset = ges_uri_clip_asset_request_sync (image_uri, NULL);
+  fail_unless (GES_IS_URI_CLIP_ASSET (asset));
+
+  /* Two clips of the same image, composited together */
+  for (i = 0; i < 2; i++) {
+    clip = ges_layer_add_asset (ges_timeline_append_layer (timeline),
+        GES_ASSET (asset), 0, 0, GST_SECOND, GES_TRACK_TYPE_UNKNOWN);
+    fail_unless (GES_IS_CLIP (clip));
+    source = GES_CONTAINER_CHILDREN (clip)->data;
+    fail_unless (GES_IS_IMAGE_SOURCE (source));
+
+    it = gst_bin_iterate_recurse (GST_BIN (ges_track_element_get_element
+            (source)));
+    fail_unless (gst_iterator_find_custom (it, (GCompareFunc) is_appsrc,
+            &value, NULL));
+    appsrc = g_value_get_object (&value);
+    pad = gst_element_get_static_pad (appsrc, "src");
+    gst_pad_add_probe (pad, GST_PAD_PROBE_TYPE_BUFFER,
+        (GstPadProbeCallback) frame_probe_cb, &frames[i], NULL);
+    gst_object_unref (pad);
+    g_value_unset (&value);
+    gst_iterator_free (it);
+  }
+  gst_object_unref (asset);
+
+  sink = gst_element_factory_make ("fakesink", NULL);
+  pipeline = ges_pipeline_new ();
+  ges_pipeline_preview_set_video_sink (pipeline, sink);
+  fail_unless (ges_pipeline_add_timeline (pipeline, timeline));
+  ges_timeline_commit (timeline);
+
+  bus = gst_element_get_bus (GST_ELEMENT (pipeline));
+  gst_element_set_state (GST_ELEMENT (pipeline), GST_STATE_PAUSED);
+  msg = gst_bus_timed_pop_filtered (bus, 10 * GST_SECOND,
+      GST_MESSAGE_ASYNC_DONE | GST_MESSAGE_ERROR);
+  fail_unless (msg != NULL);
+  fail_unless (GST_MESSAGE_TYPE (msg) == GST_MESSAGE_ASYNC_DONE);
+  gst_message_unref (msg);
+
+  /* Both sources pushed the very same decoded frame */
+  fail_unless (frames[0] != NULL);
+  fail_unless (frames[0] == frames[1]);
+
+  gst_element_set_state (GST_ELEMENT (pipeline), GST_STATE_NULL);
+  gst_object_unref (bus);
+  gst_object_unref (pipeline);
+}
+
+GST_END_TEST;
+
+static GstSample *
+make_thumbnail (guint8 value)
+{
+  GstSample *sample;
+  GstBuffer *buffer = gst_buffer_new_allocate (NULL, 4 * 2 * 3, NULL);
+  GstCaps *caps = gst_caps_from_string ("video/x-raw,format=RGB,width=4,"
+      "height=2,framerate=0/1");
+
+  gst_buffer_memset (buffer, 0, value, 4 * 2 * 3);
+  sample = gst_sample_new (buffer, caps, NULL, NULL);
+  gst_buffer_unref (buffer);
+  gst_caps_unref (caps);
+
+  return sample;
+}
+
+static void
+check_thumbnail (GstSample * sample, GstClockTime timestamp, guint8 value)
+{
+  GstMapInfo info;
+  GstBuffer *buffer = gst_sample_get_buffer (sample);
+
+  assert_equals_uint64 (GST_BUFFER_PTS (buffer), timestamp);
+  gst_buffer_map (buffer, &info, GST_MAP_READ);
+  assert_equals_int (info.size, 4 * 2 * 3);
+  assert_equals_int (info.data[0], value);
+  assert_equals_int (info.data[info.size - 1], value);
+  gst_buffer_unmap (buffer, &info);
+}
+
+GST_START_TEST (test_media_cache)
+{
+  guint i;
+  GList *thumbnails;
+  GstSample *sample;
+  gchar *dirname, *filename;
+  GESPeaksCache *peaks_cache;
+  GESThumbnailCache *thumbnail_cache;
+  GESAudioPeak peaks[20], cached[20];
+
+  ges_init ();
+
+  dirname = g_dir_make_tmp ("ges-media-cache-XXXXXX", NULL);
+  fail_unless (dirname != NULL);
+
+  for (i = 0; i < G_N_ELEMENTS (peaks); i++) {
+    peaks[i].min = -(gfloat) i / G_N_ELEMENTS (peaks);
+    peaks[i].max = (gfloat) i / G_N_ELEMENTS (peaks);
+    peaks[i].rms = peaks[i].max / 2;
+  }
+
+  /* 10 buckets of 2 channels, only the beginning is there while the rest
+   * is being computed */
+  filename = g_build_filename (dirname, "peaks", NULL);
+  peaks_cache = ges_peaks_cache_new (filename, GST_SECOND / 10, 2, 10);
+  assert_equals_int (ges_peaks_cache_lookup (peaks_cache, 0, 10, cached), 0);
+  ges_peaks_cache_store (peaks_cache, 0, 4, peaks);
+  ges_peaks_cache_store (peaks_cache, 6, 4, peaks + 12);
+  assert_equals_int (ges_peaks_cache_lookup (peaks_cache, 0, 10, cached), 4);
+  fail_unless (memcmp (cached, peaks, 4 * 2 * sizeof (GESAudioPeak)) == 0);
+  assert_equals_int (ges_peaks_cache_lookup (peaks_cache, 6, 10, cached), 4);
+  fail_if (ges_peaks_cache_is_complete (peaks_cache));
+  ges_peaks_cache_store (peaks_cache, 4, 2, peaks + 8);
+  fail_unless (ges_peaks_cache_is_complete (peaks_cache));
+  fail_unless (ges_peaks_cache_save (peaks_cache, NULL));
+  ges_peaks_cache_free (peaks_cache);
+
+  /* Reopening it only maps the file */
+  peaks_cache = ges_peaks_cache_new (filename, GST_SECOND / 10, 2, 10);
+  fail_unless (ges_peaks_cache_is_mapped (peaks_cache));
+  fail_unless (ges_peaks_cache_is_complete (peaks_cache));
+  assert_equals_int (ges_peaks_cache_lookup (peaks_cache, 0, 10, cached), 10);
+  fail_unless (memcmp (cached, peaks, sizeof (peaks)) == 0);
+  ges_peaks_cache_store (peaks_cache, 0, 1, peaks + 2);
+  fail_if (ges_peaks_cache_is_mapped (peaks_cache));
+  ges_peaks_cache_free (peaks_cache);
+
+  /* Another resolution does not use the file */
+  peaks_cache = ges_peaks_cache_new (filename, GST_SECOND / 100, 2, 100);
+  fail_if (ges_peaks_cache_is_mapped (peaks_cache));
+  assert_equals_int (ges_peaks_cache_lookup (peaks_cache, 0, 10, cached), 0);
+  ges_peaks_cache_free (peaks_cache);
+  g_unlink (filename);
+  g_free (filename);
+
+  filename = g_build_filename (dirname, "thumbnails", NULL);
+  thumbnail_cache = ges_thumbnail_cache_new (filename);
+  for (i = 0; i < 3; i++) {
+    sample = make_thumbnail (i + 1);
+    ges_thumbnail_cache_store (thumbnail_cache, i * GST_SECOND, sample);
+    gst_sample_unref (sample);
+  }
+  fail_unless (ges_thumbnail_cache_save (thumbnail_cache, NULL));
+  ges_thumbnail_cache_free (thumbnail_cache);
+
+  thumbnail_cache = ges_thumbnail_cache_new (filename);
+  thumbnails = ges_thumbnail_cache_lookup (thumbnail_cache, GST_SECOND / 2,
+      2 * GST_SECOND);
+  assert_equals_int (g_list_length (thumbnails), 2);
+  check_thumbnail (thumbnails->data, GST_SECOND, 2);
+  check_thumbnail (thumbnails->next->data, 2 * GST_SECOND, 3);
+  g_list_free_full (thumbnails, (GDestroyNotify) gst_sample_unref);
+
+  /* Storing at the same timestamp replaces the thumbnail */
+  sample = make_thumbnail (42);
+  ges_thumbnail_cache_store (thumbnail_cache, 0, sample);
+  gst_sample_unref (sample);
+  thumbnails = ges_thumbnail_cache_lookup (thumbnail_cache, 0, 0);
+  assert_equals_int (g_list_length (thumbnails), 1);
+  check_thumbnail (thumbnails->data, 0, 42);
+  ges_thumbnail_cache_free (thumbnail_cache);
+
+  /* The thumbnails outlive the cache */
+  check_thumbnail (thumbnails->data, 0, 42);
+  g_list_free_full (thumbnails, (GDestroyNotify) gst_sample_unref);
+
+  g_unlink (filename);
+  g_free (filename);
+  g_rmdir (dirname);
+  g_free (dirname);
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_asset_media_cache)
+{
+  guint i;
+  GList *thumbnails;
+  GstSample *sample;
+  GstCaps *caps;
+  GESUriClipAsset *asset;
+  GESAudioPeak peaks[10] = { {0,}, };
+  GESAudioPeak stereo[20] = { {0,}, };
+  GESAudioPeak cached[20];
+
+  ges_init ();
+
+  asset = ges_uri_clip_asset_request_sync (av_uri, NULL);
+  fail_unless (GES_IS_URI_CLIP_ASSET (asset));
+  assert_equals_uint64 (ges_uri_clip_asset_get_duration (asset), GST_SECOND);
+
+  /* Nothing is cached yet */
+  assert_equals_int (count_cache_files ("media"), 0);
+  assert_equals_int (ges_uri_clip_asset_get_cached_peaks (asset,
+          GST_SECOND / 10, 1, 0, 10, cached), 0);
+
+  /* A 1 second file has 10 buckets of 100ms, the ones past the end are
+   * ignored. Complete peaks are written to disk right away. */
+  peaks[0].max = 0.5;
+  peaks[5].min = -0.5;
+  ges_uri_clip_asset_store_peaks (asset, GST_SECOND / 10, 1, 0, 10, peaks);
+  ges_uri_clip_asset_store_peaks (asset, GST_SECOND / 10, 1, 10, 10, peaks);
+  assert_equals_int (ges_uri_clip_asset_get_cached_peaks (asset,
+          GST_SECOND / 10, 1, 0, 20, cached), 10);
+  fail_unless (memcmp (cached, peaks, sizeof (peaks)) == 0);
+  assert_equals_int (ges_uri_clip_asset_get_cached_peaks (asset,
+          GST_SECOND / 10, 1, 8, 10, cached), 2);
+  assert_equals_int (count_cache_files ("media"), 1);
+
+  /* Nothing is known for other resolutions */
+  assert_equals_int (ges_uri_clip_asset_get_cached_peaks (asset,
+          GST_SECOND / 100, 1, 0, 10, cached), 0);
+
+  /* Peaks with other channels are kept apart, the mono ones are not lost */
+  for (i = 0; i < G_N_ELEMENTS (stereo); i++)
+    stereo[i].max = 0.25;
+  ges_uri_clip_asset_store_peaks (asset, GST_SECOND / 10, 2, 0, 10, stereo);
+  assert_equals_int (ges_uri_clip_asset_get_cached_peaks (asset,
+          GST_SECOND / 10, 2, 0, 10, cached), 10);
+  fail_unless (memcmp (cached, stereo, sizeof (stereo)) == 0);
+  assert_equals_int (ges_uri_clip_asset_get_cached_peaks (asset,
+          GST_SECOND / 10, 1, 0, 10, cached), 10);
+  fail_unless (memcmp (cached, peaks, sizeof (peaks)) == 0);
+
+  assert_equals_int (count_cache_files ("media"), 2);
+
+  sample = make_thumbnail (7);
+  ges_uri_clip_asset_store_thumbnail (asset, GST_SECOND / 2, sample);
+  gst_sample_unref (sample);
+
+  /* Thumbnails are looked up with their whole caps, not only their size */
+  caps = gst_caps_from_string ("video/x-raw,format=RGB,width=8,height=4,"
+      "framerate=0/1");
+  fail_unless (ges_uri_clip_asset_get_cached_thumbnails (asset, caps, 0,
+          GST_SECOND) == NULL);
+  gst_caps_unref (caps);
+  caps = gst_caps_from_string ("video/x-raw,format=BGR,width=4,height=2,"
+      "framerate=0/1");
+  fail_unless (ges_uri_clip_asset_get_cached_thumbnails (asset, caps, 0,
+          GST_SECOND) == NULL);
+  gst_caps_unref (caps);
+  caps = gst_caps_from_string ("video/x-raw,format=RGB,width=4,height=2,"
+      "framerate=0/1");
+  thumbnails = ges_uri_clip_asset_get_cached_thumbnails (asset, caps, 0,
+      GST_SECOND);
+  gst_caps_unref (caps);
+  assert_equals_int (g_list_length (thumbnails), 1);
+  check_thumbnail (thumbnails->data, GST_SECOND / 2, 7);
+  g_list_free_full (thumbnails, (GDestroyNotify) gst_sample_unref);
+
+  /* Thumbnails are only written when saving */
+  assert_equals_int (count_cache_files ("media"), 2);
+  fail_unless (ges_uri_clip_asset_save_media_cache (asset, NULL));
+  assert_equals_int (count_cache_files ("media"), 3);
+
+  gst_object_unref (asset);
+}
+
+GST_END_TEST;
+
+/* Scalar reference of the peaks computation, from interleaved samples */
+static GESAudioPeak *
+reference_peaks (const gfloat * samples, guint64 n_frames, guint n_channels,
+    gint rate, GstClockTime bucket_duration, guint64 n_buckets)
+{
+  guint64 b, f;
+  guint c;
+  GESAudioPeak *peaks = g_new0 (GESAudioPeak, n_buckets * n_channels);
+
+  for (b = 0; b < n_buckets; b++) {
+    guint64 start = gst_util_uint64_scale (b * bucket_duration, rate,
+        GST_SECOND);
+    guint64 stop = gst_util_uint64_scale ((b + 1) * bucket_duration, rate,
+        GST_SECOND);
+
+    stop = MIN (stop, n_frames);
+    for (c = 0; c < n_channels && start < stop; c++) {
+      GESAudioPeak *peak = &peaks[b * n_channels + c];
+      gdouble squares = 0;
+
+      peak->min = peak->max = samples[start * n_channels + c];
+      for (f = start; f < stop; f++) {
+        gfloat x = samples[f * n_channels + c];
+
+        if (x < peak->min)
+          peak->min = x;
+        if (x > peak->max)
+          peak->max = x;
+        squares += (gdouble) x *x;
+      }
+      peak->rms = sqrt (squares / (stop - start));
+    }
+  }
+
+  return peaks;
+}
+
+static void
+check_peaks (const GESAudioPeak * peaks, const GESAudioPeak * reference,
+    guint64 n)
+{
+  guint64 i;
+
+  for (i = 0; i < n; i++) {
+    fail_unless (peaks[i].min == reference[i].min, "min %" G_GUINT64_FORMAT
+        ": %f != %f", i, peaks[i].min, reference[i].min);
+    fail_unless (peaks[i].max == reference[i].max, "max %" G_GUINT64_FORMAT
+        ": %f != %f", i, peaks[i].max, reference[i].max);
+    fail_unless (fabs (peaks[i].rms - reference[i].rms) <= 1e-4,
+        "rms %" G_GUINT64_FORMAT ": %f != %f", i, peaks[i].rms,
+        reference[i].rms);
+  }
+}
+
+GST_START_TEST (test_peaks_kernels)
+{
+  guint i, n;
+  GRand *rand;
+  gfloat *samples, *planar;
+  GESAudioPeak *peaks, *reference;
+  GESPeaksReducer *reducer;
+  guint64 first_bucket, n_buckets;
+  guint n_taken;
+
+  ges_init ();
+
+  /* Deterministic noise, with lengths that are not multiple of the lanes */
+  rand = g_rand_new_with_seed (42);
+  samples = g_new (gfloat, 2 * 1001);
+  planar = g_new (gfloat, 2 * 1001);
+  for (i = 0; i < 2 * 1001; i++)
+    samples[i] = g_rand_double_range (rand, -1.0, 1.0);
+
+  for (n = 0; n < 40; n++) {
+    gfloat min = G_MAXFLOAT, max = -G_MAXFLOAT;
+    gfloat ref_min = G_MAXFLOAT, ref_max = -G_MAXFLOAT;
+    gdouble squares = 0, ref_squares = 0;
+
+    ges_audio_peaks_reduce (samples, n, &min, &max, &squares);
+    for (i = 0; i < n; i++) {
+      ref_min = MIN (ref_min, samples[i]);
+      ref_max = MAX (ref_max, samples[i]);
+      ref_squares += (gdouble) samples[i] * samples[i];
+    }
+    fail_unless (min == ref_min);
+    fail_unless (max == ref_max);
+    fail_unless (fabs (squares - ref_squares) <= 1e-5);
+  }
+
+  ges_audio_peaks_deinterleave (samples, 1001, 2, planar);
+  for (i = 0; i < 1001; i++) {
+    fail_unless (planar[i] == samples[2 * i]);
+    fail_unless (planar[1001 + i] == samples[2 * i + 1]);
+  }
+
+  /* 1001 frames at 8kHz in buckets of 10ms, pushed in uneven chunks */
+  reducer = ges_peaks_reducer_new (GST_MSECOND * 10, 2, 8000);
+  for (i = 0; i < 1001; i += n) {
+    n = MIN (1001 - i, 37 + i % 100);
+    ges_audio_peaks_deinterleave (samples + 2 * i, n, 2, planar);
+    ges_peaks_reducer_push (reducer, planar, n);
+  }
+  ges_peaks_reducer_drain (reducer);
+  n_buckets = ges_peaks_reducer_get_n_buckets (reducer);
+  assert_equals_uint64 (n_buckets, 13);
+
+  peaks = ges_peaks_reducer_take (reducer, &first_bucket, &n_taken);
+  assert_equals_uint64 (first_bucket, 0);
+  assert_equals_int (n_taken, n_buckets);
+  reference = reference_peaks (samples, 1001, 2, 8000, GST_MSECOND * 10,
+      n_buckets);
+  check_peaks (peaks, reference, n_buckets * 2);
+  fail_unless (ges_peaks_reducer_take (reducer, &first_bucket,
+          &n_taken) == NULL);
+
+  g_free (peaks);
+  g_free (reference);
+  ges_peaks_reducer_free (reducer);
+  g_free (samples);
+  g_free (planar);
+  g_rand_free (rand);
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_peaks_timestamps)
+{
+  guint i, j;
+  GRand *rand;
+  gfloat chunk[160];
+  gfloat expected[1400] = { 0, };
+  GESAudioPeak *peaks, *reference;
+  GESPeaksReducer *reducer;
+  guint64 first_bucket;
+  guint n_taken;
+  /* Mono at 8kHz in buckets of 10ms, that is 80 frames */
+  struct
+  {
+    guint64 timestamp;          /* The frame the buffer is stamped with */
+    guint64 start;              /* The frame it is expected to start at */
+    guint n_frames;
+    gboolean discont;
+    guint first_kept;           /* The frames before are dropped */
+  } chunks[] = {
+    /* Not starting at 0 */
+    {240, 240, 160, FALSE, 0},
+    {400, 400, 80, FALSE, 0},
+    /* Jitter below the threshold is ignored */
+    {482, 480, 80, FALSE, 0},
+    /* A small gap only resynchronises when flagged as a discontinuity */
+    {640, 640, 160, TRUE, 0},
+    /* A gap bigger than the threshold always does */
+    {1200, 1200, 160, FALSE, 0},
+    /* Going back drops what was already reduced */
+    {1320, 1320, 80, TRUE, 40},
+  };
+
+  ges_init ();
+
+  rand = g_rand_new_with_seed (42);
+  reducer = ges_peaks_reducer_new (GST_MSECOND * 10, 1, 8000);
+  for (i = 0; i < G_N_ELEMENTS (chunks); i++) {
+    for (j = 0; j < chunks[i].n_frames; j++) {
+      chunk[j] = g_rand_double_range (rand, -1.0, 1.0);
+      if (j >= chunks[i].first_kept)
+        expected[chunks[i].start + j] = chunk[j];
+    }
+    ges_peaks_reducer_push_at (reducer, chunks[i].timestamp,
+        chunks[i].discont, chunk, chunks[i].n_frames);
+  }
+  ges_peaks_reducer_drain (reducer);
+  assert_equals_uint64 (ges_peaks_reducer_get_n_buckets (reducer), 18);
+
+  /* The gaps are silent */
+  peaks = ges_peaks_reducer_take (reducer, &first_bucket, &n_taken);
+  assert_equals_uint64 (first_bucket, 0);
+  assert_equals_int (n_taken, 18);
+  reference = reference_peaks (expected, G_N_ELEMENTS (expected), 1, 8000,
+      GST_MSECOND * 10, n_taken);
+  check_peaks (peaks, reference, n_taken);
+  for (i = 0; i < 3; i++)
+    fail_unless (peaks[i].min == 0 && peaks[i].max == 0 && peaks[i].rms == 0);
+  fail_unless (peaks[7].max == 0);
+  fail_unless (peaks[10].max == 0 && peaks[14].max == 0);
+
+  g_free (peaks);
+  g_free (reference);
+  ges_peaks_reducer_free (reducer);
+  g_rand_free (rand);
+}
+
+GST_END_TEST;
+
+static void
+peaks_progress_cb (GESUriClipAsset * asset, gdouble progress,
+    gdouble * last_progress)
+{
+  fail_unless (progress > *last_progress);
+  fail_unless (progress <= 1.0);
+  *last_progress = progress;
+}
+
+static void
+peaks_computed_cb (GESUriClipAsset * asset, GAsyncResult * result,
+    guint * n_channels)
+{
+  GError *error = NULL;
+
+  fail_unless (ges_uri_clip_asset_compute_peaks_finish (asset, result,
+          n_channels, &error), "%s", error ? error->message : "");
+  g_main_loop_quit (mainloop);
+}
+
+/* Decodes @uri to interleaved floats */
+static gfloat *
+decode_audio (const gchar * uri, guint64 * n_frames, gint * channels,
+    gint * rate)
+{
+  gchar *description;
+  GstElement *pipeline, *sink;
+  GstSample *sample;
+  GByteArray *data = g_byte_array_new ();
+
+  description = g_strdup_printf ("uridecodebin uri=%s ! audioconvert ! "
+      "appsink name=sink sync=false caps=audio/x-raw,format=%s,"
+      "layout=interleaved", uri,
+      G_BYTE_ORDER == G_LITTLE_ENDIAN ? "F32LE" : "F32BE");
+  pipeline = gst_parse_launch (description, NULL);
+  fail_unless (pipeline != NULL);
+  g_free (description);
+
+  sink = gst_bin_get_by_name (GST_BIN (pipeline), "sink");
+  gst_element_set_state (pipeline, GST_STATE_PLAYING);
+  while (TRUE) {
+    GstMapInfo info;
+    GstStructure *structure;
+
+    g_signal_emit_by_name (sink, "pull-sample", &sample);
+    if (sample == NULL)
+      break;
+
+    structure = gst_caps_get_structure (gst_sample_get_caps (sample), 0);
+    fail_unless (gst_structure_get_int (structure, "channels", channels));
+    fail_unless (gst_structure_get_int (structure, "rate", rate));
+    gst_buffer_map (gst_sample_get_buffer (sample), &info, GST_MAP_READ);
+    g_byte_array_append (data, info.data, info.size);
+    gst_buffer_unmap (gst_sample_get_buffer (sample), &info);
+    gst_sample_unref (sample);
+  }
+  gst_element_set_state (pipeline, GST_STATE_NULL);
+  gst_object_unref (sink);
+  gst_object_unref (pipeline);
+
+  *n_frames = data->len / (sizeof (gfloat) * *channels);
+
+  return (gfloat *) g_byte_array_free (data, FALSE);
+}
+
+GST_START_TEST (test_compute_peaks)
+{
+  guint i;
+  gchar *uri;
+  gint channels, rate;
+  gfloat *samples;
+  guint64 n_frames, n_buckets;
+  GESUriClipAsset *asset;
+  guint n_channels = 0;
+  gdouble last_progress = -1;
+  GESAudioPeak marker = { 0, }, *markers;
+  GstClockTime durations[] = { GST_SECOND / 10, GST_SECOND / 3 };
+
+  ges_init ();
+
+  uri = ges_test_get_audio_only_uri ();
+  asset = ges_uri_clip_asset_request_sync (uri, NULL);
+  fail_unless (GES_IS_URI_CLIP_ASSET (asset));
+
+  /* Nothing is cached yet, so the file is decoded */
+  assert_equals_int (count_cache_files ("media"), 0);
+
+  mainloop = g_main_loop_new (NULL, FALSE);
+  ges_uri_clip_asset_compute_peaks_async (asset, durations,
+      G_N_ELEMENTS (durations), NULL,
+      (GESPeaksProgressCallback) peaks_progress_cb, &last_progress,
+      (GAsyncReadyCallback) peaks_computed_cb, &n_channels);
+  g_main_loop_run (mainloop);
+
+  /* The progress is notified before the end of the computation */
+  fail_unless (last_progress == 1.0);
+
+  samples = decode_audio (uri, &n_frames, &channels, &rate);
+  assert_equals_int (n_channels, channels);
+  fail_unless (n_frames > 0);
+
+  for (i = 0; i < G_N_ELEMENTS (durations); i++) {
+    GESAudioPeak *peaks, *reference;
+
+    n_buckets = (ges_uri_clip_asset_get_duration (asset) + durations[i] - 1) /
+        durations[i];
+    peaks = g_new (GESAudioPeak, n_buckets * n_channels);
+    assert_equals_int (ges_uri_clip_asset_get_cached_peaks (asset,
+            durations[i], n_channels, 0, n_buckets, peaks), n_buckets);
+
+    reference = reference_peaks (samples, n_frames, n_channels, rate,
+        durations[i], n_buckets);
+    check_peaks (peaks, reference, n_buckets * n_channels);
+    g_free (reference);
+    g_free (peaks);
+  }
+
+  /* Each resolution has been written to disk */
+  assert_equals_int (count_cache_files ("media"), G_N_ELEMENTS (durations));
+
+  /* All the resolutions are in the cache now, so computing them again
+   * does not decode the file, which would overwrite the marker */
+  marker.max = 42;
+  markers = g_new0 (GESAudioPeak, n_channels);
+  for (i = 0; i < n_channels; i++)
+    markers[i] = marker;
+  ges_uri_clip_asset_store_peaks (asset, durations[0], n_channels, 0, 1,
+      markers);
+
+  last_progress = -1;
+  ges_uri_clip_asset_compute_peaks_async (asset, durations,
+      G_N_ELEMENTS (durations), NULL,
+      (GESPeaksProgressCallback) peaks_progress_cb, &last_progress,
+      (GAsyncReadyCallback) peaks_computed_cb, &n_channels);
+  g_main_loop_run (mainloop);
+  g_main_loop_unref (mainloop);
+
+  fail_unless (last_progress == 1.0);
+  assert_equals_int (ges_uri_clip_asset_get_cached_peaks (asset,
+          durations[0], n_channels, 0, 1, markers), 1);
+  for (i = 0; i < n_channels; i++)
+    fail_unless (markers[i].max == 42);
+  g_free (markers);
+
+  gst_object_unref (asset);
+  g_free (samples);
+  g_free (uri);
+}
+
+GST_END_TEST;
 
 static Suite *
 ges_suite (void)
@@ -272,10 +1327,21 @@ ges_suite (void)
   TCase *tc_chain = tcase_create ("filesource");
 
   suite_add_tcase (s, tc_chain);
+  tcase_add_checked_fixture (tc_chain, clear_caches, NULL);
 
   tcase_add_test (tc_chain, test_filesource_basic);
   tcase_add_test (tc_chain, test_filesource_images);
   tcase_add_test (tc_chain, test_filesource_properties);
+  tcase_add_test (tc_chain, test_filesource_split);
+  tcase_add_test (tc_chain, test_filesource_discoverer_cache);
+  tcase_add_test (tc_chain, test_filesource_concurrent_loading);
+  tcase_add_test (tc_chain, test_image_cache);
+  tcase_add_test (tc_chain, test_image_sources_share_frame);
+  tcase_add_test (tc_chain, test_media_cache);
+  tcase_add_test (tc_chain, test_asset_media_cache);
+  tcase_add_test (tc_chain, test_peaks_kernels);
+  tcase_add_test (tc_chain, test_peaks_timestamps);
+  tcase_add_test (tc_chain, test_compute_peaks);
 
   return s;
 }
@@ -287,6 +1353,10 @@ main (int argc, char **argv)
 
   Suite *s = ges_suite ();
 
+  /* Before anything caches the user cache directory */
+  cache_dir = g_dir_make_tmp ("ges-uriclip-XXXXXX", NULL);
+  g_setenv ("XDG_CACHE_HOME", cache_dir, TRUE);
+
   gst_check_init (&argc, &argv);
 
   av_uri = ges_test_get_audio_video_uri ();
@@ -296,6 +1366,8 @@ main (int argc, char **argv)
 
   g_free (av_uri);
   g_free (image_uri);
+  remove_directory (cache_dir);
+  g_free (cache_dir);
 
   return nf;
 }